@@ -24,6 +24,7 @@
  * THE SOFTWARE.
  */
 
+#include "py/gc.h"
 #include "py/runtime.h"
 #include "py/smallint.h"
 #include "py/pairheap.h"
@@ -123,6 +124,7 @@ static mp_obj_t task_queue_push(size_t n_args, const mp_obj_t *args) {
         task->ph_key = args[2];
     }
     self->heap = (mp_obj_task_t *)mp_pairheap_push(task_lt, TASK_PAIRHEAP(self->heap), TASK_PAIRHEAP(task));
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(self->heap));
     #if MICROPY_PY_ASYNCIO_TASK_QUEUE_PUSH_CALLBACK
     if (self->push_callback != MP_OBJ_NULL) {
         mp_call_function_1(self->push_callback, MP_OBJ_NEW_SMALL_INT(0));
@@ -139,6 +141,7 @@ static mp_obj_t task_queue_pop(mp_obj_t self_in) {
         mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("empty heap"));
     }
     self->heap = (mp_obj_task_t *)mp_pairheap_pop(task_lt, &self->heap->pairheap);
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(self->heap));
     return MP_OBJ_FROM_PTR(head);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(task_queue_pop_obj, task_queue_pop);
@@ -147,6 +150,7 @@ static mp_obj_t task_queue_remove(mp_obj_t self_in, mp_obj_t task_in) {
     mp_obj_task_queue_t *self = MP_OBJ_TO_PTR(self_in);
     mp_obj_task_t *task = MP_OBJ_TO_PTR(task_in);
     self->heap = (mp_obj_task_t *)mp_pairheap_delete(task_lt, &self->heap->pairheap, &task->pairheap);
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(self->heap));
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(task_queue_remove_obj, task_queue_remove);
@@ -262,9 +266,11 @@ static void task_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
         // Store
         if (attr == MP_QSTR_data) {
             self->data = dest[1];
+            MP_GC_WRITE_BARRIER(dest[1]);
             dest[0] = MP_OBJ_NULL;
         } else if (attr == MP_QSTR_state) {
             self->state = dest[1];
+            MP_GC_WRITE_BARRIER(dest[1]);
             dest[0] = MP_OBJ_NULL;
         }
     }
@@ -279,6 +285,7 @@ static mp_obj_t task_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf) {
     } else if (self->state == TASK_STATE_RUNNING_NOT_WAITED_ON) {
         // Allocate the waiting queue.
         self->state = task_queue_make_new(&task_queue_type, 0, 0, NULL);
+        MP_GC_WRITE_BARRIER(self->state);
     } else if (mp_obj_get_type(self->state) != &task_queue_type) {
         // Task has state used for another purpose, so can't also wait on it.
         mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("can't wait"));
@@ -298,6 +305,7 @@ static mp_obj_t task_iternext(mp_obj_t self_in) {
         task_queue_push(2, args);
         // Set calling task's data to this task that it waits on, to double-link it.
         ((mp_obj_task_t *)MP_OBJ_TO_PTR(cur_task))->data = self_in;
+        MP_GC_WRITE_BARRIER(self_in);
     }
     return mp_const_none;
 }
@@ -27,6 +27,7 @@
 
 #include "py/mpconfig.h"
 #include "py/runtime.h"
+#include "py/gc.h"
 #include "py/obj.h"
 #include "py/objlist.h"
 #include "py/stream.h"
@@ -183,6 +184,7 @@ static struct pollfd *poll_set_add_fd(poll_set_t *poll_set, int fd) {
             }
 
             poll_set->pollfds = new_fds;
+            MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(new_fds));
             poll_set->alloc = new_alloc;
         }
         free_slot = &poll_set->pollfds[poll_set->max_used++];
@@ -274,6 +276,7 @@ static void poll_set_add_obj(poll_set_t *poll_set, const mp_obj_t *obj, mp_uint_
             poll_obj_set_events(poll_obj, events);
             poll_obj_set_revents(poll_obj, 0);
             elem->value = MP_OBJ_FROM_PTR(poll_obj);
+            MP_GC_WRITE_BARRIER(elem->value);
         } else {
             // object exists; update its events
             poll_obj_t *poll_obj = (poll_obj_t *)MP_OBJ_TO_PTR(elem->value);
@@ -583,6 +586,7 @@ static mp_obj_t poll_ipoll(size_t n_args, const mp_obj_t *args) {
 
     if (self->ret_tuple == MP_OBJ_NULL) {
         self->ret_tuple = mp_obj_new_tuple(2, NULL);
+        MP_GC_WRITE_BARRIER(self->ret_tuple);
     }
 
     int n_ready = poll_poll_internal(n_args, args);
@@ -611,6 +615,7 @@ static mp_obj_t poll_iternext(mp_obj_t self_in) {
         if (poll_obj_get_revents(poll_obj) != 0) {
             mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->ret_tuple);
             t->items[0] = poll_obj->obj;
+            MP_GC_WRITE_BARRIER(poll_obj->obj);
             t->items[1] = MP_OBJ_NEW_SMALL_INT(poll_obj_get_revents(poll_obj));
             if (self->flags & FLAG_ONESHOT) {
                 // Don't poll next time, until new event mask will be set explicitly
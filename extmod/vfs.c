@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "py/gc.h"
 #include "py/runtime.h"
 #include "py/objstr.h"
 #include "py/mperrno.h"
@@ -279,6 +280,7 @@ mp_obj_t mp_vfs_mount(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args
         vfsp = &(*vfsp)->next;
     }
     *vfsp = vfs;
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(vfs));
 
     return mp_const_none;
 }
@@ -296,6 +298,7 @@ mp_obj_t mp_vfs_umount(mp_obj_t mnt_in) {
         if ((mnt_str != NULL && mnt_len == (*vfsp)->len && !memcmp(mnt_str, (*vfsp)->str, mnt_len)) || (*vfsp)->obj == mnt_in) {
             vfs = *vfsp;
             *vfsp = (*vfsp)->next;
+            MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(*vfsp));
             break;
         }
     }
@@ -61,7 +61,8 @@ typedef struct _mp_obj_vfs_lfs1_t {
     mp_vfs_blockdev_t blockdev;
     vstr_t cur_dir;
     struct lfs1_config config;
-    lfs1_t lfs;
+    lfs1_t *lfs;
+    lfs1_t lfs_storage;
 } mp_obj_vfs_lfs1_t;
 
 typedef struct _mp_obj_vfs_lfs1_file_t {
@@ -111,7 +112,8 @@ typedef struct _mp_obj_vfs_lfs2_t {
     bool enable_mtime;
     vstr_t cur_dir;
     struct lfs2_config config;
-    lfs2_t lfs;
+    lfs2_t *lfs; // lfs_storage, or a filesystem adopted from the port
+    lfs2_t lfs_storage;
 } mp_obj_vfs_lfs2_t;
 
 typedef struct _mp_obj_vfs_lfs2_file_t {
@@ -140,6 +142,18 @@ static void lfs_get_mtime(uint8_t buf[8]) {
 #include "extmod/vfs_lfsx.c"
 #include "extmod/vfs_lfsx_file.c"
 
+#if MICROPY_VFS_LFS2_ADOPT
+mp_obj_t mp_vfs_lfs2_adopt(lfs2_t *lfs) {
+    mp_obj_vfs_lfs2_t *self = m_new0(mp_obj_vfs_lfs2_t, 1);
+    self->base.type = &mp_type_vfs_lfs2;
+    vstr_init(&self->cur_dir, 16);
+    vstr_add_byte(&self->cur_dir, '/');
+    self->enable_mtime = true;
+    self->lfs = lfs;
+    return MP_OBJ_FROM_PTR(self);
+}
+#endif
+
 #endif // MICROPY_VFS_LFS2
 
 #endif // MICROPY_VFS && (MICROPY_VFS_LFS1 || MICROPY_VFS_LFS2)
@@ -36,4 +36,12 @@ extern const mp_obj_type_t mp_type_vfs_lfs2;
 extern const mp_obj_type_t mp_type_vfs_lfs2_fileio;
 extern const mp_obj_type_t mp_type_vfs_lfs2_textio;
 
+#if MICROPY_VFS_LFS2_ADOPT
+// Wrap an lfs2 filesystem that is mounted and owned by the port, so that it
+// can be mounted into the VFS and used from Python and C at the same time.
+// The owner must keep it mounted, and with LFS2_THREADSAFE serialise access.
+struct lfs2;
+mp_obj_t mp_vfs_lfs2_adopt(struct lfs2 *lfs);
+#endif
+
 #endif // MICROPY_INCLUDED_EXTMOD_VFS_LFS_H
@@ -68,6 +68,14 @@ static int MP_VFS_LFSx(dev_sync)(const struct LFSx_API (config) * c) {
     return MP_VFS_LFSx(dev_ioctl)(c, MP_BLOCKDEV_IOCTL_SYNC, 0, false);
 }
 
+#if LFS_BUILD_VERSION == 2 && defined(LFS2_THREADSAFE)
+// Filesystems created from Python are only used by the VM, so need no locking.
+static int MP_VFS_LFSx(dev_lock)(const struct LFSx_API (config) * c) {
+    (void)c;
+    return 0;
+}
+#endif
+
 static void MP_VFS_LFSx(init_config)(MP_OBJ_VFS_LFSx * self, mp_obj_t bdev, size_t read_size, size_t prog_size, size_t lookahead) {
     self->blockdev.flags = MP_BLOCKDEV_FLAG_FREE_OBJ;
     mp_vfs_blockdev_init(&self->blockdev, bdev);
@@ -81,6 +89,10 @@ static void MP_VFS_LFSx(init_config)(MP_OBJ_VFS_LFSx * self, mp_obj_t bdev, size
     config->prog = MP_VFS_LFSx(dev_prog);
     config->erase = MP_VFS_LFSx(dev_erase);
     config->sync = MP_VFS_LFSx(dev_sync);
+    #if LFS_BUILD_VERSION == 2 && defined(LFS2_THREADSAFE)
+    config->lock = MP_VFS_LFSx(dev_lock);
+    config->unlock = MP_VFS_LFSx(dev_lock);
+    #endif
 
     MP_VFS_LFSx(dev_ioctl)(config, MP_BLOCKDEV_IOCTL_INIT, 1, false); // initialise block device
     int bs = MP_VFS_LFSx(dev_ioctl)(config, MP_BLOCKDEV_IOCTL_BLOCK_SIZE, 0, true); // get block size
@@ -133,7 +145,8 @@ static mp_obj_t MP_VFS_LFSx(make_new)(const mp_obj_type_t * type, size_t n_args,
     #endif
     MP_VFS_LFSx(init_config)(self, args[LFS_MAKE_ARG_bdev].u_obj,
         args[LFS_MAKE_ARG_readsize].u_int, args[LFS_MAKE_ARG_progsize].u_int, args[LFS_MAKE_ARG_lookahead].u_int);
-    int ret = LFSx_API(mount)(&self->lfs, &self->config);
+    self->lfs = &self->lfs_storage;
+    int ret = LFSx_API(mount)(self->lfs, &self->config);
     if (ret < 0) {
         mp_raise_OSError(-ret);
     }
@@ -147,7 +160,7 @@ static mp_obj_t MP_VFS_LFSx(mkfs)(size_t n_args, const mp_obj_t *pos_args, mp_ma
     MP_OBJ_VFS_LFSx self;
     MP_VFS_LFSx(init_config)(&self, args[LFS_MAKE_ARG_bdev].u_obj,
         args[LFS_MAKE_ARG_readsize].u_int, args[LFS_MAKE_ARG_progsize].u_int, args[LFS_MAKE_ARG_lookahead].u_int);
-    int ret = LFSx_API(format)(&self.lfs, &self.config);
+    int ret = LFSx_API(format)(&self.lfs_storage, &self.config);
     if (ret < 0) {
         mp_raise_OSError(-ret);
     }
@@ -177,9 +190,9 @@ static mp_obj_t MP_VFS_LFSx(ilistdir_it_iternext)(mp_obj_t self_in) {
 
     struct LFSx_API (info) info;
     for (;;) {
-        int ret = LFSx_API(dir_read)(&self->vfs->lfs, &self->dir, &info);
+        int ret = LFSx_API(dir_read)(self->vfs->lfs, &self->dir, &info);
         if (ret == 0) {
-            LFSx_API(dir_close)(&self->vfs->lfs, &self->dir);
+            LFSx_API(dir_close)(self->vfs->lfs, &self->dir);
             self->vfs = NULL;
             return MP_OBJ_STOP_ITERATION;
         }
@@ -206,7 +219,7 @@ static mp_obj_t MP_VFS_LFSx(ilistdir_it_iternext)(mp_obj_t self_in) {
 static mp_obj_t MP_VFS_LFSx(ilistdir_it_del)(mp_obj_t self_in) {
     MP_VFS_LFSx(ilistdir_it_t) * self = MP_OBJ_TO_PTR(self_in);
     if (self->vfs != NULL) {
-        LFSx_API(dir_close)(&self->vfs->lfs, &self->dir);
+        LFSx_API(dir_close)(self->vfs->lfs, &self->dir);
     }
     return mp_const_none;
 }
@@ -229,7 +242,7 @@ static mp_obj_t MP_VFS_LFSx(ilistdir_func)(size_t n_args, const mp_obj_t *args)
     iter->iternext = MP_VFS_LFSx(ilistdir_it_iternext);
     iter->finaliser = MP_VFS_LFSx(ilistdir_it_del);
     iter->is_str = is_str_type;
-    int ret = LFSx_API(dir_open)(&self->lfs, &iter->dir, path);
+    int ret = LFSx_API(dir_open)(self->lfs, &iter->dir, path);
     if (ret < 0) {
         mp_raise_OSError(-ret);
     }
@@ -241,7 +254,7 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(MP_VFS_LFSx(ilistdir_obj), 1, 2, MP_V
 static mp_obj_t MP_VFS_LFSx(remove)(mp_obj_t self_in, mp_obj_t path_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
     const char *path = MP_VFS_LFSx(make_path)(self, path_in);
-    int ret = LFSx_API(remove)(&self->lfs, path);
+    int ret = LFSx_API(remove)(self->lfs, path);
     if (ret < 0) {
         mp_raise_OSError(-ret);
     }
@@ -252,7 +265,7 @@ static MP_DEFINE_CONST_FUN_OBJ_2(MP_VFS_LFSx(remove_obj), MP_VFS_LFSx(remove));
 static mp_obj_t MP_VFS_LFSx(rmdir)(mp_obj_t self_in, mp_obj_t path_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
     const char *path = MP_VFS_LFSx(make_path)(self, path_in);
-    int ret = LFSx_API(remove)(&self->lfs, path);
+    int ret = LFSx_API(remove)(self->lfs, path);
     if (ret < 0) {
         mp_raise_OSError(-ret);
     }
@@ -270,7 +283,7 @@ static mp_obj_t MP_VFS_LFSx(rename)(mp_obj_t self_in, mp_obj_t path_old_in, mp_o
         vstr_add_strn(&path_new, vstr_str(&self->cur_dir), vstr_len(&self->cur_dir));
     }
     vstr_add_str(&path_new, path);
-    int ret = LFSx_API(rename)(&self->lfs, path_old, vstr_null_terminated_str(&path_new));
+    int ret = LFSx_API(rename)(self->lfs, path_old, vstr_null_terminated_str(&path_new));
     vstr_clear(&path_new);
     if (ret < 0) {
         mp_raise_OSError(-ret);
@@ -282,7 +295,7 @@ static MP_DEFINE_CONST_FUN_OBJ_3(MP_VFS_LFSx(rename_obj), MP_VFS_LFSx(rename));
 static mp_obj_t MP_VFS_LFSx(mkdir)(mp_obj_t self_in, mp_obj_t path_o) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
     const char *path = MP_VFS_LFSx(make_path)(self, path_o);
-    int ret = LFSx_API(mkdir)(&self->lfs, path);
+    int ret = LFSx_API(mkdir)(self->lfs, path);
     if (ret < 0) {
         mp_raise_OSError(-ret);
     }
@@ -298,7 +311,7 @@ static mp_obj_t MP_VFS_LFSx(chdir)(mp_obj_t self_in, mp_obj_t path_in) {
     if (path[1] != '\0') {
         // Not at root, check it exists
         struct LFSx_API (info) info;
-        int ret = LFSx_API(stat)(&self->lfs, path, &info);
+        int ret = LFSx_API(stat)(self->lfs, path, &info);
         if (ret < 0 || info.type != LFSx_MACRO(_TYPE_DIR)) {
             mp_raise_OSError(MP_ENOENT);
         }
@@ -373,7 +386,7 @@ static mp_obj_t MP_VFS_LFSx(stat)(mp_obj_t self_in, mp_obj_t path_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
     const char *path = MP_VFS_LFSx(make_path)(self, path_in);
     struct LFSx_API (info) info;
-    int ret = LFSx_API(stat)(&self->lfs, path, &info);
+    int ret = LFSx_API(stat)(self->lfs, path, &info);
     if (ret < 0) {
         mp_raise_OSError(-ret);
     }
@@ -381,7 +394,7 @@ static mp_obj_t MP_VFS_LFSx(stat)(mp_obj_t self_in, mp_obj_t path_in) {
     mp_uint_t mtime = 0;
     #if LFS_BUILD_VERSION == 2
     uint8_t mtime_buf[8];
-    lfs2_ssize_t sz = lfs2_getattr(&self->lfs, path, LFS_ATTR_MTIME, &mtime_buf, sizeof(mtime_buf));
+    lfs2_ssize_t sz = lfs2_getattr(self->lfs, path, LFS_ATTR_MTIME, &mtime_buf, sizeof(mtime_buf));
     if (sz == sizeof(mtime_buf)) {
         uint64_t ns = 0;
         for (size_t i = sizeof(mtime_buf); i > 0; --i) {
@@ -420,19 +433,19 @@ static mp_obj_t MP_VFS_LFSx(statvfs)(mp_obj_t self_in, mp_obj_t path_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
     uint32_t n_used_blocks = 0;
     #if LFS_BUILD_VERSION == 1
-    int ret = LFSx_API(traverse)(&self->lfs, LFSx_API(traverse_cb), &n_used_blocks);
+    int ret = LFSx_API(traverse)(self->lfs, LFSx_API(traverse_cb), &n_used_blocks);
     #else
-    int ret = LFSx_API(fs_traverse)(&self->lfs, LFSx_API(traverse_cb), &n_used_blocks);
+    int ret = LFSx_API(fs_traverse)(self->lfs, LFSx_API(traverse_cb), &n_used_blocks);
     #endif
     if (ret < 0) {
         mp_raise_OSError(-ret);
     }
 
     mp_obj_tuple_t *t = MP_OBJ_TO_PTR(mp_obj_new_tuple(10, NULL));
-    t->items[0] = MP_OBJ_NEW_SMALL_INT(self->lfs.cfg->block_size); // f_bsize
+    t->items[0] = MP_OBJ_NEW_SMALL_INT(self->lfs->cfg->block_size); // f_bsize
     t->items[1] = t->items[0]; // f_frsize
-    t->items[2] = MP_OBJ_NEW_SMALL_INT(self->lfs.cfg->block_count); // f_blocks
-    t->items[3] = MP_OBJ_NEW_SMALL_INT(self->lfs.cfg->block_count - n_used_blocks); // f_bfree
+    t->items[2] = MP_OBJ_NEW_SMALL_INT(self->lfs->cfg->block_count); // f_blocks
+    t->items[3] = MP_OBJ_NEW_SMALL_INT(self->lfs->cfg->block_count - n_used_blocks); // f_bfree
     t->items[4] = t->items[3]; // f_bavail
     t->items[5] = MP_OBJ_NEW_SMALL_INT(0); // f_files
     t->items[6] = MP_OBJ_NEW_SMALL_INT(0); // f_ffree
@@ -461,8 +474,11 @@ static MP_DEFINE_CONST_FUN_OBJ_3(MP_VFS_LFSx(mount_obj), MP_VFS_LFSx(mount));
 
 static mp_obj_t MP_VFS_LFSx(umount)(mp_obj_t self_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
-    // LFS unmount never fails
-    LFSx_API(unmount)(&self->lfs);
+    // A filesystem adopted from the port stays mounted for its owner.
+    if (self->lfs == &self->lfs_storage) {
+        // LFS unmount never fails
+        LFSx_API(unmount)(self->lfs);
+    }
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(MP_VFS_LFSx(umount_obj), MP_VFS_LFSx(umount));
@@ -489,7 +505,7 @@ static mp_import_stat_t MP_VFS_LFSx(import_stat)(void *self_in, const char *path
     struct LFSx_API (info) info;
     mp_obj_str_t path_obj = { { &mp_type_str }, 0, 0, (const byte *)path };
     path = MP_VFS_LFSx(make_path)(self, MP_OBJ_FROM_PTR(&path_obj));
-    int ret = LFSx_API(stat)(&self->lfs, path, &info);
+    int ret = LFSx_API(stat)(self->lfs, path, &info);
     if (ret == 0) {
         if (info.type == LFSx_MACRO(_TYPE_REG)) {
             return MP_IMPORT_STAT_FILE;
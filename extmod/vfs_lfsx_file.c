@@ -90,9 +90,9 @@ mp_obj_t MP_VFS_LFSx(file_open)(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mod
     }
 
     #if LFS_BUILD_VERSION == 1
-    MP_OBJ_VFS_LFSx_FILE *o = mp_obj_malloc_var_with_finaliser(MP_OBJ_VFS_LFSx_FILE, uint8_t, self->lfs.cfg->prog_size, type);
+    MP_OBJ_VFS_LFSx_FILE *o = mp_obj_malloc_var_with_finaliser(MP_OBJ_VFS_LFSx_FILE, uint8_t, self->lfs->cfg->prog_size, type);
     #else
-    MP_OBJ_VFS_LFSx_FILE *o = mp_obj_malloc_var_with_finaliser(MP_OBJ_VFS_LFSx_FILE, uint8_t, self->lfs.cfg->cache_size, type);
+    MP_OBJ_VFS_LFSx_FILE *o = mp_obj_malloc_var_with_finaliser(MP_OBJ_VFS_LFSx_FILE, uint8_t, self->lfs->cfg->cache_size, type);
     #endif
     o->vfs = self;
     #if !MICROPY_GC_CONSERVATIVE_CLEAR
@@ -113,7 +113,7 @@ mp_obj_t MP_VFS_LFSx(file_open)(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mod
     #endif
 
     const char *path = MP_VFS_LFSx(make_path)(self, path_in);
-    int ret = LFSx_API(file_opencfg)(&self->lfs, &o->file, path, flags, &o->cfg);
+    int ret = LFSx_API(file_opencfg)(self->lfs, &o->file, path, flags, &o->cfg);
     if (ret < 0) {
         o->vfs = NULL;
         mp_raise_OSError(-ret);
@@ -125,7 +125,7 @@ mp_obj_t MP_VFS_LFSx(file_open)(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mod
 static mp_uint_t MP_VFS_LFSx(file_read)(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
     MP_OBJ_VFS_LFSx_FILE *self = MP_OBJ_TO_PTR(self_in);
     MP_VFS_LFSx(check_open)(self);
-    LFSx_API(ssize_t) sz = LFSx_API(file_read)(&self->vfs->lfs, &self->file, buf, size);
+    LFSx_API(ssize_t) sz = LFSx_API(file_read)(self->vfs->lfs, &self->file, buf, size);
     if (sz < 0) {
         *errcode = -sz;
         return MP_STREAM_ERROR;
@@ -141,7 +141,7 @@ static mp_uint_t MP_VFS_LFSx(file_write)(mp_obj_t self_in, const void *buf, mp_u
         lfs_get_mtime(&self->mtime[0]);
     }
     #endif
-    LFSx_API(ssize_t) sz = LFSx_API(file_write)(&self->vfs->lfs, &self->file, buf, size);
+    LFSx_API(ssize_t) sz = LFSx_API(file_write)(self->vfs->lfs, &self->file, buf, size);
     if (sz < 0) {
         *errcode = -sz;
         return MP_STREAM_ERROR;
@@ -158,12 +158,12 @@ static mp_uint_t MP_VFS_LFSx(file_ioctl)(mp_obj_t self_in, mp_uint_t request, ui
 
     if (request == MP_STREAM_SEEK) {
         struct mp_stream_seek_t *s = (struct mp_stream_seek_t *)(uintptr_t)arg;
-        int res = LFSx_API(file_seek)(&self->vfs->lfs, &self->file, s->offset, s->whence);
+        int res = LFSx_API(file_seek)(self->vfs->lfs, &self->file, s->offset, s->whence);
         if (res < 0) {
             *errcode = -res;
             return MP_STREAM_ERROR;
         }
-        res = LFSx_API(file_tell)(&self->vfs->lfs, &self->file);
+        res = LFSx_API(file_tell)(self->vfs->lfs, &self->file);
         if (res < 0) {
             *errcode = -res;
             return MP_STREAM_ERROR;
@@ -171,7 +171,7 @@ static mp_uint_t MP_VFS_LFSx(file_ioctl)(mp_obj_t self_in, mp_uint_t request, ui
         s->offset = res;
         return 0;
     } else if (request == MP_STREAM_FLUSH) {
-        int res = LFSx_API(file_sync)(&self->vfs->lfs, &self->file);
+        int res = LFSx_API(file_sync)(self->vfs->lfs, &self->file);
         if (res < 0) {
             *errcode = -res;
             return MP_STREAM_ERROR;
@@ -181,7 +181,7 @@ static mp_uint_t MP_VFS_LFSx(file_ioctl)(mp_obj_t self_in, mp_uint_t request, ui
         if (self->vfs == NULL) {
             return 0;
         }
-        int res = LFSx_API(file_close)(&self->vfs->lfs, &self->file);
+        int res = LFSx_API(file_close)(self->vfs->lfs, &self->file);
         self->vfs = NULL; // indicate a closed file
         if (res < 0) {
             *errcode = -res;
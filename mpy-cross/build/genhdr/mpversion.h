@@ -0,0 +1,4 @@
+// This file was generated by py/makeversionhdr.py
+#define MICROPY_GIT_TAG "b816bfb-dirty"
+#define MICROPY_GIT_HASH "b816bfb"
+#define MICROPY_BUILD_DATE "2026-10-18"
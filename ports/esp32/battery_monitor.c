@@ -0,0 +1,196 @@
+#include "battery_monitor.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_task.h"
+#include "driver/i2c.h"
+#include "modmachine.h"
+
+// Battery voltage is measured by an ADS1115 on the shared sensor bus:
+// AIN0 is the battery through a 1:10 divider and AIN1 the charger sense line.
+// The ADC runs in continuous-conversion mode and a low-priority task samples
+// it on a fixed period, alternating between the two inputs.  Each tick reads
+// the result of the input selected on the previous tick (which has had
+// several conversion periods to settle) and then switches the multiplexer,
+// so there is no blocking wait for a conversion.  Readings go into a small
+// ring buffer per channel and are averaged when queried.
+
+#define BATTERY_I2C_PORT        I2C_NUM_0
+#define BATTERY_I2C_SCL         22
+#define BATTERY_I2C_SDA         21
+#define BATTERY_I2C_FREQ        400000
+#define BATTERY_I2C_TIMEOUT_MS  20
+
+#define ADS1X15_ADDR            0x48
+#define ADS1X15_REG_CONVERT     0x00
+#define ADS1X15_REG_CONFIG      0x01
+#define ADS1X15_MUX_SINGLE(ch)  (0x4000 | ((ch) << 12))
+#define ADS1X15_PGA_4_096V      0x0200
+#define ADS1X15_MODE_CONTIN     0x0000
+#define ADS1X15_DR_128SPS       0x0080  // 1600 SPS on the ADS1015
+#define ADS1X15_CQUE_NONE       0x0003
+
+#define BATTERY_FULL_SCALE_V    4.096f
+#define BATTERY_DIVIDER         10.0f
+
+#define BATTERY_NUM_CHANNELS    2
+#define BATTERY_RING_LEN        32
+#define BATTERY_SAMPLE_MS       25
+#define BATTERY_TASK_STACK      2048
+#define BATTERY_TASK_PRIORITY   (ESP_TASK_PRIO_MIN + 1)
+
+typedef struct {
+    int16_t ring[BATTERY_NUM_CHANNELS][BATTERY_RING_LEN];
+    uint8_t head[BATTERY_NUM_CHANNELS];
+    uint8_t count[BATTERY_NUM_CHANNELS];
+    uint32_t errors;
+} battery_samples_t;
+
+static const char *TAG = "battery_monitor";
+
+static battery_samples_t s_samples;
+static portMUX_TYPE s_samples_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task = NULL;
+
+// Command links are built once and reused for every sample.  For each input
+// there is a "select" link that only writes the config register, and a
+// "sample" link that reads the conversion result of that input and then
+// selects the next one, so a steady-state tick is a single bus transaction.
+static uint8_t s_config[BATTERY_NUM_CHANNELS][3];
+static uint8_t s_convert_reg = ADS1X15_REG_CONVERT;
+static uint8_t s_result[2];
+static i2c_cmd_handle_t s_select_cmd[BATTERY_NUM_CHANNELS];
+static i2c_cmd_handle_t s_sample_cmd[BATTERY_NUM_CHANNELS];
+
+static void ads1x15_add_select(i2c_cmd_handle_t cmd, uint8_t channel) {
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, ADS1X15_ADDR << 1 | I2C_MASTER_WRITE, true);
+    i2c_master_write(cmd, s_config[channel], sizeof(s_config[channel]), true);
+    i2c_master_stop(cmd);
+}
+
+static bool ads1x15_build_commands(void) {
+    for (uint8_t ch = 0; ch < BATTERY_NUM_CHANNELS; ch++) {
+        uint16_t config = ADS1X15_MUX_SINGLE(ch) | ADS1X15_PGA_4_096V | ADS1X15_MODE_CONTIN
+            | ADS1X15_DR_128SPS | ADS1X15_CQUE_NONE;
+        s_config[ch][0] = ADS1X15_REG_CONFIG;
+        s_config[ch][1] = config >> 8;
+        s_config[ch][2] = config & 0xff;
+    }
+    for (uint8_t ch = 0; ch < BATTERY_NUM_CHANNELS; ch++) {
+        s_select_cmd[ch] = i2c_cmd_link_create();
+        s_sample_cmd[ch] = i2c_cmd_link_create();
+        if (s_select_cmd[ch] == NULL || s_sample_cmd[ch] == NULL) {
+            return false;
+        }
+        ads1x15_add_select(s_select_cmd[ch], ch);
+
+        i2c_cmd_handle_t cmd = s_sample_cmd[ch];
+        i2c_master_start(cmd);
+        i2c_master_write_byte(cmd, ADS1X15_ADDR << 1 | I2C_MASTER_WRITE, true);
+        i2c_master_write_byte(cmd, s_convert_reg, true);
+        i2c_master_start(cmd);
+        i2c_master_write_byte(cmd, ADS1X15_ADDR << 1 | I2C_MASTER_READ, true);
+        i2c_master_read(cmd, s_result, sizeof(s_result), I2C_MASTER_LAST_NACK);
+        i2c_master_stop(cmd);
+        ads1x15_add_select(cmd, (ch + 1) % BATTERY_NUM_CHANNELS);
+    }
+    return true;
+}
+
+static void battery_monitor_task(void *pvParameter) {
+    uint8_t channel = 0;
+    bool configured = false;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    for (;;) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(BATTERY_SAMPLE_MS));
+
+        esp_err_t err;
+        if (configured) {
+            err = machine_hw_i2c_cmd_begin(BATTERY_I2C_PORT, s_sample_cmd[channel], BATTERY_I2C_TIMEOUT_MS);
+            if (err == ESP_OK) {
+                int16_t value = (int16_t)((s_result[0] << 8) | s_result[1]);
+                portENTER_CRITICAL(&s_samples_lock);
+                s_samples.ring[channel][s_samples.head[channel]] = value;
+                s_samples.head[channel] = (s_samples.head[channel] + 1) % BATTERY_RING_LEN;
+                if (s_samples.count[channel] < BATTERY_RING_LEN) {
+                    s_samples.count[channel]++;
+                }
+                portEXIT_CRITICAL(&s_samples_lock);
+                channel = (channel + 1) % BATTERY_NUM_CHANNELS;
+            }
+        } else {
+            err = machine_hw_i2c_cmd_begin(BATTERY_I2C_PORT, s_select_cmd[channel], BATTERY_I2C_TIMEOUT_MS);
+        }
+
+        // On any error select the input again before trusting a reading.
+        configured = (err == ESP_OK);
+        if (err != ESP_OK) {
+            portENTER_CRITICAL(&s_samples_lock);
+            s_samples.errors++;
+            portEXIT_CRITICAL(&s_samples_lock);
+        }
+    }
+}
+
+esp_err_t battery_monitor_init(void) {
+    if (s_task != NULL) {
+        return ESP_OK;
+    }
+
+    machine_hw_i2c_setup(BATTERY_I2C_PORT, BATTERY_I2C_SCL, BATTERY_I2C_SDA, BATTERY_I2C_FREQ);
+    if (!ads1x15_build_commands()) {
+        ESP_LOGE(TAG, "Failed to build ADS1x15 command links");
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (xTaskCreatePinnedToCore(battery_monitor_task, "battery_mon",
+        BATTERY_TASK_STACK, NULL, BATTERY_TASK_PRIORITY, &s_task, 1) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create battery monitor task");
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Battery monitor started, period %d ms", BATTERY_SAMPLE_MS);
+    return ESP_OK;
+}
+
+bool battery_monitor_get(battery_status_t *status) {
+    int32_t sum[BATTERY_NUM_CHANNELS] = {0};
+    uint8_t count[BATTERY_NUM_CHANNELS];
+
+    portENTER_CRITICAL(&s_samples_lock);
+    for (int ch = 0; ch < BATTERY_NUM_CHANNELS; ch++) {
+        count[ch] = s_samples.count[ch];
+        for (int i = 0; i < count[ch]; i++) {
+            sum[ch] += s_samples.ring[ch][i];
+        }
+    }
+    status->errors = s_samples.errors;
+    portEXIT_CRITICAL(&s_samples_lock);
+
+    if (count[0] == 0 || count[1] == 0) {
+        return false;
+    }
+
+    const float scale = BATTERY_FULL_SCALE_V / 32768.0f * BATTERY_DIVIDER;
+    status->voltage = (float)sum[0] / count[0] * scale;
+    status->charging = (float)sum[1] / count[1] * scale;
+    status->samples = count[0] < count[1] ? count[0] : count[1];
+    return true;
+}
+
+int battery_monitor_format_json(char *buf, size_t buf_size) {
+    battery_status_t status;
+    if (!battery_monitor_get(&status)) {
+        return snprintf(buf, buf_size,
+                        "{\"status\":\"error\",\"message\":\"No battery samples yet\",\"errors\":%lu}",
+                        (unsigned long)status.errors);
+    }
+    return snprintf(buf, buf_size,
+                    "{\"voltage\":%.3f,\"charging\":%.3f,\"samples\":%lu,\"errors\":%lu}",
+                    status.voltage, status.charging,
+                    (unsigned long)status.samples, (unsigned long)status.errors);
+}
@@ -0,0 +1,25 @@
+#ifndef BATTERY_MONITOR_H
+#define BATTERY_MONITOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct {
+    float voltage;      // averaged battery voltage, V
+    float charging;     // averaged charger sense voltage, V
+    uint32_t samples;   // samples in the average of each channel
+    uint32_t errors;    // failed bus transactions since start
+} battery_status_t;
+
+// Start sampling the ADS1x15 in continuous mode from a background task
+esp_err_t battery_monitor_init(void);
+
+// Get the averaged readings; false if nothing has been sampled yet
+bool battery_monitor_get(battery_status_t *status);
+
+// Format the averaged readings as a JSON object, returns the length
+int battery_monitor_format_json(char *buf, size_t buf_size);
+
+#endif // BATTERY_MONITOR_H
@@ -0,0 +1,69 @@
+#include "boot_profile.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+// Timestamps of the startup milestones, for the hello message.  The settings
+// filesystem, the Wi-Fi driver and the interpreter come up in parallel, so
+// each milestone is stamped by whichever task reaches it.  Ready means a
+// command sent over MQTT would start running straight away.
+
+static const char *TAG = "boot_profile";
+
+static const char *const phase_name[BOOT_PHASE_COUNT] = {
+    [BOOT_PHASE_SETTINGS] = "fs",
+    [BOOT_PHASE_WIFI_START] = "wifi",
+    [BOOT_PHASE_MP_INIT] = "vm",
+    [BOOT_PHASE_MP_READY] = "py",
+    [BOOT_PHASE_GOT_IP] = "ip",
+    [BOOT_PHASE_MQTT] = "mqtt",
+    [BOOT_PHASE_READY] = "ready",
+};
+
+static uint32_t s_phase_ms[BOOT_PHASE_COUNT];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void boot_profile_mark(boot_phase_t phase) {
+    // Never 0, which means not reached.
+    uint32_t now_ms = esp_timer_get_time() / 1000 + 1;
+    bool marked = false;
+    bool ready = false;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_phase_ms[phase] == 0) {
+        s_phase_ms[phase] = now_ms;
+        marked = true;
+        if (s_phase_ms[BOOT_PHASE_READY] == 0
+            && s_phase_ms[BOOT_PHASE_MP_READY] != 0 && s_phase_ms[BOOT_PHASE_MQTT] != 0) {
+            s_phase_ms[BOOT_PHASE_READY] = now_ms;
+            ready = true;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (marked) {
+        ESP_LOGI(TAG, "%s at %lu ms", phase_name[phase], (unsigned long)now_ms);
+    }
+    if (ready) {
+        ESP_LOGI(TAG, "Ready for commands at %lu ms", (unsigned long)now_ms);
+    }
+}
+
+uint32_t boot_profile_get_ms(boot_phase_t phase) {
+    return s_phase_ms[phase];
+}
+
+int boot_profile_format_json(char *buf, size_t buf_size) {
+    size_t len = 0;
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        int r = snprintf(buf + len, len < buf_size ? buf_size - len : 0, "%s\"%s\":%lu",
+            i == 0 ? "{" : ",", phase_name[i], (unsigned long)s_phase_ms[i]);
+        len += r > 0 ? r : 0;
+    }
+    int r = snprintf(buf + len, len < buf_size ? buf_size - len : 0, "}");
+    len += r > 0 ? r : 0;
+    return len;
+}
@@ -0,0 +1,28 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Startup milestones, in no particular order since most run concurrently
+typedef enum {
+    BOOT_PHASE_SETTINGS,    // filesystem mounted and settings loaded
+    BOOT_PHASE_WIFI_START,  // Wi-Fi driver initialised and associating
+    BOOT_PHASE_MP_INIT,     // interpreter up and _boot.py run (VFS mounted)
+    BOOT_PHASE_MP_READY,    // boot.py done, waiting for jobs
+    BOOT_PHASE_GOT_IP,
+    BOOT_PHASE_MQTT,        // first MQTT connection
+    BOOT_PHASE_READY,       // MQTT connected and interpreter waiting for jobs
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+// Record the time of a milestone; only the first call for each counts
+void boot_profile_mark(boot_phase_t phase);
+
+// Milliseconds from boot to the milestone, 0 if not reached yet
+uint32_t boot_profile_get_ms(boot_phase_t phase);
+
+// Format all milestones as a JSON object, returns the length
+int boot_profile_format_json(char *buf, size_t buf_size);
+
+#endif // BOOT_PROFILE_H
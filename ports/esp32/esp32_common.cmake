@@ -129,9 +129,13 @@ list(APPEND MICROPY_SOURCE_PORT
     modsocket.c
     lwip_patch.c
     modesp.c
+    esp32_hbridge.c
+    esp32_i2c_sequence.c
     esp32_nvs.c
     esp32_partition.c
+    esp32_recorder.c
     esp32_rmt.c
+    esp32_tcs3472.c
     esp32_ulp.c
     modesp32.c
     machine_hw_spi.c
@@ -142,6 +146,12 @@ list(APPEND MICROPY_SOURCE_PORT
     mqtt_handler.c
     uart_handler.c
     settings_manager.c
+    battery_monitor.c
+    system_stats.c
+    wifi_cache.c
+    boot_profile.c
+    shared_fs.c
+    file_transfer.c
     cJSON.c
     cJSON_Utils.c
     micropython_task.c
@@ -261,7 +271,7 @@ target_compile_definitions(${MICROPY_TARGET} PUBLIC
     MICROPY_VFS_LFS2=1
     FFCONF_H=\"${MICROPY_OOFATFS_DIR}/ffconf.h\"
     LFS1_NO_MALLOC LFS1_NO_DEBUG LFS1_NO_WARN LFS1_NO_ERROR LFS1_NO_ASSERT
-    LFS2_NO_MALLOC LFS2_NO_DEBUG LFS2_NO_WARN LFS2_NO_ERROR LFS2_NO_ASSERT
+    LFS2_NO_MALLOC LFS2_NO_DEBUG LFS2_NO_WARN LFS2_NO_ERROR LFS2_NO_ASSERT LFS2_THREADSAFE
 )
 
 # Disable some warnings to keep the build output clean.
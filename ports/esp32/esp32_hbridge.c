@@ -0,0 +1,480 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 autolab-fi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "modmachine.h"
+#include "modesp32.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+// esp32.HBridge drives N DC motors, each through a pair of PWM inputs (IN1/IN2)
+// of an H-bridge driver such as the DRV8833 or L298.  A single call sets the
+// signed duty of every motor and all LEDC channels are latched back-to-back,
+// so both sides of a differential drive change at the same instant and a
+// control step costs one call into C instead of one per PWM pin.
+//
+// Positive duty drives IN1, negative duty drives IN2 (fast decay).  A duty of
+// zero puts the motor into the idle mode: COAST (both inputs low) or BRAKE
+// (both inputs high).
+//
+// An optional watchdog guards against a stalled control loop: every call to
+// duty() or kick() restarts a one-shot esp_timer, and if it expires the
+// callback ramps every channel to zero from the esp_timer task, without
+// waiting for the VM.  stop() disarms it, since idle motors need no guard.
+
+#define HBRIDGE_MODE_COAST (0)
+#define HBRIDGE_MODE_BRAKE (1)
+
+// Same 10-bit scale as PWM.duty().
+#define HBRIDGE_DUTY_MAX (1023)
+#define HBRIDGE_MAX_MOTORS (8)
+#define HBRIDGE_WDT_MAX (2)
+
+static const char *TAG = "hbridge";
+
+// Watchdog state lives outside the GC heap so the timer callback never has
+// to touch a Python object.
+typedef struct _hbridge_wdt_t {
+    esp_timer_handle_t timer;
+    portMUX_TYPE lock;
+    bool armed;
+    bool tripped;
+    uint8_t num_channels;
+    uint16_t ramp_ms;
+    uint32_t timeout_us;
+    uint32_t kicks;
+    uint32_t misses;
+    uint32_t worst_us; // longest interval between two kicks
+    int64_t last_kick_us;
+    machine_pwm_channel_t ch[2 * HBRIDGE_MAX_MOTORS];
+} hbridge_wdt_t;
+
+static hbridge_wdt_t hbridge_wdt[HBRIDGE_WDT_MAX];
+
+// Keeps an HBridge alive while it owns a watchdog slot.
+MP_REGISTER_ROOT_POINTER(mp_obj_t esp32_hbridge_wdt_owner[HBRIDGE_WDT_MAX]);
+
+typedef struct _esp32_hbridge_obj_t {
+    mp_obj_base_t base;
+    uint8_t num_motors;
+    uint8_t mode;
+    uint16_t fade_ms;
+    int8_t wdt; // index into hbridge_wdt, or -1
+    int16_t duty[HBRIDGE_MAX_MOTORS];
+    mp_obj_t pwm[]; // 2 * num_motors PWM objects, IN1/IN2 of each motor
+} esp32_hbridge_obj_t;
+
+static void hbridge_wdt_expired(void *arg) {
+    hbridge_wdt_t *wdt = arg;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&wdt->lock);
+    // A kick may have raced with the timer firing; only trip if the deadline
+    // really passed.
+    bool trip = wdt->armed && now - wdt->last_kick_us >= wdt->timeout_us;
+    if (trip) {
+        wdt->armed = false;
+        wdt->tripped = true;
+        ++wdt->misses;
+    }
+    portEXIT_CRITICAL(&wdt->lock);
+    if (trip) {
+        machine_pwm_ramp_to_zero(wdt->num_channels, wdt->ch, wdt->ramp_ms);
+        ESP_LOGW(TAG, "watchdog: no kick for %u us, motors stopped", (unsigned)(now - wdt->last_kick_us));
+    }
+}
+
+static void hbridge_wdt_kick(hbridge_wdt_t *wdt) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&wdt->lock);
+    if (wdt->last_kick_us != 0 && now - wdt->last_kick_us > wdt->worst_us) {
+        wdt->worst_us = now - wdt->last_kick_us;
+    }
+    wdt->last_kick_us = now;
+    ++wdt->kicks;
+    wdt->armed = true;
+    wdt->tripped = false;
+    portEXIT_CRITICAL(&wdt->lock);
+    if (esp_timer_restart(wdt->timer, wdt->timeout_us) != ESP_OK) {
+        // Not running, either never started or already expired.
+        check_esp_err(esp_timer_start_once(wdt->timer, wdt->timeout_us));
+    }
+}
+
+static void hbridge_wdt_disarm(hbridge_wdt_t *wdt) {
+    esp_timer_stop(wdt->timer);
+    portENTER_CRITICAL(&wdt->lock);
+    wdt->armed = false;
+    // The next kick starts a new measurement of the loop interval.
+    wdt->last_kick_us = 0;
+    portEXIT_CRITICAL(&wdt->lock);
+}
+
+static void hbridge_wdt_release(esp32_hbridge_obj_t *self) {
+    if (self->wdt >= 0) {
+        hbridge_wdt_disarm(&hbridge_wdt[self->wdt]);
+        MP_STATE_PORT(esp32_hbridge_wdt_owner)[self->wdt] = MP_OBJ_NULL;
+        self->wdt = -1;
+    }
+}
+
+// If the watchdog stopped the motors, make the stored duties agree.
+static void hbridge_wdt_sync(esp32_hbridge_obj_t *self) {
+    if (self->wdt >= 0 && hbridge_wdt[self->wdt].tripped) {
+        for (size_t i = 0; i < self->num_motors; ++i) {
+            self->duty[i] = 0;
+        }
+    }
+}
+
+// Called on soft reset, before the PWM channels are released.
+void esp32_hbridge_deinit_all(void) {
+    for (size_t i = 0; i < HBRIDGE_WDT_MAX; ++i) {
+        if (hbridge_wdt[i].timer != NULL) {
+            esp_timer_stop(hbridge_wdt[i].timer);
+            esp_timer_delete(hbridge_wdt[i].timer);
+            hbridge_wdt[i].timer = NULL;
+        }
+        MP_STATE_PORT(esp32_hbridge_wdt_owner)[i] = MP_OBJ_NULL;
+    }
+}
+
+static uint32_t hbridge_duty_10_to_16(mp_int_t duty) {
+    return duty >= HBRIDGE_DUTY_MAX ? 65535 : (uint32_t)duty << 6;
+}
+
+// Convert the signed duties into IN1/IN2 duty_u16 pairs and commit them.
+static void hbridge_apply(esp32_hbridge_obj_t *self, uint32_t fade_ms) {
+    uint32_t duty_u16[2 * HBRIDGE_MAX_MOTORS];
+    for (size_t i = 0; i < self->num_motors; ++i) {
+        mp_int_t duty = self->duty[i];
+        uint32_t in1, in2;
+        if (duty > 0) {
+            in1 = hbridge_duty_10_to_16(duty);
+            in2 = 0;
+        } else if (duty < 0) {
+            in1 = 0;
+            in2 = hbridge_duty_10_to_16(-duty);
+        } else if (self->mode == HBRIDGE_MODE_BRAKE) {
+            in1 = in2 = 65535;
+        } else {
+            in1 = in2 = 0;
+        }
+        duty_u16[2 * i] = in1;
+        duty_u16[2 * i + 1] = in2;
+    }
+    machine_pwm_set_duty_u16_many(2 * self->num_motors, self->pwm, duty_u16, fade_ms);
+}
+
+static mp_obj_t esp32_hbridge_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_pwms, ARG_mode, ARG_fade_ms };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_pwms,    MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_mode,    MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = HBRIDGE_MODE_COAST} },
+        { MP_QSTR_fade_ms, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    size_t n_pwms;
+    mp_obj_t *pwms;
+    mp_obj_get_array(args[ARG_pwms].u_obj, &n_pwms, &pwms);
+    if (n_pwms == 0 || (n_pwms & 1) || n_pwms > 2 * HBRIDGE_MAX_MOTORS) {
+        mp_raise_ValueError(MP_ERROR_TEXT("need 1-8 pairs of PWM"));
+    }
+    mp_int_t mode = args[ARG_mode].u_int;
+    if (mode != HBRIDGE_MODE_COAST && mode != HBRIDGE_MODE_BRAKE) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid mode"));
+    }
+    mp_int_t fade_ms = args[ARG_fade_ms].u_int;
+    if (fade_ms < 0 || fade_ms > 0xffff) {
+        mp_raise_ValueError(MP_ERROR_TEXT("fade_ms must be 0-65535"));
+    }
+
+    esp32_hbridge_obj_t *self = mp_obj_malloc_var(esp32_hbridge_obj_t, pwm, mp_obj_t, n_pwms, type);
+    self->num_motors = n_pwms / 2;
+    self->mode = mode;
+    self->fade_ms = fade_ms;
+    self->wdt = -1;
+    for (size_t i = 0; i < n_pwms; ++i) {
+        self->pwm[i] = pwms[i];
+    }
+    for (size_t i = 0; i < HBRIDGE_MAX_MOTORS; ++i) {
+        self->duty[i] = 0;
+    }
+
+    // Start from a known idle state.  This also validates the PWM objects.
+    hbridge_apply(self, 0);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static void esp32_hbridge_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    esp32_hbridge_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    hbridge_wdt_sync(self);
+    mp_printf(print, "HBridge(motors=%u, mode=%s, fade_ms=%u, duty=(",
+        self->num_motors, self->mode == HBRIDGE_MODE_BRAKE ? "BRAKE" : "COAST", self->fade_ms);
+    for (size_t i = 0; i < self->num_motors; ++i) {
+        mp_printf(print, i == 0 ? "%d" : ", %d", self->duty[i]);
+    }
+    mp_printf(print, self->num_motors == 1 ? ",))" : "))");
+}
+
+// HBridge.duty([d0, d1, ...])
+static mp_obj_t esp32_hbridge_duty(size_t n_args, const mp_obj_t *args) {
+    esp32_hbridge_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (n_args == 1) {
+        hbridge_wdt_sync(self);
+        mp_obj_t items[HBRIDGE_MAX_MOTORS];
+        for (size_t i = 0; i < self->num_motors; ++i) {
+            items[i] = MP_OBJ_NEW_SMALL_INT(self->duty[i]);
+        }
+        return mp_obj_new_tuple(self->num_motors, items);
+    }
+    if (n_args - 1 != self->num_motors) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("expecting %d duties"), self->num_motors);
+    }
+    // Parse all values before touching any output.
+    int16_t duty[HBRIDGE_MAX_MOTORS];
+    for (size_t i = 0; i < self->num_motors; ++i) {
+        mp_int_t d = mp_obj_get_int(args[i + 1]);
+        if (d > HBRIDGE_DUTY_MAX) {
+            d = HBRIDGE_DUTY_MAX;
+        } else if (d < -HBRIDGE_DUTY_MAX) {
+            d = -HBRIDGE_DUTY_MAX;
+        }
+        duty[i] = d;
+    }
+    for (size_t i = 0; i < self->num_motors; ++i) {
+        self->duty[i] = duty[i];
+    }
+    if (self->wdt >= 0) {
+        hbridge_wdt_kick(&hbridge_wdt[self->wdt]);
+    }
+    hbridge_apply(self, self->fade_ms);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_hbridge_duty_obj, 1, 1 + HBRIDGE_MAX_MOTORS, esp32_hbridge_duty);
+
+// HBridge.stop([mode]): put every motor into the idle mode, without fading.
+static mp_obj_t esp32_hbridge_stop(size_t n_args, const mp_obj_t *args) {
+    esp32_hbridge_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (n_args > 1) {
+        mp_int_t mode = mp_obj_get_int(args[1]);
+        if (mode != HBRIDGE_MODE_COAST && mode != HBRIDGE_MODE_BRAKE) {
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid mode"));
+        }
+        self->mode = mode;
+    }
+    for (size_t i = 0; i < self->num_motors; ++i) {
+        self->duty[i] = 0;
+    }
+    if (self->wdt >= 0) {
+        hbridge_wdt_disarm(&hbridge_wdt[self->wdt]);
+    }
+    hbridge_apply(self, 0);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_hbridge_stop_obj, 1, 2, esp32_hbridge_stop);
+
+static mp_obj_t esp32_hbridge_brake(mp_obj_t self_in) {
+    mp_obj_t args[2] = { self_in, MP_OBJ_NEW_SMALL_INT(HBRIDGE_MODE_BRAKE) };
+    return esp32_hbridge_stop(2, args);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_hbridge_brake_obj, esp32_hbridge_brake);
+
+static mp_obj_t esp32_hbridge_coast(mp_obj_t self_in) {
+    mp_obj_t args[2] = { self_in, MP_OBJ_NEW_SMALL_INT(HBRIDGE_MODE_COAST) };
+    return esp32_hbridge_stop(2, args);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_hbridge_coast_obj, esp32_hbridge_coast);
+
+// HBridge.fade_ms([value])
+static mp_obj_t esp32_hbridge_fade_ms(size_t n_args, const mp_obj_t *args) {
+    esp32_hbridge_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (n_args == 1) {
+        return MP_OBJ_NEW_SMALL_INT(self->fade_ms);
+    }
+    mp_int_t fade_ms = mp_obj_get_int(args[1]);
+    if (fade_ms < 0 || fade_ms > 0xffff) {
+        mp_raise_ValueError(MP_ERROR_TEXT("fade_ms must be 0-65535"));
+    }
+    self->fade_ms = fade_ms;
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_hbridge_fade_ms_obj, 1, 2, esp32_hbridge_fade_ms);
+
+// HBridge.watchdog([timeout_ms], *, ramp_ms=0)
+static mp_obj_t esp32_hbridge_watchdog(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_timeout_ms, ARG_ramp_ms };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_timeout_ms, MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_ramp_ms,    MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+    };
+    esp32_hbridge_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    if (args[ARG_timeout_ms].u_obj == MP_OBJ_NULL) {
+        if (self->wdt < 0) {
+            return MP_OBJ_NEW_SMALL_INT(0);
+        }
+        return MP_OBJ_NEW_SMALL_INT(hbridge_wdt[self->wdt].timeout_us / 1000);
+    }
+
+    mp_int_t timeout_ms = mp_obj_get_int(args[ARG_timeout_ms].u_obj);
+    mp_int_t ramp_ms = args[ARG_ramp_ms].u_int;
+    if (timeout_ms < 0 || timeout_ms > 60000) {
+        mp_raise_ValueError(MP_ERROR_TEXT("timeout_ms must be 0-60000"));
+    }
+    if (ramp_ms < 0 || ramp_ms > 0xffff) {
+        mp_raise_ValueError(MP_ERROR_TEXT("ramp_ms must be 0-65535"));
+    }
+    if (timeout_ms == 0) {
+        hbridge_wdt_release(self);
+        return mp_const_none;
+    }
+
+    // Look up the channels first, this raises if a PWM is inactive.
+    machine_pwm_channel_t ch[2 * HBRIDGE_MAX_MOTORS];
+    for (size_t i = 0; i < 2 * self->num_motors; ++i) {
+        machine_pwm_get_channel(self->pwm[i], &ch[i]);
+    }
+    if (ramp_ms > 0) {
+        machine_pwm_fade_init();
+    }
+
+    if (self->wdt < 0) {
+        mp_obj_t *owner = MP_STATE_PORT(esp32_hbridge_wdt_owner);
+        size_t i = 0;
+        while (i < HBRIDGE_WDT_MAX && owner[i] != MP_OBJ_NULL) {
+            ++i;
+        }
+        if (i == HBRIDGE_WDT_MAX) {
+            mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("no free watchdog"));
+        }
+        hbridge_wdt_t *wdt = &hbridge_wdt[i];
+        if (wdt->timer == NULL) {
+            esp_timer_create_args_t timer_args = {
+                .callback = hbridge_wdt_expired,
+                .arg = wdt,
+                .dispatch_method = ESP_TIMER_TASK,
+                .name = "hbridge_wdt",
+                .skip_unhandled_events = true,
+            };
+            check_esp_err(esp_timer_create(&timer_args, &wdt->timer));
+        }
+        portMUX_INITIALIZE(&wdt->lock);
+        wdt->armed = false;
+        wdt->tripped = false;
+        wdt->kicks = 0;
+        wdt->misses = 0;
+        wdt->worst_us = 0;
+        wdt->last_kick_us = 0;
+        owner[i] = MP_OBJ_FROM_PTR(self);
+        self->wdt = i;
+    }
+
+    // Reconfigure with the timer stopped; the next kick arms it.
+    hbridge_wdt_t *wdt = &hbridge_wdt[self->wdt];
+    hbridge_wdt_disarm(wdt);
+    wdt->timeout_us = timeout_ms * 1000;
+    wdt->ramp_ms = ramp_ms;
+    wdt->num_channels = 2 * self->num_motors;
+    for (size_t i = 0; i < wdt->num_channels; ++i) {
+        wdt->ch[i] = ch[i];
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(esp32_hbridge_watchdog_obj, 1, esp32_hbridge_watchdog);
+
+// HBridge.kick(): tell the watchdog the control loop is alive without
+// changing the duty.  Outputs stopped by the watchdog stay stopped until the
+// next call to duty().
+static mp_obj_t esp32_hbridge_kick(mp_obj_t self_in) {
+    esp32_hbridge_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->wdt < 0) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("watchdog not enabled"));
+    }
+    hbridge_wdt_sync(self);
+    hbridge_wdt_kick(&hbridge_wdt[self->wdt]);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_hbridge_kick_obj, esp32_hbridge_kick);
+
+// HBridge.watchdog_stats([reset]) -> (kicks, misses, worst_us)
+static mp_obj_t esp32_hbridge_watchdog_stats(size_t n_args, const mp_obj_t *args) {
+    esp32_hbridge_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (self->wdt < 0) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("watchdog not enabled"));
+    }
+    hbridge_wdt_t *wdt = &hbridge_wdt[self->wdt];
+    portENTER_CRITICAL(&wdt->lock);
+    uint32_t kicks = wdt->kicks;
+    uint32_t misses = wdt->misses;
+    uint32_t worst_us = wdt->worst_us;
+    if (n_args > 1 && mp_obj_is_true(args[1])) {
+        wdt->kicks = 0;
+        wdt->misses = 0;
+        wdt->worst_us = 0;
+    }
+    portEXIT_CRITICAL(&wdt->lock);
+    mp_obj_t items[3] = {
+        mp_obj_new_int_from_uint(kicks),
+        mp_obj_new_int_from_uint(misses),
+        mp_obj_new_int_from_uint(worst_us),
+    };
+    return mp_obj_new_tuple(3, items);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_hbridge_watchdog_stats_obj, 1, 2, esp32_hbridge_watchdog_stats);
+
+static const mp_rom_map_elem_t esp32_hbridge_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_duty), MP_ROM_PTR(&esp32_hbridge_duty_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&esp32_hbridge_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_brake), MP_ROM_PTR(&esp32_hbridge_brake_obj) },
+    { MP_ROM_QSTR(MP_QSTR_coast), MP_ROM_PTR(&esp32_hbridge_coast_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fade_ms), MP_ROM_PTR(&esp32_hbridge_fade_ms_obj) },
+    { MP_ROM_QSTR(MP_QSTR_watchdog), MP_ROM_PTR(&esp32_hbridge_watchdog_obj) },
+    { MP_ROM_QSTR(MP_QSTR_kick), MP_ROM_PTR(&esp32_hbridge_kick_obj) },
+    { MP_ROM_QSTR(MP_QSTR_watchdog_stats), MP_ROM_PTR(&esp32_hbridge_watchdog_stats_obj) },
+
+    // Constants
+    { MP_ROM_QSTR(MP_QSTR_COAST), MP_ROM_INT(HBRIDGE_MODE_COAST) },
+    { MP_ROM_QSTR(MP_QSTR_BRAKE), MP_ROM_INT(HBRIDGE_MODE_BRAKE) },
+    { MP_ROM_QSTR(MP_QSTR_DUTY_MAX), MP_ROM_INT(HBRIDGE_DUTY_MAX) },
+};
+static MP_DEFINE_CONST_DICT(esp32_hbridge_locals_dict, esp32_hbridge_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    esp32_hbridge_type,
+    MP_QSTR_HBridge,
+    MP_TYPE_FLAG_NONE,
+    make_new, esp32_hbridge_make_new,
+    print, esp32_hbridge_print,
+    locals_dict, &esp32_hbridge_locals_dict
+    );
@@ -0,0 +1,237 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 autolab-fi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "py/runtime.h"
+#include "py/mperrno.h"
+#include "py/mphal.h"
+#include "modmachine.h"
+#include "modesp32.h"
+
+// esp32.I2CSequence is a prebuilt I2C transaction: an optional write followed
+// by an optional read from one device.  The command link is built once and
+// reused, and the whole sequence runs as one unit on the bus, so a register
+// select and the read that follows cannot be split by another bus user.
+// run() executes it while waiting; start() hands it to the bus task and
+// returns at once, and done()/wait() collect the result later.
+
+#define I2C_SEQUENCE_WRITE_MAX (16)
+#define I2C_SEQUENCE_READ_MAX (32)
+#define I2C_SEQUENCE_TIMEOUT_MS (50)
+
+typedef struct _esp32_i2c_sequence_obj_t {
+    mp_obj_base_t base;
+    machine_hw_i2c_txn_t txn;
+    uint8_t port;
+    uint8_t addr;
+    uint8_t write_len;
+    uint8_t read_len;
+    uint8_t write_buf[I2C_SEQUENCE_WRITE_MAX];
+    uint8_t read_buf[I2C_SEQUENCE_READ_MAX];
+} esp32_i2c_sequence_obj_t;
+
+static void i2c_sequence_done(machine_hw_i2c_txn_t *txn) {
+    mp_hal_wake_main_task();
+}
+
+static void i2c_sequence_check(esp32_i2c_sequence_obj_t *self) {
+    if (self->txn.cmd == NULL) {
+        mp_raise_OSError(MP_EBADF);
+    }
+}
+
+static void i2c_sequence_raise(esp_err_t err) {
+    if (err == ESP_FAIL) {
+        mp_raise_OSError(MP_ENODEV);
+    } else if (err == ESP_ERR_TIMEOUT) {
+        mp_raise_OSError(MP_ETIMEDOUT);
+    } else if (err != ESP_OK) {
+        check_esp_err(err);
+    }
+}
+
+// Copy the read data to buf, or return it as new bytes if buf is None.
+static mp_obj_t i2c_sequence_result(esp32_i2c_sequence_obj_t *self, mp_obj_t buf_in) {
+    i2c_sequence_raise(self->txn.err);
+    if (buf_in == mp_const_none) {
+        return mp_obj_new_bytes(self->read_buf, self->read_len);
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo.len < self->read_len) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+    memcpy(bufinfo.buf, self->read_buf, self->read_len);
+    return mp_const_none;
+}
+
+static void i2c_sequence_wait_idle(esp32_i2c_sequence_obj_t *self) {
+    while (self->txn.busy) {
+        MICROPY_EVENT_POLL_HOOK
+    }
+}
+
+static mp_obj_t esp32_i2c_sequence_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_i2c, ARG_addr, ARG_write, ARG_read, ARG_stop };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_i2c,   MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_addr,  MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_write, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_read,  MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_stop,  MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    int port = machine_hw_i2c_get_port(args[ARG_i2c].u_obj);
+
+    mp_buffer_info_t write = { .buf = NULL, .len = 0 };
+    if (args[ARG_write].u_obj != mp_const_none) {
+        mp_get_buffer_raise(args[ARG_write].u_obj, &write, MP_BUFFER_READ);
+    }
+    mp_int_t read_len = args[ARG_read].u_int;
+    if (write.len > I2C_SEQUENCE_WRITE_MAX || read_len < 0 || read_len > I2C_SEQUENCE_READ_MAX
+        || (write.len == 0 && read_len == 0)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bad sequence length"));
+    }
+
+    esp32_i2c_sequence_obj_t *self = mp_obj_malloc_with_finaliser(esp32_i2c_sequence_obj_t, type);
+    self->port = port;
+    self->addr = args[ARG_addr].u_int;
+    self->write_len = write.len;
+    self->read_len = read_len;
+    memcpy(self->write_buf, write.buf, write.len);
+    memset(self->read_buf, 0, sizeof(self->read_buf));
+
+    // The link refers to write_buf/read_buf, which stay put because GC heap
+    // objects never move.
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    if (cmd == NULL) {
+        mp_raise_OSError(MP_ENOMEM);
+    }
+    if (self->write_len > 0) {
+        i2c_master_start(cmd);
+        i2c_master_write_byte(cmd, self->addr << 1 | I2C_MASTER_WRITE, true);
+        i2c_master_write(cmd, self->write_buf, self->write_len, true);
+        if (args[ARG_stop].u_bool || self->read_len == 0) {
+            i2c_master_stop(cmd);
+        }
+    }
+    if (self->read_len > 0) {
+        i2c_master_start(cmd);
+        i2c_master_write_byte(cmd, self->addr << 1 | I2C_MASTER_READ, true);
+        i2c_master_read(cmd, self->read_buf, self->read_len, I2C_MASTER_LAST_NACK);
+        i2c_master_stop(cmd);
+    }
+    self->txn.cmd = cmd;
+    self->txn.timeout_ms = I2C_SEQUENCE_TIMEOUT_MS + self->read_len + self->write_len;
+    self->txn.done_cb = i2c_sequence_done;
+    self->txn.arg = self;
+    self->txn.err = ESP_OK;
+    self->txn.busy = false;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static void esp32_i2c_sequence_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    esp32_i2c_sequence_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "I2CSequence(I2C(%u), 0x%02x, write=%u, read=%u)",
+        self->port, self->addr, self->write_len, self->read_len);
+}
+
+// I2CSequence.run([buf]): execute now and return the data read.
+static mp_obj_t esp32_i2c_sequence_run(size_t n_args, const mp_obj_t *args) {
+    esp32_i2c_sequence_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    i2c_sequence_check(self);
+    i2c_sequence_wait_idle(self);
+    self->txn.err = machine_hw_i2c_cmd_begin(self->port, self->txn.cmd, self->txn.timeout_ms);
+    return i2c_sequence_result(self, n_args > 1 ? args[1] : mp_const_none);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_i2c_sequence_run_obj, 1, 2, esp32_i2c_sequence_run);
+
+// I2CSequence.start(): queue for the bus task and return immediately.
+static mp_obj_t esp32_i2c_sequence_start(mp_obj_t self_in) {
+    esp32_i2c_sequence_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    i2c_sequence_check(self);
+    if (self->txn.busy) {
+        mp_raise_OSError(MP_EBUSY);
+    }
+    check_esp_err(machine_hw_i2c_submit(self->port, &self->txn));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_i2c_sequence_start_obj, esp32_i2c_sequence_start);
+
+static mp_obj_t esp32_i2c_sequence_done(mp_obj_t self_in) {
+    esp32_i2c_sequence_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(!self->txn.busy);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_i2c_sequence_done_obj, esp32_i2c_sequence_done);
+
+// I2CSequence.wait([buf]): wait for a started sequence and return its data.
+static mp_obj_t esp32_i2c_sequence_wait(size_t n_args, const mp_obj_t *args) {
+    esp32_i2c_sequence_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    i2c_sequence_check(self);
+    i2c_sequence_wait_idle(self);
+    return i2c_sequence_result(self, n_args > 1 ? args[1] : mp_const_none);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_i2c_sequence_wait_obj, 1, 2, esp32_i2c_sequence_wait);
+
+static mp_obj_t esp32_i2c_sequence_deinit(mp_obj_t self_in) {
+    esp32_i2c_sequence_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->txn.cmd != NULL) {
+        // The bus task may still be using the link and buffers.
+        while (self->txn.busy) {
+            vTaskDelay(1);
+        }
+        i2c_cmd_link_delete(self->txn.cmd);
+        self->txn.cmd = NULL;
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_i2c_sequence_deinit_obj, esp32_i2c_sequence_deinit);
+
+static const mp_rom_map_elem_t esp32_i2c_sequence_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&esp32_i2c_sequence_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&esp32_i2c_sequence_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_run), MP_ROM_PTR(&esp32_i2c_sequence_run_obj) },
+    { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&esp32_i2c_sequence_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_done), MP_ROM_PTR(&esp32_i2c_sequence_done_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wait), MP_ROM_PTR(&esp32_i2c_sequence_wait_obj) },
+};
+static MP_DEFINE_CONST_DICT(esp32_i2c_sequence_locals_dict, esp32_i2c_sequence_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    esp32_i2c_sequence_type,
+    MP_QSTR_I2CSequence,
+    MP_TYPE_FLAG_NONE,
+    make_new, esp32_i2c_sequence_make_new,
+    print, esp32_i2c_sequence_print,
+    locals_dict, &esp32_i2c_sequence_locals_dict
+    );
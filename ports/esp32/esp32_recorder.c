@@ -0,0 +1,510 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 autolab-fi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mperrno.h"
+#include "py/mphal.h"
+#include "modesp32.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+#include "esp_task.h"
+
+// esp32.Recorder is an on-device flight recorder.  Fixed-size binary records
+// are appended to a RAM sector buffer from Python without any heap allocation,
+// and a low-priority writer task copies each buffer to a raw flash partition
+// in whole, sector-aligned writes.  The partition is used as a ring of 4k
+// sectors, so the most recent data is always kept.
+//
+// Each sector starts with a 128-byte header (see rec_header_t) that describes
+// the record layout, followed by as many records as fit.  A record is a
+// little-endian uint32 timestamp in ms followed by the payload packed
+// according to the struct-style format given to the constructor.  Unused
+// record slots are left erased (0xff), which the reader uses to find the end
+// of a partially filled sector.  ports/esp32/tools/flightlog.py decodes the
+// partition contents.
+
+#define REC_SECTOR_SIZE (4096)
+#define REC_HEADER_SIZE (128)
+#define REC_VERSION (1)
+#define REC_FMT_MAX (24)
+#define REC_NAMES_MAX (88)
+#define REC_PAYLOAD_MAX (64)
+#define REC_NUM_BUFFERS (2)
+#define REC_QUEUE_LEN (8)
+#define REC_TASK_STACK_SIZE (3072)
+#define REC_TASK_PRIORITY (ESP_TASK_PRIO_MIN)
+
+typedef struct _rec_header_t {
+    char magic[4];          // "MPFR"
+    uint16_t version;
+    uint16_t record_size;   // including the 4-byte timestamp
+    uint32_t seq;           // sector sequence number, increases across sessions
+    uint32_t session;       // incremented each time a Recorder is opened
+    char fmt[REC_FMT_MAX];  // payload format, nul terminated
+    char names[REC_NAMES_MAX]; // comma separated column names, nul terminated
+} rec_header_t;
+
+_Static_assert(sizeof(rec_header_t) == REC_HEADER_SIZE, "bad rec_header_t size");
+
+typedef struct _rec_buffer_t {
+    uint8_t *data;
+    uint32_t seq;
+    uint32_t sector;
+    volatile bool busy; // a full-sector write is queued
+} rec_buffer_t;
+
+typedef struct _rec_job_t {
+    uint8_t buffer;
+    uint16_t len;
+    uint32_t seq;
+    uint32_t sector;
+} rec_job_t;
+
+typedef struct _rec_state_t {
+    const esp_partition_t *part;
+    uint32_t num_sectors;
+    uint32_t session;
+    uint32_t next_seq;
+    uint32_t next_sector;
+    uint16_t record_size;
+    uint16_t pos;
+    uint8_t cur;
+    char fmt[REC_FMT_MAX];
+    char names[REC_NAMES_MAX];
+    rec_buffer_t buf[REC_NUM_BUFFERS];
+    uint32_t records;
+    volatile uint32_t dropped;
+    volatile uint32_t sectors_written;
+    volatile uint32_t write_errors;
+    uint32_t submitted;           // jobs queued, only touched by the MicroPython task
+    volatile uint32_t completed;  // jobs finished, only touched by the writer task
+} rec_state_t;
+
+typedef struct _esp32_recorder_obj_t {
+    mp_obj_base_t base;
+    bool open;
+} esp32_recorder_obj_t;
+
+static rec_state_t *rec_state = NULL;
+static QueueHandle_t rec_queue = NULL;
+static uint32_t rec_erased_seq[REC_NUM_BUFFERS];
+
+static void rec_writer_task(void *arg) {
+    rec_job_t job;
+    for (;;) {
+        if (xQueueReceive(rec_queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        rec_state_t *st = rec_state;
+        rec_buffer_t *b = &st->buf[job.buffer];
+        size_t offset = job.sector * REC_SECTOR_SIZE;
+        esp_err_t err = ESP_OK;
+        if (rec_erased_seq[job.buffer] != job.seq) {
+            err = esp_partition_erase_range(st->part, offset, REC_SECTOR_SIZE);
+            if (err == ESP_OK) {
+                rec_erased_seq[job.buffer] = job.seq;
+            }
+        }
+        if (err == ESP_OK) {
+            // Bytes beyond the last record are still 0xff, so rewriting the
+            // same sector after a partial flush only programs the new records.
+            err = esp_partition_write(st->part, offset, b->data, job.len);
+        }
+        if (err != ESP_OK) {
+            st->write_errors += 1;
+        }
+        if (job.len == REC_SECTOR_SIZE) {
+            st->sectors_written += 1;
+            b->busy = false;
+        }
+        st->completed += 1;
+    }
+}
+
+static void rec_start_sector(rec_state_t *st, uint8_t idx) {
+    rec_buffer_t *b = &st->buf[idx];
+    b->seq = st->next_seq++;
+    b->sector = st->next_sector;
+    st->next_sector = (st->next_sector + 1) % st->num_sectors;
+    memset(b->data, 0xff, REC_SECTOR_SIZE);
+    rec_header_t *hdr = (rec_header_t *)b->data;
+    memcpy(hdr->magic, "MPFR", 4);
+    hdr->version = REC_VERSION;
+    hdr->record_size = st->record_size;
+    hdr->seq = b->seq;
+    hdr->session = st->session;
+    memset(hdr->fmt, 0, sizeof(hdr->fmt));
+    memset(hdr->names, 0, sizeof(hdr->names));
+    strcpy(hdr->fmt, st->fmt);
+    strcpy(hdr->names, st->names);
+    st->cur = idx;
+    st->pos = REC_HEADER_SIZE;
+}
+
+static void rec_submit(rec_state_t *st, uint8_t idx, uint16_t len) {
+    rec_buffer_t *b = &st->buf[idx];
+    rec_job_t job = { .buffer = idx, .len = len, .seq = b->seq, .sector = b->sector };
+    if (len == REC_SECTOR_SIZE) {
+        b->busy = true;
+    }
+    if (xQueueSend(rec_queue, &job, 0) == pdTRUE) {
+        st->submitted += 1;
+    } else {
+        // Never block the control loop on a full queue, just lose the data.
+        b->busy = false;
+        st->dropped += 1;
+    }
+}
+
+static void rec_wait_idle(rec_state_t *st) {
+    while (st->completed != st->submitted) {
+        mp_hal_delay_ms(1);
+    }
+}
+
+static size_t rec_payload_size(const char *fmt) {
+    size_t size = 0;
+    for (; *fmt; ++fmt) {
+        switch (*fmt) {
+            case 'b':
+            case 'B':
+                size += 1;
+                break;
+            case 'h':
+            case 'H':
+                size += 2;
+                break;
+            case 'i':
+            case 'I':
+            case 'f':
+                size += 4;
+                break;
+            default:
+                mp_raise_ValueError(MP_ERROR_TEXT("bad format"));
+        }
+    }
+    return size;
+}
+
+// Scan the sector headers to continue the ring after the newest sector.
+static void rec_scan(rec_state_t *st) {
+    rec_header_t hdr;
+    bool found = false;
+    uint32_t max_seq = 0;
+    uint32_t max_seq_sector = 0;
+    uint32_t max_session = 0;
+    for (uint32_t s = 0; s < st->num_sectors; ++s) {
+        check_esp_err(esp_partition_read(st->part, s * REC_SECTOR_SIZE, &hdr, sizeof(hdr)));
+        if (memcmp(hdr.magic, "MPFR", 4) != 0 || hdr.version != REC_VERSION) {
+            continue;
+        }
+        if (!found || hdr.seq > max_seq) {
+            max_seq = hdr.seq;
+            max_seq_sector = s;
+        }
+        if (!found || hdr.session > max_session) {
+            max_session = hdr.session;
+        }
+        found = true;
+    }
+    if (found) {
+        st->next_seq = max_seq + 1;
+        st->next_sector = (max_seq_sector + 1) % st->num_sectors;
+        st->session = max_session + 1;
+    } else {
+        st->next_seq = 0;
+        st->next_sector = 0;
+        st->session = 0;
+    }
+}
+
+static void rec_close(void) {
+    rec_state_t *st = rec_state;
+    if (st == NULL || st->part == NULL) {
+        return;
+    }
+    if (st->pos > REC_HEADER_SIZE) {
+        rec_submit(st, st->cur, st->pos);
+    }
+    rec_wait_idle(st);
+    st->part = NULL;
+}
+
+// Called on soft reset so buffered records reach flash.
+void esp32_recorder_deinit(void) {
+    rec_close();
+}
+
+static mp_obj_t esp32_recorder_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_fmt, ARG_names, ARG_partition };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_fmt,       MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_names,     MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_partition, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = MP_OBJ_NEW_QSTR(MP_QSTR_rec)} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    size_t fmt_len;
+    const char *fmt = mp_obj_str_get_data(args[ARG_fmt].u_obj, &fmt_len);
+    if (fmt_len == 0 || fmt_len >= REC_FMT_MAX) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bad format"));
+    }
+    size_t payload = rec_payload_size(fmt);
+    if (payload > REC_PAYLOAD_MAX) {
+        mp_raise_ValueError(MP_ERROR_TEXT("record too large"));
+    }
+    size_t names_len = 0;
+    const char *names = "";
+    if (args[ARG_names].u_obj != mp_const_none) {
+        names = mp_obj_str_get_data(args[ARG_names].u_obj, &names_len);
+        if (names_len >= REC_NAMES_MAX) {
+            mp_raise_ValueError(MP_ERROR_TEXT("names too long"));
+        }
+    }
+
+    if (rec_state != NULL && rec_state->part != NULL) {
+        mp_raise_OSError(MP_EBUSY);
+    }
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+        mp_obj_str_get_str(args[ARG_partition].u_obj));
+    if (part == NULL) {
+        mp_raise_OSError(MP_ENOENT);
+    }
+    if (part->size < 2 * REC_SECTOR_SIZE) {
+        mp_raise_ValueError(MP_ERROR_TEXT("partition too small"));
+    }
+
+    // Buffers and queue live outside the GC heap because the writer task
+    // accesses them concurrently; they are kept for the lifetime of the firmware.
+    if (rec_state == NULL) {
+        rec_state_t *st = heap_caps_calloc(1, sizeof(rec_state_t), MALLOC_CAP_8BIT);
+        if (st == NULL) {
+            mp_raise_OSError(MP_ENOMEM);
+        }
+        for (size_t i = 0; i < REC_NUM_BUFFERS; ++i) {
+            st->buf[i].data = heap_caps_malloc(REC_SECTOR_SIZE, MALLOC_CAP_8BIT);
+            if (st->buf[i].data == NULL) {
+                for (size_t j = 0; j < i; ++j) {
+                    heap_caps_free(st->buf[j].data);
+                }
+                heap_caps_free(st);
+                mp_raise_OSError(MP_ENOMEM);
+            }
+        }
+        rec_queue = xQueueCreate(REC_QUEUE_LEN, sizeof(rec_job_t));
+        rec_state = st;
+        xTaskCreatePinnedToCore(rec_writer_task, "rec_writer", REC_TASK_STACK_SIZE / sizeof(StackType_t),
+            NULL, REC_TASK_PRIORITY, NULL, 1);
+    }
+
+    rec_state_t *st = rec_state;
+    st->part = part;
+    st->num_sectors = part->size / REC_SECTOR_SIZE;
+    st->record_size = 4 + payload;
+    memcpy(st->fmt, fmt, fmt_len);
+    st->fmt[fmt_len] = '\0';
+    memcpy(st->names, names, names_len);
+    st->names[names_len] = '\0';
+    st->records = 0;
+    st->dropped = 0;
+    st->sectors_written = 0;
+    st->write_errors = 0;
+    for (size_t i = 0; i < REC_NUM_BUFFERS; ++i) {
+        st->buf[i].busy = false;
+        rec_erased_seq[i] = UINT32_MAX;
+    }
+    rec_scan(st);
+    rec_start_sector(st, 0);
+
+    esp32_recorder_obj_t *self = mp_obj_malloc_with_finaliser(esp32_recorder_obj_t, type);
+    self->open = true;
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static rec_state_t *rec_get_open(esp32_recorder_obj_t *self) {
+    if (!self->open) {
+        mp_raise_OSError(MP_EBADF);
+    }
+    return rec_state;
+}
+
+static void esp32_recorder_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    esp32_recorder_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (!self->open) {
+        mp_printf(print, "Recorder(closed)");
+        return;
+    }
+    rec_state_t *st = rec_state;
+    mp_printf(print, "Recorder(fmt='%s', names='%s', partition='%s', session=%u)",
+        st->fmt, st->names, st->part->label, (unsigned)st->session);
+}
+
+// Recorder.log(v0, v1, ...)
+static mp_obj_t esp32_recorder_log(size_t n_args, const mp_obj_t *args) {
+    rec_state_t *st = rec_get_open(MP_OBJ_TO_PTR(args[0]));
+    if (n_args - 1 != strlen(st->fmt)) {
+        mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("expecting %d values"), (int)strlen(st->fmt));
+    }
+
+    if (st->pos + st->record_size > REC_SECTOR_SIZE) {
+        // Current sector is full: hand it to the writer and move on, unless
+        // the writer has fallen so far behind that the next buffer is in use.
+        uint8_t next = (st->cur + 1) % REC_NUM_BUFFERS;
+        if (st->buf[next].busy) {
+            st->dropped += 1;
+            return mp_const_false;
+        }
+        rec_submit(st, st->cur, REC_SECTOR_SIZE);
+        rec_start_sector(st, next);
+    }
+
+    // Pack into a local record first so a bad value leaves the buffer untouched.
+    uint8_t rec[4 + REC_PAYLOAD_MAX];
+    uint32_t t = mp_hal_ticks_ms();
+    memcpy(rec, &t, 4);
+    uint8_t *p = rec + 4;
+    for (size_t i = 0; st->fmt[i]; ++i) {
+        mp_obj_t v = args[i + 1];
+        switch (st->fmt[i]) {
+            case 'b':
+            case 'B':
+                *p++ = mp_obj_get_int(v);
+                break;
+            case 'h':
+            case 'H': {
+                uint16_t x = mp_obj_get_int(v);
+                memcpy(p, &x, 2);
+                p += 2;
+                break;
+            }
+            case 'i':
+            case 'I': {
+                uint32_t x = mp_obj_get_int_truncated(v);
+                memcpy(p, &x, 4);
+                p += 4;
+                break;
+            }
+            case 'f': {
+                float x = mp_obj_get_float_to_f(v);
+                memcpy(p, &x, 4);
+                p += 4;
+                break;
+            }
+        }
+    }
+    memcpy(st->buf[st->cur].data + st->pos, rec, st->record_size);
+    st->pos += st->record_size;
+    st->records += 1;
+    return mp_const_true;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_recorder_log_obj, 1, 1 + REC_FMT_MAX, esp32_recorder_log);
+
+// Recorder.flush(): write the partially filled sector and wait for the writer.
+static mp_obj_t esp32_recorder_flush(mp_obj_t self_in) {
+    rec_state_t *st = rec_get_open(MP_OBJ_TO_PTR(self_in));
+    if (st->pos > REC_HEADER_SIZE) {
+        rec_submit(st, st->cur, st->pos);
+    }
+    rec_wait_idle(st);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_recorder_flush_obj, esp32_recorder_flush);
+
+// Recorder.stats() -> (session, records, dropped, sectors_written, write_errors)
+static mp_obj_t esp32_recorder_stats(mp_obj_t self_in) {
+    rec_state_t *st = rec_get_open(MP_OBJ_TO_PTR(self_in));
+    mp_obj_t items[] = {
+        mp_obj_new_int_from_uint(st->session),
+        mp_obj_new_int_from_uint(st->records),
+        mp_obj_new_int_from_uint(st->dropped),
+        mp_obj_new_int_from_uint(st->sectors_written),
+        mp_obj_new_int_from_uint(st->write_errors),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(items), items);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_recorder_stats_obj, esp32_recorder_stats);
+
+static mp_obj_t esp32_recorder_close(mp_obj_t self_in) {
+    esp32_recorder_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->open) {
+        rec_close();
+        self->open = false;
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(esp32_recorder_close_obj, esp32_recorder_close);
+
+static mp_obj_t esp32_recorder___exit__(size_t n_args, const mp_obj_t *args) {
+    return esp32_recorder_close(args[0]);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_recorder___exit___obj, 4, 4, esp32_recorder___exit__);
+
+// Recorder.erase(partition='rec'): wipe the recorder partition.
+static mp_obj_t esp32_recorder_erase(size_t n_args, const mp_obj_t *args) {
+    const char *label = n_args > 0 ? mp_obj_str_get_str(args[0]) : "rec";
+    if (rec_state != NULL && rec_state->part != NULL && strcmp(rec_state->part->label, label) == 0) {
+        mp_raise_OSError(MP_EBUSY);
+    }
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (part == NULL) {
+        mp_raise_OSError(MP_ENOENT);
+    }
+    check_esp_err(esp_partition_erase_range(part, 0, part->size));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_recorder_erase_fun_obj, 0, 1, esp32_recorder_erase);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(esp32_recorder_erase_obj, MP_ROM_PTR(&esp32_recorder_erase_fun_obj));
+
+static const mp_rom_map_elem_t esp32_recorder_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&esp32_recorder_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&esp32_recorder___exit___obj) },
+    { MP_ROM_QSTR(MP_QSTR_log), MP_ROM_PTR(&esp32_recorder_log_obj) },
+    { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&esp32_recorder_flush_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&esp32_recorder_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&esp32_recorder_close_obj) },
+
+    // Static methods
+    { MP_ROM_QSTR(MP_QSTR_erase), MP_ROM_PTR(&esp32_recorder_erase_obj) },
+};
+static MP_DEFINE_CONST_DICT(esp32_recorder_locals_dict, esp32_recorder_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    esp32_recorder_type,
+    MP_QSTR_Recorder,
+    MP_TYPE_FLAG_NONE,
+    make_new, esp32_recorder_make_new,
+    print, esp32_recorder_print,
+    locals_dict, &esp32_recorder_locals_dict
+    );
@@ -0,0 +1,387 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 autolab-fi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mperrno.h"
+#include "py/mphal.h"
+#include "extmod/modmachine.h"
+#include "modesp32.h"
+
+// esp32.TCS3472 is a driver for the TCS3472 colour sensor.  Each read waits
+// until the current integration cycle has finished (the AVALID status bit),
+// fetches all four channels in one transaction and then restarts integration,
+// so a reading is never stale and never a repeat of the previous one.  Samples
+// go into a caller-provided buffer, so the read loop does not allocate.
+//
+// classify() matches a sample against a calibrated palette by nearest centroid
+// in a normalised space: chromaticity (R/C, G/C, B/C) plus brightness relative
+// to the palette's white level, so that black, grey and white are separated
+// as well as hues.
+
+#define TCS3472_CMD (0x80)
+#define TCS3472_CMD_AUTO_INC (0xa0)
+#define TCS3472_REG_ENABLE (0x00)
+#define TCS3472_REG_ATIME (0x01)
+#define TCS3472_REG_CONTROL (0x0f)
+#define TCS3472_REG_STATUS (0x13)
+#define TCS3472_REG_CDATAL (0x14)
+
+#define TCS3472_ENABLE_PON (0x01)
+#define TCS3472_ENABLE_AEN (0x02)
+#define TCS3472_STATUS_AVALID (0x01)
+
+// One integration step, and the power-on/init delay before the first cycle.
+#define TCS3472_STEP_US (2400)
+#define TCS3472_INIT_US (2400)
+
+// ATIME used by the original tcs3472.py, ~511ms.
+#define TCS3472_DEFAULT_ATIME (0x2b)
+
+#define TCS3472_PALETTE_MAX (16)
+
+typedef struct _esp32_tcs3472_obj_t {
+    mp_obj_base_t base;
+    mp_obj_base_t *i2c;
+    uint8_t addr;
+    uint8_t atime;
+    uint8_t gain;
+    uint8_t palette_len;
+    uint32_t cycle_us;
+    uint32_t cycle_start;
+    uint16_t crgb[4];
+    float white;
+    float palette[TCS3472_PALETTE_MAX][4];
+} esp32_tcs3472_obj_t;
+
+static const uint8_t tcs3472_gain_table[] = { 1, 4, 16, 60 };
+
+static void tcs3472_check(int ret) {
+    if (ret < 0) {
+        mp_raise_OSError(-ret);
+    }
+}
+
+static int tcs3472_write_reg(esp32_tcs3472_obj_t *self, uint8_t reg, uint8_t value) {
+    mp_machine_i2c_p_t *i2c_p = (mp_machine_i2c_p_t *)MP_OBJ_TYPE_GET_SLOT(self->i2c->type, protocol);
+    uint8_t data[2] = { TCS3472_CMD | reg, value };
+    mp_machine_i2c_buf_t buf = { .len = 2, .buf = data };
+    return i2c_p->transfer(self->i2c, self->addr, 1, &buf, MP_MACHINE_I2C_FLAG_STOP);
+}
+
+// Read len bytes starting at reg, as a single combined transaction if possible.
+static int tcs3472_read_regs(esp32_tcs3472_obj_t *self, uint8_t reg, uint8_t *dest, size_t len) {
+    mp_machine_i2c_p_t *i2c_p = (mp_machine_i2c_p_t *)MP_OBJ_TYPE_GET_SLOT(self->i2c->type, protocol);
+    uint8_t cmd = (len > 1 ? TCS3472_CMD_AUTO_INC : TCS3472_CMD) | reg;
+    mp_machine_i2c_buf_t bufs[2] = {
+        { .len = 1, .buf = &cmd },
+        { .len = len, .buf = dest },
+    };
+    if (i2c_p->transfer_supports_write1) {
+        return i2c_p->transfer(self->i2c, self->addr, 2, bufs,
+            MP_MACHINE_I2C_FLAG_WRITE1 | MP_MACHINE_I2C_FLAG_READ | MP_MACHINE_I2C_FLAG_STOP);
+    }
+    int ret = i2c_p->transfer(self->i2c, self->addr, 1, &bufs[0], MP_MACHINE_I2C_FLAG_STOP);
+    if (ret < 0) {
+        return ret;
+    }
+    return i2c_p->transfer(self->i2c, self->addr, 1, &bufs[1], MP_MACHINE_I2C_FLAG_READ | MP_MACHINE_I2C_FLAG_STOP);
+}
+
+// Restart integration: clearing AEN resets the ADC and its AVALID flag.
+static void tcs3472_start_cycle(esp32_tcs3472_obj_t *self) {
+    tcs3472_check(tcs3472_write_reg(self, TCS3472_REG_ENABLE, TCS3472_ENABLE_PON));
+    tcs3472_check(tcs3472_write_reg(self, TCS3472_REG_ENABLE, TCS3472_ENABLE_PON | TCS3472_ENABLE_AEN));
+    self->cycle_start = mp_hal_ticks_us();
+}
+
+static void tcs3472_configure(esp32_tcs3472_obj_t *self) {
+    tcs3472_check(tcs3472_write_reg(self, TCS3472_REG_ATIME, self->atime));
+    tcs3472_check(tcs3472_write_reg(self, TCS3472_REG_CONTROL, self->gain));
+    self->cycle_us = (256 - self->atime) * TCS3472_STEP_US + TCS3472_INIT_US;
+    tcs3472_start_cycle(self);
+}
+
+static void tcs3472_set_integration(esp32_tcs3472_obj_t *self, mp_obj_t ms_in) {
+    mp_int_t steps = (mp_int_t)(mp_obj_get_float(ms_in) * 1000 / TCS3472_STEP_US + MICROPY_FLOAT_CONST(0.5));
+    if (steps < 1 || steps > 256) {
+        mp_raise_ValueError(MP_ERROR_TEXT("integration_ms must be 2.4-614.4"));
+    }
+    self->atime = 256 - steps;
+}
+
+static void tcs3472_set_gain(esp32_tcs3472_obj_t *self, mp_int_t gain) {
+    for (size_t i = 0; i < MP_ARRAY_SIZE(tcs3472_gain_table); ++i) {
+        if (tcs3472_gain_table[i] == gain) {
+            self->gain = i;
+            return;
+        }
+    }
+    mp_raise_ValueError(MP_ERROR_TEXT("gain must be 1, 4, 16 or 60"));
+}
+
+static mp_obj_t esp32_tcs3472_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_i2c, ARG_address, ARG_integration_ms, ARG_gain };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_i2c,            MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_address,        MP_ARG_INT, {.u_int = 0x29} },
+        { MP_QSTR_integration_ms, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_gain,           MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 1} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_obj_t i2c = args[ARG_i2c].u_obj;
+    if (!mp_obj_is_type(i2c, &machine_i2c_type) && !mp_obj_is_type(i2c, &mp_machine_soft_i2c_type)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("expecting an I2C object"));
+    }
+
+    esp32_tcs3472_obj_t *self = mp_obj_malloc(esp32_tcs3472_obj_t, type);
+    self->i2c = MP_OBJ_TO_PTR(i2c);
+    self->addr = args[ARG_address].u_int;
+    self->atime = TCS3472_DEFAULT_ATIME;
+    if (args[ARG_integration_ms].u_obj != mp_const_none) {
+        tcs3472_set_integration(self, args[ARG_integration_ms].u_obj);
+    }
+    tcs3472_set_gain(self, args[ARG_gain].u_int);
+    self->palette_len = 0;
+    self->white = 0;
+    memset(self->crgb, 0, sizeof(self->crgb));
+    tcs3472_configure(self);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static void esp32_tcs3472_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    esp32_tcs3472_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "TCS3472(address=0x%02x, integration_ms=%u.%u, gain=%u, palette=%u)",
+        self->addr, (256 - self->atime) * 24 / 10, (256 - self->atime) * 24 % 10,
+        tcs3472_gain_table[self->gain], self->palette_len);
+}
+
+// TCS3472.config(*, integration_ms, gain)
+static mp_obj_t esp32_tcs3472_config(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_integration_ms, ARG_gain };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_integration_ms, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_gain,           MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+    };
+    esp32_tcs3472_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    if (args[ARG_integration_ms].u_obj != mp_const_none) {
+        tcs3472_set_integration(self, args[ARG_integration_ms].u_obj);
+    }
+    if (args[ARG_gain].u_obj != mp_const_none) {
+        tcs3472_set_gain(self, mp_obj_get_int(args[ARG_gain].u_obj));
+    }
+    tcs3472_configure(self);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(esp32_tcs3472_config_obj, 1, esp32_tcs3472_config);
+
+// TCS3472.read([buf], *, wait=True)
+// Wait for a fresh integration result and store it as CRGB into buf, which
+// must hold four uint16 values (eg array('H', [0, 0, 0, 0])).  Returns True,
+// or False if wait=False and the cycle has not finished yet.  Without buf a
+// new (c, r, g, b) tuple is returned (or None).
+static mp_obj_t esp32_tcs3472_read(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_buf, ARG_wait };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_buf,  MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_wait, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = true} },
+    };
+    esp32_tcs3472_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_buffer_info_t bufinfo = { .buf = NULL };
+    if (args[ARG_buf].u_obj != mp_const_none) {
+        mp_get_buffer_raise(args[ARG_buf].u_obj, &bufinfo, MP_BUFFER_WRITE);
+        if (bufinfo.len < sizeof(self->crgb)) {
+            mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+        }
+    }
+
+    // Sleep through the bulk of the integration time, then poll AVALID.
+    uint32_t elapsed = mp_hal_ticks_us() - self->cycle_start;
+    if (elapsed < self->cycle_us) {
+        if (!args[ARG_wait].u_bool) {
+            return bufinfo.buf != NULL ? mp_const_false : mp_const_none;
+        }
+        // Yield to other tasks for whole milliseconds, spin for the rest.
+        uint32_t remaining = self->cycle_us - elapsed;
+        mp_hal_delay_ms(remaining / 1000);
+        mp_hal_delay_us(remaining % 1000);
+    }
+    uint8_t status;
+    for (uint32_t start = mp_hal_ticks_ms();;) {
+        tcs3472_check(tcs3472_read_regs(self, TCS3472_REG_STATUS, &status, 1));
+        if (status & TCS3472_STATUS_AVALID) {
+            break;
+        }
+        if (!args[ARG_wait].u_bool) {
+            return bufinfo.buf != NULL ? mp_const_false : mp_const_none;
+        }
+        if (mp_hal_ticks_ms() - start > self->cycle_us / 1000 + 10) {
+            mp_raise_OSError(MP_ETIMEDOUT);
+        }
+        mp_hal_delay_ms(1);
+    }
+
+    uint8_t data[8];
+    tcs3472_check(tcs3472_read_regs(self, TCS3472_REG_CDATAL, data, sizeof(data)));
+    tcs3472_start_cycle(self);
+    for (size_t i = 0; i < 4; ++i) {
+        self->crgb[i] = data[2 * i] | data[2 * i + 1] << 8;
+    }
+
+    if (bufinfo.buf != NULL) {
+        memcpy(bufinfo.buf, self->crgb, sizeof(self->crgb));
+        return mp_const_true;
+    }
+    mp_obj_t items[4];
+    for (size_t i = 0; i < 4; ++i) {
+        items[i] = MP_OBJ_NEW_SMALL_INT(self->crgb[i]);
+    }
+    return mp_obj_new_tuple(4, items);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(esp32_tcs3472_read_obj, 1, esp32_tcs3472_read);
+
+// Get a CRGB sample from a buffer of four uint16 or a sequence of four ints.
+static void tcs3472_get_crgb(mp_obj_t crgb_in, float crgb[4]) {
+    mp_buffer_info_t bufinfo;
+    if (mp_get_buffer(crgb_in, &bufinfo, MP_BUFFER_READ)) {
+        if (bufinfo.len < 4 * sizeof(uint16_t)) {
+            mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+        }
+        const uint16_t *p = bufinfo.buf;
+        for (size_t i = 0; i < 4; ++i) {
+            crgb[i] = p[i];
+        }
+    } else {
+        mp_obj_t *items;
+        mp_obj_get_array_fixed_n(crgb_in, 4, &items);
+        for (size_t i = 0; i < 4; ++i) {
+            crgb[i] = mp_obj_get_float_to_f(items[i]);
+        }
+    }
+}
+
+static void tcs3472_normalise(const float crgb[4], float white, float out[4]) {
+    if (crgb[0] <= 0) {
+        out[0] = out[1] = out[2] = out[3] = 0;
+        return;
+    }
+    out[0] = crgb[1] / crgb[0];
+    out[1] = crgb[2] / crgb[0];
+    out[2] = crgb[3] / crgb[0];
+    out[3] = white > 0 ? crgb[0] / white : 0;
+}
+
+// TCS3472.palette(colours, white=0)
+// Set the palette from a sequence of calibration CRGB samples, one per colour.
+// white is the clear-channel level treated as full brightness; by default the
+// largest clear value in the palette is used.
+static mp_obj_t esp32_tcs3472_palette(size_t n_args, const mp_obj_t *args) {
+    esp32_tcs3472_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    size_t n;
+    mp_obj_t *colours;
+    mp_obj_get_array(args[1], &n, &colours);
+    if (n > TCS3472_PALETTE_MAX) {
+        mp_raise_ValueError(MP_ERROR_TEXT("palette too large"));
+    }
+
+    float samples[TCS3472_PALETTE_MAX][4];
+    float white = n_args > 2 ? mp_obj_get_float_to_f(args[2]) : 0;
+    for (size_t i = 0; i < n; ++i) {
+        tcs3472_get_crgb(colours[i], samples[i]);
+        if (n_args <= 2 && samples[i][0] > white) {
+            white = samples[i][0];
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        tcs3472_normalise(samples[i], white, self->palette[i]);
+    }
+    self->white = white;
+    self->palette_len = n;
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_tcs3472_palette_obj, 2, 3, esp32_tcs3472_palette);
+
+// TCS3472.classify([crgb]) -> index of the nearest palette colour
+// Classifies the last sample from read() if crgb is not given.
+static mp_obj_t esp32_tcs3472_classify(size_t n_args, const mp_obj_t *args) {
+    esp32_tcs3472_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (self->palette_len == 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("no palette"));
+    }
+    float crgb[4];
+    if (n_args > 1) {
+        tcs3472_get_crgb(args[1], crgb);
+    } else {
+        for (size_t i = 0; i < 4; ++i) {
+            crgb[i] = self->crgb[i];
+        }
+    }
+    float v[4];
+    tcs3472_normalise(crgb, self->white, v);
+
+    size_t best = 0;
+    float best_dist = 0;
+    for (size_t i = 0; i < self->palette_len; ++i) {
+        float dist = 0;
+        for (size_t j = 0; j < 4; ++j) {
+            float d = v[j] - self->palette[i][j];
+            dist += d * d;
+        }
+        if (i == 0 || dist < best_dist) {
+            best = i;
+            best_dist = dist;
+        }
+    }
+    return MP_OBJ_NEW_SMALL_INT(best);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(esp32_tcs3472_classify_obj, 1, 2, esp32_tcs3472_classify);
+
+static const mp_rom_map_elem_t esp32_tcs3472_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_config), MP_ROM_PTR(&esp32_tcs3472_config_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&esp32_tcs3472_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_palette), MP_ROM_PTR(&esp32_tcs3472_palette_obj) },
+    { MP_ROM_QSTR(MP_QSTR_classify), MP_ROM_PTR(&esp32_tcs3472_classify_obj) },
+};
+static MP_DEFINE_CONST_DICT(esp32_tcs3472_locals_dict, esp32_tcs3472_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    esp32_tcs3472_type,
+    MP_QSTR_TCS3472,
+    MP_TYPE_FLAG_NONE,
+    make_new, esp32_tcs3472_make_new,
+    print, esp32_tcs3472_print,
+    locals_dict, &esp32_tcs3472_locals_dict
+    );
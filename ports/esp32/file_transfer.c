@@ -0,0 +1,353 @@
+#include "file_transfer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "mbedtls/sha256.h"
+#include "shared_fs.h"
+
+// Moving files to and from the shared filesystem over MQTT, so programs can
+// be stored once and run by path instead of sent as a string every time.
+//
+// An upload is announced with its size and SHA-256, then arrives as binary
+// frames of a fixed chunk size (the last one may be shorter), each with its
+// offset and a CRC32 of its data.  Frames are written to "<path>.part" as
+// they come, hashed on the way, and acked; a frame with a bad CRC or an
+// unexpected offset is nacked with the offset to resend from.  When the last
+// byte is in, the file is closed and renamed over <path> only if the hash
+// matches, so a broken upload never replaces a good file.
+//
+// A download is sent as the same frames, followed by a reply with the size
+// and SHA-256 of what was sent.
+//
+// Everything here runs in the MQTT task, so the upload state needs no lock;
+// littlefs serialises the file access with MicroPython itself.
+
+static const char *TAG = "file_transfer";
+
+static const uint8_t FRAME_MAGIC[2] = {'F', 'T'};
+#define FRAME_VERSION 1
+#define PART_SUFFIX   ".part"
+
+typedef struct {
+    bool active;
+    lfs2_file_t file;
+    struct lfs2_file_config config;
+    uint8_t buffer[SHARED_FS_CACHE_SIZE];
+    mbedtls_sha256_context sha;
+    uint8_t sha256[32];     // expected
+    char path[FILE_TRANSFER_PATH_MAX];
+    char part_path[FILE_TRANSFER_PATH_MAX + sizeof(PART_SUFFIX)];
+    uint32_t size;
+    uint32_t received;
+    uint32_t chunk;
+} put_state_t;
+
+static put_state_t s_put;
+
+// Absolute, only [A-Za-z0-9._-] in names, no "." or ".." components.
+static bool path_valid(const char *path) {
+    size_t len = strlen(path);
+    if (len < 2 || len >= FILE_TRANSFER_PATH_MAX || path[0] != '/' || path[len - 1] == '/') {
+        return false;
+    }
+    for (const char *p = path; *p; p++) {
+        char c = *p;
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+            || c == '_' || c == '-' || c == '.' || c == '/';
+        if (!ok || (c == '/' && (p[1] == '/' || p[1] == '.'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_sha256(const char *hex, uint8_t out[32]) {
+    if (hex == NULL || strlen(hex) != 64) {
+        return false;
+    }
+    for (int i = 0; i < 32; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+            return false;
+        }
+        out[i] = byte;
+    }
+    return true;
+}
+
+static void format_sha256(const uint8_t sha[32], char out[65]) {
+    for (int i = 0; i < 32; i++) {
+        sprintf(out + 2 * i, "%02x", sha[i]);
+    }
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static int reply_error(char *reply, size_t reply_size, const char *type, const char *message) {
+    return snprintf(reply, reply_size, "{\"type\":\"%s\",\"status\":\"error\",\"message\":\"%s\"}", type, message);
+}
+
+// Create the directories leading up to path
+static void make_parents(lfs2_t *lfs, const char *path) {
+    char dir[FILE_TRANSFER_PATH_MAX];
+    for (const char *p = strchr(path + 1, '/'); p != NULL; p = strchr(p + 1, '/')) {
+        memcpy(dir, path, p - path);
+        dir[p - path] = '\0';
+        lfs2_mkdir(lfs, dir);
+    }
+}
+
+void file_transfer_abort(void) {
+    if (!s_put.active) {
+        return;
+    }
+    lfs2_t *lfs = shared_fs_wait();
+    lfs2_file_close(lfs, &s_put.file);
+    lfs2_remove(lfs, s_put.part_path);
+    mbedtls_sha256_free(&s_put.sha);
+    s_put.active = false;
+    ESP_LOGW(TAG, "Upload of %s dropped at %lu/%lu", s_put.path,
+        (unsigned long)s_put.received, (unsigned long)s_put.size);
+}
+
+static int put_finish(char *reply, size_t reply_size) {
+    lfs2_t *lfs = shared_fs_wait();
+    uint8_t sha[32];
+    mbedtls_sha256_finish(&s_put.sha, sha);
+    mbedtls_sha256_free(&s_put.sha);
+    s_put.active = false;
+
+    int err = lfs2_file_close(lfs, &s_put.file);
+    if (err < 0) {
+        lfs2_remove(lfs, s_put.part_path);
+        ESP_LOGE(TAG, "Failed to close %s (%d)", s_put.part_path, err);
+        return reply_error(reply, reply_size, "file-put", "write failed");
+    }
+    if (memcmp(sha, s_put.sha256, sizeof(sha)) != 0) {
+        lfs2_remove(lfs, s_put.part_path);
+        ESP_LOGE(TAG, "SHA-256 mismatch for %s", s_put.path);
+        return reply_error(reply, reply_size, "file-put", "sha256 mismatch");
+    }
+    err = lfs2_rename(lfs, s_put.part_path, s_put.path);
+    if (err < 0) {
+        lfs2_remove(lfs, s_put.part_path);
+        ESP_LOGE(TAG, "Failed to rename to %s (%d)", s_put.path, err);
+        return reply_error(reply, reply_size, "file-put", "rename failed");
+    }
+
+    ESP_LOGI(TAG, "Stored %s, %lu bytes", s_put.path, (unsigned long)s_put.size);
+    return snprintf(reply, reply_size, "{\"type\":\"file-put\",\"status\":\"done\",\"path\":\"%s\",\"size\":%lu}",
+        s_put.path, (unsigned long)s_put.size);
+}
+
+int file_transfer_put_begin(const char *path, uint32_t size, const char *sha256_hex, uint32_t chunk,
+    char *reply, size_t reply_size) {
+    file_transfer_abort();
+
+    lfs2_t *lfs = shared_fs_wait();
+    if (lfs == NULL) {
+        return reply_error(reply, reply_size, "file-put", "no filesystem");
+    }
+    if (path == NULL || !path_valid(path)) {
+        return reply_error(reply, reply_size, "file-put", "bad path");
+    }
+    if (!parse_sha256(sha256_hex, s_put.sha256)) {
+        return reply_error(reply, reply_size, "file-put", "bad sha256");
+    }
+    if (chunk == 0) {
+        chunk = FILE_TRANSFER_DEFAULT_CHUNK;
+    }
+    if (chunk > FILE_TRANSFER_MAX_CHUNK) {
+        return reply_error(reply, reply_size, "file-put", "chunk too large");
+    }
+
+    strcpy(s_put.path, path);
+    snprintf(s_put.part_path, sizeof(s_put.part_path), "%s" PART_SUFFIX, path);
+    make_parents(lfs, path);
+    memset(&s_put.config, 0, sizeof(s_put.config));
+    s_put.config.buffer = s_put.buffer;
+    int err = lfs2_file_opencfg(lfs, &s_put.file, s_put.part_path,
+        LFS2_O_WRONLY | LFS2_O_CREAT | LFS2_O_TRUNC, &s_put.config);
+    if (err < 0) {
+        ESP_LOGE(TAG, "Failed to open %s (%d)", s_put.part_path, err);
+        return reply_error(reply, reply_size, "file-put", "open failed");
+    }
+
+    mbedtls_sha256_init(&s_put.sha);
+    mbedtls_sha256_starts(&s_put.sha, 0);
+    s_put.size = size;
+    s_put.received = 0;
+    s_put.chunk = chunk;
+    s_put.active = true;
+    ESP_LOGI(TAG, "Receiving %s, %lu bytes in chunks of %lu", path, (unsigned long)size, (unsigned long)chunk);
+
+    if (size == 0) {
+        return put_finish(reply, reply_size);
+    }
+    return snprintf(reply, reply_size,
+        "{\"type\":\"file-put\",\"status\":\"ready\",\"path\":\"%s\",\"size\":%lu,\"chunk\":%lu}",
+        path, (unsigned long)size, (unsigned long)chunk);
+}
+
+int file_transfer_put_chunk(const uint8_t *frame, size_t len, char *reply, size_t reply_size) {
+    if (!s_put.active) {
+        return reply_error(reply, reply_size, "file-put", "no upload");
+    }
+    if (len < FILE_TRANSFER_HEADER_SIZE || memcmp(frame, FRAME_MAGIC, 2) != 0 || frame[2] != FRAME_VERSION) {
+        return reply_error(reply, reply_size, "file-put", "bad frame");
+    }
+
+    uint32_t offset = get_le32(frame + 4);
+    uint32_t crc = get_le32(frame + 8);
+    const uint8_t *data = frame + FILE_TRANSFER_HEADER_SIZE;
+    size_t data_len = len - FILE_TRANSFER_HEADER_SIZE;
+    uint32_t remaining = s_put.size - s_put.received;
+    size_t expected_len = remaining < s_put.chunk ? remaining : s_put.chunk;
+
+    const char *nack = NULL;
+    if (offset != s_put.received) {
+        nack = "offset";
+    } else if (data_len != expected_len) {
+        nack = "length";
+    } else if (esp_rom_crc32_le(0, data, data_len) != crc) {
+        nack = "crc";
+    }
+    if (nack != NULL) {
+        ESP_LOGW(TAG, "Chunk at %lu rejected (%s)", (unsigned long)offset, nack);
+        return snprintf(reply, reply_size,
+            "{\"type\":\"file-put\",\"status\":\"nack\",\"offset\":%lu,\"message\":\"%s\"}",
+            (unsigned long)s_put.received, nack);
+    }
+
+    lfs2_ssize_t n = lfs2_file_write(shared_fs_wait(), &s_put.file, data, data_len);
+    if (n != (lfs2_ssize_t)data_len) {
+        ESP_LOGE(TAG, "Failed to write %s (%ld)", s_put.part_path, (long)n);
+        file_transfer_abort();
+        return reply_error(reply, reply_size, "file-put", n == LFS2_ERR_NOSPC ? "no space" : "write failed");
+    }
+    mbedtls_sha256_update(&s_put.sha, data, data_len);
+    s_put.received += data_len;
+
+    if (s_put.received == s_put.size) {
+        return put_finish(reply, reply_size);
+    }
+    return snprintf(reply, reply_size, "{\"type\":\"file-put\",\"status\":\"ack\",\"offset\":%lu}",
+        (unsigned long)s_put.received);
+}
+
+int file_transfer_get(const char *path, uint32_t offset, uint32_t length, uint32_t chunk,
+    file_transfer_send_fn send, void *ctx, char *reply, size_t reply_size) {
+    lfs2_t *lfs = shared_fs_wait();
+    if (lfs == NULL) {
+        return reply_error(reply, reply_size, "file-get", "no filesystem");
+    }
+    if (path == NULL || !path_valid(path)) {
+        return reply_error(reply, reply_size, "file-get", "bad path");
+    }
+    if (chunk == 0) {
+        chunk = FILE_TRANSFER_DEFAULT_CHUNK;
+    }
+    if (chunk > FILE_TRANSFER_MAX_CHUNK) {
+        return reply_error(reply, reply_size, "file-get", "chunk too large");
+    }
+
+    uint8_t file_buffer[SHARED_FS_CACHE_SIZE];
+    struct lfs2_file_config config = { .buffer = file_buffer };
+    lfs2_file_t file;
+    int err = lfs2_file_opencfg(lfs, &file, path, LFS2_O_RDONLY, &config);
+    if (err < 0) {
+        return reply_error(reply, reply_size, "file-get", err == LFS2_ERR_NOENT ? "not found" : "open failed");
+    }
+    uint8_t *frame = malloc(FILE_TRANSFER_HEADER_SIZE + chunk);
+    if (frame == NULL) {
+        lfs2_file_close(lfs, &file);
+        return reply_error(reply, reply_size, "file-get", "out of memory");
+    }
+
+    lfs2_soff_t size = lfs2_file_size(lfs, &file);
+    uint32_t end = size < 0 ? 0 : size;
+    if (offset > end) {
+        offset = end;
+    }
+    if (length != 0 && length < end - offset) {
+        end = offset + length;
+    }
+    if (offset > 0) {
+        lfs2_file_seek(lfs, &file, offset, LFS2_SEEK_SET);
+    }
+
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    memcpy(frame, FRAME_MAGIC, 2);
+    frame[2] = FRAME_VERSION;
+    frame[3] = 0;
+    const char *error = NULL;
+    uint32_t pos = offset;
+    while (pos < end) {
+        uint32_t want = end - pos < chunk ? end - pos : chunk;
+        uint8_t *data = frame + FILE_TRANSFER_HEADER_SIZE;
+        lfs2_ssize_t n = lfs2_file_read(lfs, &file, data, want);
+        if (n != (lfs2_ssize_t)want) {
+            error = "read failed";
+            break;
+        }
+        put_le32(frame + 4, pos);
+        put_le32(frame + 8, esp_rom_crc32_le(0, data, n));
+        mbedtls_sha256_update(&sha, data, n);
+        if (!send(frame, FILE_TRANSFER_HEADER_SIZE + n, ctx)) {
+            error = "send failed";
+            break;
+        }
+        pos += n;
+    }
+    lfs2_file_close(lfs, &file);
+    free(frame);
+
+    uint8_t digest[32];
+    char hex[65];
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+    if (error != NULL) {
+        ESP_LOGE(TAG, "Download of %s stopped at %lu: %s", path, (unsigned long)pos, error);
+        return reply_error(reply, reply_size, "file-get", error);
+    }
+    format_sha256(digest, hex);
+    ESP_LOGI(TAG, "Sent %s, %lu bytes from %lu", path, (unsigned long)(end - offset), (unsigned long)offset);
+    return snprintf(reply, reply_size,
+        "{\"type\":\"file-get\",\"status\":\"done\",\"path\":\"%s\",\"offset\":%lu,\"size\":%lu,\"sha256\":\"%s\"}",
+        path, (unsigned long)offset, (unsigned long)(end - offset), hex);
+}
+
+int file_transfer_run_code(const char *path, char *code, size_t code_size) {
+    if (path == NULL || !path_valid(path)) {
+        return -1;
+    }
+
+    size_t len = strlen(path);
+    if (len > 4 && strcmp(path + len - 4, ".mpy") == 0) {
+        // Import from its directory, so the compiled code is loaded as is
+        // and nothing is compiled on the robot.
+        const char *name = strrchr(path, '/') + 1;
+        int dir_len = name - path > 1 ? name - path - 1 : 1;
+        int name_len = path + len - 4 - name;
+        if (name_len == 0 || memchr(name, '.', name_len) != NULL) {
+            return -1;
+        }
+        return snprintf(code, code_size, "import sys\nsys.path.insert(0, \"%.*s\")\n__import__(\"%.*s\")",
+            dir_len, path, name_len, name);
+    }
+    return snprintf(code, code_size, "execfile(\"%s\")", path);
+}
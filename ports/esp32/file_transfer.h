@@ -0,0 +1,39 @@
+#ifndef FILE_TRANSFER_H
+#define FILE_TRANSFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary chunk frame, little endian:
+//   "FT", version, flags (0), offset u32, crc32 u32 of the data, data
+#define FILE_TRANSFER_HEADER_SIZE   12
+#define FILE_TRANSFER_DEFAULT_CHUNK 1024
+#define FILE_TRANSFER_MAX_CHUNK     4096
+#define FILE_TRANSFER_PATH_MAX      64
+#define FILE_TRANSFER_REPLY_SIZE    192
+
+// Sends one frame of a download; false aborts it
+typedef bool (*file_transfer_send_fn)(const uint8_t *frame, size_t len, void *ctx);
+
+// Start an upload, replacing any unfinished one.  Chunks go to "<path>.part",
+// which becomes <path> once size bytes matching sha256_hex have arrived.
+// All functions write a JSON reply and return its length.
+int file_transfer_put_begin(const char *path, uint32_t size, const char *sha256_hex, uint32_t chunk,
+    char *reply, size_t reply_size);
+
+// Handle one frame of the current upload
+int file_transfer_put_chunk(const uint8_t *frame, size_t len, char *reply, size_t reply_size);
+
+// Drop the current upload, if any
+void file_transfer_abort(void);
+
+// Send length bytes of a file from offset (0 for all) through send()
+int file_transfer_get(const char *path, uint32_t offset, uint32_t length, uint32_t chunk,
+    file_transfer_send_fn send, void *ctx, char *reply, size_t reply_size);
+
+// Python job that runs a stored file: execfile() for source, import for .mpy.
+// Returns the length, or -1 for a bad path.
+int file_transfer_run_code(const char *path, char *code, size_t code_size);
+
+#endif // FILE_TRANSFER_H
@@ -34,6 +34,30 @@
 #include "py/gc.h"
 #include "py/mpthread.h"
 #include "gccollect.h"
+#include "esp_timer.h"
+
+gc_collect_stats_t gc_collect_stats;
+
+// The heap is at its fullest just before a collection, so sampling it here
+// gives a cheap peak without hooking every allocation.
+static int64_t gc_collect_stats_begin(void) {
+    gc_info_t info;
+    gc_info(&info);
+    if (info.used > gc_collect_stats.peak_used) {
+        gc_collect_stats.peak_used = info.used;
+    }
+    return esp_timer_get_time();
+}
+
+static void gc_collect_stats_end(int64_t t0) {
+    gc_collect_stats.count += 1;
+    gc_collect_stats.time_us += esp_timer_get_time() - t0;
+    gc_info_t info;
+    gc_info(&info);
+    gc_collect_stats.total = info.total;
+    gc_collect_stats.free = info.free;
+    gc_collect_stats.largest = info.max_free * MICROPY_BYTES_PER_GC_BLOCK;
+}
 
 #if CONFIG_IDF_TARGET_ARCH_XTENSA
 
@@ -53,24 +77,28 @@ static void gc_collect_inner(volatile unsigned int level) {
 }
 
 void gc_collect(void) {
+    int64_t t0 = gc_collect_stats_begin();
     gc_collect_start();
     gc_collect_inner(0);
     #if MICROPY_PY_THREAD
     mp_thread_gc_others();
     #endif
     gc_collect_end();
+    gc_collect_stats_end(t0);
 }
 
 #elif CONFIG_IDF_TARGET_ARCH_RISCV
 #include "shared/runtime/gchelper.h"
 
 void gc_collect(void) {
+    int64_t t0 = gc_collect_stats_begin();
     gc_collect_start();
     gc_helper_collect_regs_and_stack();
     #if MICROPY_PY_THREAD
     mp_thread_gc_others();
     #endif
     gc_collect_end();
+    gc_collect_stats_end(t0);
 }
 
 #else
@@ -40,3 +40,17 @@ extern uint32_t _heap_start;
 extern uint32_t _heap_end;
 
 void gc_collect(void);
+
+// Collection statistics, used by the job profiler in micropython_task.c and
+// by system_stats.c.
+typedef struct _gc_collect_stats_t {
+    uint32_t count;
+    uint32_t time_us;
+    size_t peak_used;  // highest heap use seen on entry to a collection
+    // Heap state right after the last collection.
+    size_t total;
+    size_t free;
+    size_t largest;    // largest free block, bytes
+} gc_collect_stats_t;
+
+extern gc_collect_stats_t gc_collect_stats;
@@ -28,7 +28,12 @@
 #include "py/mphal.h"
 #include "py/mperrno.h"
 #include "extmod/modmachine.h"
+#include "modmachine.h"
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_task.h"
 #include "driver/i2c.h"
 #include "hal/i2c_ll.h"
 
@@ -73,7 +78,68 @@ typedef struct _machine_hw_i2c_obj_t {
 
 static machine_hw_i2c_obj_t machine_hw_i2c_obj[I2C_NUM_MAX];
 
+// Bus manager.  The hardware ports are shared between MicroPython and native
+// drivers running in their own tasks (eg battery_monitor.c), so driver
+// (re)installation and every transaction are serialised with a per-port mutex.
+// Blocking transfers take the mutex directly.  Asynchronous transactions are
+// put on a per-port queue and executed in order by a bus task, which signals
+// completion through the transaction itself.  A transaction is usually a
+// prebuilt command link that is reused for every execution.
+#define MACHINE_HW_I2C_QUEUE_LEN (8)
+#define MACHINE_HW_I2C_STATIC_LINK_BUFS (3)
+#define MACHINE_HW_I2C_TASK_STACK_SIZE (2048)
+#define MACHINE_HW_I2C_TASK_PRIORITY (ESP_TASK_PRIO_MIN + 2)
+
+static SemaphoreHandle_t machine_hw_i2c_mutex[I2C_NUM_MAX];
+static StaticSemaphore_t machine_hw_i2c_mutex_buf[I2C_NUM_MAX];
+static QueueHandle_t machine_hw_i2c_queue[I2C_NUM_MAX];
+
+static void machine_hw_i2c_lock(i2c_port_t port);
+static void machine_hw_i2c_unlock(i2c_port_t port);
+
+static void machine_hw_i2c_bus_task(void *arg) {
+    i2c_port_t port = (i2c_port_t)(intptr_t)arg;
+    machine_hw_i2c_txn_t *txn;
+    for (;;) {
+        if (xQueueReceive(machine_hw_i2c_queue[port], &txn, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        machine_hw_i2c_lock(port);
+        esp_err_t err = i2c_master_cmd_begin(port, txn->cmd, pdMS_TO_TICKS(txn->timeout_ms));
+        machine_hw_i2c_unlock(port);
+        txn->err = err;
+        txn->busy = false;
+        if (txn->done_cb != NULL) {
+            txn->done_cb(txn);
+        }
+    }
+}
+
+void machine_hw_i2c_init0(void) {
+    for (int i = 0; i < I2C_NUM_MAX; ++i) {
+        if (machine_hw_i2c_mutex[i] == NULL) {
+            machine_hw_i2c_mutex[i] = xSemaphoreCreateMutexStatic(&machine_hw_i2c_mutex_buf[i]);
+            machine_hw_i2c_queue[i] = xQueueCreate(MACHINE_HW_I2C_QUEUE_LEN, sizeof(machine_hw_i2c_txn_t *));
+            xTaskCreatePinnedToCore(machine_hw_i2c_bus_task, "i2c_bus", MACHINE_HW_I2C_TASK_STACK_SIZE,
+                (void *)(intptr_t)i, MACHINE_HW_I2C_TASK_PRIORITY, NULL, 1);
+        }
+    }
+}
+
+static void machine_hw_i2c_lock(i2c_port_t port) {
+    if (machine_hw_i2c_mutex[port] != NULL) {
+        xSemaphoreTake(machine_hw_i2c_mutex[port], portMAX_DELAY);
+    }
+}
+
+static void machine_hw_i2c_unlock(i2c_port_t port) {
+    if (machine_hw_i2c_mutex[port] != NULL) {
+        xSemaphoreGive(machine_hw_i2c_mutex[port]);
+    }
+}
+
 static void machine_hw_i2c_init(machine_hw_i2c_obj_t *self, uint32_t freq, uint32_t timeout_us, bool first_init) {
+    machine_hw_i2c_lock(self->port);
     if (!first_init) {
         i2c_driver_delete(self->port);
     }
@@ -89,12 +155,62 @@ static void machine_hw_i2c_init(machine_hw_i2c_obj_t *self, uint32_t freq, uint3
     int timeout = I2C_SCLK_FREQ / 1000000 * timeout_us;
     i2c_set_timeout(self->port, (timeout > I2C_LL_MAX_TIMEOUT) ? I2C_LL_MAX_TIMEOUT : timeout);
     i2c_driver_install(self->port, I2C_MODE_MASTER, 0, 0, 0);
+    machine_hw_i2c_unlock(self->port);
+}
+
+// Configure a port for use from native code, unless MicroPython already has.
+// A later I2C() constructor call from Python reinitialises it as usual.
+void machine_hw_i2c_setup(int port, int scl, int sda, uint32_t freq) {
+    machine_hw_i2c_obj_t *self = &machine_hw_i2c_obj[port];
+    if (self->base.type != NULL) {
+        return;
+    }
+    self->base.type = &machine_i2c_type;
+    self->port = port;
+    self->scl = scl;
+    self->sda = sda;
+    machine_hw_i2c_init(self, freq, I2C_DEFAULT_TIMEOUT_US, true);
+}
+
+// Execute a command link on a port that has been set up, holding the port lock.
+esp_err_t machine_hw_i2c_cmd_begin(int port, i2c_cmd_handle_t cmd, uint32_t timeout_ms) {
+    machine_hw_i2c_lock(port);
+    esp_err_t err = i2c_master_cmd_begin(port, cmd, pdMS_TO_TICKS(timeout_ms));
+    machine_hw_i2c_unlock(port);
+    return err;
+}
+
+// Queue a transaction for the bus task.  txn must stay valid until txn->busy
+// is cleared; txn->done_cb, if set, is then called from the bus task.
+esp_err_t machine_hw_i2c_submit(int port, machine_hw_i2c_txn_t *txn) {
+    if (machine_hw_i2c_queue[port] == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    txn->busy = true;
+    if (xQueueSend(machine_hw_i2c_queue[port], &txn, 0) != pdTRUE) {
+        txn->busy = false;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+// Return the port of a hardware machine.I2C object.
+int machine_hw_i2c_get_port(mp_obj_t i2c_in) {
+    if (!mp_obj_is_type(i2c_in, &machine_i2c_type)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("expecting a hardware I2C object"));
+    }
+    machine_hw_i2c_obj_t *self = MP_OBJ_TO_PTR(i2c_in);
+    return self->port;
 }
 
 int machine_hw_i2c_transfer(mp_obj_base_t *self_in, uint16_t addr, size_t n, mp_machine_i2c_buf_t *bufs, unsigned int flags) {
     machine_hw_i2c_obj_t *self = MP_OBJ_TO_PTR(self_in);
 
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    // Build the command link on the stack for the common small transfers
+    // instead of allocating it from the IDF heap on every call.
+    uint8_t link_buf[I2C_LINK_RECOMMENDED_SIZE(MACHINE_HW_I2C_STATIC_LINK_BUFS)];
+    bool static_link = n <= MACHINE_HW_I2C_STATIC_LINK_BUFS;
+    i2c_cmd_handle_t cmd = static_link ? i2c_cmd_link_create_static(link_buf, sizeof(link_buf)) : i2c_cmd_link_create();
     int data_len = 0;
 
     if (flags & MP_MACHINE_I2C_FLAG_WRITE1) {
@@ -125,8 +241,14 @@ int machine_hw_i2c_transfer(mp_obj_base_t *self_in, uint16_t addr, size_t n, mp_
     }
 
     // TODO proper timeout
+    machine_hw_i2c_lock(self->port);
     esp_err_t err = i2c_master_cmd_begin(self->port, cmd, 100 * (1 + data_len) / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(cmd);
+    machine_hw_i2c_unlock(self->port);
+    if (static_link) {
+        i2c_cmd_link_delete_static(cmd);
+    } else {
+        i2c_cmd_link_delete(cmd);
+    }
 
     if (err == ESP_FAIL) {
         return -MP_ENODEV;
@@ -35,8 +35,10 @@
 
 #include "py/runtime.h"
 #include "py/mphal.h"
+#include "py/gc.h"
 #include "extmod/modmachine.h"
 #include "extmod/virtpin.h"
+#include "shared/runtime/eventring.h"
 #include "modmachine.h"
 #include "machine_pin.h"
 #include "machine_rtc.h"
@@ -57,11 +59,23 @@
 #define GPIO_FIRST_NON_OUTPUT (46)
 #endif
 
+// Limits for the size of the per-pin event ring, see Pin.irq(events=...).
+#define MACHINE_PIN_IRQ_EVENTS_MIN (2)
+#define MACHINE_PIN_IRQ_EVENTS_MAX (1024)
+
 // Return the gpio_num_t index for a given machine_pin_obj_t pointer.
 #define PIN_OBJ_PTR_INDEX(self) ((self) - &machine_pin_obj_table[0])
 // Return the machine_pin_obj_t pointer corresponding to a machine_pin_irq_obj_t pointer.
 #define PIN_OBJ_PTR_FROM_IRQ_OBJ_PTR(self) ((machine_pin_obj_t *)((uintptr_t)(self) - offsetof(machine_pin_obj_t, irq)))
 
+typedef struct _machine_pin_irq_state_t {
+    bool hard;
+    volatile bool scheduled;
+    uint32_t sched_overflow;
+} machine_pin_irq_state_t;
+
+static machine_pin_irq_state_t machine_pin_irq_state[GPIO_PIN_COUNT];
+
 static const machine_pin_obj_t *machine_pin_find_named(const mp_obj_dict_t *named_pins, mp_obj_t name) {
     const mp_map_t *named_map = &named_pins->map;
     mp_map_elem_t *named_elem = mp_map_lookup((mp_map_t *)named_map, name, MP_MAP_LOOKUP);
@@ -78,6 +92,8 @@ void machine_pins_init(void) {
         did_install = true;
     }
     memset(&MP_STATE_PORT(machine_pin_irq_handler[0]), 0, sizeof(MP_STATE_PORT(machine_pin_irq_handler)));
+    memset(&MP_STATE_PORT(machine_pin_irq_ring[0]), 0, sizeof(MP_STATE_PORT(machine_pin_irq_ring)));
+    memset(machine_pin_irq_state, 0, sizeof(machine_pin_irq_state));
 }
 
 void machine_pins_deinit(void) {
@@ -88,10 +104,92 @@ void machine_pins_deinit(void) {
     }
 }
 
+// Scheduled from the ISR in event mode: allow the next edge to schedule the
+// handler again, then call it.  Edges arriving in between are in the ring.
+static mp_obj_t machine_pin_irq_dispatch(mp_obj_t pin_in) {
+    gpio_num_t index = PIN_OBJ_PTR_INDEX((machine_pin_obj_t *)MP_OBJ_TO_PTR(pin_in));
+    machine_pin_irq_state[index].scheduled = false;
+    mp_obj_t handler = MP_STATE_PORT(machine_pin_irq_handler)[index];
+    if (handler != MP_OBJ_NULL) {
+        mp_call_function_1(handler, pin_in);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(machine_pin_irq_dispatch_obj, machine_pin_irq_dispatch);
+
+static mp_obj_t machine_pin_irq_report(mp_obj_t exc_in) {
+    mp_printf(MICROPY_ERROR_PRINTER, "Uncaught exception in IRQ callback handler\n");
+    mp_obj_print_exception(MICROPY_ERROR_PRINTER, exc_in);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(machine_pin_irq_report_obj, machine_pin_irq_report);
+
+// Call a hard handler directly from the ISR.  The ISR may have interrupted
+// any task, so it runs with its own thread state (restored on exit) and with
+// the GC and scheduler locked.  The handler is a viper function, which keeps
+// the stack use within what the interrupt stack can provide.
+static void machine_pin_irq_call_hard(mp_obj_t handler, machine_pin_obj_t *self) {
+    mp_state_thread_t *ts_orig = mp_thread_get_state();
+    mp_state_thread_t ts;
+    mp_thread_init_state(&ts, CONFIG_ESP_SYSTEM_ISR_STACK_SIZE / 2, NULL, NULL);
+
+    mp_sched_lock();
+    gc_lock();
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_call_function_1(handler, MP_OBJ_FROM_PTR(self));
+        nlr_pop();
+    } else {
+        // Uncaught exception; disable the handler and report it from the
+        // main task, the console can't be used from here.
+        gpio_num_t index = PIN_OBJ_PTR_INDEX(self);
+        gpio_set_intr_type(index, GPIO_INTR_DISABLE);
+        MP_STATE_PORT(machine_pin_irq_handler)[index] = MP_OBJ_NULL;
+        mp_sched_schedule(MP_OBJ_FROM_PTR(&machine_pin_irq_report_obj), MP_OBJ_FROM_PTR(nlr.ret_val));
+    }
+    gc_unlock();
+    mp_sched_unlock();
+
+    mp_thread_set_state(ts_orig);
+}
+
 static void machine_pin_isr_handler(void *arg) {
     machine_pin_obj_t *self = arg;
-    mp_obj_t handler = MP_STATE_PORT(machine_pin_irq_handler)[PIN_OBJ_PTR_INDEX(self)];
-    mp_sched_schedule(handler, MP_OBJ_FROM_PTR(self));
+    gpio_num_t index = PIN_OBJ_PTR_INDEX(self);
+    machine_pin_irq_state_t *state = &machine_pin_irq_state[index];
+    mp_obj_t handler = MP_STATE_PORT(machine_pin_irq_handler)[index];
+    mp_event_ring_t *ring = MP_STATE_PORT(machine_pin_irq_ring)[index];
+
+    if (ring != NULL) {
+        uint32_t time = mp_hal_ticks_us() & (MICROPY_PY_TIME_TICKS_PERIOD - 1);
+        mp_event_ring_put(ring, time, gpio_get_level(index));
+    }
+
+    if (handler == MP_OBJ_NULL) {
+        return;
+    }
+    if (state->hard) {
+        machine_pin_irq_call_hard(handler, self);
+        return;
+    }
+
+    bool scheduled;
+    if (ring != NULL) {
+        // Coalesce: one pending call drains all events recorded until it runs.
+        if (state->scheduled) {
+            return;
+        }
+        state->scheduled = true;
+        scheduled = mp_sched_schedule(MP_OBJ_FROM_PTR(&machine_pin_irq_dispatch_obj), MP_OBJ_FROM_PTR(self));
+        if (!scheduled) {
+            state->scheduled = false;
+        }
+    } else {
+        scheduled = mp_sched_schedule(handler, MP_OBJ_FROM_PTR(self));
+    }
+    if (!scheduled) {
+        state->sched_overflow += 1;
+    }
     mp_hal_wake_main_task_from_isr();
 }
 
@@ -296,13 +394,15 @@ static mp_obj_t machine_pin_toggle(mp_obj_t self_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(machine_pin_toggle_obj, machine_pin_toggle);
 
-// pin.irq(handler=None, trigger=IRQ_FALLING|IRQ_RISING)
+// pin.irq(handler=None, trigger=IRQ_FALLING|IRQ_RISING, *, wake=None, hard=False, events=0)
 static mp_obj_t machine_pin_irq(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
-    enum { ARG_handler, ARG_trigger, ARG_wake };
+    enum { ARG_handler, ARG_trigger, ARG_wake, ARG_hard, ARG_events };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_handler, MP_ARG_OBJ, {.u_obj = mp_const_none} },
         { MP_QSTR_trigger, MP_ARG_INT, {.u_int = GPIO_INTR_POSEDGE | GPIO_INTR_NEGEDGE} },
         { MP_QSTR_wake, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_hard, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
+        { MP_QSTR_events, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
     };
     machine_pin_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -346,12 +446,40 @@ static mp_obj_t machine_pin_irq(size_t n_args, const mp_obj_t *pos_args, mp_map_
                 machine_rtc_config.ext0_pin = -1;
             }
 
+            bool hard = args[ARG_hard].u_bool;
+            mp_int_t n_events = args[ARG_events].u_int;
+            #if MICROPY_EMIT_NATIVE
+            if (hard && !mp_obj_is_type(handler, &mp_type_fun_viper)) {
+                mp_raise_ValueError(MP_ERROR_TEXT("hard handler must be viper"));
+            }
+            #else
+            if (hard) {
+                mp_raise_ValueError(MP_ERROR_TEXT("hard handler must be viper"));
+            }
+            #endif
+            if (n_events != 0 && (n_events < MACHINE_PIN_IRQ_EVENTS_MIN || n_events > MACHINE_PIN_IRQ_EVENTS_MAX
+                                  || (n_events & (n_events - 1)) != 0)) {
+                mp_raise_ValueError(MP_ERROR_TEXT("bad events value"));
+            }
+
             if (handler == mp_const_none) {
                 handler = MP_OBJ_NULL;
-                trigger = 0;
+                if (n_events == 0) {
+                    trigger = 0;
+                }
+            }
+            mp_event_ring_t *ring = NULL;
+            if (n_events != 0) {
+                // The ring and its storage are one GC block, kept alive by the root pointer.
+                ring = m_malloc(sizeof(mp_event_ring_t) + n_events * sizeof(mp_event_ring_event_t));
+                mp_event_ring_init(ring, (mp_event_ring_event_t *)(ring + 1), n_events);
             }
             gpio_isr_handler_remove(index);
             MP_STATE_PORT(machine_pin_irq_handler)[index] = handler;
+            MP_STATE_PORT(machine_pin_irq_ring)[index] = ring;
+            machine_pin_irq_state[index].hard = hard;
+            machine_pin_irq_state[index].scheduled = false;
+            machine_pin_irq_state[index].sched_overflow = 0;
             gpio_set_intr_type(index, trigger);
             gpio_isr_handler_add(index, machine_pin_isr_handler, (void *)self);
         }
@@ -454,8 +582,61 @@ static mp_obj_t machine_pin_irq_trigger(size_t n_args, const mp_obj_t *args) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(machine_pin_irq_trigger_obj, 1, 2, machine_pin_irq_trigger);
 
+// irq.events([buf]): drain the event ring.  Without buf return a list of
+// (ticks_us, level) tuples, otherwise fill buf with pairs of 32-bit words and
+// return the number of events written.
+static mp_obj_t machine_pin_irq_events(size_t n_args, const mp_obj_t *args) {
+    machine_pin_irq_obj_t *self = args[0];
+    gpio_num_t index = PIN_OBJ_PTR_INDEX(PIN_OBJ_PTR_FROM_IRQ_OBJ_PTR(self));
+    mp_event_ring_t *ring = MP_STATE_PORT(machine_pin_irq_ring)[index];
+    if (ring == NULL) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("events not enabled"));
+    }
+
+    mp_event_ring_event_t ev[8];
+    if (n_args == 2) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+        size_t max = bufinfo.len / sizeof(mp_event_ring_event_t);
+        size_t total = 0;
+        uint32_t n;
+        while (total < max && (n = mp_event_ring_get(ring, ev, MIN(max - total, MP_ARRAY_SIZE(ev)))) != 0) {
+            memcpy((uint8_t *)bufinfo.buf + total * sizeof(mp_event_ring_event_t), ev, n * sizeof(mp_event_ring_event_t));
+            total += n;
+        }
+        return MP_OBJ_NEW_SMALL_INT(total);
+    }
+
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    uint32_t n;
+    while ((n = mp_event_ring_get(ring, ev, MP_ARRAY_SIZE(ev))) != 0) {
+        for (uint32_t i = 0; i < n; ++i) {
+            mp_obj_t tuple[2] = { mp_obj_new_int_from_uint(ev[i].time), MP_OBJ_NEW_SMALL_INT(ev[i].value) };
+            mp_obj_list_append(list, mp_obj_new_tuple(2, tuple));
+        }
+    }
+    return list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(machine_pin_irq_events_obj, 1, 2, machine_pin_irq_events);
+
+// irq.overflow(): return (events dropped because the ring was full,
+// callbacks dropped because the scheduler queue was full).
+static mp_obj_t machine_pin_irq_overflow(mp_obj_t self_in) {
+    machine_pin_irq_obj_t *self = self_in;
+    gpio_num_t index = PIN_OBJ_PTR_INDEX(PIN_OBJ_PTR_FROM_IRQ_OBJ_PTR(self));
+    mp_event_ring_t *ring = MP_STATE_PORT(machine_pin_irq_ring)[index];
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int_from_uint(ring == NULL ? 0 : mp_event_ring_overflow(ring)),
+        mp_obj_new_int_from_uint(machine_pin_irq_state[index].sched_overflow),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(machine_pin_irq_overflow_obj, machine_pin_irq_overflow);
+
 static const mp_rom_map_elem_t machine_pin_irq_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_trigger), MP_ROM_PTR(&machine_pin_irq_trigger_obj) },
+    { MP_ROM_QSTR(MP_QSTR_events), MP_ROM_PTR(&machine_pin_irq_events_obj) },
+    { MP_ROM_QSTR(MP_QSTR_overflow), MP_ROM_PTR(&machine_pin_irq_overflow_obj) },
 };
 static MP_DEFINE_CONST_DICT(machine_pin_irq_locals_dict, machine_pin_irq_locals_dict_table);
 
@@ -468,3 +649,4 @@ MP_DEFINE_CONST_OBJ_TYPE(
     );
 
 MP_REGISTER_ROOT_POINTER(mp_obj_t machine_pin_irq_handler[GPIO_PIN_COUNT]);
+MP_REGISTER_ROOT_POINTER(struct _mp_event_ring_t *machine_pin_irq_ring[GPIO_PIN_COUNT]);
@@ -39,6 +39,7 @@
 #include "soc/gpio_sig_map.h"
 #include "esp_clk_tree.h"
 #include "py/mpprint.h"
+#include "modmachine.h"
 
 #define debug_printf(...) mp_printf(&mp_plat_print, __VA_ARGS__); mp_printf(&mp_plat_print, " | %d at %s\n", __LINE__, __FILE__);
 
@@ -73,6 +74,11 @@
 // Config of timer upon which we run all PWM'ed GPIO pins
 static bool pwm_inited = false;
 
+#if !FADE
+// Fade service installed on demand by machine_pwm_set_duty_u16_many()
+static bool pwm_fade_installed = false;
+#endif
+
 // MicroPython PWM object struct
 typedef struct _machine_pwm_obj_t {
     mp_obj_base_t base;
@@ -190,6 +196,11 @@ void machine_pwm_deinit_all(void) {
         }
         #if FADE
         ledc_fade_func_uninstall();
+        #else
+        if (pwm_fade_installed) {
+            ledc_fade_func_uninstall();
+            pwm_fade_installed = false;
+        }
         #endif
         pwm_inited = false;
     }
@@ -566,6 +577,114 @@ static void set_freq_duty(machine_pwm_obj_t *self, unsigned int freq) {
     apply_duty(self);
 }
 
+// ******************************************************************************
+// Batched duty update, used by esp32.HBridge
+
+static machine_pwm_obj_t *machine_pwm_get_active(mp_obj_t pwm_in) {
+    if (!mp_obj_is_type(pwm_in, &machine_pwm_type)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("expecting a PWM object"));
+    }
+    machine_pwm_obj_t *self = MP_OBJ_TO_PTR(pwm_in);
+    pwm_is_active(self);
+    return self;
+}
+
+// Make sure the LEDC fade service is installed.
+void machine_pwm_fade_init(void) {
+    #if !FADE
+    if (!pwm_fade_installed) {
+        check_esp_err(ledc_fade_func_install(0));
+        pwm_fade_installed = true;
+    }
+    #endif
+}
+
+// Set the 16-bit duty of n channels.  All duty registers are written first and
+// then latched back-to-back, so the outputs change within a few APB cycles of
+// each other rather than one interpreter round trip apart.  If fade_ms is
+// non-zero the LEDC fade hardware ramps each channel to its new duty instead.
+void machine_pwm_set_duty_u16_many(size_t n, const mp_obj_t *pwms, const uint32_t *duty_u16, uint32_t fade_ms) {
+    machine_pwm_obj_t *objs[n];
+    for (size_t i = 0; i < n; ++i) {
+        objs[i] = machine_pwm_get_active(pwms[i]);
+        if (duty_u16[i] > MAX_16_DUTY - 1) {
+            mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("duty_u16 must be from 0 to %d"), MAX_16_DUTY);
+        }
+    }
+
+    if (fade_ms > 0) {
+        machine_pwm_fade_init();
+    }
+
+    // Stage the new duties.
+    for (size_t i = 0; i < n; ++i) {
+        machine_pwm_obj_t *self = objs[i];
+        int duty = duty_u16[i] == MAX_16_DUTY - 1 ? MAX_16_DUTY : duty_u16[i];
+        self->duty_scale = DUTY_16;
+        self->duty_ui = duty;
+        if (chans[self->mode][self->channel].pin != self->pin || self->output_invert_prev != self->output_invert) {
+            // Channel needs a full (re)configuration, which also latches the duty.
+            apply_duty(self);
+            continue;
+        }
+        self->channel_duty = duty >> (UI_RES_16_BIT - timers[self->mode][self->timer].duty_resolution);
+        if (fade_ms > 0) {
+            check_esp_err(ledc_set_fade_with_time(self->mode, self->channel, self->channel_duty, fade_ms));
+        } else {
+            check_esp_err(ledc_set_duty(self->mode, self->channel, self->channel_duty));
+        }
+    }
+
+    // Commit them together.
+    for (size_t i = 0; i < n; ++i) {
+        machine_pwm_obj_t *self = objs[i];
+        if (fade_ms > 0) {
+            check_esp_err(ledc_fade_start(self->mode, self->channel, LEDC_FADE_NO_WAIT));
+        } else {
+            check_esp_err(ledc_update_duty(self->mode, self->channel));
+        }
+    }
+}
+
+// Return the LEDC channel behind an active PWM object, for native drivers
+// that need to reach the output without going through the VM.
+void machine_pwm_get_channel(mp_obj_t pwm, machine_pwm_channel_t *ch) {
+    machine_pwm_obj_t *self = machine_pwm_get_active(pwm);
+    ch->pin = self->pin;
+    ch->mode = self->mode;
+    ch->channel = self->channel;
+}
+
+// Ramp n channels to zero duty over ramp_ms (or at once if ramp_ms is zero or
+// the fade service is not installed).  This neither raises nor touches Python
+// objects, so it may be called from any task while the VM is busy.  A channel
+// that no longer drives the pin it was looked up for is left alone, and the
+// duty reported by the PWM objects is not updated.
+void machine_pwm_ramp_to_zero(size_t n, const machine_pwm_channel_t *ch, uint32_t ramp_ms) {
+    #if !FADE
+    if (!pwm_fade_installed) {
+        ramp_ms = 0;
+    }
+    #endif
+    for (size_t i = 0; i < n; ++i) {
+        if (chans[ch[i].mode][ch[i].channel].pin != ch[i].pin) {
+            continue;
+        }
+        if (ramp_ms > 0 && ledc_set_fade_with_time(ch[i].mode, ch[i].channel, 0, ramp_ms) == ESP_OK) {
+            continue;
+        }
+        ledc_set_duty(ch[i].mode, ch[i].channel, 0);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (chans[ch[i].mode][ch[i].channel].pin != ch[i].pin) {
+            continue;
+        }
+        if (ramp_ms == 0 || ledc_fade_start(ch[i].mode, ch[i].channel, LEDC_FADE_NO_WAIT) != ESP_OK) {
+            ledc_update_duty(ch[i].mode, ch[i].channel);
+        }
+    }
+}
+
 // ******************************************************************************
 // MicroPython bindings for PWM
 
@@ -41,6 +41,8 @@
 
 // Include our custom modules
 #include "settings_manager.h"
+#include "battery_monitor.h"
+#include "system_stats.h"
 #include "mqtt_handler.h"
 #include "uart_handler.h"
 #include "micropython_task.h"
@@ -91,14 +93,6 @@ void MICROPY_ESP_IDF_ENTRY(void) {
     ESP_LOGI(TAG, "[APP] Free memory: %lu bytes", esp_get_free_heap_size());
     ESP_LOGI(TAG, "[APP] IDF version: %s", esp_get_idf_version());
 
-    // Initialize settings first
-    if (settings_init() != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize settings");
-        esp_restart();
-    }
-    
-    
-
     // Set log levels
     esp_log_level_set("*", ESP_LOG_INFO);
     esp_log_level_set("mqtt_client", ESP_LOG_VERBOSE);
@@ -121,7 +115,7 @@ void MICROPY_ESP_IDF_ENTRY(void) {
     }
     
     // Create queue for Python code communication between tasks
-    python_code_queue = xQueueCreate(10, sizeof(char*));
+    python_code_queue = xQueueCreate(10, sizeof(python_job_t));
     if (python_code_queue == NULL) {
         ESP_LOGE(TAG, "Failed to create Python code queue");
         esp_restart();
@@ -131,8 +125,11 @@ void MICROPY_ESP_IDF_ENTRY(void) {
    // watchdog_init();
    uart_handler_init();
 
-    
-    
+    // Shared I2C bus locks must exist before any task touches the bus
+    machine_hw_i2c_init0();
+
+    // The Wi-Fi driver and the interpreter start up while the settings
+    // filesystem is mounted below; both wait for it only where they need it.
     // Create MQTT task on core 1
     xTaskCreatePinnedToCore(mqtt_task, "mqtt_task", 
         8192, NULL, MQTT_TASK_PRIORITY, NULL, 1);
@@ -141,6 +138,19 @@ void MICROPY_ESP_IDF_ENTRY(void) {
     xTaskCreatePinnedToCore(mp_task, "mp_task", 
         MICROPY_TASK_STACK_SIZE / sizeof(StackType_t), 
         NULL, MP_TASK_PRIORITY, &mp_main_task_handle, 0);
+
+    if (settings_init() != ESP_OK) {
+        // Keep booting on the defaults, a restart would only fail the same way
+        ESP_LOGE(TAG, "Failed to initialize settings");
+    }
+
+    if (battery_monitor_init() != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start battery monitor");
+    }
+    int stats_sample_ms = get_int_setting("stats_sample_ms", SYSTEM_STATS_DEFAULT_PERIOD_MS);
+    if (system_stats_init(stats_sample_ms > 0 ? stats_sample_ms : 0) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start system stats");
+    }
     
     xTaskCreatePinnedToCore(uart_handler_task, "uart_task", 
         4096, NULL, WATCHDOG_TASK_PRIORITY, NULL, 1);
@@ -151,7 +161,4 @@ void MICROPY_ESP_IDF_ENTRY(void) {
     // Create watchdog task
     // xTaskCreatePinnedToCore(watchdog_task, "watchdog_task", 
     //     4096, NULL, WATCHDOG_TASK_PRIORITY, NULL, 1);
-
-    // Write settings to MicroPython file system
-    write_settings_to_micropython();
 }
@@ -11,6 +11,7 @@
 #include "esp_log.h"
 #include "esp_memory_utils.h"
 #include "esp_cpu.h"
+#include "esp_timer.h"
 #include "mbedtls/platform_time.h"
 
 #include "py/cstack.h"
@@ -32,9 +33,12 @@
 #include "usb_serial_jtag.h"
 #include "mphalport.h"
 #include "modmachine.h"
+#include "modesp32.h"
 #include "modnetwork.h"
 #include "settings_manager.h"
 #include "mqtt_handler.h"
+#include "gccollect.h"
+#include "boot_profile.h"
 
 #if MICROPY_BLUETOOTH_NIMBLE
 #include "extmod/modbluetooth.h"
@@ -46,10 +50,15 @@
 
 // Constants
 #define MAX_STR_LEN 64
-#define USER_CODE_TIMEOUT_MS (70000)
 #define USER_CODE_RESTART_GRACE_MS (2000)
 #define USER_CODE_GUARD_POLL_MS (100)
 
+// Unused mp_task stack is filled with this before each job, to find how deep
+// the job went.  Same as the FreeRTOS fill byte, so the task watermark agrees.
+#define JOB_STACK_FILL (0xa5)
+// Leave this much below the current stack pointer alone while filling.
+#define JOB_STACK_FILL_MARGIN (1024)
+
 static const char *TAG = "micropython_task";
 
 // Global variables
@@ -60,9 +69,6 @@ StreamBufferHandle_t mqtt_print_stream = NULL;
 // Static variables for native code management
 static native_code_node_t *native_code_head = NULL;
 
-// ADC measurement flag
-static bool measure_adc = false;
-
 // Python code storage
 static char* py_code = "";
 
@@ -72,6 +78,11 @@ static volatile uint32_t user_code_execution_id = 0;
 static volatile TickType_t user_code_deadline = 0;
 static volatile TickType_t user_code_interrupt_deadline = 0;
 
+// Profile of the last finished job, handed to mqtt_task.
+static python_job_profile_t job_profile;
+static volatile bool job_profile_new = false;
+static portMUX_TYPE job_profile_lock = portMUX_INITIALIZER_UNLOCKED;
+
 // Python string argument structure
 typedef struct {
     const char *code;   // указатель на строку Python-кода
@@ -96,23 +107,18 @@ static inline void mp_user_code_finish_execution(void) {
     MICROPY_END_ATOMIC_SECTION(atomic_state);
 }
 
-// ADC flag functions
-bool get_measure_adc_flag(void) {
-    return measure_adc;
-}
 
-void set_measure_adc_flag(bool value) {
-    measure_adc = value;
+bool python_code_enqueue(char *code, TickType_t wait) {
+    python_job_t job = {
+        .code = code,
+        .queued_us = esp_timer_get_time(),
+    };
+    return python_code_queue != NULL && xQueueSend(python_code_queue, &job, wait) == pdTRUE;
 }
 
-void clear_measure_adc_flag(void) {
-    measure_adc = false;
-}
-
-
 void  execute_python_code(const char* code){
     if (code != NULL) {
-        if (xQueueSend(python_code_queue, &code, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        if (!python_code_enqueue((char *)code, pdMS_TO_TICKS(1000))) {
             ESP_LOGE(TAG, "Failed to send Python code to queue");
             free(code);
         } else {
@@ -191,6 +197,97 @@ void mp_user_code_guard_task(void *pvParameter) {
     }
 }
 
+bool python_job_profile_take(python_job_profile_t *profile) {
+    bool is_new;
+    portENTER_CRITICAL(&job_profile_lock);
+    is_new = job_profile_new;
+    if (is_new) {
+        *profile = job_profile;
+        job_profile_new = false;
+    }
+    portEXIT_CRITICAL(&job_profile_lock);
+    return is_new;
+}
+
+int python_job_profile_format_json(const python_job_profile_t *p, char *buf, size_t buf_size) {
+    static const char *const status_str[] = { "ok", "exception", "memory", "timeout" };
+    return snprintf(buf, buf_size,
+        "{\"job\":%lu,\"status\":\"%s\",\"exc\":\"%s\",\"code_len\":%lu,"
+        "\"queue_us\":%lu,\"compile_us\":%lu,\"run_us\":%lu,"
+        "\"gc_count\":%lu,\"gc_us\":%lu,\"heap_peak\":%lu,\"heap_total\":%lu,"
+        "\"stack_peak\":%lu,\"stack_size\":%lu}",
+        (unsigned long)p->id, status_str[p->status], p->exc, (unsigned long)p->code_len,
+        (unsigned long)p->queue_us, (unsigned long)p->compile_us, (unsigned long)p->run_us,
+        (unsigned long)p->gc_count, (unsigned long)p->gc_us,
+        (unsigned long)p->heap_peak, (unsigned long)p->heap_total,
+        (unsigned long)p->stack_peak, (unsigned long)p->stack_size);
+}
+
+// Fill the unused part of the stack, see JOB_STACK_FILL.
+static void job_stack_fill(void) {
+    uint8_t *bottom = (uint8_t *)pxTaskGetStackStart(NULL);
+    uint8_t *sp = (uint8_t *)esp_cpu_get_sp();
+    if (sp - bottom > JOB_STACK_FILL_MARGIN) {
+        memset(bottom, JOB_STACK_FILL, sp - JOB_STACK_FILL_MARGIN - bottom);
+    }
+}
+
+// Return the deepest stack use since job_stack_fill(), in bytes.
+static size_t job_stack_peak(void) {
+    const uint32_t *p = (const uint32_t *)pxTaskGetStackStart(NULL);
+    while (*p == JOB_STACK_FILL * 0x01010101u) {
+        ++p;
+    }
+    return (uint8_t *)MP_STATE_THREAD(stack_top) - (uint8_t *)p;
+}
+
+static void job_profile_begin(python_job_profile_t *p, const python_job_t *job, int64_t now) {
+    memset(p, 0, sizeof(*p));
+    p->id = user_code_execution_id;
+    p->code_len = strlen(job->code);
+    p->queue_us = job->queued_us != 0 ? now - job->queued_us : 0;
+    p->stack_size = MICROPY_TASK_STACK_SIZE;
+
+    // gc_count and gc_us hold the starting counts until job_profile_end().
+    gc_info_t info;
+    gc_info(&info);
+    p->gc_count = gc_collect_stats.count;
+    p->gc_us = gc_collect_stats.time_us;
+    gc_collect_stats.peak_used = info.used;
+    job_stack_fill();
+}
+
+static void job_profile_end(python_job_profile_t *p, mp_obj_t exc) {
+    gc_info_t info;
+    gc_info(&info);
+    p->heap_total = info.total;
+    p->heap_peak = MAX(info.used, gc_collect_stats.peak_used);
+    p->gc_count = gc_collect_stats.count - p->gc_count;
+    p->gc_us = gc_collect_stats.time_us - p->gc_us;
+    p->stack_peak = job_stack_peak();
+
+    if (exc != MP_OBJ_NULL) {
+        const mp_obj_type_t *type = mp_obj_get_type(exc);
+        snprintf(p->exc, sizeof(p->exc), "%s", qstr_str(type->name));
+        if (mp_user_code_timeout_handled()) {
+            p->status = PYTHON_JOB_TIMEOUT;
+        } else if (mp_obj_is_subclass_fast(MP_OBJ_FROM_PTR(type), MP_OBJ_FROM_PTR(&mp_type_MemoryError))) {
+            p->status = PYTHON_JOB_MEMORY;
+        } else {
+            p->status = PYTHON_JOB_EXCEPTION;
+        }
+    }
+
+    portENTER_CRITICAL(&job_profile_lock);
+    job_profile = *p;
+    job_profile_new = true;
+    portEXIT_CRITICAL(&job_profile_lock);
+
+    ESP_LOGI(TAG, "Job %lu: queue %lu us, compile %lu us, run %lu us, %lu GCs in %lu us, heap peak %lu, stack peak %lu",
+        (unsigned long)p->id, (unsigned long)p->queue_us, (unsigned long)p->compile_us, (unsigned long)p->run_us,
+        (unsigned long)p->gc_count, (unsigned long)p->gc_us, (unsigned long)p->heap_peak, (unsigned long)p->stack_peak);
+}
+
 // MicroPython task running on core 0
 void mp_task(void *pvParameter) {
     ESP_LOGI(TAG, "Starting MicroPython task on core %d", xPortGetCoreID());
@@ -239,25 +336,22 @@ soft_reset:
 
     // run boot-up scripts
     pyexec_frozen_module("_boot.py", false);
+    boot_profile_mark(BOOT_PHASE_MP_INIT);
     int ret = pyexec_file_if_exists("boot.py");
     if (ret & PYEXEC_FORCED_EXIT) {
         goto soft_reset_exit;
     }
 
-    char* received_code = NULL;
+    boot_profile_mark(BOOT_PHASE_MP_READY);
+
+    python_job_t received_job = { NULL, 0 };
 
     for (;;) {
-        // Check ADC measurement flag
-        if (measure_adc) {
-            pyexec_file_if_exists("battery_status.py");
-            measure_adc = false;
-        }
-        
         // Check for new Python code to execute
-        if (xQueueReceive(python_code_queue, &received_code, pdMS_TO_TICKS(10)) == pdTRUE) {
-            py_code = received_code;
+        if (xQueueReceive(python_code_queue, &received_job, pdMS_TO_TICKS(10)) == pdTRUE) {
+            py_code = received_job.code;
         }
-        
+
         // Execute Python code if available
         if (strlen(py_code) > 0) {
             printf("Executing Python code: %s\n", py_code);
@@ -266,6 +360,14 @@ soft_reset:
             mp_user_code_begin_execution();
             ESP_LOGI(TAG, "User code execution started, timeout armed for %d ms", USER_CODE_TIMEOUT_MS);
 
+            // Written before and read after the nlr jump, so kept out of registers.
+            static python_job_profile_t profile;
+            static volatile int64_t t_start, t_compiled;
+            t_start = esp_timer_get_time();
+            job_profile_begin(&profile, &received_job, t_start);
+            t_compiled = 0;
+            mp_obj_t exc = MP_OBJ_NULL;
+
             nlr_buf_t nlr;
             if (nlr_push(&nlr) == 0) {
                 mp_lexer_t *lex = mp_lexer_new_from_str_len(
@@ -277,22 +379,34 @@ soft_reset:
                 mp_obj_t module_fun = mp_compile(&parse_tree,
                                                  MP_QSTR__lt_string_gt_,
                                                  false);
+                t_compiled = esp_timer_get_time();
                 mp_call_function_0(module_fun);
                 nlr_pop();
                 
                 // Send execution success status via MQTT
                 //publish_system_message("{\"msg\":\"Python code executed successfully\"}");
             } else {
+                exc = MP_OBJ_FROM_PTR(nlr.ret_val);
                 printf("Python exception:\n");
-                mp_obj_print_exception(&mp_plat_print, MP_OBJ_FROM_PTR(nlr.ret_val));
+                mp_obj_print_exception(&mp_plat_print, exc);
                 
                 // Send execution error status via MQTT
                // publish_system_message("{\"msg\":\"Python code execution failed\"}");
             }
 
-            if (received_code != NULL) {
-                free(received_code);
-                received_code = NULL;
+            int64_t t_end = esp_timer_get_time();
+            if (t_compiled == 0) {
+                // Failed to compile.
+                profile.compile_us = t_end - t_start;
+            } else {
+                profile.compile_us = t_compiled - t_start;
+                profile.run_us = t_end - t_compiled;
+            }
+            job_profile_end(&profile, exc);
+
+            if (received_job.code != NULL) {
+                free(received_job.code);
+                received_job.code = NULL;
             }
             mp_user_code_finish_execution();
             py_code = "";
@@ -316,6 +430,10 @@ soft_reset_exit:
     #endif
 
     machine_timer_deinit_all();
+    esp32_hbridge_deinit_all();
+
+    // Push any buffered flight-recorder data to flash.
+    esp32_recorder_deinit();
 
     #if MICROPY_PY_THREAD
     mp_thread_deinit();
@@ -12,21 +12,47 @@
 // Task handle for MicroPython main task
 extern TaskHandle_t mp_main_task_handle;
 
+// A queued job is stopped after this long
+#define USER_CODE_TIMEOUT_MS (70000)
+
 // Global queues and streams
 extern QueueHandle_t python_code_queue;
 extern StreamBufferHandle_t mqtt_print_stream;
 
+// An entry in python_code_queue
+typedef struct {
+    char *code;         // malloc'ed, freed by mp_task once run
+    int64_t queued_us;  // esp_timer_get_time() when queued
+} python_job_t;
+
+// Resource accounting for one job from python_code_queue
+typedef struct {
+    uint32_t id;          // execution id, see mp_user_code_get_execution_id()
+    uint32_t code_len;
+    uint32_t queue_us;    // waiting in python_code_queue
+    uint32_t compile_us;  // lexing, parsing and compiling
+    uint32_t run_us;      // running the compiled code
+    uint32_t gc_count;    // garbage collections during the job
+    uint32_t gc_us;       // time spent in those collections
+    uint32_t heap_peak;   // highest GC heap use seen, bytes
+    uint32_t heap_total;
+    uint32_t stack_peak;  // deepest C stack use of mp_task, bytes
+    uint32_t stack_size;
+    uint8_t status;       // PYTHON_JOB_OK etc.
+    char exc[24];         // exception type name, if any
+} python_job_profile_t;
+
+#define PYTHON_JOB_OK        (0)
+#define PYTHON_JOB_EXCEPTION (1)
+#define PYTHON_JOB_MEMORY    (2)
+#define PYTHON_JOB_TIMEOUT   (3)
+
 // Native code management structure
 typedef struct _native_code_node_t {
     struct _native_code_node_t *next;
     uint32_t data[];
 } native_code_node_t;
 
-// ADC measurement flag functions
-bool get_measure_adc_flag(void);
-void set_measure_adc_flag(bool value);
-void clear_measure_adc_flag(void);
-
 // MicroPython task function
 void mp_task(void *pvParameter);
 
@@ -35,6 +61,15 @@ void *esp_native_code_commit(void *buf, size_t len, void *reloc);
 void esp_native_code_free_all(void);
 void  execute_python_code(const char* code);
 
+// Queue malloc'ed code for mp_task, which takes ownership on success
+bool python_code_enqueue(char *code, TickType_t wait);
+
+// Get the profile of the last finished job; true once per new job
+bool python_job_profile_take(python_job_profile_t *profile);
+
+// Format a job profile as a JSON object, returns the length
+int python_job_profile_format_json(const python_job_profile_t *profile, char *buf, size_t buf_size);
+
 // User-code execution guard helpers
 void mp_user_code_guard_task(void *pvParameter);
 bool mp_user_code_is_active(void);
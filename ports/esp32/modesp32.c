@@ -42,6 +42,10 @@
 #include "modmachine.h"
 #include "machine_rtc.h"
 #include "modesp32.h"
+#include "battery_monitor.h"
+#include "system_stats.h"
+#include "shared_fs.h"
+#include "extmod/vfs_lfs.h"
 
 // These private includes are needed for idf_heap_info.
 #define MULTI_HEAP_FREERTOS
@@ -212,6 +216,114 @@ static mp_obj_t esp32_idf_heap_info(const mp_obj_t cap_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(esp32_idf_heap_info_obj, esp32_idf_heap_info);
 
+static mp_obj_t esp32_battery_status(void) {
+    battery_status_t status;
+    if (!battery_monitor_get(&status)) {
+        return mp_const_none;
+    }
+    mp_obj_t data[] = {
+        mp_obj_new_float(status.voltage),
+        mp_obj_new_float(status.charging),
+        mp_obj_new_int_from_uint(status.samples),
+        mp_obj_new_int_from_uint(status.errors),
+    };
+    return mp_obj_new_tuple(4, data);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(esp32_battery_status_obj, esp32_battery_status);
+
+static mp_obj_t system_stats_new_load(uint16_t permille) {
+    return mp_obj_new_float(permille / (mp_float_t)10);
+}
+
+static mp_obj_t system_stats_new_heap(const system_stats_heap_t *heap) {
+    mp_obj_t data[] = {
+        mp_obj_new_int_from_uint(heap->free),
+        mp_obj_new_int_from_uint(heap->largest),
+        mp_obj_new_int_from_uint(heap->min_free),
+    };
+    return mp_obj_new_tuple(3, data);
+}
+
+static mp_obj_t esp32_system_stats(void) {
+    system_stats_t *stats = m_new_obj(system_stats_t);
+    if (!system_stats_read(stats)) {
+        m_del_obj(system_stats_t, stats);
+        return mp_const_none;
+    }
+
+    mp_obj_list_t *task_list = MP_OBJ_TO_PTR(mp_obj_new_list(stats->num_tasks, NULL));
+    for (size_t i = 0; i < stats->num_tasks; i++) {
+        const system_stats_task_t *task = &stats->tasks[i];
+        mp_obj_t task_data[] = {
+            mp_obj_new_str(task->name, strlen(task->name)),
+            MP_OBJ_NEW_SMALL_INT(task->core),
+            MP_OBJ_NEW_SMALL_INT(task->priority),
+            system_stats_new_load(task->load),
+            mp_obj_new_int_from_uint(task->stack_free),
+        };
+        task_list->items[i] = mp_obj_new_tuple(5, task_data);
+    }
+    mp_obj_t core_load[] = {
+        system_stats_new_load(stats->core_load[0]),
+        system_stats_new_load(stats->core_load[1]),
+    };
+    mp_obj_t heaps[] = {
+        system_stats_new_heap(&stats->internal),
+        system_stats_new_heap(&stats->dma),
+        system_stats_new_heap(&stats->spiram),
+    };
+    mp_obj_t gc_data[] = {
+        mp_obj_new_int_from_uint(stats->gc_total),
+        mp_obj_new_int_from_uint(stats->gc_free),
+        mp_obj_new_int_from_uint(stats->gc_largest),
+        mp_obj_new_int_from_uint(stats->gc_count),
+    };
+    mp_obj_t data[] = {
+        mp_obj_new_int_from_uint(stats->uptime_s),
+        mp_obj_new_tuple(2, core_load),
+        MP_OBJ_FROM_PTR(task_list),
+        mp_obj_new_tuple(3, heaps),
+        mp_obj_new_tuple(4, gc_data),
+    };
+    m_del_obj(system_stats_t, stats);
+    return mp_obj_new_tuple(5, data);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(esp32_system_stats_obj, esp32_system_stats);
+
+static mp_obj_t esp32_system_stats_history(void) {
+    system_stats_sample_t *history = m_new(system_stats_sample_t, SYSTEM_STATS_HISTORY_LEN);
+    size_t n = system_stats_history(history, SYSTEM_STATS_HISTORY_LEN);
+    mp_obj_list_t *list = MP_OBJ_TO_PTR(mp_obj_new_list(n, NULL));
+    for (size_t i = 0; i < n; i++) {
+        const system_stats_sample_t *h = &history[i];
+        mp_obj_t data[] = {
+            mp_obj_new_int_from_uint(h->uptime_s),
+            system_stats_new_load(h->core_load[0]),
+            system_stats_new_load(h->core_load[1]),
+            mp_obj_new_int_from_uint(h->heap_free),
+            mp_obj_new_int_from_uint(h->heap_largest),
+            mp_obj_new_int_from_uint(h->gc_free),
+            mp_obj_new_int_from_uint(h->gc_largest),
+            mp_obj_new_int_from_uint(h->mp_stack_free),
+        };
+        list->items[i] = mp_obj_new_tuple(8, data);
+    }
+    m_del(system_stats_sample_t, history, SYSTEM_STATS_HISTORY_LEN);
+    return MP_OBJ_FROM_PTR(list);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(esp32_system_stats_history_obj, esp32_system_stats_history);
+
+static mp_obj_t esp32_shared_fs(void) {
+    MP_THREAD_GIL_EXIT();
+    lfs2_t *lfs = shared_fs_wait();
+    MP_THREAD_GIL_ENTER();
+    if (lfs == NULL) {
+        return mp_const_none;
+    }
+    return mp_vfs_lfs2_adopt(lfs);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(esp32_shared_fs_obj, esp32_shared_fs);
+
 #if CONFIG_FREERTOS_USE_TRACE_FACILITY
 static mp_obj_t esp32_idf_task_info(void) {
     const size_t task_count_max = uxTaskGetNumberOfTasks();
@@ -271,13 +383,21 @@ static const mp_rom_map_elem_t esp32_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_mcu_temperature), MP_ROM_PTR(&esp32_mcu_temperature_obj) },
     #endif
     { MP_ROM_QSTR(MP_QSTR_idf_heap_info), MP_ROM_PTR(&esp32_idf_heap_info_obj) },
+    { MP_ROM_QSTR(MP_QSTR_battery_status), MP_ROM_PTR(&esp32_battery_status_obj) },
+    { MP_ROM_QSTR(MP_QSTR_system_stats), MP_ROM_PTR(&esp32_system_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_system_stats_history), MP_ROM_PTR(&esp32_system_stats_history_obj) },
+    { MP_ROM_QSTR(MP_QSTR_shared_fs), MP_ROM_PTR(&esp32_shared_fs_obj) },
     #if CONFIG_FREERTOS_USE_TRACE_FACILITY
     { MP_ROM_QSTR(MP_QSTR_idf_task_info), MP_ROM_PTR(&esp32_idf_task_info_obj) },
     #endif
 
+    { MP_ROM_QSTR(MP_QSTR_HBridge), MP_ROM_PTR(&esp32_hbridge_type) },
+    { MP_ROM_QSTR(MP_QSTR_I2CSequence), MP_ROM_PTR(&esp32_i2c_sequence_type) },
     { MP_ROM_QSTR(MP_QSTR_NVS), MP_ROM_PTR(&esp32_nvs_type) },
     { MP_ROM_QSTR(MP_QSTR_Partition), MP_ROM_PTR(&esp32_partition_type) },
+    { MP_ROM_QSTR(MP_QSTR_Recorder), MP_ROM_PTR(&esp32_recorder_type) },
     { MP_ROM_QSTR(MP_QSTR_RMT), MP_ROM_PTR(&esp32_rmt_type) },
+    { MP_ROM_QSTR(MP_QSTR_TCS3472), MP_ROM_PTR(&esp32_tcs3472_type) },
     #if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2 || CONFIG_IDF_TARGET_ESP32S3
     { MP_ROM_QSTR(MP_QSTR_ULP), MP_ROM_PTR(&esp32_ulp_type) },
     #endif
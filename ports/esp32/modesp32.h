@@ -61,11 +61,18 @@
 
 extern int8_t esp32_rmt_bitstream_channel_id;
 
+extern const mp_obj_type_t esp32_hbridge_type;
+extern const mp_obj_type_t esp32_i2c_sequence_type;
 extern const mp_obj_type_t esp32_nvs_type;
 extern const mp_obj_type_t esp32_partition_type;
+extern const mp_obj_type_t esp32_recorder_type;
 extern const mp_obj_type_t esp32_rmt_type;
+extern const mp_obj_type_t esp32_tcs3472_type;
 extern const mp_obj_type_t esp32_ulp_type;
 
 esp_err_t rmt_driver_install_core1(uint8_t channel_id);
 
+void esp32_hbridge_deinit_all(void);
+void esp32_recorder_deinit(void);
+
 #endif // MICROPY_INCLUDED_ESP32_MODESP32_H
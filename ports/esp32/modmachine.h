@@ -2,6 +2,7 @@
 #define MICROPY_INCLUDED_ESP32_MODMACHINE_H
 
 #include "py/obj.h"
+#include "driver/i2c.h"
 
 typedef enum {
     // MACHINE_WAKE_IDLE=0x01,
@@ -18,8 +19,37 @@ void machine_deinit(void);
 void machine_pins_init(void);
 void machine_pins_deinit(void);
 void machine_pwm_deinit_all(void);
+void machine_pwm_set_duty_u16_many(size_t n, const mp_obj_t *pwms, const uint32_t *duty_u16, uint32_t fade_ms);
+void machine_pwm_fade_init(void);
+
+// LEDC channel of a PWM object, see machine_pwm_ramp_to_zero().
+typedef struct _machine_pwm_channel_t {
+    int8_t pin;
+    int8_t mode;
+    int8_t channel;
+} machine_pwm_channel_t;
+
+void machine_pwm_get_channel(mp_obj_t pwm, machine_pwm_channel_t *ch);
+void machine_pwm_ramp_to_zero(size_t n, const machine_pwm_channel_t *ch, uint32_t ramp_ms);
 // TODO: void machine_rmt_deinit_all(void);
 void machine_timer_deinit_all(void);
 void machine_i2s_init0();
 
+// Hardware I2C bus manager for native drivers, see machine_i2c.c.
+typedef struct _machine_hw_i2c_txn_t machine_hw_i2c_txn_t;
+struct _machine_hw_i2c_txn_t {
+    i2c_cmd_handle_t cmd;
+    uint32_t timeout_ms;
+    void (*done_cb)(machine_hw_i2c_txn_t *txn);
+    void *arg;
+    volatile esp_err_t err;
+    volatile bool busy;
+};
+
+void machine_hw_i2c_init0(void);
+void machine_hw_i2c_setup(int port, int scl, int sda, uint32_t freq);
+esp_err_t machine_hw_i2c_cmd_begin(int port, i2c_cmd_handle_t cmd, uint32_t timeout_ms);
+esp_err_t machine_hw_i2c_submit(int port, machine_hw_i2c_txn_t *txn);
+int machine_hw_i2c_get_port(mp_obj_t i2c_in);
+
 #endif // MICROPY_INCLUDED_ESP32_MODMACHINE_H
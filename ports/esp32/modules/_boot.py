@@ -1,9 +1,14 @@
 import gc
 import vfs
+from esp32 import shared_fs
 from flashbdev import bdev
 
 try:
-    if bdev:
+    # The firmware mounts the filesystem for its settings; use that mount.
+    fs = shared_fs()
+    if fs:
+        vfs.mount(fs, "/")
+    elif bdev:
         vfs.mount(bdev, "/")
 except OSError:
     import inisetup
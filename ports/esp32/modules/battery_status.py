@@ -1,2 +0,0 @@
-from measure_adc import measure_print
-measure_print()
\ No newline at end of file
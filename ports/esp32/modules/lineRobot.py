@@ -2,7 +2,15 @@ import time
 import math
 import ujson
 import os
-from machine import Pin, PWM, Timer
+from array import array
+from machine import Pin, PWM, Timer, disable_irq, enable_irq
+from esp32 import HBridge
+
+# Step for each (previous << 2 | current) quadrature state transition.
+_QUADRATURE_STEP = {
+    0b1101: 1, 0b0100: 1, 0b0010: 1, 0b1011: 1,
+    0b1110: -1, 0b0111: -1, 0b0001: -1, 0b1000: -1,
+}
 
 class Robot:
     CONFIG_FILE = "settings.json"
@@ -103,10 +111,10 @@ class Robot:
         self.in2 = PWM(Pin(config["pml2"]), freq=1000)
         self.in3 = PWM(Pin(config["pmr1"]), freq=1000)
         self.in4 = PWM(Pin(config["pmr2"]), freq=1000)
-        self.in1.duty(0)
-        self.in2.duty(0)
-        self.in3.duty(0)
-        self.in4.duty(0)
+        # Both H-bridge channels are committed together in one native call
+        self.motors = HBridge((self.in1, self.in2, self.in3, self.in4))
+        self._duty_left = 0
+        self._duty_right = 0
         
         # Encoder pins
         self.encoder_pin_a_left = Pin(config["pel1"], Pin.IN)
@@ -136,81 +144,95 @@ class Robot:
         
     def begin(self):
         """Initialize encoder interrupts"""
-        self.encoder_pin_a_left.irq(trigger=Pin.IRQ_RISING | Pin.IRQ_FALLING, 
-                                   handler=self._update_encoder_left)
-        self.encoder_pin_b_left.irq(trigger=Pin.IRQ_RISING | Pin.IRQ_FALLING, 
-                                   handler=self._update_encoder_left)
-        self.encoder_pin_a_right.irq(trigger=Pin.IRQ_RISING | Pin.IRQ_FALLING, 
-                                    handler=self._update_encoder_right)
-        self.encoder_pin_b_right.irq(trigger=Pin.IRQ_RISING | Pin.IRQ_FALLING, 
-                                    handler=self._update_encoder_right)
-    
+        edges = Pin.IRQ_RISING | Pin.IRQ_FALLING
+        # Edges are recorded in the interrupt and decoded in batches, so bursts
+        # at high speed are not lost when the scheduler queue is full.
+        self.last_encoded_l = self._encoder_state(self.encoder_pin_a_left, self.encoder_pin_b_left)
+        self.last_encoded_r = self._encoder_state(self.encoder_pin_a_right, self.encoder_pin_b_right)
+        # Handlers run one at a time from the scheduler, so they share one pair
+        # of buffers, each holding (ticks_us, level) words for a full ring.
+        self._events_a = array("I", bytes(8 * 32))
+        self._events_b = array("I", bytes(8 * 32))
+        self._irq_a_l = self.encoder_pin_a_left.irq(trigger=edges, handler=self._update_encoder_left, events=32)
+        self._irq_b_l = self.encoder_pin_b_left.irq(trigger=edges, handler=self._update_encoder_left, events=32)
+        self._irq_a_r = self.encoder_pin_a_right.irq(trigger=edges, handler=self._update_encoder_right, events=32)
+        self._irq_b_r = self.encoder_pin_b_right.irq(trigger=edges, handler=self._update_encoder_right, events=32)
+
+    def _encoder_state(self, pin_a, pin_b):
+        return (pin_a.value() << 1) | pin_b.value()
+
+    def _decode_encoder(self, irq_a, irq_b, encoded):
+        """Decode the pending edges of both encoder pins, return (steps, state)"""
+        ev_a = self._events_a
+        ev_b = self._events_b
+        # Drain both rings together, so an edge on one pin can't be taken
+        # while an earlier edge on the other is left for the next call.
+        state = disable_irq()
+        n_a = irq_a.events(ev_a)
+        n_b = irq_b.events(ev_b)
+        enable_irq(state)
+        # Each ring is in time order, so merge them.
+        steps = 0
+        i = j = 0
+        while i < n_a or j < n_b:
+            if j >= n_b or (i < n_a and time.ticks_diff(ev_a[2 * i], ev_b[2 * j]) <= 0):
+                bit = 2
+                level = ev_a[2 * i + 1]
+                i += 1
+            else:
+                bit = 1
+                level = ev_b[2 * j + 1]
+                j += 1
+            new = (encoded | bit) if level else (encoded & ~bit)
+            steps += _QUADRATURE_STEP.get((encoded << 2) | new, 0)
+            encoded = new
+        return steps, encoded
+
     def _update_encoder_left(self, pin):
         """Left encoder interrupt handler"""
-        msb_l = self.encoder_pin_a_left.value()
-        lsb_l = self.encoder_pin_b_left.value()
-        encoded_l = (msb_l << 1) | lsb_l
-        sum_l = (self.last_encoded_l << 2) | encoded_l
-        
-        if sum_l in [0b1101, 0b0100, 0b0010, 0b1011]:
-            self.encoder_position_left += 1
-        elif sum_l in [0b1110, 0b0111, 0b0001, 0b1000]:
-            self.encoder_position_left -= 1
-            
-        self.last_encoded_l = encoded_l
-    
+        steps, self.last_encoded_l = self._decode_encoder(
+            self._irq_a_l, self._irq_b_l, self.last_encoded_l
+        )
+        self.encoder_position_left += steps
+
     def _update_encoder_right(self, pin):
         """Right encoder interrupt handler"""
-        msb_r = self.encoder_pin_a_right.value()
-        lsb_r = self.encoder_pin_b_right.value()
-        encoded_r = (msb_r << 1) | lsb_r
-        sum_r = (self.last_encoded_r << 2) | encoded_r
-        
-        if sum_r in [0b1101, 0b0100, 0b0010, 0b1011]:
-            self.encoder_position_right -= 1
-        elif sum_r in [0b1110, 0b0111, 0b0001, 0b1000]:
-            self.encoder_position_right += 1
-            
-        self.last_encoded_r = encoded_r
-    
+        steps, self.last_encoded_r = self._decode_encoder(
+            self._irq_a_r, self._irq_b_r, self.last_encoded_r
+        )
+        self.encoder_position_right -= steps
+
     def constrain(self, value, min_val, max_val):
         """Constrain value between min and max"""
         return max(min_val, min(max_val, value))
     
+    def run_motors(self, u_left, u_right):
+        """Run both motors with PWM values (-1023 to 1023) in one update"""
+        self._duty_left = self.constrain(u_left, -1000, 1000)
+        self._duty_right = self.constrain(u_right, -1000, 1000)
+        self.motors.duty(self._duty_left, self._duty_right)
+
     def run_motor_left(self, u):
         """Run left motor with PWM value u (-1023 to 1023)"""
-        u = self.constrain(u, -1000, 1000)
-        if u < 0:
-            self.in1.duty(0)
-            self.in2.duty(-u)
-        else:
-            self.in1.duty(u)
-            self.in2.duty(0)
+        self.run_motors(u, self._duty_right)
     
     def run_motor_right(self, u):
         """Run right motor with PWM value u (-1023 to 1023)"""
-        u = self.constrain(u, -1000, 1000)
-        if u < 0:
-            self.in3.duty(0)
-            self.in4.duty(-u)
-        else:
-            self.in3.duty(u)
-            self.in4.duty(0)
+        self.run_motors(self._duty_left, u)
     
     def stop_motor_left(self):
         """Stop left motor"""
-        self.in1.duty(0)
-        self.in2.duty(0)
+        self.run_motors(0, self._duty_right)
     
     def stop_motor_right(self):
         """Stop right motor"""
-        self.in3.duty(0)
-        self.in4.duty(0)
+        self.run_motors(self._duty_left, 0)
     
     def stop(self):
         """Stop both motors"""
-        self.stop_motor_left()
-        self.stop_motor_right()
+        self._duty_left = 0
+        self._duty_right = 0
+        self.motors.stop()
         self.left_motor_signal = 0
         self.right_motor_signal = 0
         self.reset_regulators()
@@ -349,8 +371,7 @@ class Robot:
                                        self.ki_speed, self.integral_speed_right, 
                                        self.previous_err_speed_right, self.last_time_right_speed)
         
-        self.run_motor_left(self.left_motor_signal)
-        self.run_motor_right(self.right_motor_signal)
+        self.run_motors(self.left_motor_signal, self.right_motor_signal)
     
     def reset_regulators(self):
         """Reset PID controllers"""
@@ -1,14 +1,10 @@
 
-from machine import I2C, Pin
-from ads1x15 import ADS1115
+import esp32
 
+# The firmware samples the ADS1115 continuously in the background (see
+# battery_monitor.c), so read the averaged values instead of touching the bus.
 def measure():
-   i2c=I2C(0, scl=Pin(22), sda=Pin(21))
-   adc = ADS1115(i2c, address=72, gain=1)
-   value = adc.read(0, 0)*4.096/(32768>>0)*10
-   value1 = adc.read(0,1)*4.096/(32768>>0)*10
-   return value, value1
-   
-def measure_print():
-   v1, v2 = measure()
-   print(f'SYS{{"voltage": {v1}, "charging": {v2}}}')
+   status = esp32.battery_status()
+   if status is None:
+      return None, None
+   return status[0], status[1]
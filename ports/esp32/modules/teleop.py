@@ -0,0 +1,169 @@
+# Direct teleoperation over UDP, bypassing the MQTT broker.
+#
+# A client on the same network sends small binary frames straight to the
+# robot; each frame carries a duty pair for the two motors, a sequence number
+# and a time-to-live.  Frames that arrive out of order or later than their
+# time-to-live are dropped, and every frame is answered with an ack so the
+# client can measure the round trip.  See ../docs/teleop.md for the frame
+# layout and ../tools/teleop_client.py for a client.
+
+import select
+import socket
+import struct
+import time
+
+PORT = 4210
+
+# Command frame: magic, version, flags, seq, left, right, sent_ms, ttl_ms.
+FRAME = "<2sBBIhhIH"
+FRAME_SIZE = struct.calcsize(FRAME)
+MAGIC = b"TO"
+VERSION = 1
+FLAG_STOP = 0x01  # stop the motors, ignore the duty pair
+FLAG_SYNC = 0x02  # first frame of a session: reset sequence and clock tracking
+
+# Ack frame: magic, version, status, seq, echoed sent_ms, robot lateness in ms.
+ACK = "<2sBBIIH"
+ACK_MAGIC = b"TA"
+APPLIED = 0
+LATE = 1
+STALE = 2  # duplicate or out of order
+
+# The one-way delay baseline is the smallest delay seen in a window, so it
+# follows clock drift between client and robot.
+_BASELINE_WINDOW_MS = 5000
+
+
+class Teleop:
+    def __init__(self, robot, *, port=PORT, hold_ms=250):
+        self.robot = robot
+        self.port = port
+        self.hold_ms = hold_ms
+        self.received = 0
+        self.applied = 0
+        self.late = 0
+        self.stale = 0
+        self.bad = 0
+        self._sock = None
+        self._seq = None
+        self._base = None
+        self._win_min = None
+        self._win_start = 0
+        self._now = 0
+        self._last_ticks = time.ticks_ms()
+        self._last_applied = 0
+        self._driving = False
+
+    def _clock(self):
+        # ticks_ms() wraps at a port-specific period; keep a monotonic count.
+        t = time.ticks_ms()
+        self._now += time.ticks_diff(t, self._last_ticks)
+        self._last_ticks = t
+        return self._now
+
+    def _lateness(self, now, sent_ms):
+        # One-way delay relative to the best seen, client and robot clocks
+        # need no synchronisation.
+        delay = (now - sent_ms) & 0xFFFFFFFF
+        if delay & 0x80000000:
+            delay -= 0x100000000
+        if self._base is None or delay < self._base:
+            self._base = delay
+        if self._win_min is None or delay < self._win_min:
+            self._win_min = delay
+        if now - self._win_start >= _BASELINE_WINDOW_MS:
+            self._base = self._win_min
+            self._win_min = None
+            self._win_start = now
+        return delay - self._base
+
+    def handle(self, data, now):
+        # Returns (status, seq, sent_ms, lateness) or None for a bad frame.
+        if len(data) != FRAME_SIZE:
+            self.bad += 1
+            return None
+        magic, version, flags, seq, left, right, sent_ms, ttl_ms = struct.unpack(FRAME, data)
+        if magic != MAGIC or version != VERSION:
+            self.bad += 1
+            return None
+        self.received += 1
+        if flags & FLAG_SYNC:
+            self._seq = None
+            self._base = None
+            self._win_min = None
+            self._win_start = now
+        if self._seq is not None and (seq - self._seq) & 0xFFFFFFFF >= 0x80000000 or seq == self._seq:
+            self.stale += 1
+            return STALE, seq, sent_ms, 0
+        self._seq = seq
+        lateness = self._lateness(now, sent_ms)
+        if lateness > ttl_ms:
+            self.late += 1
+            return LATE, seq, sent_ms, lateness
+        if flags & FLAG_STOP:
+            self.robot.stop()
+            self._driving = False
+        else:
+            self.robot.run_motors(left, right)
+            self._driving = True
+        self._last_applied = now
+        self.applied += 1
+        return APPLIED, seq, sent_ms, lateness
+
+    def serve(self, duration_ms=60000, idle_ms=10000):
+        """Drive the robot from UDP frames until duration_ms passes, or no
+        frame has arrived for idle_ms."""
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        sock.bind(socket.getaddrinfo("0.0.0.0", self.port)[0][-1])
+        poller = select.poll()
+        poller.register(sock, select.POLLIN)
+        self._sock = sock
+
+        # The motor watchdog stops the robot even if this loop stalls.
+        self.robot.motors.watchdog(self.hold_ms)
+        start = last_rx = self._clock()
+        ack = bytearray(struct.calcsize(ACK))
+        print("teleop: listening on UDP port", self.port)
+        try:
+            while True:
+                now = self._clock()
+                if now - start >= duration_ms or now - last_rx >= idle_ms:
+                    break
+                if self._driving and now - self._last_applied >= self.hold_ms:
+                    # No fresh command: don't keep driving on an old one.
+                    self.robot.stop()
+                    self._driving = False
+                if not poller.poll(0):
+                    time.sleep_ms(1)
+                    continue
+                data, addr = sock.recvfrom(64)
+                last_rx = now
+                result = self.handle(data, now)
+                if result is not None:
+                    status, seq, sent_ms, lateness = result
+                    struct.pack_into(ACK, ack, 0, ACK_MAGIC, VERSION, status, seq, sent_ms, min(max(lateness, 0), 0xFFFF))
+                    sock.sendto(ack, addr)
+        finally:
+            self.robot.stop()
+            self.robot.motors.watchdog(0)
+            sock.close()
+            self._sock = None
+        print("teleop:", self.stats())
+
+    def stats(self):
+        return {
+            "received": self.received,
+            "applied": self.applied,
+            "late": self.late,
+            "stale": self.stale,
+            "bad": self.bad,
+        }
+
+
+def serve(port=PORT, duration_ms=60000, idle_ms=10000, hold_ms=250):
+    from lineRobot import Robot
+
+    t = Teleop(Robot(), port=port, hold_ms=hold_ms)
+    t.serve(duration_ms, idle_ms)
+    return t.stats()
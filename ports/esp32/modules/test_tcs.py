@@ -1,12 +1,16 @@
 import machine
-from tcs3472 import tcs3472
+import esp32
+from array import array
 import time
 
 def test():
     bus = machine.I2C(sda=machine.Pin(21), scl=machine.Pin(22)) # adjust pin numbers as per hardware
-    tcs = tcs3472(bus)
+    tcs = esp32.TCS3472(bus)
+    crgb = array("H", [0, 0, 0, 0])
 
     for i in range(100):
-       print("Light:", tcs.light())
-       print("RGB:", tcs.rgb())
+       tcs.read(crgb)
+       print("Light:", crgb[0])
+       c = crgb[0] or 1
+       print("RGB:", tuple(int(x * 255 / c) for x in crgb[1:]))
        time.sleep(1)
@@ -53,6 +53,7 @@
 #endif
 #else
 #define MICROPY_EMIT_XTENSAWIN              (1)
+#define MICROPY_EMIT_INLINE_XTENSA          (1)
 #endif
 
 // optimisations
@@ -76,6 +77,7 @@
 #define MICROPY_SCHEDULER_DEPTH             (8)
 #define MICROPY_VFS                         (1)
 #define MICROPY_VFS_SPIFFS         (1)
+#define MICROPY_VFS_LFS2_ADOPT              (1)
 
 // control over Python builtins
 #define MICROPY_PY_STR_BYTES_CMP_WARN       (1)
@@ -91,6 +93,14 @@
 
 #define MICROPY_GC_SPLIT_HEAP               (1)
 #define MICROPY_GC_SPLIT_HEAP_AUTO          (1)
+// Built in but off until enabled with gc.incremental(budget_us), as C code
+// outside py/ and extmod/ doesn't use the write barriers yet.
+#define MICROPY_GC_INCREMENTAL              (1)
+#define MICROPY_GC_INCREMENTAL_BUDGET_US    (0)
+// Leave the sweep to the allocator, the full sweep of a PSRAM heap is long.
+#define MICROPY_GC_LAZY_SWEEP               (1)
+// Allocate heap blocks for floats a batch at a time.
+#define MICROPY_FLOAT_FREELIST              (32)
 
 // extended modules
 #ifndef MICROPY_PY_ESPNOW
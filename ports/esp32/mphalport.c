@@ -35,6 +35,7 @@
 #include "esp_timer.h"
 
 #include "py/obj.h"
+#include "py/gc.h"
 #include "py/objstr.h"
 #include "py/stream.h"
 #include "py/mpstate.h"
@@ -196,6 +197,10 @@ void mp_hal_delay_ms(uint32_t ms) {
     uint64_t us = (uint64_t)ms * 1000ULL;
     uint64_t dt;
     uint64_t t0 = esp_timer_get_time();
+    #if MICROPY_GC_INCREMENTAL
+    // spend some of the wait on the incremental GC
+    gc_incremental_idle(MIN(us, (mp_uint_t)-1));
+    #endif
     for (;;) {
         mp_handle_pending(true);
         MICROPY_PY_SOCKET_EVENTS_HANDLER
@@ -1,6 +1,12 @@
 #include "mqtt_handler.h"
 #include "settings_manager.h"
 #include "uart_handler.h"
+#include "battery_monitor.h"
+#include "system_stats.h"
+#include "wifi_cache.h"
+#include "boot_profile.h"
+#include "file_transfer.h"
+#include "micropython_task.h"
 #include "esp_http_client.h"
 #include "esp_ota_ops.h"
 #include "esp_task_wdt.h"
@@ -51,6 +57,8 @@
 static char MQTT_SYSTEM_INPUT_TOPIC[MAX_STR_LEN*2];
 static char MQTT_SYSTEM_OUTPUT_TOPIC[MAX_STR_LEN*2];
 static char MQTT_PYTHON_OUTPUT_TOPIC[MAX_STR_LEN*2];
+static char MQTT_FILE_INPUT_TOPIC[MAX_STR_LEN*2];
+static char MQTT_FILE_OUTPUT_TOPIC[MAX_STR_LEN*2];
 
 // WiFi and MQTT variables
 static EventGroupHandle_t s_wifi_event_group;
@@ -86,6 +94,25 @@ static char s_mqtt_username[MAX_STR_LEN] = {0};
 static char s_mqtt_password[MAX_STR_LEN] = {0};
 static char s_client_id[MAX_STR_LEN] = {0};
 
+// Fast connect: the first attempt goes straight to the AP cached from the
+// last good connection, see wifi_cache.c.  The DHCP client asks for the
+// previous lease itself (CONFIG_LWIP_DHCP_RESTORE_LAST_IP), or a static
+// address from the settings skips DHCP altogether.
+static esp_netif_t *s_sta_netif = NULL;
+// The event handler and mqtt_task both update s_wifi_config and the cache
+// below, so they're accessed with s_wifi_lock held.
+static portMUX_TYPE s_wifi_lock = portMUX_INITIALIZER_UNLOCKED;
+static wifi_config_t s_wifi_config;
+static wifi_cache_t s_wifi_cache;
+static bool s_wifi_cache_valid = false;
+static bool s_wifi_cache_dirty = false;  // new AP to store, done by mqtt_task
+static bool s_wifi_fast_connect = true;
+static bool s_wifi_fast_path = false;    // the current attempt targets the cached AP
+static bool s_static_ip_valid = false;
+static esp_netif_ip_info_t s_static_ip;
+static esp_netif_dns_info_t s_static_dns;
+static bool s_boot_fast_path = false;     // the first IP came from the cached AP
+
 static uint32_t elapsed_ms_since(TickType_t from_tick) {
     return (uint32_t)(pdTICKS_TO_MS(xTaskGetTickCount() - from_tick));
 }
@@ -299,10 +326,8 @@ static void restart_mqtt_client(void)
     ESP_LOGI(TAG, "MQTT client restarted");
 }
 
-// External flag for ADC measurement
-extern bool get_measure_adc_flag(void);
-extern void set_measure_adc_flag(bool value);
-
+// Periodic battery telemetry, interval from the "battery_telemetry_ms" setting
+#define BATTERY_TELEMETRY_DEFAULT_MS 60000
 
 
 // OTA status variables
@@ -441,6 +466,13 @@ static void stop_motors_for_reset(void) {
     machine_pwm_deinit_all();
 }
 
+static bool publish_file_frame(const uint8_t *frame, size_t len, void *ctx) {
+    // QoS 0 so a long download doesn't pile up in the outbox; frames carry
+    // their own CRC and the final reply the SHA-256, a lost one is re-fetched.
+    esp_mqtt_client_handle_t client = ctx;
+    return esp_mqtt_client_publish(client, MQTT_FILE_OUTPUT_TOPIC, (const char *)frame, len, 0, 0) >= 0;
+}
+
 static void process_system_input_message(esp_mqtt_client_handle_t client, const char *data, int data_len) {
     if (!data || data_len <= 0) {
         ESP_LOGW(TAG, "Empty MQTT payload on system input topic");
@@ -468,7 +500,7 @@ static void process_system_input_message(esp_mqtt_client_handle_t client, const
             if (cJSON_IsString(value) && (value->valuestring != NULL)) {
                 char *code_copy = strdup(value->valuestring);
                 if (code_copy != NULL) {
-                    if (xQueueSend(python_code_queue, &code_copy, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                    if (!python_code_enqueue(code_copy, pdMS_TO_TICKS(1000))) {
                         ESP_LOGE(TAG, "Failed to send Python code to queue");
                         free(code_copy);
                     } else {
@@ -585,7 +617,7 @@ static void process_system_input_message(esp_mqtt_client_handle_t client, const
         else if (strcmp(command->valuestring, "test-movement") == 0) {
             char *code = strdup("from test_robot_lib import test\ntest()");
             if (code != NULL) {
-                if (xQueueSend(python_code_queue, &code, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                if (!python_code_enqueue(code, pdMS_TO_TICKS(1000))) {
                     ESP_LOGE(TAG, "Failed to send Python code to queue");
                     free(code);
                 } else {
@@ -596,7 +628,7 @@ static void process_system_input_message(esp_mqtt_client_handle_t client, const
         else if (strcmp(command->valuestring, "test-line-sensor") == 0) {
             char *code = strdup("from test_octoliner import test\ntest()");
             if (code != NULL) {
-                if (xQueueSend(python_code_queue, &code, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                if (!python_code_enqueue(code, pdMS_TO_TICKS(1000))) {
                     ESP_LOGE(TAG, "Failed to send Python code to queue");
                     free(code);
                 } else {
@@ -607,7 +639,7 @@ static void process_system_input_message(esp_mqtt_client_handle_t client, const
         else if (strcmp(command->valuestring, "test-color-sensor") == 0) {
             char *code = strdup("from test_tcs import test\ntest()");
             if (code != NULL) {
-                if (xQueueSend(python_code_queue, &code, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                if (!python_code_enqueue(code, pdMS_TO_TICKS(1000))) {
                     ESP_LOGE(TAG, "Failed to send Python code to queue");
                     free(code);
                 } else {
@@ -618,7 +650,7 @@ static void process_system_input_message(esp_mqtt_client_handle_t client, const
         else if (strcmp(command->valuestring, "test-scan-i2c") == 0) {
             char *code = strdup("from scan import scan\nscan()");
             if (code != NULL) {
-                if (xQueueSend(python_code_queue, &code, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                if (!python_code_enqueue(code, pdMS_TO_TICKS(1000))) {
                     ESP_LOGE(TAG, "Failed to send Python code to queue");
                     free(code);
                 } else {
@@ -626,8 +658,103 @@ static void process_system_input_message(esp_mqtt_client_handle_t client, const
                 }
             }
         }
+        else if (strcmp(command->valuestring, "teleop") == 0) {
+            // Direct UDP control, see docs/teleop.md. The session is a
+            // Python job, so it must end before the user code timeout.
+            cJSON *port = cJSON_GetObjectItemCaseSensitive(json, "port");
+            cJSON *duration = cJSON_GetObjectItemCaseSensitive(json, "duration");
+            int port_value = cJSON_IsNumber(port) ? port->valueint : 4210;
+            int duration_ms = cJSON_IsNumber(duration) ? duration->valueint : 60000;
+            if (duration_ms <= 0 || duration_ms > USER_CODE_TIMEOUT_MS - 5000) {
+                duration_ms = USER_CODE_TIMEOUT_MS - 5000;
+            }
+
+            char code[96];
+            snprintf(code, sizeof(code), "from teleop import serve\nserve(%d, %d)", port_value, duration_ms);
+            char *job = strdup(code);
+            if (job != NULL) {
+                if (!python_code_enqueue(job, pdMS_TO_TICKS(1000))) {
+                    ESP_LOGE(TAG, "Failed to send teleop code to queue");
+                    free(job);
+                    esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC,
+                                           "{\"status\":\"error\",\"message\":\"Failed to queue teleop\"}", 0, 1, 0);
+                } else {
+                    ESP_LOGI(TAG, "Teleop queued on UDP port %d for %d ms", port_value, duration_ms);
+                    esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC,
+                                           "{\"status\":\"queued\",\"message\":\"Teleop started\"}", 0, 1, 0);
+                }
+            }
+        }
+        else if (strcmp(command->valuestring, "file-put") == 0) {
+            // Chunks follow on the file input topic, see docs/file-transfer.md
+            cJSON *path = cJSON_GetObjectItemCaseSensitive(json, "path");
+            cJSON *size = cJSON_GetObjectItemCaseSensitive(json, "size");
+            cJSON *sha256 = cJSON_GetObjectItemCaseSensitive(json, "sha256");
+            cJSON *chunk = cJSON_GetObjectItemCaseSensitive(json, "chunk");
+            char reply[FILE_TRANSFER_REPLY_SIZE];
+            if (!cJSON_IsNumber(size) || size->valuedouble < 0) {
+                snprintf(reply, sizeof(reply), "{\"type\":\"file-put\",\"status\":\"error\",\"message\":\"bad size\"}");
+            } else {
+                file_transfer_put_begin(cJSON_GetStringValue(path), (uint32_t)size->valuedouble,
+                    cJSON_GetStringValue(sha256), cJSON_IsNumber(chunk) ? chunk->valueint : 0,
+                    reply, sizeof(reply));
+            }
+            esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC, reply, 0, 1, 0);
+        }
+        else if (strcmp(command->valuestring, "file-get") == 0) {
+            cJSON *path = cJSON_GetObjectItemCaseSensitive(json, "path");
+            cJSON *offset = cJSON_GetObjectItemCaseSensitive(json, "offset");
+            cJSON *length = cJSON_GetObjectItemCaseSensitive(json, "length");
+            cJSON *chunk = cJSON_GetObjectItemCaseSensitive(json, "chunk");
+            char reply[FILE_TRANSFER_REPLY_SIZE];
+            file_transfer_get(cJSON_GetStringValue(path),
+                cJSON_IsNumber(offset) ? (uint32_t)offset->valuedouble : 0,
+                cJSON_IsNumber(length) ? (uint32_t)length->valuedouble : 0,
+                cJSON_IsNumber(chunk) ? chunk->valueint : 0,
+                publish_file_frame, client, reply, sizeof(reply));
+            esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC, reply, 0, 1, 0);
+        }
+        else if (strcmp(command->valuestring, "run") == 0) {
+            cJSON *path = cJSON_GetObjectItemCaseSensitive(json, "path");
+            char code[FILE_TRANSFER_PATH_MAX * 2 + 64];
+            if (file_transfer_run_code(cJSON_GetStringValue(path), code, sizeof(code)) < 0) {
+                esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC,
+                                       "{\"status\":\"error\",\"message\":\"Bad path\"}", 0, 1, 0);
+            } else {
+                char *job = strdup(code);
+                if (job != NULL) {
+                    if (!python_code_enqueue(job, pdMS_TO_TICKS(1000))) {
+                        ESP_LOGE(TAG, "Failed to send run code to queue");
+                        free(job);
+                        esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC,
+                                               "{\"status\":\"error\",\"message\":\"Failed to queue run\"}", 0, 1, 0);
+                    } else {
+                        ESP_LOGI(TAG, "Queued run of %s", path->valuestring);
+                        esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC,
+                                               "{\"status\":\"queued\",\"message\":\"Run started\"}", 0, 1, 0);
+                    }
+                }
+            }
+        }
         else if (strcmp(command->valuestring, "battery-status") == 0) {
-            set_measure_adc_flag(true);
+            char status[128];
+            battery_monitor_format_json(status, sizeof(status));
+            esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC, status, 0, 1, 0);
+        }
+        else if (strcmp(command->valuestring, "stats") == 0) {
+            cJSON *history = cJSON_GetObjectItemCaseSensitive(json, "history");
+            bool want_history = cJSON_IsTrue(history);
+            size_t size = want_history ? SYSTEM_STATS_HISTORY_JSON_SIZE : SYSTEM_STATS_JSON_SIZE;
+            char *stats = malloc(size);
+            if (stats != NULL) {
+                if (want_history) {
+                    system_stats_format_history_json(stats, size);
+                } else {
+                    system_stats_format_json(stats, size);
+                }
+                esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC, stats, 0, 1, 0);
+                free(stats);
+            }
         }
         else if (strcmp(command->valuestring, "auto-calibrate") == 0) {
             cJSON *mode = cJSON_GetObjectItemCaseSensitive(json, "mode");
@@ -644,7 +771,7 @@ static void process_system_input_message(esp_mqtt_client_handle_t client, const
             }
 
             if (code != NULL) {
-                if (xQueueSend(python_code_queue, &code, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                if (!python_code_enqueue(code, pdMS_TO_TICKS(1000))) {
                     ESP_LOGE(TAG, "Failed to send calibration code to queue");
                     free(code);
                     esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC,
@@ -686,6 +813,14 @@ static void process_incoming_mqtt_message(esp_mqtt_client_handle_t client, const
         return;
     }
 
+    if (topic_matches(topic, topic_len, MQTT_FILE_INPUT_TOPIC)) {
+        // Binary, not worth printing
+        char reply[FILE_TRANSFER_REPLY_SIZE];
+        file_transfer_put_chunk((const uint8_t *)data, data_len, reply, sizeof(reply));
+        esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC, reply, 0, 1, 0);
+        return;
+    }
+
     printf("TOPIC=%.*s\r\n", topic_len, topic);
     printf("DATA=%.*s\r\n", data_len, data);
 
@@ -1002,6 +1137,56 @@ static void ota_task(void *pvParameter)
     vTaskDelete(NULL);
 }
 
+// Point the next connect at the cached AP, or scan for the SSID.
+static void wifi_select_ap(bool fast)
+{
+    wifi_config_t config;
+    portENTER_CRITICAL(&s_wifi_lock);
+    s_wifi_fast_path = fast && s_wifi_fast_connect && s_wifi_cache_valid;
+    if (s_wifi_fast_path) {
+        memcpy(s_wifi_config.sta.bssid, s_wifi_cache.bssid, sizeof(s_wifi_config.sta.bssid));
+        s_wifi_config.sta.bssid_set = true;
+        s_wifi_config.sta.channel = s_wifi_cache.channel;
+    } else {
+        s_wifi_config.sta.bssid_set = false;
+        s_wifi_config.sta.channel = 0;
+    }
+    config = s_wifi_config;
+    portEXIT_CRITICAL(&s_wifi_lock);
+    esp_wifi_set_config(WIFI_IF_STA, &config);
+}
+
+static void load_static_ip(void)
+{
+    char ip[MAX_STR_LEN] = {0};
+    char gw[MAX_STR_LEN] = {0};
+    char netmask[MAX_STR_LEN] = {0};
+    char dns[MAX_STR_LEN] = {0};
+
+    if (get_string_setting("static_ip", ip, sizeof(ip)) != ESP_OK || ip[0] == '\0') {
+        return;
+    }
+    get_string_setting("static_gateway", gw, sizeof(gw));
+    if (get_string_setting("static_netmask", netmask, sizeof(netmask)) != ESP_OK || netmask[0] == '\0') {
+        strcpy(netmask, "255.255.255.0");
+    }
+    get_string_setting("static_dns", dns, sizeof(dns));
+
+    memset(&s_static_ip, 0, sizeof(s_static_ip));
+    memset(&s_static_dns, 0, sizeof(s_static_dns));
+    if (esp_netif_str_to_ip4(ip, &s_static_ip.ip) != ESP_OK
+        || esp_netif_str_to_ip4(netmask, &s_static_ip.netmask) != ESP_OK
+        || (gw[0] != '\0' && esp_netif_str_to_ip4(gw, &s_static_ip.gw) != ESP_OK)) {
+        ESP_LOGE(TAG, "Invalid static IP settings, using DHCP");
+        return;
+    }
+    if (dns[0] != '\0' && esp_netif_str_to_ip4(dns, &s_static_dns.ip.u_addr.ip4) == ESP_OK) {
+        s_static_dns.ip.type = ESP_IPADDR_TYPE_V4;
+    }
+    s_static_ip_valid = true;
+    ESP_LOGI(TAG, "Static IP " IPSTR, IP2STR(&s_static_ip.ip));
+}
+
 // WiFi event handler
 static void wifi_event_handler(void *arg, esp_event_base_t event_base,
                               int32_t event_id, void *event_data)
@@ -1029,8 +1214,17 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
         s_recovery.wifi_connected = false;
         s_recovery.mqtt_connected = false;
         esp_wifi_connect();
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        if (s_static_ip_valid) {
+            esp_netif_dhcpc_stop(s_sta_netif);
+            esp_netif_set_ip_info(s_sta_netif, &s_static_ip);
+            if (s_static_dns.ip.type == ESP_IPADDR_TYPE_V4) {
+                esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &s_static_dns);
+            }
+        }
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
         wifi_event_sta_disconnected_t *disconn = (wifi_event_sta_disconnected_t *)event_data;
+        bool was_connected = s_recovery.wifi_connected;
         s_recovery.wifi_connected = false;
         s_recovery.mqtt_connected = false;
         s_recovery.last_wifi_disconnect_tick = now;
@@ -1041,6 +1235,19 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
         recovery_note_degradation(1);
         xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
 
+        if (s_wifi_fast_path && !was_connected) {
+            // The cached AP is gone or moved: scan right away rather than
+            // waiting for the backoff, this is still the first attempt.
+            ESP_LOGW(TAG, "Fast connect to cached AP failed, reason=%d; scanning",
+                     disconn ? disconn->reason : -1);
+            wifi_select_ap(false);
+            esp_wifi_connect();
+            s_recovery.next_wifi_reconnect_tick = now + backoff_to_ticks(WIFI_RECONNECT_BACKOFF_MS[0]);
+            return;
+        }
+        // A connection that was up is most likely back on the same AP.
+        wifi_select_ap(was_connected);
+
         uint32_t idx = s_recovery.wifi_reconnect_attempt;
         if (idx >= WIFI_RECONNECT_BACKOFF_STEPS) {
             idx = WIFI_RECONNECT_BACKOFF_STEPS - 1;
@@ -1069,6 +1276,23 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
         s_recovery.wifi_reconnect_attempt = 0;
         s_recovery.next_wifi_reconnect_tick = now;
         s_recovery.recovery_guard = false;
+
+        wifi_ap_record_t ap;
+        if (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) {
+            portENTER_CRITICAL(&s_wifi_lock);
+            if (!s_wifi_cache_valid || ap.primary != s_wifi_cache.channel
+                || memcmp(ap.bssid, s_wifi_cache.bssid, sizeof(ap.bssid)) != 0) {
+                memcpy(s_wifi_cache.bssid, ap.bssid, sizeof(s_wifi_cache.bssid));
+                s_wifi_cache.channel = ap.primary;
+                s_wifi_cache_valid = true;
+                s_wifi_cache_dirty = true;
+            }
+            portEXIT_CRITICAL(&s_wifi_lock);
+        }
+        if (boot_profile_get_ms(BOOT_PHASE_GOT_IP) == 0) {
+            s_boot_fast_path = s_wifi_fast_path;
+            boot_profile_mark(BOOT_PHASE_GOT_IP);
+        }
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
     }
 }
@@ -1088,14 +1312,21 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         s_recovery.mqtt_connected_since_ms = monotonic_ms();
         s_recovery.last_mqtt_disconnect_tick = xTaskGetTickCount();
         s_recovery.recovery_guard = false;
+        boot_profile_mark(BOOT_PHASE_MQTT);
 
         // Subscribe to topic
         msg_id = esp_mqtt_client_subscribe(client, MQTT_SYSTEM_INPUT_TOPIC, 1);
         ESP_LOGI(TAG, "sent subscribe to command topic, msg_id=%d", msg_id);
+        msg_id = esp_mqtt_client_subscribe(client, MQTT_FILE_INPUT_TOPIC, 1);
+        ESP_LOGI(TAG, "sent subscribe to file topic, msg_id=%d", msg_id);
         
         // Publish status
-        char response[64];
-        snprintf(response, sizeof(response), "{\"type\":\"hello\", \"msg\":\"calib-fw 07.04.2026\"}");
+        char boot[160];
+        char response[256];
+        boot_profile_format_json(boot, sizeof(boot));
+        snprintf(response, sizeof(response),
+                 "{\"type\":\"hello\", \"msg\":\"calib-fw 07.04.2026\", \"boot\":%s, \"fast\":%s}",
+                 boot, s_boot_fast_path ? "true" : "false");
         msg_id = esp_mqtt_client_publish(client, MQTT_SYSTEM_OUTPUT_TOPIC, response, 0, 1, 0);
         ESP_LOGI(TAG, "sent status publish, msg_id=%d", msg_id);
         break;
@@ -1232,7 +1463,7 @@ static void wifi_init_sta()
 
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
+    s_sta_netif = esp_netif_create_default_wifi_sta();
 
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
@@ -1249,6 +1480,11 @@ static void wifi_init_sta()
                     &wifi_event_handler,
                     NULL,
                     &instance_got_ip));
+    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
+
+    // Everything above is independent of the settings, which may still be
+    // loading.
+    settings_wait_ready();
 
     char wssid[MAX_STR_LEN];
     char wpass[MAX_STR_LEN];
@@ -1256,21 +1492,23 @@ static void wifi_init_sta()
     get_string_setting("wifi_ssid", wssid, sizeof(wssid));
     get_string_setting("wifi_pass", wpass, sizeof(wpass));
 
-    wifi_config_t wifi_config = {
-       .sta = {
-           .threshold = {
-               .authmode = WIFI_AUTH_WPA2_PSK
-           },
-       },
-    };
+    memset(&s_wifi_config, 0, sizeof(s_wifi_config));
+    s_wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
 
     // Copy the strings into the wifi_config structure
-    strncpy((char*)wifi_config.sta.ssid, wssid, sizeof(wifi_config.sta.ssid));
-    strncpy((char*)wifi_config.sta.password, wpass, sizeof(wifi_config.sta.password));
-    
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+    strncpy((char*)s_wifi_config.sta.ssid, wssid, sizeof(s_wifi_config.sta.ssid));
+    strncpy((char*)s_wifi_config.sta.password, wpass, sizeof(s_wifi_config.sta.password));
+
+    s_wifi_fast_connect = get_int_setting("wifi_fast_connect", 1) != 0;
+    s_wifi_cache_valid = wifi_cache_load(wssid, &s_wifi_cache);
+    load_static_ip();
+
+    wifi_select_ap(true);
+    if (s_wifi_fast_path) {
+        ESP_LOGI(TAG, "Connecting to cached AP on channel %u", s_wifi_cache.channel);
+    }
     ESP_ERROR_CHECK(esp_wifi_start());
+    boot_profile_mark(BOOT_PHASE_WIFI_START);
 
     ESP_LOGI(TAG, "wifi_init_sta finished.");
 
@@ -1332,6 +1570,8 @@ void mqtt_task(void *pvParameter) {
     snprintf(MQTT_PYTHON_OUTPUT_TOPIC, MAX_STR_LEN*2, "%s/output", topic_python);
     snprintf(MQTT_SYSTEM_OUTPUT_TOPIC, MAX_STR_LEN*2, "%s/output", topic_system);
     snprintf(MQTT_SYSTEM_INPUT_TOPIC, MAX_STR_LEN*2, "%s/input", topic_system);
+    snprintf(MQTT_FILE_INPUT_TOPIC, MAX_STR_LEN*2, "%s/file/input", topic_system);
+    snprintf(MQTT_FILE_OUTPUT_TOPIC, MAX_STR_LEN*2, "%s/file/output", topic_system);
     
     mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
     esp_mqtt_client_register_event(mqtt_client, (esp_mqtt_event_id_t)ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
@@ -1343,6 +1583,9 @@ void mqtt_task(void *pvParameter) {
     
     char buffer[256];
     size_t received_len;
+
+    int battery_telemetry_ms = get_int_setting("battery_telemetry_ms", BATTERY_TELEMETRY_DEFAULT_MS);
+    TickType_t last_battery_telemetry_tick = xTaskGetTickCount();
     
     while (1) {
         reset_watchdog();
@@ -1374,6 +1617,7 @@ void mqtt_task(void *pvParameter) {
             ESP_LOGW(TAG, "Recovery L2: WiFi reinit after %u ms without IP", (unsigned)elapsed_ms_since(s_recovery.last_ip_tick));
             esp_wifi_disconnect();
             esp_wifi_stop();
+            wifi_select_ap(false);
             esp_wifi_start();
             esp_wifi_connect();
             s_recovery.wifi_reconnect_attempt = 0;
@@ -1404,6 +1648,42 @@ void mqtt_task(void *pvParameter) {
             }
         }
 #endif
+
+        // Take a copy to store, the flash write can't be done with the lock held.
+        bool store_cache = false;
+        uint8_t ssid[sizeof(s_wifi_config.sta.ssid) + 1] = {0};
+        wifi_cache_t cache = {0};
+        portENTER_CRITICAL(&s_wifi_lock);
+        if (s_wifi_cache_dirty) {
+            s_wifi_cache_dirty = false;
+            store_cache = true;
+            memcpy(ssid, s_wifi_config.sta.ssid, sizeof(s_wifi_config.sta.ssid));
+            cache = s_wifi_cache;
+        }
+        portEXIT_CRITICAL(&s_wifi_lock);
+        if (store_cache) {
+            wifi_cache_store((const char *)ssid, cache.bssid, cache.channel);
+        }
+
+        if (battery_telemetry_ms > 0 && s_recovery.mqtt_connected
+            && elapsed_ms_since(last_battery_telemetry_tick) >= (uint32_t)battery_telemetry_ms) {
+            last_battery_telemetry_tick = now;
+            battery_status_t status;
+            if (battery_monitor_get(&status)) {
+                char telemetry[128];
+                battery_monitor_format_json(telemetry, sizeof(telemetry));
+                esp_mqtt_client_publish(mqtt_client, MQTT_SYSTEM_OUTPUT_TOPIC, telemetry, 0, 0, 0);
+            }
+        }
+
+        // Resource accounting of the last Python job, once per job.
+        python_job_profile_t job_profile;
+        if (s_recovery.mqtt_connected && python_job_profile_take(&job_profile)) {
+            char profile_json[384];
+            python_job_profile_format_json(&job_profile, profile_json, sizeof(profile_json));
+            esp_mqtt_client_publish(mqtt_client, MQTT_SYSTEM_OUTPUT_TOPIC, profile_json, 0, 1, 0);
+        }
+
         // check watchdog
         //vTaskDelay(pdMS_TO_TICKS(15000));
         // Handle MQTT print stream
@@ -1414,23 +1694,6 @@ void mqtt_task(void *pvParameter) {
             pdMS_TO_TICKS(10)
         );
 
-        if (received_len > 3 && strncmp(buffer, "SYS", 3) == 0) {
-            // Создаем буфер с учетом нуль-терминатора
-            char bat[received_len - 3 + 1]; // +1 для '\0'
-            strncpy(bat, buffer + 3, received_len - 3);
-            bat[received_len - 3] = '\0'; // Явно добавляем нуль-терминатор
-            
-            printf("%s\n", bat);
-            esp_mqtt_client_publish(
-                mqtt_client,
-                MQTT_SYSTEM_OUTPUT_TOPIC,
-                bat,
-                0, 1, 0
-            );
-            received_len = 0;
-            continue;
-        }
-
         if (received_len > 0) {
             buffer[received_len] = '\0';
             
@@ -14,6 +14,7 @@
 #include "cJSON.h"
 #include "config_manager.h"
 #include "my_mqtt_client.h"
+#include "micropython_task.h"
 
 
 static const char *TAG = "MQTT_CLIENT";
@@ -168,8 +169,8 @@ static void process_mqtt_message(const char* topic, const char* data, int data_l
                 strcpy(python_code, value->valuestring);
                 
                 // Отправляем код в очередь для выполнения MicroPython
-                if (python_code_queue != NULL && 
-                    xQueueSend(python_code_queue, &python_code, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                if (python_code_queue != NULL &&
+                    !python_code_enqueue(python_code, pdMS_TO_TICKS(1000))) {
                     printf("Failed to send Python code to queue");
                     free(python_code);
                 } else {
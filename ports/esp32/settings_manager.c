@@ -1,76 +1,131 @@
 #include "settings_manager.h"
+#include "micropython_task.h"
+#include "boot_profile.h"
 #include "esp_log.h"
+#include "shared_fs.h"
 #include "esp_spiffs.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "freertos/semphr.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+
+#define LEGACY_SETTINGS_BASE "/spiffs"
+#define LEGACY_SETTINGS_FILE LEGACY_SETTINGS_BASE "/settings.json"
 
 static const char *TAG = "settings";
 static SemaphoreHandle_t settings_mutex = NULL;
+static volatile bool settings_ready = false;
 
 // Forward declarations
 static cJSON* read_settings_file(void);
 static esp_err_t write_settings_file(cJSON *settings);
 
-esp_err_t settings_init(void) {
-    // Initialize SPIFFS
+// Settings used to live in their own SPIFFS partition.  Move them over to the
+// shared filesystem the first time this firmware boots, so nothing is lost.
+static void migrate_legacy_settings(void) {
     esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs",
+        .base_path = LEGACY_SETTINGS_BASE,
         .partition_label = "spiffs",
-        .max_files = 5,
-        .format_if_mount_failed = true
+        .max_files = 1,
+        .format_if_mount_failed = false
     };
-    esp_err_t ret = esp_vfs_spiffs_register(&conf);
-    
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize SPIFFS (%s)", esp_err_to_name(ret));
-        return ret;
+    if (esp_vfs_spiffs_register(&conf) != ESP_OK) {
+        return;
+    }
+
+    FILE *f = fopen(LEGACY_SETTINGS_FILE, "r");
+    if (f != NULL) {
+        char *json_str = malloc(SETTINGS_MAX_FILE_SIZE);
+        size_t len = json_str ? fread(json_str, 1, SETTINGS_MAX_FILE_SIZE, f) : 0;
+        fclose(f);
+        if (len > 0 && shared_fs_write_file(SETTINGS_FILE, json_str, len) == ESP_OK) {
+            unlink(LEGACY_SETTINGS_FILE);
+            ESP_LOGI(TAG, "Moved settings from SPIFFS");
+        }
+        free(json_str);
     }
+    esp_vfs_spiffs_unregister("spiffs");
+}
+
+// Built-in settings, written out when there is no settings file yet
+static cJSON *default_settings(void) {
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL) {
+        ESP_LOGE(TAG, "Failed to create JSON object");
+        return NULL;
+    }
+    cJSON_AddStringToObject(root, "broker_uri", "mqtt://138.68.88.247:1883");
+    cJSON_AddStringToObject(root, "client_id", "lfmp1");
+    cJSON_AddStringToObject(root, "mqtt_username", "ondroid-iot");
+    cJSON_AddStringToObject(root, "mqtt_password", "pQT1#TCeeWulV2PL");
+    cJSON_AddStringToObject(root, "wifi_pass", "12345678");
+    cJSON_AddStringToObject(root, "wifi_ssid", "ssid");
+    cJSON_AddStringToObject(root, "topic_system", "lfmp_init/system");
+    cJSON_AddStringToObject(root, "topic_python", "lfmp_init/python");
+    return root;
+}
+
+// Without a filesystem the settings live here, starting from the defaults,
+// so the robot still boots and set_setting() works until the next reset.
+static cJSON *s_memory_settings = NULL;
+
+esp_err_t settings_init(void) {
+    // Mount first: MicroPython's _boot.py waits for this whatever happens here.
+    esp_err_t ret = shared_fs_init();
+    bool have_fs = ret == ESP_OK;
 
     // Create mutex
     settings_mutex = xSemaphoreCreateMutex();
     if (settings_mutex == NULL) {
         ESP_LOGE(TAG, "Failed to create settings mutex");
-        return ESP_FAIL;
+        ret = ESP_FAIL;
+        goto done;
     }
-    
+
+    if (!have_fs) {
+        ESP_LOGE(TAG, "Failed to mount filesystem (%s), using default settings", esp_err_to_name(ret));
+        s_memory_settings = default_settings();
+        goto done;
+    }
+
+    migrate_legacy_settings();
+
     // Check if settings file exists
-    FILE* f = fopen(SETTINGS_FILE, "r");
-    if (f == NULL) {
+    char *json_str;
+    size_t len;
+    if (shared_fs_read_file(SETTINGS_FILE, &json_str, &len) != ESP_OK) {
         ESP_LOGW(TAG, "Settings file not found, creating default");
-        
-        // Create default settings structure
-        cJSON *root = cJSON_CreateObject();
+        cJSON *root = default_settings();
         if (root == NULL) {
-            ESP_LOGE(TAG, "Failed to create JSON object");
-            return ESP_FAIL;
+            ret = ESP_FAIL;
+            goto done;
         }
-        
-        cJSON_AddStringToObject(root, "broker_uri", "mqtt://138.68.88.247:1883");
-        cJSON_AddStringToObject(root, "client_id", "lfmp1");
-        cJSON_AddStringToObject(root, "mqtt_username", "ondroid-iot");
-        cJSON_AddStringToObject(root, "mqtt_password", "pQT1#TCeeWulV2PL");
-        cJSON_AddStringToObject(root, "wifi_pass", "12345678");
-        cJSON_AddStringToObject(root, "wifi_ssid", "ssid");
-        cJSON_AddStringToObject(root, "topic_system", "lfmp_init/system");
-        cJSON_AddStringToObject(root, "topic_python", "lfmp_init/python");
-        
-        // Save to file
         ret = write_settings_file(root);
         cJSON_Delete(root);
-        
         if (ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to write default settings");
-            return ret;
         }
     } else {
-        fclose(f);
+        free(json_str);
         ESP_LOGI(TAG, "Settings file found");
     }
-    
-    return ESP_OK;
+
+done:
+    // Tasks waiting for the settings carry on in any case, with defaults
+    // from the getters if the settings couldn't be read.
+    boot_profile_mark(BOOT_PHASE_SETTINGS);
+    settings_ready = true;
+    return ret;
+}
+
+void settings_wait_ready(void) {
+    // Only waited for during startup, so a short poll is good enough.
+    while (!settings_ready) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
 }
 
 static cJSON* read_settings_file(void) {
@@ -84,37 +139,21 @@ static cJSON* read_settings_file(void) {
         return NULL;
     }
     
-    FILE *f = fopen(SETTINGS_FILE, "r");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "Failed to open settings file for reading");
+    if (s_memory_settings != NULL) {
+        cJSON *json = cJSON_Duplicate(s_memory_settings, true);
         xSemaphoreGive(settings_mutex);
-        return NULL;
+        return json;
     }
-    
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    if (size <= 0) {
-        ESP_LOGE(TAG, "Invalid file size: %ld", size);
-        fclose(f);
-        xSemaphoreGive(settings_mutex);
-        return NULL;
-    }
-    fseek(f, 0, SEEK_SET);
-    
-    char *json_str = malloc(size + 1);
-    if (json_str == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate memory for JSON string");
-        fclose(f);
-        xSemaphoreGive(settings_mutex);
+
+    char *json_str;
+    size_t len;
+    esp_err_t ret = shared_fs_read_file(SETTINGS_FILE, &json_str, &len);
+    xSemaphoreGive(settings_mutex);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read settings file");
         return NULL;
     }
     
-    size_t bytes_read = fread(json_str, 1, size, f);
-    json_str[bytes_read] = '\0';
-    
-    fclose(f);
-    xSemaphoreGive(settings_mutex);
-    
     cJSON *json = cJSON_Parse(json_str);
     if (json == NULL) {
         const char *error_ptr = cJSON_GetErrorPtr();
@@ -136,6 +175,16 @@ static esp_err_t write_settings_file(cJSON *settings) {
         return ESP_FAIL;
     }
     
+    if (s_memory_settings != NULL) {
+        cJSON *copy = cJSON_Duplicate(settings, true);
+        if (copy != NULL) {
+            cJSON_Delete(s_memory_settings);
+            s_memory_settings = copy;
+        }
+        xSemaphoreGive(settings_mutex);
+        return copy != NULL ? ESP_OK : ESP_ERR_NO_MEM;
+    }
+
     char *json = cJSON_Print(settings);
     if (json == NULL) {
         ESP_LOGE(TAG, "Failed to serialize JSON");
@@ -143,26 +192,15 @@ static esp_err_t write_settings_file(cJSON *settings) {
         return ESP_FAIL;
     }
     
-    FILE *f = fopen(SETTINGS_FILE, "w");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "Failed to open settings file for writing");
-        free(json);
-        xSemaphoreGive(settings_mutex);
-        return ESP_FAIL;
-    }
-    
-    size_t json_len = strlen(json);
-    size_t written = fwrite(json, 1, json_len, f);
-    fclose(f);
+    esp_err_t ret = shared_fs_write_file(SETTINGS_FILE, json, strlen(json));
     free(json);
     xSemaphoreGive(settings_mutex);
     
-    if (written != json_len) {
-        ESP_LOGE(TAG, "Failed to write complete JSON to file");
-        return ESP_FAIL;
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write settings file");
     }
     
-    return ESP_OK;
+    return ret;
 }
 
 esp_err_t set_setting(const char *key, cJSON *value) {
@@ -302,88 +340,3 @@ void print_all_settings(void) {
     ESP_LOGI(TAG, "========================");
     cJSON_Delete(root);
 }
-
-void write_settings_to_micropython(void) {
-    extern QueueHandle_t python_code_queue;
-    
-    cJSON *root = read_settings_file();
-    if (root == NULL) {
-        ESP_LOGE(TAG, "Failed to read settings for MicroPython");
-        return;
-    }
-    
-    char *json_compact = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    
-    if (json_compact == NULL) {
-        ESP_LOGE(TAG, "Failed to serialize settings to JSON");
-        return;
-    }
-    
-    // Escape the JSON string for Python
-    size_t escaped_len = strlen(json_compact) * 2 + 1; // Worst case
-    char *escaped_json = malloc(escaped_len);
-    if (escaped_json == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate memory for escaped JSON");
-        free(json_compact);
-        return;
-    }
-    
-    size_t out_pos = 0;
-    for (size_t i = 0; json_compact[i] != '\0' && out_pos < escaped_len - 1; i++) {
-        char c = json_compact[i];
-        switch (c) {
-            case '\'':
-                if (out_pos < escaped_len - 2) {
-                    escaped_json[out_pos++] = '\\';
-                    escaped_json[out_pos++] = '\'';
-                }
-                break;
-            case '\\':
-                if (out_pos < escaped_len - 2) {
-                    escaped_json[out_pos++] = '\\';
-                    escaped_json[out_pos++] = '\\';
-                }
-                break;
-            default:
-                escaped_json[out_pos++] = c;
-                break;
-        }
-    }
-    escaped_json[out_pos] = '\0';
-    
-    // Create Python code to write settings file
-    size_t py_code_len = strlen(escaped_json) + 200;
-    char *py_code = malloc(py_code_len);
-    if (py_code == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate memory for Python code");
-        free(json_compact);
-        free(escaped_json);
-        return;
-    }
-    
-    snprintf(py_code, py_code_len,
-        "try:\n"
-        "    with open('settings.json', 'w') as f:\n"
-        "        f.write('%s')\n"
-        "    print('Settings file written successfully')\n"
-        "except Exception as e:\n"
-        "    print('Error writing settings file:', e)\n",
-        escaped_json);
-    
-    free(json_compact);
-    free(escaped_json);
-    
-    // Send to MicroPython execution queue
-    if (python_code_queue != NULL) {
-        if (xQueueSend(python_code_queue, &py_code, pdMS_TO_TICKS(1000)) != pdTRUE) {
-            ESP_LOGE(TAG, "Failed to send settings write code to Python queue");
-            free(py_code);
-        } else {
-            ESP_LOGI(TAG, "Settings write code sent to MicroPython execution queue");
-        }
-    } else {
-        ESP_LOGE(TAG, "Python code queue not initialized");
-        free(py_code);
-    }
-}
\ No newline at end of file
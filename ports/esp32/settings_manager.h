@@ -4,12 +4,17 @@
 #include "esp_err.h"
 #include "cJSON.h"
 
-#define SETTINGS_FILE "/spiffs/settings.json"
+// On the filesystem shared with MicroPython, where it is "/settings.json" too
+#define SETTINGS_FILE "/settings.json"
+#define SETTINGS_MAX_FILE_SIZE 4096
 #define MAX_STR_LEN 64
 
 // Initialize settings system
 esp_err_t settings_init(void);
 
+// Block until settings_init() has finished, for tasks started before it
+void settings_wait_ready(void);
+
 // Read functions
 esp_err_t get_string_setting(const char *key, char *buffer, size_t buf_size);
 int get_int_setting(const char *key, int default_value);
@@ -20,6 +25,5 @@ esp_err_t set_setting(const char *key, cJSON *value);
 
 // Utility functions
 void print_all_settings(void);
-void write_settings_to_micropython(void);
 
 #endif // SETTINGS_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "shared_fs.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+
+// One littlefs mount of the "vfs" partition, shared by the firmware and
+// MicroPython.  C code reads and writes files through the helpers below;
+// _boot.py wraps the same lfs2_t with esp32.shared_fs() and mounts it at "/",
+// so a file such as settings.json exists once and both sides see each
+// other's writes immediately.
+//
+// The mount lives outside the GC heap and survives the soft reset after each
+// job.  littlefs is built with LFS2_THREADSAFE, so every lfs2 call takes the
+// recursive lock below; the helpers hold it across a whole file operation.
+// The geometry matches what VfsLfs2 uses for the partition, so filesystems
+// created by earlier firmware mount unchanged.
+
+#define SHARED_FS_BLOCK_SIZE 4096 // flash sector, as esp32.Partition reports
+#define SHARED_FS_READ_SIZE  32
+#define SHARED_FS_PROG_SIZE  32
+#define SHARED_FS_LOOKAHEAD  32
+
+static const char *TAG = "shared_fs";
+
+static const esp_partition_t *s_partition;
+static SemaphoreHandle_t s_lock;
+static lfs2_t s_lfs;
+static struct lfs2_config s_config;
+_Static_assert(SHARED_FS_CACHE_SIZE == 4 * SHARED_FS_PROG_SIZE, "cache size as VfsLfs2 picks it");
+static uint8_t s_read_buffer[SHARED_FS_CACHE_SIZE];
+static uint8_t s_prog_buffer[SHARED_FS_CACHE_SIZE];
+static uint8_t s_lookahead_buffer[SHARED_FS_LOOKAHEAD];
+// Cache of the file open in a helper, guarded by the lock
+static uint8_t s_file_buffer[SHARED_FS_CACHE_SIZE];
+static volatile bool s_done = false;
+static bool s_mounted = false;
+
+static int fs_read(const struct lfs2_config *c, lfs2_block_t block, lfs2_off_t off, void *buffer, lfs2_size_t size) {
+    esp_err_t err = esp_partition_read(s_partition, block * c->block_size + off, buffer, size);
+    return err == ESP_OK ? LFS2_ERR_OK : LFS2_ERR_IO;
+}
+
+static int fs_prog(const struct lfs2_config *c, lfs2_block_t block, lfs2_off_t off, const void *buffer, lfs2_size_t size) {
+    esp_err_t err = esp_partition_write(s_partition, block * c->block_size + off, buffer, size);
+    return err == ESP_OK ? LFS2_ERR_OK : LFS2_ERR_IO;
+}
+
+static int fs_erase(const struct lfs2_config *c, lfs2_block_t block) {
+    esp_err_t err = esp_partition_erase_range(s_partition, block * c->block_size, c->block_size);
+    return err == ESP_OK ? LFS2_ERR_OK : LFS2_ERR_IO;
+}
+
+static int fs_sync(const struct lfs2_config *c) {
+    return LFS2_ERR_OK;
+}
+
+static int fs_lock(const struct lfs2_config *c) {
+    xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+    return LFS2_ERR_OK;
+}
+
+static int fs_unlock(const struct lfs2_config *c) {
+    xSemaphoreGiveRecursive(s_lock);
+    return LFS2_ERR_OK;
+}
+
+static esp_err_t lfs_to_esp_err(int err) {
+    switch (err) {
+        case LFS2_ERR_OK:
+            return ESP_OK;
+        case LFS2_ERR_NOENT:
+            return ESP_ERR_NOT_FOUND;
+        case LFS2_ERR_NOMEM:
+        case LFS2_ERR_NOSPC:
+        case LFS2_ERR_FBIG:
+            return ESP_ERR_NO_MEM;
+        default:
+            return ESP_FAIL;
+    }
+}
+
+static bool first_block_is_erased(void) {
+    // Read through the file cache, which isn't in use yet, to keep the stack small.
+    for (size_t off = 0; off < SHARED_FS_BLOCK_SIZE; off += sizeof(s_file_buffer)) {
+        if (esp_partition_read(s_partition, off, s_file_buffer, sizeof(s_file_buffer)) != ESP_OK) {
+            return false;
+        }
+        for (size_t i = 0; i < sizeof(s_file_buffer); i++) {
+            if (s_file_buffer[i] != 0xff) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static esp_err_t mount(void) {
+    s_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SHARED_FS_PARTITION);
+    if (s_partition == NULL) {
+        ESP_LOGE(TAG, "Partition \"%s\" not found", SHARED_FS_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    s_lock = xSemaphoreCreateRecursiveMutex();
+    if (s_lock == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_config.read = fs_read;
+    s_config.prog = fs_prog;
+    s_config.erase = fs_erase;
+    s_config.sync = fs_sync;
+    s_config.lock = fs_lock;
+    s_config.unlock = fs_unlock;
+    s_config.read_size = SHARED_FS_READ_SIZE;
+    s_config.prog_size = SHARED_FS_PROG_SIZE;
+    s_config.block_size = SHARED_FS_BLOCK_SIZE;
+    s_config.block_count = s_partition->size / SHARED_FS_BLOCK_SIZE;
+    s_config.block_cycles = 100;
+    s_config.cache_size = SHARED_FS_CACHE_SIZE;
+    s_config.lookahead_size = SHARED_FS_LOOKAHEAD;
+    s_config.read_buffer = s_read_buffer;
+    s_config.prog_buffer = s_prog_buffer;
+    s_config.lookahead_buffer = s_lookahead_buffer;
+
+    int err = lfs2_mount(&s_lfs, &s_config);
+    if (err < 0) {
+        // Only format blank flash, as inisetup.check_bootsec() does.  Anything
+        // else may hold user files, so leave it unmounted for _boot.py to deal
+        // with rather than erase it.
+        if (!first_block_is_erased()) {
+            ESP_LOGE(TAG, "Mount failed (%d), not formatting a partition in use", err);
+            return lfs_to_esp_err(err);
+        }
+        ESP_LOGW(TAG, "Mount failed (%d) on blank flash, formatting", err);
+        err = lfs2_format(&s_lfs, &s_config);
+        if (err == 0) {
+            err = lfs2_mount(&s_lfs, &s_config);
+        }
+        if (err < 0) {
+            ESP_LOGE(TAG, "Failed to format (%d)", err);
+            return lfs_to_esp_err(err);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t shared_fs_init(void) {
+    esp_err_t ret = mount();
+    s_mounted = ret == ESP_OK;
+    s_done = true;
+    if (s_mounted) {
+        ESP_LOGI(TAG, "Mounted \"%s\", %lu blocks", SHARED_FS_PARTITION, (unsigned long)s_config.block_count);
+    }
+    return ret;
+}
+
+lfs2_t *shared_fs_wait(void) {
+    // Only waited for during startup, so a short poll is good enough.
+    while (!s_done) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    return s_mounted ? &s_lfs : NULL;
+}
+
+void shared_fs_lock(void) {
+    fs_lock(&s_config);
+}
+
+void shared_fs_unlock(void) {
+    fs_unlock(&s_config);
+}
+
+esp_err_t shared_fs_read_file(const char *path, char **data, size_t *len) {
+    if (!s_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    struct lfs2_file_config file_config = { .buffer = s_file_buffer };
+    lfs2_file_t file;
+    char *buf = NULL;
+    shared_fs_lock();
+    int err = lfs2_file_opencfg(&s_lfs, &file, path, LFS2_O_RDONLY, &file_config);
+    if (err == 0) {
+        lfs2_soff_t size = lfs2_file_size(&s_lfs, &file);
+        buf = size >= 0 ? malloc(size + 1) : NULL;
+        if (size < 0) {
+            err = size;
+        } else if (buf == NULL) {
+            err = LFS2_ERR_NOMEM;
+        } else {
+            lfs2_ssize_t n = lfs2_file_read(&s_lfs, &file, buf, size);
+            if (n < 0) {
+                err = n;
+            } else {
+                buf[n] = '\0';
+                *len = n;
+            }
+        }
+        lfs2_file_close(&s_lfs, &file);
+    }
+    shared_fs_unlock();
+
+    if (err < 0) {
+        free(buf);
+        if (err != LFS2_ERR_NOENT) {
+            ESP_LOGE(TAG, "Failed to read %s (%d)", path, err);
+        }
+        return lfs_to_esp_err(err);
+    }
+    *data = buf;
+    return ESP_OK;
+}
+
+esp_err_t shared_fs_write_file(const char *path, const void *data, size_t len) {
+    if (!s_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // littlefs only commits the new contents on close, so a reader never
+    // sees a half-written file, and a power cut leaves the old one.
+    struct lfs2_file_config file_config = { .buffer = s_file_buffer };
+    lfs2_file_t file;
+    shared_fs_lock();
+    int err = lfs2_file_opencfg(&s_lfs, &file, path, LFS2_O_WRONLY | LFS2_O_CREAT | LFS2_O_TRUNC, &file_config);
+    if (err == 0) {
+        lfs2_ssize_t n = lfs2_file_write(&s_lfs, &file, data, len);
+        if (n < 0) {
+            err = n;
+        } else if ((size_t)n != len) {
+            err = LFS2_ERR_NOSPC;
+        }
+        int close_err = lfs2_file_close(&s_lfs, &file);
+        if (err == 0) {
+            err = close_err;
+        }
+    }
+    shared_fs_unlock();
+
+    if (err < 0) {
+        ESP_LOGE(TAG, "Failed to write %s (%d)", path, err);
+        return lfs_to_esp_err(err);
+    }
+    return ESP_OK;
+}
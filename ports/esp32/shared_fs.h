@@ -0,0 +1,30 @@
+#ifndef SHARED_FS_H
+#define SHARED_FS_H
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "lib/littlefs/lfs2.h"
+
+// Label of the flash partition holding the filesystem
+#define SHARED_FS_PARTITION "vfs"
+
+// Size of the buffer lfs2_file_opencfg() needs for a file
+#define SHARED_FS_CACHE_SIZE 128
+
+// Mount the filesystem, formatting the partition if it holds none
+esp_err_t shared_fs_init(void);
+
+// Block until shared_fs_init() has finished; the mounted filesystem, or NULL
+lfs2_t *shared_fs_wait(void);
+
+// Read a whole file into a malloc'ed, NUL-terminated buffer
+esp_err_t shared_fs_read_file(const char *path, char **data, size_t *len);
+
+// Replace a whole file; readers see either the old or the new contents
+esp_err_t shared_fs_write_file(const char *path, const void *data, size_t len);
+
+// Hold the filesystem across several lfs2 calls (recursive)
+void shared_fs_lock(void);
+void shared_fs_unlock(void);
+
+#endif // SHARED_FS_H
@@ -0,0 +1,293 @@
+#include "system_stats.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_task.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "micropython_task.h"
+#include "gccollect.h"
+
+// Periodic view of CPU share, stack headroom and memory of the whole system,
+// to right-size task stacks and heaps.  A low-priority task takes a sample
+// every period: per-task run time since the previous sample (from the FreeRTOS
+// run-time counters), the stack high-water mark of each task, free and
+// largest free block of the internal, DMA and SPIRAM heaps, and the
+// MicroPython heap as left by the last garbage collection (it is not safe to
+// walk the GC heap from outside mp_task).  A compact copy of each sample goes
+// into a ring buffer, so the last SYSTEM_STATS_HISTORY_LEN periods can be
+// fetched at once.  Reading the stats on request (esp32.system_stats(), the
+// "stats" command) does not add to the series or move the load baseline, so
+// loads read then cover the time since the last periodic sample.
+//
+// Run-time counters need CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS; without it
+// all loads read as zero.
+
+#define SYSTEM_STATS_TASK_STACK    3072
+#define SYSTEM_STATS_TASK_PRIORITY (ESP_TASK_PRIO_MIN + 1)
+
+static const char *TAG = "system_stats";
+
+typedef struct {
+    TaskHandle_t handle;
+    uint32_t run_time;
+} task_run_time_t;
+
+// Recursive, so the formatters can hold it around their static buffers.
+static SemaphoreHandle_t s_lock = NULL;
+static TaskHandle_t s_task = NULL;
+
+// Run-time counters at the previous sample, guarded by s_lock.
+static task_run_time_t s_prev[SYSTEM_STATS_MAX_TASKS];
+static size_t s_prev_count;
+static uint32_t s_prev_total;
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static TaskStatus_t s_status[SYSTEM_STATS_MAX_TASKS];
+#endif
+
+static system_stats_sample_t s_history[SYSTEM_STATS_HISTORY_LEN];
+static size_t s_history_head;
+static size_t s_history_count;
+
+static void heap_stats(uint32_t caps, system_stats_heap_t *heap) {
+    heap->free = heap_caps_get_free_size(caps);
+    heap->largest = heap_caps_get_largest_free_block(caps);
+    heap->min_free = heap_caps_get_minimum_free_size(caps);
+}
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static uint32_t prev_run_time(TaskHandle_t handle) {
+    for (size_t i = 0; i < s_prev_count; i++) {
+        if (s_prev[i].handle == handle) {
+            return s_prev[i].run_time;
+        }
+    }
+    return 0;
+}
+
+// Fill in the task list and core loads, with loads measured since the
+// previous sample.  Returns the run-time total for set_baseline().
+static uint32_t task_stats(system_stats_t *stats) {
+    uint32_t total = 0;
+    size_t n = uxTaskGetSystemState(s_status, SYSTEM_STATS_MAX_TASKS, &total);
+    // Counters are 32-bit microseconds, so only differences are meaningful.
+    uint32_t elapsed = total - s_prev_total;
+
+    stats->num_tasks = n;
+    for (size_t i = 0; i < n; i++) {
+        const TaskStatus_t *st = &s_status[i];
+        system_stats_task_t *task = &stats->tasks[i];
+        strncpy(task->name, st->pcTaskName, sizeof(task->name) - 1);
+        task->name[sizeof(task->name) - 1] = '\0';
+        #if CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID
+        task->core = st->xCoreID == tskNO_AFFINITY ? -1 : st->xCoreID;
+        #else
+        task->core = -1;
+        #endif
+        task->priority = st->uxCurrentPriority;
+        task->stack_free = st->usStackHighWaterMark * sizeof(StackType_t);
+        task->load = 0;
+        #if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        if (elapsed > 0 && s_prev_total != 0) {
+            uint64_t delta = st->ulRunTimeCounter - prev_run_time(st->xHandle);
+            task->load = delta * 1000 / elapsed;
+        }
+        #endif
+    }
+
+    // A core is busy whenever its idle task is not running.
+    for (int core = 0; core < portNUM_PROCESSORS && core < 2; core++) {
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCore(core);
+        stats->core_load[core] = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (s_status[i].xHandle == idle && stats->tasks[i].load <= 1000) {
+                stats->core_load[core] = s_prev_total != 0 ? 1000 - stats->tasks[i].load : 0;
+            }
+        }
+    }
+    return total;
+}
+
+// Make the counters read by the last task_stats() the baseline for the next.
+static void set_baseline(size_t n, uint32_t total) {
+    for (size_t i = 0; i < n; i++) {
+        s_prev[i].handle = s_status[i].xHandle;
+        #if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        s_prev[i].run_time = s_status[i].ulRunTimeCounter;
+        #endif
+    }
+    s_prev_count = n;
+    s_prev_total = total;
+}
+#endif
+
+// Fill in stats without changing any state, returns the run-time total.
+static uint32_t read_stats(system_stats_t *stats) {
+    uint32_t total = 0;
+    memset(stats, 0, sizeof(*stats));
+    stats->uptime_s = esp_timer_get_time() / 1000000;
+    #if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    total = task_stats(stats);
+    #endif
+    heap_stats(MALLOC_CAP_INTERNAL, &stats->internal);
+    heap_stats(MALLOC_CAP_DMA, &stats->dma);
+    heap_stats(MALLOC_CAP_SPIRAM, &stats->spiram);
+    stats->gc_total = gc_collect_stats.total;
+    stats->gc_free = gc_collect_stats.free;
+    stats->gc_largest = gc_collect_stats.largest;
+    stats->gc_count = gc_collect_stats.count;
+    return total;
+}
+
+bool system_stats_read(system_stats_t *stats) {
+    if (s_lock == NULL) {
+        return false;
+    }
+    xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+    read_stats(stats);
+    xSemaphoreGiveRecursive(s_lock);
+    return true;
+}
+
+// Take the periodic sample: append it to the time series and make it the
+// baseline that task loads are measured against.
+static void system_stats_sample(system_stats_t *stats) {
+    xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+    uint32_t total = read_stats(stats);
+    #if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    set_baseline(stats->num_tasks, total);
+    #else
+    (void)total;
+    #endif
+
+    system_stats_sample_t *entry = &s_history[s_history_head];
+    entry->uptime_s = stats->uptime_s;
+    entry->core_load[0] = stats->core_load[0];
+    entry->core_load[1] = stats->core_load[1];
+    entry->heap_free = stats->internal.free;
+    entry->heap_largest = stats->internal.largest;
+    entry->gc_free = stats->gc_free;
+    entry->gc_largest = stats->gc_largest;
+    entry->mp_stack_free = mp_main_task_handle != NULL
+        ? uxTaskGetStackHighWaterMark(mp_main_task_handle) * sizeof(StackType_t) : 0;
+    s_history_head = (s_history_head + 1) % SYSTEM_STATS_HISTORY_LEN;
+    if (s_history_count < SYSTEM_STATS_HISTORY_LEN) {
+        s_history_count++;
+    }
+
+    xSemaphoreGiveRecursive(s_lock);
+}
+
+size_t system_stats_history(system_stats_sample_t *buf, size_t n) {
+    if (s_lock == NULL) {
+        return 0;
+    }
+    xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+    if (n > s_history_count) {
+        n = s_history_count;
+    }
+    size_t start = (s_history_head + SYSTEM_STATS_HISTORY_LEN - n) % SYSTEM_STATS_HISTORY_LEN;
+    for (size_t i = 0; i < n; i++) {
+        buf[i] = s_history[(start + i) % SYSTEM_STATS_HISTORY_LEN];
+    }
+    xSemaphoreGiveRecursive(s_lock);
+    return n;
+}
+
+static void system_stats_task(void *pvParameter) {
+    uint32_t period_ms = (uint32_t)pvParameter;
+    static system_stats_t stats;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    for (;;) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(period_ms));
+        system_stats_sample(&stats);
+    }
+}
+
+esp_err_t system_stats_init(uint32_t period_ms) {
+    if (s_lock != NULL) {
+        return ESP_OK;
+    }
+    s_lock = xSemaphoreCreateRecursiveMutex();
+    if (s_lock == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (period_ms == 0) {
+        ESP_LOGI(TAG, "Periodic sampling disabled");
+        return ESP_OK;
+    }
+    if (xTaskCreatePinnedToCore(system_stats_task, "sys_stats",
+        SYSTEM_STATS_TASK_STACK, (void *)period_ms, SYSTEM_STATS_TASK_PRIORITY, &s_task, 1) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create system stats task");
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "System stats started, period %lu ms", (unsigned long)period_ms);
+    return ESP_OK;
+}
+
+#define APPEND(...) do { \
+        int r = snprintf(buf + len, len < buf_size ? buf_size - len : 0, __VA_ARGS__); \
+        len += r > 0 ? r : 0; \
+} while (0)
+
+static void format_heap(char *buf, size_t buf_size, size_t *plen, const char *name, const system_stats_heap_t *heap) {
+    size_t len = *plen;
+    APPEND("\"%s\":[%lu,%lu,%lu]", name,
+        (unsigned long)heap->free, (unsigned long)heap->largest, (unsigned long)heap->min_free);
+    *plen = len;
+}
+
+int system_stats_format_json(char *buf, size_t buf_size) {
+    static system_stats_t stats;
+    if (s_lock == NULL) {
+        return snprintf(buf, buf_size, "{\"status\":\"error\",\"message\":\"Stats not started\"}");
+    }
+    xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+    system_stats_read(&stats);
+
+    size_t len = 0;
+    APPEND("{\"uptime\":%lu,\"load\":[%u.%u,%u.%u],\"tasks\":[", (unsigned long)stats.uptime_s,
+        stats.core_load[0] / 10, stats.core_load[0] % 10, stats.core_load[1] / 10, stats.core_load[1] % 10);
+    for (size_t i = 0; i < stats.num_tasks; i++) {
+        const system_stats_task_t *t = &stats.tasks[i];
+        APPEND("%s[\"%s\",%d,%u,%u.%u,%lu]", i == 0 ? "" : ",", t->name, t->core, t->priority,
+            t->load / 10, t->load % 10, (unsigned long)t->stack_free);
+    }
+    APPEND("],\"heap\":{");
+    format_heap(buf, buf_size, &len, "internal", &stats.internal);
+    APPEND(",");
+    format_heap(buf, buf_size, &len, "dma", &stats.dma);
+    APPEND(",");
+    format_heap(buf, buf_size, &len, "spiram", &stats.spiram);
+    APPEND("},\"gc\":[%lu,%lu,%lu,%lu]}", (unsigned long)stats.gc_total, (unsigned long)stats.gc_free,
+        (unsigned long)stats.gc_largest, (unsigned long)stats.gc_count);
+    xSemaphoreGiveRecursive(s_lock);
+    return len;
+}
+
+int system_stats_format_history_json(char *buf, size_t buf_size) {
+    static system_stats_sample_t history[SYSTEM_STATS_HISTORY_LEN];
+    if (s_lock == NULL) {
+        return snprintf(buf, buf_size, "{\"history\":[]}");
+    }
+    xSemaphoreTakeRecursive(s_lock, portMAX_DELAY);
+    size_t n = system_stats_history(history, SYSTEM_STATS_HISTORY_LEN);
+
+    size_t len = 0;
+    APPEND("{\"history\":[");
+    for (size_t i = 0; i < n; i++) {
+        const system_stats_sample_t *h = &history[i];
+        APPEND("%s[%lu,%u.%u,%u.%u,%lu,%lu,%lu,%lu,%lu]", i == 0 ? "" : ",", (unsigned long)h->uptime_s,
+            h->core_load[0] / 10, h->core_load[0] % 10, h->core_load[1] / 10, h->core_load[1] % 10,
+            (unsigned long)h->heap_free, (unsigned long)h->heap_largest,
+            (unsigned long)h->gc_free, (unsigned long)h->gc_largest, (unsigned long)h->mp_stack_free);
+    }
+    APPEND("]}");
+    xSemaphoreGiveRecursive(s_lock);
+    return len;
+}
@@ -0,0 +1,71 @@
+#ifndef SYSTEM_STATS_H
+#define SYSTEM_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// Sampling period used unless the "stats_sample_ms" setting says otherwise
+#define SYSTEM_STATS_DEFAULT_PERIOD_MS 5000
+#define SYSTEM_STATS_MAX_TASKS   24
+#define SYSTEM_STATS_HISTORY_LEN 60
+#define SYSTEM_STATS_JSON_SIZE   2048
+#define SYSTEM_STATS_HISTORY_JSON_SIZE (SYSTEM_STATS_HISTORY_LEN * 80 + 16)
+
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    int8_t core;            // pinned core, -1 if not pinned
+    uint8_t priority;
+    uint16_t load;          // share of one core since the previous sample, 0.1%
+    uint32_t stack_free;    // least free stack seen, bytes
+} system_stats_task_t;
+
+typedef struct {
+    uint32_t free;
+    uint32_t largest;       // largest free block
+    uint32_t min_free;      // least free seen since boot
+} system_stats_heap_t;
+
+typedef struct {
+    uint32_t uptime_s;
+    uint32_t num_tasks;
+    system_stats_task_t tasks[SYSTEM_STATS_MAX_TASKS];
+    uint16_t core_load[2];  // busy share of each core, 0.1%
+    system_stats_heap_t internal;
+    system_stats_heap_t dma;
+    system_stats_heap_t spiram;
+    uint32_t gc_total;      // MicroPython heap, as of the last collection
+    uint32_t gc_free;
+    uint32_t gc_largest;
+    uint32_t gc_count;
+} system_stats_t;
+
+// One entry of the time series
+typedef struct {
+    uint32_t uptime_s;
+    uint16_t core_load[2];
+    uint32_t heap_free;     // internal RAM
+    uint32_t heap_largest;
+    uint32_t gc_free;
+    uint32_t gc_largest;
+    uint32_t mp_stack_free;
+} system_stats_sample_t;
+
+// Start sampling every period_ms into the time series; 0 disables sampling
+esp_err_t system_stats_init(uint32_t period_ms);
+
+// Read the current stats without recording them; task loads cover the time
+// since the last periodic sample, and read as zero before the first one
+bool system_stats_read(system_stats_t *stats);
+
+// Copy up to n entries of the time series, oldest first; returns the count
+size_t system_stats_history(system_stats_sample_t *buf, size_t n);
+
+// Format the current stats (or the time series) as JSON, returns the length
+// Buffers of SYSTEM_STATS_JSON_SIZE and SYSTEM_STATS_HISTORY_JSON_SIZE always fit
+int system_stats_format_json(char *buf, size_t buf_size);
+int system_stats_format_history_json(char *buf, size_t buf_size);
+
+#endif // SYSTEM_STATS_H
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Upload, download and run files on the robot over MQTT, see
+# ../docs/file-transfer.md.
+#
+#    ./tools/file_transfer.py put mission.py /mission.py
+#    ./tools/file_transfer.py run /mission.py
+#    ./tools/file_transfer.py get /settings.json settings.json
+#
+# The broker and topic default to the values in the firmware's default
+# settings and can be changed with --broker, --user, --password and --topic
+# (the topic_system setting).  Needs paho-mqtt, as settings_writer does.
+
+import argparse
+import hashlib
+import json
+import queue
+import struct
+import sys
+import time
+import zlib
+
+import paho.mqtt.client as mqtt
+
+HEADER = "<2sBBII"
+HEADER_SIZE = struct.calcsize(HEADER)
+MAGIC = b"FT"
+VERSION = 1
+
+
+def encode_frame(offset, data):
+    return struct.pack(HEADER, MAGIC, VERSION, 0, offset, zlib.crc32(data)) + data
+
+
+def decode_frame(frame):
+    # (offset, data), or None if the frame is damaged
+    if len(frame) < HEADER_SIZE:
+        return None
+    magic, version, _, offset, crc = struct.unpack_from(HEADER, frame)
+    data = frame[HEADER_SIZE:]
+    if magic != MAGIC or version != VERSION or zlib.crc32(data) != crc:
+        return None
+    return offset, data
+
+
+class Robot:
+    def __init__(self, broker, user, password, topic):
+        self.command_topic = topic + "/input"
+        self.reply_topic = topic + "/output"
+        self.file_in_topic = topic + "/file/input"
+        self.file_out_topic = topic + "/file/output"
+        self.replies = queue.Queue()
+        self.frames = queue.Queue()
+
+        scheme, _, rest = broker.partition("://")
+        host, _, port = rest.rpartition(":")
+        self.client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION2)
+        if scheme == "mqtts":
+            self.client.tls_set()
+        self.client.username_pw_set(user, password)
+        self.client.on_message = self._on_message
+        self.client.connect(host, int(port))
+        self.client.subscribe([(self.reply_topic, 1), (self.file_out_topic, 0)])
+        self.client.loop_start()
+
+    def _on_message(self, client, userdata, msg):
+        if msg.topic == self.file_out_topic:
+            self.frames.put(msg.payload)
+            return
+        try:
+            reply = json.loads(msg.payload)
+        except ValueError:
+            return
+        if isinstance(reply, dict):
+            self.replies.put(reply)
+
+    def command(self, **kwargs):
+        self.client.publish(self.command_topic, json.dumps(kwargs), qos=1)
+
+    def reply(self, kind, timeout=10):
+        # Next reply of the given type, skipping unrelated messages.
+        deadline = time.monotonic() + timeout
+        while True:
+            try:
+                reply = self.replies.get(timeout=max(0, deadline - time.monotonic()))
+            except queue.Empty:
+                raise TimeoutError("no %s reply from the robot" % (kind or "command"))
+            if reply.get("type") == kind or (kind is None and "status" in reply):
+                if reply.get("status") == "error":
+                    raise RuntimeError(reply.get("message", "error"))
+                return reply
+
+    def put(self, data, path, chunk=2048, retries=5):
+        self.command(
+            command="file-put",
+            path=path,
+            size=len(data),
+            sha256=hashlib.sha256(data).hexdigest(),
+            chunk=chunk,
+        )
+        reply = self.reply("file-put")
+        offset = 0
+        failures = 0
+        while reply["status"] != "done":
+            if reply["status"] == "nack":
+                failures += 1
+                if failures > retries:
+                    raise RuntimeError("chunk at %d rejected: %s" % (offset, reply["message"]))
+            else:
+                failures = 0
+            offset = reply.get("offset", offset)
+            self.client.publish(
+                self.file_in_topic, encode_frame(offset, data[offset : offset + chunk]), qos=1
+            )
+            reply = self.reply("file-put")
+        return reply
+
+    def get(self, path, chunk=2048, timeout=30, retries=5):
+        # Frames may be lost (they are sent with QoS 0), so missing ranges
+        # are asked for again until the whole file is in.
+        parts = {}
+        offset, length = 0, 0
+        size = sha256 = None
+        for _ in range(retries + 1):
+            self.command(command="file-get", path=path, offset=offset, length=length, chunk=chunk)
+            reply = self.reply("file-get", timeout)
+            while True:
+                try:
+                    frame = decode_frame(self.frames.get(timeout=0.5))
+                except queue.Empty:
+                    break
+                if frame:
+                    parts[frame[0]] = frame[1]
+            if size is None:
+                size, sha256 = reply["size"], reply["sha256"]
+            data = bytearray()
+            for o in sorted(parts):
+                if o == len(data):
+                    data += parts[o]
+            if len(data) >= size:
+                data = bytes(data[:size])
+                if hashlib.sha256(data).hexdigest() != sha256:
+                    raise RuntimeError("sha256 mismatch")
+                return data
+            offset, length = len(data), size - len(data)
+        raise RuntimeError("gave up at %d of %d bytes" % (offset, size))
+
+    def run(self, path):
+        self.command(command="run", path=path)
+        return self.reply(None)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Move files to and from the robot over MQTT.")
+    parser.add_argument("--broker", default="mqtt://138.68.88.247:1883")
+    parser.add_argument("--user", default="ondroid-iot")
+    parser.add_argument("--password", default="pQT1#TCeeWulV2PL")
+    parser.add_argument("--topic", default="lfmp_init/system")
+    parser.add_argument("--chunk", type=int, default=2048)
+    sub = parser.add_subparsers(dest="action", required=True)
+    p = sub.add_parser("put")
+    p.add_argument("local")
+    p.add_argument("remote")
+    p = sub.add_parser("get")
+    p.add_argument("remote")
+    p.add_argument("local")
+    p = sub.add_parser("run")
+    p.add_argument("remote")
+    args = parser.parse_args()
+
+    robot = Robot(args.broker, args.user, args.password, args.topic)
+    start = time.monotonic()
+    if args.action == "put":
+        with open(args.local, "rb") as f:
+            data = f.read()
+        robot.put(data, args.remote, args.chunk)
+        print("stored %s, %d bytes in %.1f s" % (args.remote, len(data), time.monotonic() - start))
+    elif args.action == "get":
+        data = robot.get(args.remote, args.chunk)
+        with open(args.local, "wb") as f:
+            f.write(data)
+        print("fetched %s, %d bytes in %.1f s" % (args.remote, len(data), time.monotonic() - start))
+    else:
+        print(robot.run(args.remote))
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (RuntimeError, TimeoutError) as e:
+        print("error:", e, file=sys.stderr)
+        sys.exit(1)
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Decoder and replay helper for the esp32.Recorder flight recorder.
+#
+# Dump the recorder partition from the board with:
+#
+#    esptool.py read_flash 0x3AE000 0x40000 rec.bin
+#
+# (or read it with esp32.Partition from Python) and then:
+#
+#    ./tools/flightlog.py rec.bin                 # list sessions
+#    ./tools/flightlog.py rec.bin -s 3            # session 3 as CSV
+#    ./tools/flightlog.py rec.bin -s 3 --columns  # session 3 as columnar JSON
+#
+# This file has no dependencies outside the standard library and also runs
+# under the MicroPython unix port, where Replay can feed a recorded session
+# into the same controller code that runs on the robot:
+#
+#    from flightlog import Replay
+#    Replay.load("rec.bin").play(controller.step)
+
+import struct
+
+SECTOR_SIZE = 4096
+HEADER_SIZE = 128
+HEADER_FMT = "<4sHHII24s88s"
+MAGIC = b"MPFR"
+VERSION = 1
+
+
+def _cstr(b):
+    i = b.find(b"\x00")
+    if i >= 0:
+        b = b[:i]
+    return b.decode()
+
+
+class Session:
+    def __init__(self, session, fmt, names):
+        self.session = session
+        self.fmt = fmt
+        self.names = ["t_ms"] + (names.split(",") if names else [])
+        while len(self.names) < len(fmt) + 1:
+            self.names.append("v%d" % (len(self.names) - 1))
+        self.sectors = []
+
+    def records(self):
+        rec_fmt = "<I" + self.fmt
+        rec_size = struct.calcsize(rec_fmt)
+        for _, data in sorted(self.sectors, key=lambda s: s[0]):
+            pos = HEADER_SIZE
+            while pos + rec_size <= len(data):
+                if data[pos : pos + 4] == b"\xff\xff\xff\xff":
+                    break
+                yield struct.unpack(rec_fmt, data[pos : pos + rec_size])
+                pos += rec_size
+
+
+def parse(data):
+    # Return a dict mapping session number to Session, from a partition image.
+    sessions = {}
+    for off in range(0, len(data) - SECTOR_SIZE + 1, SECTOR_SIZE):
+        magic, ver, rec_size, seq, session, fmt, names = struct.unpack(
+            HEADER_FMT, data[off : off + HEADER_SIZE]
+        )
+        if magic != MAGIC or ver != VERSION:
+            continue
+        fmt = _cstr(fmt)
+        if struct.calcsize("<I" + fmt) != rec_size:
+            continue
+        s = sessions.get(session)
+        if s is None:
+            s = sessions[session] = Session(session, fmt, _cstr(names))
+        s.sectors.append((seq, data[off : off + SECTOR_SIZE]))
+    return sessions
+
+
+class Replay:
+    def __init__(self, session):
+        self.names = session.names
+        self.rows = list(session.records())
+
+    @classmethod
+    def load(cls, filename, session=None):
+        with open(filename, "rb") as f:
+            sessions = parse(f.read())
+        if not sessions:
+            raise ValueError("no recorder data")
+        if session is None:
+            session = max(sessions)
+        return cls(sessions[session])
+
+    def columns(self):
+        return {name: [r[i] for r in self.rows] for i, name in enumerate(self.names)}
+
+    def at(self, t_ms):
+        # Latest record at or before t_ms (relative to the first record).
+        if not self.rows:
+            return None
+        t = self.rows[0][0] + t_ms
+        lo, hi = 0, len(self.rows)
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self.rows[mid][0] <= t:
+                lo = mid + 1
+            else:
+                hi = mid
+        return self.rows[lo - 1] if lo else None
+
+    def play(self, handler, realtime=False):
+        # Call handler(dt_ms, values) for each record, in order.
+        if realtime:
+            import time
+
+            sleep_ms = getattr(time, "sleep_ms", lambda ms: time.sleep(ms / 1000))
+        prev = None
+        for r in self.rows:
+            dt = 0 if prev is None else (r[0] - prev) & 0xFFFFFFFF
+            if realtime and dt:
+                sleep_ms(dt)
+            handler(dt, r[1:])
+            prev = r[0]
+
+
+def main():
+    import argparse
+    import json
+    import sys
+
+    cmd_parser = argparse.ArgumentParser(description="Decode an esp32.Recorder partition dump.")
+    cmd_parser.add_argument("image", help="raw partition image")
+    cmd_parser.add_argument("-s", "--session", type=int, help="session to decode")
+    cmd_parser.add_argument("--columns", action="store_true", help="output columnar JSON")
+    args = cmd_parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        sessions = parse(f.read())
+
+    if args.session is None:
+        for n in sorted(sessions):
+            s = sessions[n]
+            count = sum(1 for _ in s.records())
+            print(
+                "session %d: fmt=%s names=%s sectors=%d records=%d"
+                % (n, s.fmt, ",".join(s.names[1:]), len(s.sectors), count)
+            )
+        return
+
+    if args.session not in sessions:
+        sys.exit("session %d not found" % args.session)
+    replay = Replay(sessions[args.session])
+    if args.columns:
+        json.dump(replay.columns(), sys.stdout)
+        print()
+    else:
+        print(",".join(replay.names))
+        for r in replay.rows:
+            print(",".join(str(v) for v in r))
+
+
+if __name__ == "__main__":
+    main()
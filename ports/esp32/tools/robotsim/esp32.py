@@ -0,0 +1,210 @@
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Simulated esp32 module for the robot simulator, with the classes used by
+# the robot firmware implemented on top of the simulated machine module.
+
+import struct
+
+import machine
+import time
+
+
+class HBridge:
+    COAST = 0
+    BRAKE = 1
+    DUTY_MAX = 1023
+
+    def __init__(self, pwms, *, mode=COAST, fade_ms=0):
+        if len(pwms) % 2 or not 2 <= len(pwms) <= 16:
+            raise ValueError("need IN1, IN2 pairs")
+        self._pwms = tuple(pwms)
+        self._mode = mode
+        self._fade_ms = fade_ms
+        self._duty = [0] * (len(pwms) // 2)
+        self._wdt = None
+        self.stop()
+
+    def duty(self, *duty):
+        if not duty:
+            return tuple(self._duty)
+        if len(duty) != len(self._duty):
+            raise ValueError("need one duty per motor")
+        if self._wdt is not None:
+            self._wdt_kick()
+        for i, d in enumerate(duty):
+            d = max(-self.DUTY_MAX, min(self.DUTY_MAX, int(d)))
+            self._duty[i] = d
+            self._set(i, d)
+
+    def _set(self, i, d):
+        in1, in2 = self._pwms[2 * i], self._pwms[2 * i + 1]
+        idle = self.DUTY_MAX if self._mode == HBridge.BRAKE else 0
+        if d == 0:
+            in1.duty(idle)
+            in2.duty(idle)
+        elif d > 0:
+            in1.duty(d)
+            in2.duty(0)
+        else:
+            in1.duty(0)
+            in2.duty(-d)
+
+    def stop(self, mode=None):
+        if mode is not None:
+            self._mode = mode
+        for i in range(len(self._duty)):
+            self._duty[i] = 0
+            self._set(i, 0)
+        if self._wdt is not None:
+            self._wdt["timer"].deinit()
+            self._wdt["last"] = None
+
+    def brake(self):
+        self.stop(HBridge.BRAKE)
+
+    def coast(self):
+        self.stop(HBridge.COAST)
+
+    def fade_ms(self, value=None):
+        if value is None:
+            return self._fade_ms
+        self._fade_ms = value
+
+    # The watchdog runs off a simulated one-shot timer, so it trips when
+    # simulated time passes without a kick; ramp_ms is accepted but ignored.
+
+    def watchdog(self, timeout_ms=None, *, ramp_ms=0):
+        if timeout_ms is None:
+            return self._wdt["timeout_ms"] if self._wdt else 0
+        if self._wdt is not None:
+            self._wdt["timer"].deinit()
+        if not timeout_ms:
+            self._wdt = None
+            return
+        self._wdt = {
+            "timer": machine.Timer(),
+            "timeout_ms": timeout_ms,
+            "last": None,
+            "kicks": 0,
+            "misses": 0,
+            "worst_us": 0,
+        }
+
+    def kick(self):
+        if self._wdt is None:
+            raise RuntimeError("watchdog not enabled")
+        self._wdt_kick()
+
+    def watchdog_stats(self, reset=False):
+        w = self._wdt
+        if w is None:
+            raise RuntimeError("watchdog not enabled")
+        stats = (w["kicks"], w["misses"], w["worst_us"])
+        if reset:
+            w["kicks"] = w["misses"] = w["worst_us"] = 0
+        return stats
+
+    def _wdt_kick(self):
+        w = self._wdt
+        now = time.ticks_us()
+        if w["last"] is not None:
+            w["worst_us"] = max(w["worst_us"], time.ticks_diff(now, w["last"]))
+        w["last"] = now
+        w["kicks"] += 1
+        w["timer"].init(mode=machine.Timer.ONE_SHOT, period=w["timeout_ms"], callback=self._wdt_expired)
+
+    def _wdt_expired(self, t):
+        self._wdt["misses"] += 1
+        for i in range(len(self._duty)):
+            self._duty[i] = 0
+            self._pwms[2 * i].duty(0)
+            self._pwms[2 * i + 1].duty(0)
+
+
+class TCS3472:
+    _GAINS = (1, 4, 16, 60)
+
+    def __init__(self, i2c, address=0x29, *, integration_ms=511.2, gain=1):
+        self._i2c = i2c
+        self._addr = address
+        self._palette = []
+        self._white = 0
+        self._last = (0, 0, 0, 0)
+        self.config(integration_ms=integration_ms, gain=gain)
+
+    def _write(self, reg, value):
+        self._i2c.writeto(self._addr, bytes((0x80 | reg, value)))
+
+    def _read(self, reg, n):
+        self._i2c.writeto(self._addr, bytes((0xA0 | reg,)))
+        return self._i2c.readfrom(self._addr, n)
+
+    def _start_cycle(self):
+        self._write(0x00, 0x01)
+        self._write(0x00, 0x03)
+        self._cycle_start = time.ticks_us()
+
+    def config(self, *, integration_ms=None, gain=None):
+        if integration_ms is not None:
+            steps = int(integration_ms * 1000 / 2400 + 0.5)
+            if not 1 <= steps <= 256:
+                raise ValueError("bad integration time")
+            self._atime = 256 - steps
+        if gain is not None:
+            if gain not in self._GAINS:
+                raise ValueError("bad gain")
+            self._gain = self._GAINS.index(gain)
+        self._write(0x01, self._atime)
+        self._write(0x0F, self._gain)
+        self._cycle_us = (256 - self._atime) * 2400 + 2400
+        self._start_cycle()
+
+    def read(self, buf=None, *, wait=True):
+        remaining = self._cycle_us - time.ticks_diff(time.ticks_us(), self._cycle_start)
+        if remaining > 0:
+            if not wait:
+                return False if buf is not None else None
+            time.sleep_us(remaining)
+        while not self._read(0x13, 1)[0] & 0x01:
+            if not wait:
+                return False if buf is not None else None
+            time.sleep_us(100)
+        crgb = struct.unpack("<HHHH", self._read(0x14, 8))
+        self._start_cycle()
+        self._last = crgb
+        if buf is None:
+            return crgb
+        for i in range(4):
+            buf[i] = crgb[i]
+        return True
+
+    def _normalise(self, crgb, white):
+        c = crgb[0]
+        if c <= 0:
+            return (0, 0, 0, 0)
+        return (crgb[1] / c, crgb[2] / c, crgb[3] / c, c / white if white > 0 else 0)
+
+    def palette(self, colours, white=0):
+        if len(colours) > 16:
+            raise ValueError("palette too large")
+        if not white:
+            white = max(c[0] for c in colours) if colours else 0
+        self._white = white
+        self._palette = [self._normalise(c, white) for c in colours]
+
+    def classify(self, crgb=None):
+        if not self._palette:
+            raise ValueError("no palette")
+        v = self._normalise(self._last if crgb is None else crgb, self._white)
+        best = 0
+        best_dist = None
+        for i, p in enumerate(self._palette):
+            dist = sum((a - b) ** 2 for a, b in zip(v, p))
+            if best_dist is None or dist < best_dist:
+                best, best_dist = i, dist
+        return best
+
+
+def battery_status():
+    # (voltage, charging, samples, errors) of a fully charged pack.
+    return (8.1, 0.0, 32, 0)
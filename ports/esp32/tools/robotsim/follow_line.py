@@ -0,0 +1,20 @@
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Example mission: follow the line with the Octoliner for 20 seconds.
+#
+#    micropython run.py follow_line.py
+
+import time
+from machine import I2C, Pin
+from lineRobot import Robot
+from octoliner import Octoliner
+
+robot = Robot()
+octo = Octoliner()
+octo.begin(I2C(0, scl=Pin(22), sda=Pin(21)))
+start = time.ticks_ms()
+while time.ticks_diff(time.ticks_ms(), start) < 20000:
+    pos = octo.track_line()
+    robot.run_motors(int(500 - 400 * pos), int(500 + 400 * pos))
+    time.sleep_ms(10)
+robot.stop()
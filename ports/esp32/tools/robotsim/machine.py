@@ -0,0 +1,225 @@
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Simulated machine module for the robot simulator, see sim.py.
+
+import sim
+
+
+class Pin:
+    IN = 1
+    OUT = 3
+    OPEN_DRAIN = 7
+    PULL_UP = 2
+    PULL_DOWN = 1
+    IRQ_RISING = sim.IRQ_RISING
+    IRQ_FALLING = sim.IRQ_FALLING
+
+    def __init__(self, id, mode=-1, pull=-1, *, value=None, **kwargs):
+        self._pin = sim.world().pin(id)
+        if value is not None:
+            self.value(value)
+
+    def init(self, mode=-1, pull=-1, *, value=None, **kwargs):
+        if value is not None:
+            self.value(value)
+
+    def value(self, v=None):
+        if v is None:
+            return self._pin.value
+        w = self._pin.world
+        self._pin.set(v, w.now_us)
+
+    def __call__(self, v=None):
+        return self.value(v)
+
+    def on(self):
+        self.value(1)
+
+    def off(self):
+        self.value(0)
+
+    def toggle(self):
+        self.value(1 - self._pin.value)
+
+    def irq(self, *args, **kwargs):
+        if args or kwargs:
+            self._irq_config(*args, **kwargs)
+        return _PinIRQ(self._pin)
+
+    def _irq_config(self, handler=None, trigger=IRQ_RISING | IRQ_FALLING, wake=None, *, hard=False, events=0):
+        if events and (events < 2 or events > 1024 or events & (events - 1)):
+            raise ValueError("bad events value")
+        p = self._pin
+        p.handler = handler
+        p.trigger = trigger if handler is not None or events else 0
+        p.hard = hard
+        p.events = [] if events else None
+        p.events_max = events
+        p.events_dropped = 0
+        p.callbacks_dropped = 0
+        p.scheduled = False
+        p.pyobj = self
+
+    def __repr__(self):
+        return "Pin(%d)" % self._pin.id
+
+
+class _PinIRQ:
+    def __init__(self, pin):
+        self._pin = pin
+
+    def __call__(self):
+        if self._pin.handler is not None:
+            self._pin.handler(self._pin.pyobj)
+
+    def trigger(self, trigger=None):
+        old = self._pin.trigger
+        if trigger is not None:
+            self._pin.trigger = trigger
+        return old
+
+    def events(self, buf=None):
+        p = self._pin
+        if p.events is None:
+            raise RuntimeError("events not enabled")
+        if buf is None:
+            events, p.events = p.events, []
+            return events
+        n = min(len(p.events), len(buf) // 2)
+        for i in range(n):
+            buf[2 * i], buf[2 * i + 1] = p.events[i]
+        del p.events[:n]
+        return n
+
+    def overflow(self):
+        return (self._pin.events_dropped, self._pin.callbacks_dropped)
+
+
+class PWM:
+    def __init__(self, dest, *, freq=None, duty=None, duty_u16=None, **kwargs):
+        self._pin = dest._pin if isinstance(dest, Pin) else sim.world().pin(dest)
+        self._pin.pwm_freq = 5000
+        self.init(freq=freq, duty=duty, duty_u16=duty_u16)
+
+    def init(self, *, freq=None, duty=None, duty_u16=None, **kwargs):
+        if freq is not None:
+            self._pin.pwm_freq = freq
+        if duty is not None:
+            self.duty(duty)
+        if duty_u16 is not None:
+            self.duty_u16(duty_u16)
+
+    def deinit(self):
+        self._pin.pwm_duty_u16 = 0
+
+    def freq(self, f=None):
+        if f is None:
+            return self._pin.pwm_freq
+        self._pin.pwm_freq = f
+
+    def duty(self, d=None):
+        if d is None:
+            return (self._pin.pwm_duty_u16 * 1023 + 32767) // 65535
+        self._pin.pwm_duty_u16 = max(0, min(1023, d)) * 65535 // 1023
+
+    def duty_u16(self, d=None):
+        if d is None:
+            return self._pin.pwm_duty_u16
+        self._pin.pwm_duty_u16 = max(0, min(65535, d))
+
+
+class I2C:
+    # All buses see the simulated devices, see World.devices.
+
+    def __init__(self, id=0, *, scl=None, sda=None, freq=400000, **kwargs):
+        self._world = sim.world()
+
+    def init(self, *args, **kwargs):
+        pass
+
+    def scan(self):
+        return sorted(self._world.devices)
+
+    def writeto(self, addr, buf, stop=True):
+        self._world.i2c_write(addr, buf)
+        self._world.advance(self._world.cpu_us)
+        return len(buf)
+
+    def readfrom(self, addr, nbytes, stop=True):
+        data = self._world.i2c_read(addr, nbytes)
+        self._world.advance(self._world.cpu_us)
+        return data
+
+    def readfrom_into(self, addr, buf, stop=True):
+        buf[:] = self.readfrom(addr, len(buf))
+
+    def writeto_mem(self, addr, memaddr, buf, *, addrsize=8):
+        self.writeto(addr, bytes([memaddr]) + bytes(buf))
+
+    def readfrom_mem(self, addr, memaddr, nbytes, *, addrsize=8):
+        self.writeto(addr, bytes([memaddr]))
+        return self.readfrom(addr, nbytes)
+
+    def readfrom_mem_into(self, addr, memaddr, buf, *, addrsize=8):
+        buf[:] = self.readfrom_mem(addr, memaddr, len(buf))
+
+
+SoftI2C = I2C
+
+
+class Timer:
+    ONE_SHOT = 0
+    PERIODIC = 1
+
+    def __init__(self, id=-1, **kwargs):
+        self.deadline_us = None
+        if kwargs:
+            self.init(**kwargs)
+
+    def init(self, *, mode=PERIODIC, period=-1, freq=-1, callback=None, **kwargs):
+        if freq > 0:
+            period = 1000 / freq
+        self._world = sim.world()
+        self._mode = mode
+        self._period_us = int(period * 1000)
+        self._callback = callback
+        self.deadline_us = self._world.now_us + self._period_us
+        self._world.add_timer(self)
+
+    def deinit(self):
+        self.deadline_us = None
+        if hasattr(self, "_world"):
+            self._world.remove_timer(self)
+
+    def fire(self):
+        if self._mode == Timer.PERIODIC:
+            self.deadline_us += self._period_us
+        else:
+            self.deinit()
+        if self._callback is not None:
+            self._callback(self)
+
+
+def freq(f=None):
+    if f is None:
+        return 240000000
+
+
+def unique_id():
+    return b"\x51\xd0\xc7\xe1\x00\x00"
+
+
+def reset():
+    raise SystemExit
+
+
+def disable_irq():
+    return 0
+
+
+def enable_irq(state=0):
+    pass
+
+
+def idle():
+    sim.world().advance(sim.world().cpu_us)
@@ -0,0 +1,143 @@
+#!/usr/bin/env micropython
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Run a robot mission script in the simulator, see ../../docs/simulator.md.
+#
+#    micropython run.py [options] mission.py
+#
+# Options:
+#    --track FILE|oval      track image (8-bit binary PGM/PPM), default oval
+#    --mm-per-px N          track image scale, default 1
+#    --start X,Y,DEG        start pose in mm and degrees
+#    --timeout-ms N         stop with an error after N ms of simulated time
+#    --call NAME            call NAME() after running the script
+#    --realtime             keep the simulated clock in step with host time
+#
+# On exit a JSON line with the final pose, distance, simulated and host time
+# and any pin IRQ overflows is printed.  The script also runs under CPython.
+
+import sys
+
+_dir = sys.argv[0].rpartition("/")[0] or "."
+if _dir not in sys.path:
+    sys.path.insert(0, _dir)
+sys.path.append(_dir + "/../../modules")
+
+try:
+    import utime as _host_time
+except ImportError:
+    import time as _host_time
+
+import sim
+
+
+def _load(name):
+    # CPython's built-in time module can't be shadowed from sys.path.
+    import types
+
+    mod = types.ModuleType(name)
+    mod.__file__ = _dir + "/" + name + ".py"
+    with open(mod.__file__) as f:
+        exec(f.read(), mod.__dict__)
+    return mod
+
+
+# Make sure the simulated modules win over built-in ones, including the
+# u-prefixed aliases that MicroPython always resolves to the built-in.
+import time
+
+if not hasattr(time, "sim"):
+    time = sys.modules["time"] = _load("time")
+import machine
+import esp32
+import json
+
+for _name, _mod in (("time", time), ("utime", time), ("machine", machine), ("esp32", esp32)):
+    sys.modules[_name] = _mod
+sys.modules["ujson"] = json
+
+
+def _host_ms():
+    if hasattr(_host_time, "ticks_ms"):
+        return _host_time.ticks_ms()
+    return int(_host_time.monotonic() * 1000)
+
+
+_host_clock = [0, None]
+
+
+def _host_us():
+    # Unwrapped, as MicroPython's ticks_us() wraps after a few minutes.
+    if not hasattr(_host_time, "ticks_us"):
+        return _host_time.monotonic_ns() // 1000
+    t = _host_time.ticks_us()
+    if _host_clock[1] is not None:
+        _host_clock[0] += _host_time.ticks_diff(t, _host_clock[1])
+    _host_clock[1] = t
+    return _host_clock[0]
+
+
+def _host_sleep_us(us):
+    if hasattr(_host_time, "sleep_us"):
+        _host_time.sleep_us(us)
+    else:
+        _host_time.sleep(us / 1e6)
+
+
+def main(argv):
+    opts = {"track": "oval", "mm-per-px": "1", "start": None, "timeout-ms": None, "call": None}
+    realtime = False
+    args = []
+    i = 0
+    while i < len(argv):
+        a = argv[i]
+        if a == "--realtime":
+            realtime = True
+            i += 1
+        elif a.startswith("--") and a[2:] in opts and i + 1 < len(argv):
+            opts[a[2:]] = argv[i + 1]
+            i += 2
+        else:
+            args.append(a)
+            i += 1
+    if len(args) != 1:
+        print("usage: run.py [options] mission.py", file=sys.stderr)
+        sys.exit(2)
+
+    if opts["track"] == "oval":
+        track = sim.Track.oval()
+    else:
+        track = sim.Track.load(opts["track"], float(opts["mm-per-px"]))
+    kwargs = {"track": track}
+    if opts["start"]:
+        x, y, deg = (float(v) for v in opts["start"].split(","))
+        kwargs.update(x=x, y=y, heading=deg * 3.141592653589793 / 180)
+    if opts["timeout-ms"]:
+        kwargs["timeout_ms"] = int(opts["timeout-ms"])
+    w = sim.World(**kwargs)
+    sim.set_world(w)
+    if realtime:
+        w.pace(_host_us, _host_sleep_us)
+
+    t0 = _host_ms()
+    status = "ok"
+    try:
+        g = {"__name__": "__main__"}
+        with open(args[0]) as f:
+            exec(f.read(), g)
+        if opts["call"]:
+            g[opts["call"]]()
+    except sim.SimTimeout:
+        status = "timeout"
+    host_ms = max(1, _host_ms() - t0)
+
+    result = w.stats()
+    result["status"] = status
+    result["host_ms"] = host_ms
+    result["speedup"] = round(result["time_ms"] / host_ms, 1)
+    print(json.dumps(result))
+    if status != "ok":
+        sys.exit(1)
+
+
+main(sys.argv[1:])
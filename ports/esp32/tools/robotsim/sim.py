@@ -0,0 +1,489 @@
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Host-side simulation of the line robot, see ../../docs/simulator.md.
+#
+# A World holds a virtual clock, a differential-drive plant driven by the
+# motor PWM duties, quadrature encoders that generate pin edges from the
+# wheel motion, and I2C devices that look at a 2D track image.  The machine,
+# time and esp32 modules in this directory are thin front ends onto the
+# current World, so lineRobot.py and mission scripts run unchanged.
+#
+# The clock only moves when the program sleeps or reads the time (each time
+# read costs cpu_us of simulated CPU time so busy loops terminate), so a
+# mission runs as fast as the host can compute it.  With pace() set the
+# clock is held back to host time instead, for missions that talk to the
+# outside world (e.g. teleoperation over UDP).
+
+import math
+import struct
+
+TICKS_PERIOD = 1 << 30
+TICKS_MASK = TICKS_PERIOD - 1
+
+IRQ_RISING = 1
+IRQ_FALLING = 2
+
+# Quadrature (A << 1 | B) sequence for forward rotation, as decoded by lineRobot.
+_QUADRATURE = (0b00, 0b10, 0b11, 0b01)
+
+# Octoliner expander pin of each line sensor, as in octoliner.py.
+_OCTOLINER_PINS = (4, 5, 6, 8, 7, 3, 2, 1)
+
+_world = None
+
+
+class SimTimeout(Exception):
+    pass
+
+
+def world():
+    global _world
+    if _world is None:
+        _world = World()
+    return _world
+
+
+def set_world(w):
+    global _world
+    _world = w
+
+
+class Track:
+    # A track image, sampled in millimetres with the origin at the bottom left.
+
+    def __init__(self, width, height, pixels, channels, mm_per_px=1.0):
+        self.width = width
+        self.height = height
+        self.pixels = pixels
+        self.channels = channels
+        self.mm_per_px = mm_per_px
+
+    @classmethod
+    def load(cls, filename, mm_per_px=1.0):
+        # Binary PGM (P5) or PPM (P6) with 8-bit samples.
+        with open(filename, "rb") as f:
+            data = f.read()
+        fields = []
+        pos = 0
+        while len(fields) < 4:
+            while data[pos : pos + 1].isspace():
+                pos += 1
+            if data[pos : pos + 1] == b"#":
+                while data[pos : pos + 1] not in (b"\n", b""):
+                    pos += 1
+                continue
+            start = pos
+            while not data[pos : pos + 1].isspace():
+                pos += 1
+            fields.append(data[start:pos])
+        magic, width, height, maxval = fields[0], int(fields[1]), int(fields[2]), int(fields[3])
+        if magic not in (b"P5", b"P6") or maxval != 255:
+            raise ValueError("track must be an 8-bit binary PGM or PPM")
+        channels = 1 if magic == b"P5" else 3
+        pixels = data[pos + 1 : pos + 1 + width * height * channels]
+        if len(pixels) != width * height * channels:
+            raise ValueError("truncated track image")
+        return cls(width, height, pixels, channels, mm_per_px)
+
+    @classmethod
+    def oval(cls, width=1200, height=800, line_mm=18, mm_per_px=4.0):
+        # A black oval line on white, with the straights along x.
+        w = int(width / mm_per_px)
+        h = int(height / mm_per_px)
+        pixels = bytearray(b"\xff" * (w * h))
+        r = (h - 2 * 100 / mm_per_px) / 2
+        cy = h / 2
+        x0 = w / 2 - (w / 2 - 100 / mm_per_px - r)
+        x1 = w - x0
+        half = line_mm / mm_per_px / 2
+        for row in range(h):
+            y = h - 1 - row + 0.5
+            for col in range(w):
+                x = col + 0.5
+                if x < x0:
+                    d = abs(math.sqrt((x - x0) ** 2 + (y - cy) ** 2) - r)
+                elif x > x1:
+                    d = abs(math.sqrt((x - x1) ** 2 + (y - cy) ** 2) - r)
+                else:
+                    d = abs(abs(y - cy) - r)
+                if d <= half:
+                    pixels[row * w + col] = 0
+        return cls(w, h, bytes(pixels), 1, mm_per_px)
+
+    def rgb(self, x_mm, y_mm):
+        # Colour under a point; off the image is white.
+        col = int(x_mm / self.mm_per_px)
+        row = self.height - 1 - int(y_mm / self.mm_per_px)
+        if not (0 <= col < self.width and 0 <= row < self.height):
+            return (255, 255, 255)
+        i = (row * self.width + col) * self.channels
+        if self.channels == 1:
+            v = self.pixels[i]
+            return (v, v, v)
+        return (self.pixels[i], self.pixels[i + 1], self.pixels[i + 2])
+
+    def luminance(self, x_mm, y_mm):
+        r, g, b = self.rgb(x_mm, y_mm)
+        return (r * 299 + g * 587 + b * 114) / 255000
+
+
+class SimPin:
+    # Simulated state of one GPIO, shared by all machine.Pin objects for it.
+
+    def __init__(self, world, id):
+        self.world = world
+        self.id = id
+        self.value = 0
+        self.pwm_duty_u16 = 0
+        self.pwm_freq = 0
+        self.handler = None
+        self.trigger = 0
+        self.hard = False
+        self.events = None
+        self.events_max = 0
+        self.events_dropped = 0
+        self.callbacks_dropped = 0
+        self.scheduled = False
+        self.pyobj = None
+
+    def set(self, value, time_us):
+        value = 1 if value else 0
+        if value == self.value:
+            return
+        self.value = value
+        if not self.trigger & (IRQ_RISING if value else IRQ_FALLING):
+            return
+        if self.events is not None:
+            if len(self.events) < self.events_max:
+                self.events.append((time_us & TICKS_MASK, value))
+            else:
+                self.events_dropped += 1
+        if self.handler is None:
+            return
+        if self.hard:
+            self.handler(self.pyobj)
+        elif self.events is not None:
+            if not self.scheduled:
+                self.scheduled = True
+                self.world.schedule(self._dispatch, self.pyobj, self)
+        else:
+            self.world.schedule(self.handler, self.pyobj, self)
+
+    def _dispatch(self, pin):
+        self.scheduled = False
+        if self.handler is not None:
+            self.handler(pin)
+
+
+class Wheel:
+    # DC motor with first-order speed response, driving a quadrature encoder.
+
+    def __init__(self, world, in1, in2, enc_a, enc_b, invert=False):
+        self.world = world
+        self.in1 = world.pin(in1)
+        self.in2 = world.pin(in2)
+        self.enc_a = world.pin(enc_a)
+        self.enc_b = world.pin(enc_b)
+        self.invert = invert
+        self.omega = 0.0
+        self.angle = 0.0
+        self.count = 0
+
+    def duty(self):
+        # Signed duty in -1..1, IN1 drives forward and IN2 backward.
+        return (self.in1.pwm_duty_u16 - self.in2.pwm_duty_u16) / 65535
+
+    def step(self, dt, t0_us):
+        w = self.world
+        d = self.duty()
+        target = 0.0
+        if abs(d) > w.deadband:
+            target = (abs(d) - w.deadband) / (1 - w.deadband) * w.max_omega
+            if d < 0:
+                target = -target
+        self.omega += (target - self.omega) * min(1.0, dt / w.tau)
+        self.angle += self.omega * dt
+        count = int(math.floor(self.angle / (2 * math.pi) * w.counts_per_rev))
+        if self.invert:
+            count = -count
+        n = count - self.count
+        if n == 0:
+            return
+        step = 1 if n > 0 else -1
+        dt_us = dt * 1e6
+        for i in range(abs(n)):
+            self.count += step
+            state = _QUADRATURE[self.count & 3]
+            t_us = t0_us + int(dt_us * (i + 1) / abs(n))
+            self.enc_a.set(state >> 1, t_us)
+            self.enc_b.set(state & 1, t_us)
+
+
+class Octoliner:
+    # The GpioExpander-based 8-channel line sensor, see gpio_expander.py.
+
+    def __init__(self, world, offset_mm=80.0, pitch_mm=8.0):
+        self.world = world
+        self.offset_mm = offset_mm
+        self.pitch_mm = pitch_mm
+        self.reply = b""
+        self.sensitivity = 0
+
+    def sensor_xy(self, i):
+        # Sensor 0 is on the robot's left.
+        w = self.world
+        lateral = (3.5 - i) * self.pitch_mm
+        c = math.cos(w.heading)
+        s = math.sin(w.heading)
+        return (w.x + self.offset_mm * c - lateral * s, w.y + self.offset_mm * s + lateral * c)
+
+    def analog(self, pin):
+        if pin not in _OCTOLINER_PINS:
+            return 0
+        x, y = self.sensor_xy(_OCTOLINER_PINS.index(pin))
+        return int((1 - self.world.track.luminance(x, y)) * 4000)
+
+    def write(self, data):
+        cmd = data[0] if data else None
+        if cmd == 0x0C and len(data) > 1:  # ANALOG_READ
+            self.reply = struct.pack(">H", self.analog(data[1]))
+        elif cmd == 0x00:  # UID
+            self.reply = struct.pack(">I", 0x51D0C7E1)
+        elif cmd == 0x08:  # DIGITAL_READ
+            self.reply = b"\x00\x00"
+        elif cmd == 0x0B and len(data) > 3 and data[1] == 0:  # ANALOG_WRITE to sense pin
+            self.sensitivity = (data[2] << 8 | data[3]) >> 8
+
+    def read(self, n):
+        data = (self.reply + bytes(n))[:n]
+        self.reply = b""
+        return data
+
+
+class TCS3472:
+    # TCS34725 colour sensor register model, looking down at the track.
+
+    def __init__(self, world, offset_mm=40.0):
+        self.world = world
+        self.offset_mm = offset_mm
+        self.regs = bytearray(32)
+        self.regs[0x01] = 0xFF
+        self.regs[0x12] = 0x44
+        self.ptr = 0
+        self.cycle_start = 0
+
+    def _cycle_us(self):
+        return (256 - self.regs[0x01]) * 2400 + 2400
+
+    def _sample(self):
+        w = self.world
+        x = w.x + self.offset_mm * math.cos(w.heading)
+        y = w.y + self.offset_mm * math.sin(w.heading)
+        r, g, b = w.track.rgb(x, y)
+        full = min(65535, (256 - self.regs[0x01]) * 1024)
+        gain = (1, 4, 16, 60)[self.regs[0x0F] & 3]
+        # Reflectance from 5% (black) to 95% (white) of a fifth of full scale.
+        scale = full * 0.2 * gain
+        rgb = [0.05 + 0.9 * v / 255 for v in (r, g, b)]
+        crgb = [min(65535, int(v * scale)) for v in [sum(rgb) / 1.5] + rgb]
+        struct.pack_into("<HHHH", self.regs, 0x14, *crgb)
+
+    def _status(self):
+        enabled = self.regs[0x00] & 0x03 == 0x03
+        if enabled and self.world.now_us - self.cycle_start >= self._cycle_us():
+            return 0x01
+        return 0x00
+
+    def write(self, data):
+        if not data:
+            return
+        self.ptr = data[0] & 0x1F
+        for b in data[1:]:
+            if self.ptr == 0x00 and (b & 0x02) and not (self.regs[0] & 0x02):
+                self.cycle_start = self.world.now_us
+            self.regs[self.ptr] = b
+            self.ptr = (self.ptr + 1) & 0x1F
+
+    def read(self, n):
+        self.regs[0x13] = self._status()
+        if self.ptr == 0x14:
+            self._sample()
+        data = bytes(self.regs[self.ptr : self.ptr + n])
+        self.ptr = (self.ptr + n) & 0x1F
+        return data
+
+
+class World:
+    # Robot geometry and encoder resolution default to lineRobot.py's config,
+    # and the start pose to the bottom straight of the default oval track,
+    # heading along +x.  Positions are in mm, the heading in radians.
+
+    def __init__(
+        self,
+        track=None,
+        x=600.0,
+        y=100.0,
+        heading=0.0,
+        config=None,
+        step_us=1000,
+        cpu_us=20,
+        max_omega=17.0,
+        tau=0.06,
+        deadband=0.08,
+        sched_depth=8,
+        timeout_ms=None,
+    ):
+        cfg = {
+            "pml1": 25,
+            "pml2": 26,
+            "pmr1": 33,
+            "pmr2": 32,
+            "pel1": 35,
+            "pel2": 34,
+            "per1": 14,
+            "per2": 27,
+            "wrad": 3.05,
+            "wdist": 18.4,
+            "er": 2376,
+        }
+        if config:
+            cfg.update(config)
+        self.track = track if track is not None else Track.oval()
+        self.x = x
+        self.y = y
+        self.heading = heading
+        self.step_us = step_us
+        self.cpu_us = cpu_us
+        self.max_omega = max_omega
+        self.tau = tau
+        self.deadband = deadband
+        self.sched_depth = sched_depth
+        self.timeout_us = None if timeout_ms is None else timeout_ms * 1000
+        self.wheel_radius_mm = cfg["wrad"] * 10
+        self.wheel_base_mm = cfg["wdist"] * 10
+        self.counts_per_rev = cfg["er"]
+        self.now_us = 0
+        self.stepped_us = 0
+        self.distance_mm = 0.0
+        self.pins = {}
+        self.queue = []
+        self.timers = []
+        self.devices = {}
+        self._in_step = False
+        self._host_us = None
+        self._host_sleep_us = None
+        self._host_t0 = 0
+        self.left = Wheel(self, cfg["pml1"], cfg["pml2"], cfg["pel1"], cfg["pel2"])
+        self.right = Wheel(self, cfg["pmr1"], cfg["pmr2"], cfg["per1"], cfg["per2"], invert=True)
+        self.devices[42] = Octoliner(self)
+        self.devices[0x29] = TCS3472(self)
+
+    def pin(self, id):
+        p = self.pins.get(id)
+        if p is None:
+            p = self.pins[id] = SimPin(self, id)
+        return p
+
+    def schedule(self, fun, arg, pin=None):
+        # Like mp_sched_schedule: fails when the queue is full.
+        if len(self.queue) >= self.sched_depth:
+            if pin is not None:
+                pin.callbacks_dropped += 1
+                if pin.events is not None:
+                    pin.scheduled = False
+            return False
+        self.queue.append((fun, arg))
+        return True
+
+    def pace(self, host_us, sleep_us):
+        # Run in real time: host_us() reads a host microsecond clock and
+        # sleep_us(n) sleeps the host.
+        self._host_us = host_us
+        self._host_sleep_us = sleep_us
+        self._host_t0 = host_us() - self.now_us
+
+    def _pace_to_host(self):
+        ahead = self.now_us - (self._host_us() - self._host_t0)
+        if ahead > 1000:
+            self._host_sleep_us(ahead)
+
+    def add_timer(self, timer):
+        if timer not in self.timers:
+            self.timers.append(timer)
+
+    def remove_timer(self, timer):
+        if timer in self.timers:
+            self.timers.remove(timer)
+
+    def _run_pending(self):
+        while self.queue:
+            fun, arg = self.queue.pop(0)
+            fun(arg)
+        for t in list(self.timers):
+            if t.deadline_us is not None and self.now_us >= t.deadline_us:
+                t.fire()
+
+    def _step(self, dt_us):
+        dt = dt_us / 1e6
+        t0 = self.stepped_us
+        self.left.step(dt, t0)
+        self.right.step(dt, t0)
+        r = self.wheel_radius_mm
+        v = r * (self.left.omega + self.right.omega) / 2
+        w = r * (self.right.omega - self.left.omega) / self.wheel_base_mm
+        self.x += v * math.cos(self.heading + w * dt / 2) * dt
+        self.y += v * math.sin(self.heading + w * dt / 2) * dt
+        self.heading += w * dt
+        self.distance_mm += abs(v) * dt
+
+    def advance(self, us):
+        # Move the clock forward, stepping the plant and running callbacks.
+        end = self.now_us + us
+        if self.timeout_us is not None and end > self.timeout_us:
+            raise SimTimeout("simulated time limit reached")
+        if self._in_step:
+            # Time read from inside a callback: just let the clock run.
+            self.now_us = end
+            return
+        self._in_step = True
+        try:
+            # The plant lags the clock when callbacks have read the time.
+            while self.stepped_us + self.step_us <= end:
+                self._step(self.step_us)
+                self.stepped_us += self.step_us
+                self.now_us = max(self.now_us, self.stepped_us)
+                self._run_pending()
+            self.now_us = max(self.now_us, end)
+            self._run_pending()
+        finally:
+            self._in_step = False
+        if self._host_us is not None:
+            self._pace_to_host()
+
+    def i2c_write(self, addr, data):
+        dev = self.devices.get(addr)
+        if dev is None:
+            raise OSError(19)  # ENODEV
+        dev.write(bytes(data))
+
+    def i2c_read(self, addr, n):
+        dev = self.devices.get(addr)
+        if dev is None:
+            raise OSError(19)  # ENODEV
+        return dev.read(n)
+
+    def stats(self):
+        overflow = [
+            (id, p.events_dropped, p.callbacks_dropped)
+            for id, p in sorted(self.pins.items())
+            if p.events_dropped or p.callbacks_dropped
+        ]
+        return {
+            "time_ms": self.now_us // 1000,
+            "x_mm": round(self.x, 1),
+            "y_mm": round(self.y, 1),
+            "heading_deg": round(math.degrees(self.heading), 1),
+            "distance_mm": round(self.distance_mm, 1),
+            "encoders": [self.left.count, self.right.count],
+            "irq_overflow": overflow,
+        }
@@ -0,0 +1,60 @@
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Simulated time module for the robot simulator: the clock is virtual and
+# sleeping advances it instantly, see sim.py.
+
+import sim
+
+
+def ticks_us():
+    w = sim.world()
+    w.advance(w.cpu_us)
+    return w.now_us & sim.TICKS_MASK
+
+
+def ticks_ms():
+    w = sim.world()
+    w.advance(w.cpu_us)
+    return (w.now_us // 1000) & sim.TICKS_MASK
+
+
+def ticks_cpu():
+    return ticks_us()
+
+
+def ticks_add(ticks, delta):
+    return (ticks + delta) & sim.TICKS_MASK
+
+
+def ticks_diff(end, start):
+    return ((end - start + sim.TICKS_PERIOD // 2) & sim.TICKS_MASK) - sim.TICKS_PERIOD // 2
+
+
+def sleep_us(us):
+    if us > 0:
+        sim.world().advance(int(us))
+
+
+def sleep_ms(ms):
+    sleep_us(int(ms * 1000))
+
+
+def sleep(s):
+    sleep_us(int(s * 1000000))
+
+
+def time_ns():
+    return sim.world().now_us * 1000
+
+
+def time():
+    return sim.world().now_us // 1000000
+
+
+def localtime(secs=None):
+    if secs is None:
+        secs = time()
+    return (2000, 1, 1, secs // 3600 % 24, secs // 60 % 60, secs % 60, 5, 1)
+
+
+gmtime = localtime
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# MIT license; Copyright (c) 2026 autolab-fi
+#
+# Client for the UDP teleoperation channel of modules/teleop.py, see
+# ../docs/teleop.md.
+#
+#    ./tools/teleop_client.py 192.168.1.42 --drive 400,400 --seconds 2
+#
+# Sends command frames at a fixed rate, then one stop frame, and prints the
+# round-trip time and what the robot did with the frames.  Without --drive
+# the duty pair is read from stdin, one "LEFT RIGHT" line at a time, and kept
+# until the next line.  This file has no dependencies outside the standard
+# library and also runs under the MicroPython unix port.
+
+import select
+import socket
+import struct
+import sys
+import time
+
+PORT = 4210
+FRAME = "<2sBBIhhIH"
+MAGIC = b"TO"
+VERSION = 1
+FLAG_STOP = 0x01
+FLAG_SYNC = 0x02
+ACK = "<2sBBIIH"
+ACK_SIZE = struct.calcsize(ACK)
+ACK_MAGIC = b"TA"
+STATUS = ("applied", "late", "stale")
+
+
+def _ms():
+    if hasattr(time, "monotonic"):
+        return int(time.monotonic() * 1000)
+    return time.time_ns() // 1000000
+
+
+class Client:
+    def __init__(self, host, port=PORT, ttl_ms=150):
+        self.addr = socket.getaddrinfo(host, port)[0][-1]
+        self.ttl_ms = ttl_ms
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.poller = select.poll()
+        self.poller.register(self.sock, select.POLLIN)
+        self.seq = 0
+        self.sent = 0
+        self.acks = [0] * len(STATUS)
+        self.rtt = []
+        self.lateness = []
+
+    def send(self, left, right, flags=0):
+        if self.seq == 0:
+            flags |= FLAG_SYNC
+        self.seq += 1
+        frame = struct.pack(
+            FRAME, MAGIC, VERSION, flags, self.seq, left, right, _ms() & 0xFFFFFFFF, self.ttl_ms
+        )
+        self.sock.sendto(frame, self.addr)
+        self.sent += 1
+
+    def stop(self):
+        self.send(0, 0, FLAG_STOP)
+
+    def poll(self, timeout_ms=0):
+        # Collect any acks that have arrived.
+        while self.poller.poll(timeout_ms):
+            timeout_ms = 0
+            data = self.sock.recv(64)
+            if len(data) != ACK_SIZE:
+                continue
+            magic, version, status, seq, sent_ms, lateness = struct.unpack(ACK, data)
+            if magic != ACK_MAGIC or status >= len(STATUS):
+                continue
+            self.acks[status] += 1
+            self.rtt.append((_ms() - sent_ms) & 0xFFFFFFFF)
+            self.lateness.append(lateness)
+
+    def summary(self):
+        s = {"sent": self.sent}
+        for name, n in zip(STATUS, self.acks):
+            s[name] = n
+        s["lost"] = self.sent - sum(self.acks)
+        if self.rtt:
+            rtt = sorted(self.rtt)
+            s["rtt_ms"] = [rtt[0], rtt[len(rtt) // 2], rtt[-1]]
+            s["lateness_ms_max"] = max(self.lateness)
+        return s
+
+
+def _stdin_ready():
+    p = select.poll()
+    p.register(sys.stdin, select.POLLIN)
+    return bool(p.poll(0))
+
+
+def main(argv):
+    opts = {"port": str(PORT), "ttl": "150", "rate": "50", "drive": None, "seconds": "2"}
+    args = []
+    i = 0
+    while i < len(argv):
+        a = argv[i]
+        if a.startswith("--") and a[2:] in opts and i + 1 < len(argv):
+            opts[a[2:]] = argv[i + 1]
+            i += 2
+        else:
+            args.append(a)
+            i += 1
+    if len(args) != 1:
+        print(
+            "usage: teleop_client.py HOST [--port N] [--ttl MS] [--rate HZ] [--drive L,R --seconds S]",
+            file=sys.stderr,
+        )
+        sys.exit(2)
+
+    c = Client(args[0], int(opts["port"]), int(opts["ttl"]))
+    period_ms = max(1, 1000 // int(opts["rate"]))
+    left = right = 0
+    if opts["drive"]:
+        left, right = (int(v) for v in opts["drive"].split(","))
+        end = _ms() + int(float(opts["seconds"]) * 1000)
+    else:
+        end = None
+
+    next_ms = _ms()
+    try:
+        while end is None or next_ms < end:
+            if end is None and _stdin_ready():
+                line = sys.stdin.readline()
+                if not line:
+                    break
+                v = line.split()
+                if len(v) == 2:
+                    left, right = int(v[0]), int(v[1])
+            c.send(left, right)
+            next_ms += period_ms
+            while next_ms - _ms() > 0:
+                c.poll(next_ms - _ms())
+    except KeyboardInterrupt:
+        pass
+    c.stop()
+    c.poll(200)
+    print(c.summary())
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
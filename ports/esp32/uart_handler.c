@@ -1,6 +1,8 @@
 #include "uart_handler.h"
 #include "settings_manager.h"
 #include "micropython_task.h"
+#include "battery_monitor.h"
+#include "system_stats.h"
 #include "esp_log.h"
 #include "driver/uart.h"
 #include <string.h>
@@ -28,7 +30,9 @@ static const char* HELP_MSG =
 "  test-line-sensor - Run line sensor test\n"
 "  test-color-sensor - Run color sensor test\n"
 "  test-scan-i2c - Scan I2C bus\n"
-"  battery-status - Get battery status\n";
+"  battery-status - Get battery status\n"
+"  stats - Get task load, stack headroom and heap usage\n"
+"  stats-history - Get the recent time series of stats\n";
 
 esp_err_t uart_handler_init(void) {
     // Configure UART parameters
@@ -194,7 +198,23 @@ void process_uart_command(const char* command) {
         execute_python_code("from scan import scan\nscan()");
     }
     else if (strcmp(command, "battery-status;") == 0) {
-        set_measure_adc_flag(true);
+        char status[128];
+        battery_monitor_format_json(status, sizeof(status));
+        printf("%s\n", status);
+    }
+    else if (strcmp(command, "stats;") == 0 || strcmp(command, "stats-history;") == 0) {
+        bool want_history = strcmp(command, "stats-history;") == 0;
+        size_t size = want_history ? SYSTEM_STATS_HISTORY_JSON_SIZE : SYSTEM_STATS_JSON_SIZE;
+        char *stats = malloc(size);
+        if (stats != NULL) {
+            if (want_history) {
+                system_stats_format_history_json(stats, size);
+            } else {
+                system_stats_format_json(stats, size);
+            }
+            printf("%s\n", stats);
+            free(stats);
+        }
     }
     else if (strcmp(command, "print-settings;") == 0) {
         print_all_settings();
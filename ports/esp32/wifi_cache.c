@@ -0,0 +1,78 @@
+#include "wifi_cache.h"
+
+#include <string.h>
+#include "esp_log.h"
+#include "nvs.h"
+
+// The BSSID and channel of the access point the robot last got an IP from
+// are kept in NVS, so the next connect can go straight to that channel and
+// AP instead of scanning all channels first.  The entry records the SSID it
+// belongs to, and is ignored once the wifi_ssid setting changes.
+
+#define WIFI_CACHE_NAMESPACE "wifi_cache"
+#define WIFI_CACHE_KEY       "ap"
+#define WIFI_CACHE_VERSION   1
+
+static const char *TAG = "wifi_cache";
+
+typedef struct {
+    uint8_t version;
+    uint8_t channel;
+    uint8_t bssid[6];
+    char ssid[33];
+} wifi_cache_entry_t;
+
+static bool read_entry(wifi_cache_entry_t *entry) {
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_CACHE_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(*entry);
+    esp_err_t err = nvs_get_blob(nvs, WIFI_CACHE_KEY, entry, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(*entry) && entry->version == WIFI_CACHE_VERSION;
+}
+
+bool wifi_cache_load(const char *ssid, wifi_cache_t *cache) {
+    wifi_cache_entry_t entry;
+    if (!read_entry(&entry)) {
+        return false;
+    }
+    entry.ssid[sizeof(entry.ssid) - 1] = '\0';
+    if (strcmp(entry.ssid, ssid) != 0 || entry.channel == 0) {
+        return false;
+    }
+    memcpy(cache->bssid, entry.bssid, sizeof(cache->bssid));
+    cache->channel = entry.channel;
+    return true;
+}
+
+void wifi_cache_store(const char *ssid, const uint8_t bssid[6], uint8_t channel) {
+    wifi_cache_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.version = WIFI_CACHE_VERSION;
+    entry.channel = channel;
+    memcpy(entry.bssid, bssid, sizeof(entry.bssid));
+    strncpy(entry.ssid, ssid, sizeof(entry.ssid) - 1);
+
+    wifi_cache_entry_t old;
+    if (read_entry(&old) && memcmp(&old, &entry, sizeof(entry)) == 0) {
+        return;
+    }
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(WIFI_CACHE_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, WIFI_CACHE_KEY, &entry, sizeof(entry));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to store AP: %s", esp_err_to_name(err));
+    } else {
+        ESP_LOGI(TAG, "Stored AP %02x:%02x:%02x:%02x:%02x:%02x channel %u",
+            bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5], channel);
+    }
+}
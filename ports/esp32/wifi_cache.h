@@ -0,0 +1,19 @@
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Access point of the last successful connection
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+} wifi_cache_t;
+
+// Get the cached access point; false if there is none for this SSID
+bool wifi_cache_load(const char *ssid, wifi_cache_t *cache);
+
+// Remember the access point; flash is only written when it changed
+void wifi_cache_store(const char *ssid, const uint8_t bssid[6], uint8_t channel);
+
+#endif // WIFI_CACHE_H
@@ -0,0 +1,230 @@
+#define MP_MAX_UNCOMPRESSED_TEXT_LEN (73)
+MP_COMPRESSED_DATA("can'\364'%q\247objec\364functio\356forma\364argumen\364argument\363no\364mus\364positiona\354keywor\344'%s\247specifie\362t\357conver\364strin\347b\345o\346require\344typ\345fo\362inde\370ar\347attribut\345invali\344wit\350%\344empt\371implemente\344isn'\364unsupporte\344assignmen\364i\356\341outsid\345generato\362supporte\344lengt\350expecte\344fro\355comple\370doesn'\364erro\362missin\347n\357rang\345conversio\356identifie\362a\356synta\370bu\364expectin\347ha\363in\364nam\345afte\362fiel\344give\356multipl\345need\363nonloca\354overflo\367sequenc\345tupl\345allowe\344ou\364struct\272to\357unknow\356dic\364i\363lis\364o\362zer\357impor\364numbe\362shoul\344specificatio\356value\363incompatibl\345issubclass(\251%\361%\363an\344byte\363clas\363foun\344loca\354stor\345take\363valu\345allocatio\356expressio\356implicitl\371incomplet\345unexpecte\344.mp\371arg\363automati\343cod\345hea\360integers\254numberin\347operatio\356redefine\344sel\346bytecod\345negativ\345defaul\364failed\254go\364indice\363intege\362se\364suppor\364befor\345binar\371buffe\362divid\345inden\364manua\354memor\371mktim\345modul\345nativ\345retur\356switc\350unpac\353")
+MP_MATCH_COMPRESSED("%c needs int or char", "\377%c\273\265\310char")
+MP_MATCH_COMPRESSED("%q index out of range", "\377\321\225\301\221\255")
+MP_MATCH_COMPRESSED("%q indices must be integers, not %s", "\377\321\357\210\220\345\207\322")
+MP_MATCH_COMPRESSED("%q() takes %d positional arguments but %d were given", "\377%q()\331\232\211\206\262\232were\271")
+MP_MATCH_COMPRESSED("'%q' argument required", "\377\201\205\222")
+MP_MATCH_COMPRESSED("'%s' object doesn't support item assignment", "\377\213\202\251\362item\237")
+MP_MATCH_COMPRESSED("'%s' object doesn't support item deletion", "\377\213\202\251\362item deletion")
+MP_MATCH_COMPRESSED("'%s' object has no attribute '%q'", "\377\213\202\264\254\227\201")
+MP_MATCH_COMPRESSED("'%s' object isn't an iterator", "\377\213\202\235\260iterator")
+MP_MATCH_COMPRESSED("'%s' object isn't callable", "\377\213\202\235callable")
+MP_MATCH_COMPRESSED("'%s' object isn't iterable", "\377\213\202\235iterable")
+MP_MATCH_COMPRESSED("'%s' object isn't subscriptable", "\377\213\202\235subscriptable")
+MP_MATCH_COMPRESSED("'=' alignment not allowed in string format specifier", "\377'=' alignment\207\300\240\217\204\214")
+MP_MATCH_COMPRESSED("'await' outside function", "\377'await'\242\203")
+MP_MATCH_COMPRESSED("'break'/'continue' outside loop", "\377'break'/'continue'\242loop")
+MP_MATCH_COMPRESSED("'not' not implemented", "\377'not'\207\234")
+MP_MATCH_COMPRESSED("'return' outside function", "\377'return'\242\203")
+MP_MATCH_COMPRESSED("'yield' outside function", "\377'yield'\242\203")
+MP_MATCH_COMPRESSED("* arg after **", "\377*\226\267**")
+MP_MATCH_COMPRESSED("*x must be assignment target", "\377*x\210\220\237target")
+MP_MATCH_COMPRESSED("0.0 to a complex power", "\3770.0\215\241\250power")
+MP_MATCH_COMPRESSED("I/O operation on closed file", "\377I/O\347on closed file")
+MP_MATCH_COMPRESSED("LHS of keyword arg must be an id", "\377LHS\221\212\226\210\220\260id")
+MP_MATCH_COMPRESSED("[addrinfo error %d]", "\377[addrinfo\252%d]")
+MP_MATCH_COMPRESSED("__init__() should return None, not '%s'", "\377__init__()\314\375None,\207\213")
+MP_MATCH_COMPRESSED("abort() called", "abort() called")
+MP_MATCH_COMPRESSED("address %08x is not aligned to %d bytes", "\377address %08x\306\207aligned\215\232\324")
+MP_MATCH_COMPRESSED("annotation must be an identifier", "\377annotation\210\220\260\257")
+MP_MATCH_COMPRESSED("arg is an empty sequence", "\377\226\306\260\233\276")
+MP_MATCH_COMPRESSED("arg must be user-type", "\377\226\210\220user-type")
+MP_MATCH_COMPRESSED("argument name reused", "\377\205\266reused")
+MP_MATCH_COMPRESSED("argument num/types mismatch", "\377\205num/types mismatch")
+MP_MATCH_COMPRESSED("argument should be a '%q' not a '%q'", "\377\205\314\220\241\201\207\241\201")
+MP_MATCH_COMPRESSED("array/bytes required on right side", "\377array/bytes\222on right side")
+MP_MATCH_COMPRESSED("async for/with outside async function", "\377async for/with\242async\203")
+MP_MATCH_COMPRESSED("attributes not supported", "\377attributes\207\244")
+MP_MATCH_COMPRESSED("bad compile mode", "bad compile mode")
+MP_MATCH_COMPRESSED("bad typecode", "bad typecode")
+MP_MATCH_COMPRESSED("binary op %q not implemented", "\377\364op\321\207\234")
+MP_MATCH_COMPRESSED("bits must be 32 or less", "\377bits\210\22032\310less")
+MP_MATCH_COMPRESSED("buffer too small", "\377\365\303small")
+MP_MATCH_COMPRESSED("bytecode overflow", "\377\352\275")
+MP_MATCH_COMPRESSED("bytes value out of range", "\377\324\332\301\221\255")
+MP_MATCH_COMPRESSED("call super().__init__() first", "call super().__init__() first")
+MP_MATCH_COMPRESSED("can't add special method to already-subclassed class", "\377\200add special method\215already-subclassed\325")
+MP_MATCH_COMPRESSED("can't assign to expression", "\377\200assign\215\334")
+MP_MATCH_COMPRESSED("can't cancel self", "\377\200cancel\351")
+MP_MATCH_COMPRESSED("can't convert %s to complex", "\377\200\216\322\215\250")
+MP_MATCH_COMPRESSED("can't convert %s to float", "\377\200\216\322\215float")
+MP_MATCH_COMPRESSED("can't convert %s to int", "\377\200\216\322\215\265")
+MP_MATCH_COMPRESSED("can't convert '%q' object to %q implicitly", "\377\200\216\201\202\215\321\335")
+MP_MATCH_COMPRESSED("can't convert NaN to int", "\377\200\216NaN\215\265")
+MP_MATCH_COMPRESSED("can't convert inf to int", "\377\200\216inf\215\265")
+MP_MATCH_COMPRESSED("can't create '%q' instances", "\377\200create\201instances")
+MP_MATCH_COMPRESSED("can't declare nonlocal in outer code", "\377\200declare\274\240outer\343")
+MP_MATCH_COMPRESSED("can't delete expression", "\377\200delete\334")
+MP_MATCH_COMPRESSED("can't do binary op between '%q' and '%q'", "\377\200do\364op between\201\323\201")
+MP_MATCH_COMPRESSED("can't do unary op of '%q'", "\377\200do unary op\221\201")
+MP_MATCH_COMPRESSED("can't implicitly convert '%q' to 'bool'", "\377\200\335\216\201\215'bool'")
+MP_MATCH_COMPRESSED("can't import name %q", "\377\200\312\266\321")
+MP_MATCH_COMPRESSED("can't load from '%q'", "\377\200load\247\201")
+MP_MATCH_COMPRESSED("can't load with '%q' index", "\377\200load\231\201\225")
+MP_MATCH_COMPRESSED("can't perform relative import", "\377\200perform relative\312")
+MP_MATCH_COMPRESSED("can't send non-None value to a just-started generator", "\377\200send non-None\332\215\241just-started\243")
+MP_MATCH_COMPRESSED("can't set attribute", "\377\200\361\227")
+MP_MATCH_COMPRESSED("can't store '%q'", "\377\200\330\201")
+MP_MATCH_COMPRESSED("can't store to '%q'", "\377\200\330\215\201")
+MP_MATCH_COMPRESSED("can't store with '%q' index", "\377\200\330\231\201\225")
+MP_MATCH_COMPRESSED("can't switch from automatic field numbering to manual field specification", "\377\200\376\247\342\270\346\215\370\270\315")
+MP_MATCH_COMPRESSED("can't switch from manual field specification to automatic field numbering", "\377\200\376\247\370\270\315\215\342\270\346")
+MP_MATCH_COMPRESSED("can't truncate-divide a complex number", "\377\200truncate-divide\241\250\313")
+MP_MATCH_COMPRESSED("can't unambiguously get sizeof scalar", "\377\200unambiguously get sizeof scalar")
+MP_MATCH_COMPRESSED("can't wait", "\377\200wait")
+MP_MATCH_COMPRESSED("casting", "casting")
+MP_MATCH_COMPRESSED("chr() arg not in range(0x110000)", "\377chr()\226\207\240range(0x110000)")
+MP_MATCH_COMPRESSED("comparison of int and uint", "\377comparison\221\265\323uint")
+MP_MATCH_COMPRESSED("complex divide by zero", "\377\250\366by\311")
+MP_MATCH_COMPRESSED("conversion to object", "\377\256\215\202")
+MP_MATCH_COMPRESSED("default 'except' must be last", "\377\354'except'\210\220last")
+MP_MATCH_COMPRESSED("dict update sequence has wrong length", "\377\305update\276\264wrong\245")
+MP_MATCH_COMPRESSED("div/mod not implemented for uint", "\377div/mod\207\234\224uint")
+MP_MATCH_COMPRESSED("divide by zero", "\377\366by\311")
+MP_MATCH_COMPRESSED("empty", "\377\233")
+MP_MATCH_COMPRESSED("empty heap", "\377\233\344")
+MP_MATCH_COMPRESSED("empty separator", "\377\233separator")
+MP_MATCH_COMPRESSED("end of format while looking for conversion specifier", "\377end\221\204while looking\224\256\214")
+MP_MATCH_COMPRESSED("error in regex", "\377\252\240regex")
+MP_MATCH_COMPRESSED("exceptions must derive from BaseException", "\377exceptions\210derive\247BaseException")
+MP_MATCH_COMPRESSED("expected ':' after format specifier", "\377\246':'\267\204\214")
+MP_MATCH_COMPRESSED("expecting a dict for keyword args", "\377\263\241\305\224\212\341")
+MP_MATCH_COMPRESSED("expecting just a value for set", "\377\263just\241\332\224\361")
+MP_MATCH_COMPRESSED("expecting key:value for dict", "\377\263key:value\224\305")
+MP_MATCH_COMPRESSED("extra keyword arguments given", "\377extra\212\206\271")
+MP_MATCH_COMPRESSED("extra positional arguments given", "\377extra\211\206\271")
+MP_MATCH_COMPRESSED("float not supported", "\377float\207\244")
+MP_MATCH_COMPRESSED("format", "\377\204")
+MP_MATCH_COMPRESSED("format needs a dict", "\377\204\273\241\305")
+MP_MATCH_COMPRESSED("format string didn't convert all arguments", "\377\204\217didn't\216all\206")
+MP_MATCH_COMPRESSED("format string needs more arguments", "\377\204\217\273more\206")
+MP_MATCH_COMPRESSED("full", "full")
+MP_MATCH_COMPRESSED("function doesn't take keyword arguments", "\377\203\251take\212\206")
+MP_MATCH_COMPRESSED("function expected at most %d arguments, got %d", "\377\203\246at most\232arguments,\356\232")
+MP_MATCH_COMPRESSED("function got multiple values for argument '%q'", "\377\203\356\272\316\224\205\201")
+MP_MATCH_COMPRESSED("function missing %d required positional arguments", "\377\203\253\232\222\211\206")
+MP_MATCH_COMPRESSED("function missing keyword-only argument", "\377\203\253keyword-only\205")
+MP_MATCH_COMPRESSED("function missing required keyword argument '%q'", "\377\203\253\222\212\205\201")
+MP_MATCH_COMPRESSED("function missing required positional argument #%d", "\377\203\253\222\211\205#%d")
+MP_MATCH_COMPRESSED("function must be bytecode with no children", "\377\203\210\220\352\231\254children")
+MP_MATCH_COMPRESSED("function takes %d positional arguments but %d were given", "\377\203\331\232\211\206\262\232were\271")
+MP_MATCH_COMPRESSED("generator already executing", "\377\243already executing")
+MP_MATCH_COMPRESSED("generator ignored GeneratorExit", "\377\243ignored GeneratorExit")
+MP_MATCH_COMPRESSED("generator raised StopIteration", "\377\243raised StopIteration")
+MP_MATCH_COMPRESSED("hash is final", "\377hash\306final")
+MP_MATCH_COMPRESSED("heap must be a list", "\377\344\210\220\241\307")
+MP_MATCH_COMPRESSED("identifier redefined as global", "\377\257\350as global")
+MP_MATCH_COMPRESSED("identifier redefined as nonlocal", "\377\257\350as\274")
+MP_MATCH_COMPRESSED("import * not at module level", "\377\312*\207at\373level")
+MP_MATCH_COMPRESSED("incompatible .mpy arch", "\377\317\340arch")
+MP_MATCH_COMPRESSED("incompatible .mpy file", "\377\317\340file")
+MP_MATCH_COMPRESSED("incomplete format", "\377\336\204")
+MP_MATCH_COMPRESSED("incomplete format key", "\377\336\204key")
+MP_MATCH_COMPRESSED("incorrect padding", "incorrect padding")
+MP_MATCH_COMPRESSED("int() arg 2 must be >= 2 and <= 36", "\377int()\2262\210\220>= 2\323<= 36")
+MP_MATCH_COMPRESSED("integer needed", "\377\360needed")
+MP_MATCH_COMPRESSED("invalid format", "\377\230\204")
+MP_MATCH_COMPRESSED("invalid format specifier", "\377\230\204\214")
+MP_MATCH_COMPRESSED("invalid micropython decorator", "\377\230micropython decorator")
+MP_MATCH_COMPRESSED("invalid mktime usage", "\377\230\372usage")
+MP_MATCH_COMPRESSED("invalid syntax", "\377\230\261")
+MP_MATCH_COMPRESSED("invalid syntax for number", "\377\230\261\224\313")
+MP_MATCH_COMPRESSED("issubclass() arg 1 must be a class", "\377\320\2261\210\220\241\325")
+MP_MATCH_COMPRESSED("issubclass() arg 2 must be a class or a tuple of classes", "\377\320\2262\210\220\241\325\310\241\277\221classes")
+MP_MATCH_COMPRESSED("join expects a list of str/bytes objects consistent with self object", "\377join expects\241\307\221str/bytes objects consistent\231\351\202")
+MP_MATCH_COMPRESSED("keyword argument(s) not implemented - use normal args instead", "\377\212argument(s)\207\234- use normal\341instead")
+MP_MATCH_COMPRESSED("lhs and rhs should be compatible", "\377lhs\323rhs\314\220compatible")
+MP_MATCH_COMPRESSED("local '%q' has type '%q' but source is '%q'", "\377\327\201\264\223\201\262source\306\201")
+MP_MATCH_COMPRESSED("local '%q' used before type known", "\377\327\201used\363\223known")
+MP_MATCH_COMPRESSED("local variable referenced before assignment", "\377\327variable referenced\363\237")
+MP_MATCH_COMPRESSED("malformed f-string", "malformed f-string")
+MP_MATCH_COMPRESSED("math domain error", "\377math domain\252")
+MP_MATCH_COMPRESSED("memory allocation failed, allocating %u bytes", "\377\371\333\355allocating %u\324")
+MP_MATCH_COMPRESSED("memory allocation failed, heap is locked", "\377\371\333\355\344\306locked")
+MP_MATCH_COMPRESSED("memoryview offset too large", "\377memoryview offset\303large")
+MP_MATCH_COMPRESSED("mktime needs a tuple of length 8 or 9", "\377\372\273\241\277\221\2458\3109")
+MP_MATCH_COMPRESSED("multiple *x in assignment", "\377\272*x\240\237")
+MP_MATCH_COMPRESSED("multiple bases have instance lay-out conflict", "\377\272bases have instance lay-out conflict")
+MP_MATCH_COMPRESSED("must raise an object", "\377\210raise\260\202")
+MP_MATCH_COMPRESSED("must use keyword argument for key function", "\377\210use\212\205\224key\203")
+MP_MATCH_COMPRESSED("name '%q' isn't defined", "\377\266\201\235defined")
+MP_MATCH_COMPRESSED("name too long", "\377\266\303long")
+MP_MATCH_COMPRESSED("native code in .mpy unsupported", "\377\374\343\240\340\236")
+MP_MATCH_COMPRESSED("native yield", "\377\374yield")
+MP_MATCH_COMPRESSED("need more than %d values to unpack", "\377need more than\232\316\215\377")
+MP_MATCH_COMPRESSED("negative factorial", "\377\353factorial")
+MP_MATCH_COMPRESSED("negative shift count", "\377\353shift count")
+MP_MATCH_COMPRESSED("no active exception to reraise", "\377\254active exception\215reraise")
+MP_MATCH_COMPRESSED("no binding for nonlocal found", "\377\254binding\224\274\326")
+MP_MATCH_COMPRESSED("no module named '%q'", "\377\254\373named\201")
+MP_MATCH_COMPRESSED("no such attribute", "\377\254such\227")
+MP_MATCH_COMPRESSED("non-default argument follows default argument", "\377non-default\205follows\354\205")
+MP_MATCH_COMPRESSED("non-hex digit", "non-hex digit")
+MP_MATCH_COMPRESSED("not a constant", "\377\207\241constant")
+MP_MATCH_COMPRESSED("object '%s' isn't a tuple or list", "\377\202\213\235\241\277\310\307")
+MP_MATCH_COMPRESSED("object not in sequence", "\377\202\207\240\276")
+MP_MATCH_COMPRESSED("object of type '%s' has no len()", "\377\202\221\223\213\264\254len()")
+MP_MATCH_COMPRESSED("object with buffer protocol required", "\377\202\231\365protocol\222")
+MP_MATCH_COMPRESSED("only slices with step=1 (aka None) are supported", "\377only slices\231step=1 (aka None) are\244")
+MP_MATCH_COMPRESSED("opcode", "opcode")
+MP_MATCH_COMPRESSED("ord() expected a character, but string of length %d found", "\377ord()\246\241character,\262\217\221\245\232\326")
+MP_MATCH_COMPRESSED("overflow converting long int to machine word", "\377\275converting long\265\215machine word")
+MP_MATCH_COMPRESSED("pop from an empty set", "\377pop\247\260\233\361")
+MP_MATCH_COMPRESSED("pop from empty list", "\377pop\247\233\307")
+MP_MATCH_COMPRESSED("popitem(): dictionary is empty", "\377popitem(): dictionary\306\233")
+MP_MATCH_COMPRESSED("positional arg after **", "\377\211\226\267**")
+MP_MATCH_COMPRESSED("positional arg after keyword arg", "\377\211\226\267\212\226")
+MP_MATCH_COMPRESSED("pow() with 3 arguments requires integers", "\377pow()\2313\206requires integers")
+MP_MATCH_COMPRESSED("requested length %d but object has length %d", "\377requested\245\232\262\202\264\245\232")
+MP_MATCH_COMPRESSED("return expected '%q' but got '%q'", "\377\375\246\201\262\356\201")
+MP_MATCH_COMPRESSED("rsplit(None,n)", "rsplit(None,n)")
+MP_MATCH_COMPRESSED("schedule queue full", "schedule queue full")
+MP_MATCH_COMPRESSED("sign not allowed in string format specifier", "\377sign\207\300\240\217\204\214")
+MP_MATCH_COMPRESSED("sign not allowed with integer format specifier 'c'", "\377sign\207\300\231\360\204\214'c'")
+MP_MATCH_COMPRESSED("single '}' encountered in format string", "\377single '}' encountered\240\204\217")
+MP_MATCH_COMPRESSED("slice step can't be zero", "\377slice step\200\220\311")
+MP_MATCH_COMPRESSED("splitting with sub-captures", "\377splitting\231sub-captures")
+MP_MATCH_COMPRESSED("stream operation not supported", "\377stream\347\207\244")
+MP_MATCH_COMPRESSED("string argument without an encoding", "\377\217\205without\260encoding")
+MP_MATCH_COMPRESSED("string index out of range", "\377\217\225\301\221\255")
+MP_MATCH_COMPRESSED("string indices must be integers, not %s", "\377\217\357\210\220\345\207\322")
+MP_MATCH_COMPRESSED("struct: can't index", "\377\302\200\225")
+MP_MATCH_COMPRESSED("struct: index out of range", "\377\302\225\301\221\255")
+MP_MATCH_COMPRESSED("struct: no fields", "\377\302\254fields")
+MP_MATCH_COMPRESSED("substring not found", "\377substring\207\326")
+MP_MATCH_COMPRESSED("super() can't find self", "\377super()\200find\351")
+MP_MATCH_COMPRESSED("syntax error in JSON", "\377\261\252\240JSON")
+MP_MATCH_COMPRESSED("syntax error in uctypes descriptor", "\377\261\252\240uctypes descriptor")
+MP_MATCH_COMPRESSED("ticks interval overflow", "\377ticks interval\275")
+MP_MATCH_COMPRESSED("too many args", "\377\303many\341")
+MP_MATCH_COMPRESSED("too many values to unpack (expected %d)", "\377\303many\316\215\377(expected %d)")
+MP_MATCH_COMPRESSED("tuple index out of range", "\377\277\225\301\221\255")
+MP_MATCH_COMPRESSED("type '%q' isn't an acceptable base type", "\377\223\201\235\260acceptable base\223")
+MP_MATCH_COMPRESSED("type object '%q' has no attribute '%q'", "\377\223\202\201\264\254\227\201")
+MP_MATCH_COMPRESSED("type takes 1 or 3 arguments", "\377\223\3311\3103\206")
+MP_MATCH_COMPRESSED("unexpected indent", "\377\337\367")
+MP_MATCH_COMPRESSED("unexpected keyword argument '%q'", "\377\337\212\205\201")
+MP_MATCH_COMPRESSED("unicode name escapes", "\377unicode\266escapes")
+MP_MATCH_COMPRESSED("unindent doesn't match any outer indent level", "\377unindent\251match any outer\367level")
+MP_MATCH_COMPRESSED("unknown conversion specifier %c", "\377\304\256\214%c")
+MP_MATCH_COMPRESSED("unknown format code '%c' for object of type '%s'", "\377\304\204\343'%c'\224\202\221\223\213")
+MP_MATCH_COMPRESSED("unknown type '%q'", "\377\304\223\201")
+MP_MATCH_COMPRESSED("unmarshallable object", "\377unmarshallable\202")
+MP_MATCH_COMPRESSED("unmatched '{' in format", "\377unmatched '{'\240\204")
+MP_MATCH_COMPRESSED("unreadable attribute", "\377unreadable\227")
+MP_MATCH_COMPRESSED("unsupported format character '%c' (0x%x) at index %d", "\377\236\204character '%c' (0x%x) at\225\232")
+MP_MATCH_COMPRESSED("unsupported type for %q: '%s'", "\377\236\223\224%q:\213")
+MP_MATCH_COMPRESSED("unsupported types for %q: '%s', '%s'", "\377\236types\224%q: '%s',\213")
+MP_MATCH_COMPRESSED("wbits", "wbits")
+MP_MATCH_COMPRESSED("wrong number of arguments", "\377wrong\313\221\206")
+MP_MATCH_COMPRESSED("zero step", "\377\311step")
+// Total input length:      6563
+// Total compressed length: 3068
+// Total data length:       1156
+// Predicted saving:        2339
+
+// gzip length:             3641
+// Percentage of gzip:      116.0%
+// zlib length:             3629
+// Percentage of zlib:      116.4%
@@ -0,0 +1,113 @@
+#define MP_MAX_UNCOMPRESSED_TEXT_LEN (68)
+MP_COMPRESSED_DATA("argumen\364functio\356objec\364can'\364no\364mus\364supporte\344assignmen\364ar\347keywor\344generato\362outsid\345positiona\354o\346nam\345b\345multipl\345nonloca\354require\344wron\347doesn'\364fo\362invali\344missin\347suppor\364t\357typ\345issubclass(\251afte\362empt\371foun\344i\356n\357rang\345allocatio\356expressio\356identifie\362tuple/lis\364unexpecte\344\341argument\363redefine\344wit\350instanc\345negativ\345overflo\367sequenc\345conver\364defaul\364expect\363failed\254ha\363in\364ou\364to\357buffe\362impor\364inden\364lengt\350memor\371numbe\362synta\370value\363a\356asyn\343byte\363clas\363inde\370isn'\364oute\362smal\354tupl\345valu\345'%q\247fro\355ite\355lis\364lon\347sel\346zer\357\262ba\344*\252*\370a\363i\363o\362\261#%\344%\361%\365'await\247'break'/'continue\247'except\247'yield\247\252\2633-ar\3473\266<\275>\275BaseExceptio\356GeneratorExi\364LH\323Non\345StopIteratio\356__init__(\251abort(\251acceptabl\345activ\345allocatin\347alread\371an\344an\371arg\363assig\356attribut\345attribute\363bas\345base\363befor\345bindin\347buil\344b\371bytecod\345callabl\345calle\344characte\362")
+MP_MATCH_COMPRESSED("'await' outside function", "\377\333\213\201")
+MP_MATCH_COMPRESSED("'break'/'continue' outside loop", "\377\334\213loop")
+MP_MATCH_COMPRESSED("'yield' outside function", "\377\336\213\201")
+MP_MATCH_COMPRESSED("* arg after **", "\377\337\210\234\322")
+MP_MATCH_COMPRESSED("*x must be assignment target", "\377\323\205\217\207target")
+MP_MATCH_COMPRESSED("3-arg pow() not supported", "\377\341pow()\204\206")
+MP_MATCH_COMPRESSED("LHS of keyword arg must be an id", "\377\347\215\211\210\205\217\277id")
+MP_MATCH_COMPRESSED("__init__() should return None", "\377\352should return\350")
+MP_MATCH_COMPRESSED("abort() called", "\377\353\376")
+MP_MATCH_COMPRESSED("argument name reused", "\377\200\216reused")
+MP_MATCH_COMPRESSED("argument num/types mismatch", "\377\200num/types mismatch")
+MP_MATCH_COMPRESSED("async for/with outside async function", "\377\300for/with\213\300\201")
+MP_MATCH_COMPRESSED("attributes not supported", "\377\365\204\206")
+MP_MATCH_COMPRESSED("bad format string", "\377\321format string")
+MP_MATCH_COMPRESSED("bad typecode", "\377\321typecode")
+MP_MATCH_COMPRESSED("buffer too small", "\377\267\266\306")
+MP_MATCH_COMPRESSED("bytecode overflow", "\377\374\255")
+MP_MATCH_COMPRESSED("bytes value out of range", "\377\301\310\265\215\241")
+MP_MATCH_COMPRESSED("can't assign to expression", "\377\203\363\231\243")
+MP_MATCH_COMPRESSED("can't convert to int", "\377\203\257\231\264")
+MP_MATCH_COMPRESSED("can't convert to str implicitly", "\377\203\257\231str implicitly")
+MP_MATCH_COMPRESSED("can't create instance", "\377\203create\253")
+MP_MATCH_COMPRESSED("can't declare nonlocal in outer code", "\377\203declare\221\237\305code")
+MP_MATCH_COMPRESSED("can't delete expression", "\377\203delete\243")
+MP_MATCH_COMPRESSED("can't import name %q", "\377\203\270\216\331")
+MP_MATCH_COMPRESSED("can't perform relative import", "\377\203perform relative\270")
+MP_MATCH_COMPRESSED("can't send non-None value to a just-started generator", "\377\203send non-None\310\231\247just-started\212")
+MP_MATCH_COMPRESSED("chr() arg not in range(256)", "\377chr()\210\204\237range(256)")
+MP_MATCH_COMPRESSED("decimal numbers not supported", "\377decimal numbers\204\206")
+MP_MATCH_COMPRESSED("default 'except' must be last", "\377\260\335\205\217last")
+MP_MATCH_COMPRESSED("dict update sequence has wrong length", "\377dict update\256\263\223\272")
+MP_MATCH_COMPRESSED("divide by zero", "\377divide\373\317")
+MP_MATCH_COMPRESSED("empty separator", "\377\235separator")
+MP_MATCH_COMPRESSED("exceptions must derive from BaseException", "\377exceptions\205derive\312\345")
+MP_MATCH_COMPRESSED("expected tuple/list", "\377expected\245")
+MP_MATCH_COMPRESSED("function got multiple values for argument '%q'", "\377\201got\220\276\225\200\311")
+MP_MATCH_COMPRESSED("function missing keyword-only argument", "\377\201\227keyword-only\200")
+MP_MATCH_COMPRESSED("function missing required keyword argument '%q'", "\377\201\227\222\211\200\311")
+MP_MATCH_COMPRESSED("function missing required positional argument #%d", "\377\201\227\222\214\200\330")
+MP_MATCH_COMPRESSED("generator already executing", "\377\212\357executing")
+MP_MATCH_COMPRESSED("generator ignored GeneratorExit", "\377\212ignored\346")
+MP_MATCH_COMPRESSED("generator raised StopIteration", "\377\212raised\351")
+MP_MATCH_COMPRESSED("identifier redefined as global", "\377\244\251\324global")
+MP_MATCH_COMPRESSED("identifier redefined as nonlocal", "\377\244\251\324\221")
+MP_MATCH_COMPRESSED("index out of range", "\377\303\265\215\241")
+MP_MATCH_COMPRESSED("indices must be integers", "\377indices\205\217integers")
+MP_MATCH_COMPRESSED("int() arg 2 must be >= 2 and <= 36", "\377int()\210\320\205\217\344\320\360\343\342")
+MP_MATCH_COMPRESSED("invalid micropython decorator", "\377\226micropython decorator")
+MP_MATCH_COMPRESSED("invalid syntax", "\377\226\275")
+MP_MATCH_COMPRESSED("invalid syntax for integer", "\377\226\275\225integer")
+MP_MATCH_COMPRESSED("issubclass() arg 1 must be a class", "\377\233\210\327\205\217\247\302")
+MP_MATCH_COMPRESSED("issubclass() arg 2 must be a class or a tuple of classes", "\377\233\210\320\205\217\247\302\326\247\307\215classes")
+MP_MATCH_COMPRESSED("join expects a list of str/bytes objects consistent with self object", "\377join\261\247\314\215str/bytes objects consistent\252\316\202")
+MP_MATCH_COMPRESSED("local variable referenced before assignment", "\377local variable referenced\370\207")
+MP_MATCH_COMPRESSED("long int not supported in this build", "\377\315\264\204\206\237this\372")
+MP_MATCH_COMPRESSED("memory allocation failed, allocating %u bytes", "\377\273\242\262\356\332\301")
+MP_MATCH_COMPRESSED("memory allocation failed, heap is locked", "\377\273\242\262heap\325locked")
+MP_MATCH_COMPRESSED("module not found", "\377module\204\236")
+MP_MATCH_COMPRESSED("multiple *x in assignment", "\377\220\323\237\207")
+MP_MATCH_COMPRESSED("multiple bases have instance lay-out conflict", "\377\220\367have\253lay-out conflict")
+MP_MATCH_COMPRESSED("must use keyword argument for key function", "\377\205use\211\200\225key\201")
+MP_MATCH_COMPRESSED("name not defined", "\377\216\204defined")
+MP_MATCH_COMPRESSED("name too long", "\377\216\266\315")
+MP_MATCH_COMPRESSED("negative power with no float support", "\377\254power\252\240float\230")
+MP_MATCH_COMPRESSED("negative shift count", "\377\254shift count")
+MP_MATCH_COMPRESSED("no active exception to reraise", "\377\240\355exception\231reraise")
+MP_MATCH_COMPRESSED("no binding for nonlocal found", "\377\240\371\225\221\236")
+MP_MATCH_COMPRESSED("no such attribute", "\377\240such\364")
+MP_MATCH_COMPRESSED("non-default argument follows default argument", "\377non-default\200follows\260\200")
+MP_MATCH_COMPRESSED("object doesn't support item assignment", "\377\202\224\230\313\207")
+MP_MATCH_COMPRESSED("object doesn't support item deletion", "\377\202\224\230\313deletion")
+MP_MATCH_COMPRESSED("object has no len", "\377\202\263\240len")
+MP_MATCH_COMPRESSED("object isn't subscriptable", "\377\202\304subscriptable")
+MP_MATCH_COMPRESSED("object not an iterator", "\377\202\204\277iterator")
+MP_MATCH_COMPRESSED("object not callable", "\377\202\204\375")
+MP_MATCH_COMPRESSED("object not in sequence", "\377\202\204\237\256")
+MP_MATCH_COMPRESSED("object not iterable", "\377\202\204iterable")
+MP_MATCH_COMPRESSED("object with buffer protocol required", "\377\202\252\267protocol\222")
+MP_MATCH_COMPRESSED("opcode", "opcode")
+MP_MATCH_COMPRESSED("ord expects a character", "\377ord\261\247\377")
+MP_MATCH_COMPRESSED("pop from empty list", "\377pop\312\235\314")
+MP_MATCH_COMPRESSED("popitem(): dictionary is empty", "\377popitem(): dictionary\325\235")
+MP_MATCH_COMPRESSED("positional arg after **", "\377\214\210\234\322")
+MP_MATCH_COMPRESSED("positional arg after keyword arg", "\377\214\210\234\211\210")
+MP_MATCH_COMPRESSED("rsplit(None,n)", "rsplit(None,n)")
+MP_MATCH_COMPRESSED("small int overflow", "\377\306\264\255")
+MP_MATCH_COMPRESSED("stream operation not supported", "\377stream operation\204\206")
+MP_MATCH_COMPRESSED("substring not found", "\377substring\204\236")
+MP_MATCH_COMPRESSED("super() can't find self", "\377super()\203find\316")
+MP_MATCH_COMPRESSED("too many args", "\377\266many\362")
+MP_MATCH_COMPRESSED("tuple index out of range", "\377\307\303\265\215\241")
+MP_MATCH_COMPRESSED("tuple/list has wrong length", "\377\245\263\223\272")
+MP_MATCH_COMPRESSED("type isn't an acceptable base type", "\377\232\304\277\354\366\232")
+MP_MATCH_COMPRESSED("type takes 1 or 3 arguments", "\377\232takes\327\326\340\250")
+MP_MATCH_COMPRESSED("unexpected indent", "\377\246\271")
+MP_MATCH_COMPRESSED("unexpected keyword argument", "\377\246\211\200")
+MP_MATCH_COMPRESSED("unicode name escapes", "\377unicode\216escapes")
+MP_MATCH_COMPRESSED("unindent doesn't match any outer indent level", "\377unindent\224match\361\305\271level")
+MP_MATCH_COMPRESSED("unsupported type for operator", "\377unsupported\232\225operator")
+MP_MATCH_COMPRESSED("wrong number of arguments", "\377\223\274\215\250")
+MP_MATCH_COMPRESSED("wrong number of values to unpack", "\377\223\274\215\276\231unpack")
+MP_MATCH_COMPRESSED("zero step", "\377\317step")
+// Total input length:      2919
+// Total compressed length: 1254
+// Total data length:       1118
+// Predicted saving:        547
+
+// gzip length:             1791
+// Percentage of gzip:      132.4%
+// zlib length:             1779
+// Percentage of zlib:      133.3%
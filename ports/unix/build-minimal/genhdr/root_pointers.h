@@ -0,0 +1,6 @@
+// Automatically generated by make_root_pointers.py.
+
+mp_obj_list_t mp_sys_argv_obj;
+mp_obj_t sys_mutable[MP_SYS_MUTABLE_NUM];
+struct _mp_vfs_mount_t *vfs_cur;
+struct _mp_vfs_mount_t *vfs_mount_table;
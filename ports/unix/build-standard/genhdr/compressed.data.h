@@ -0,0 +1,228 @@
+#define MP_MAX_UNCOMPRESSED_TEXT_LEN (73)
+MP_COMPRESSED_DATA("can'\364'%q\247objec\364forma\364argumen\364functio\356argument\363no\364mus\364positiona\354keywor\344'%s\247specifie\362t\357conver\364strin\347o\346require\344typ\345fo\362b\345inde\370ar\347attribut\345invali\344%\344empt\371implemente\344isn'\364unsupporte\344wit\350assignmen\364i\356\341outsid\345generato\362supporte\344lengt\350expecte\344fro\355comple\370doesn'\364erro\362missin\347rang\345conversio\356identifie\362a\356n\357synta\370bu\364expectin\347ha\363in\364nam\345afte\362fiel\344give\356multipl\345need\363nonloca\354overflo\367sequenc\345tupl\345allowe\344ou\364struct\272to\357unknow\356dic\364i\363lis\364o\362zer\357impor\364numbe\362shoul\344specificatio\356value\363incompatibl\345issubclass(\251%\361%\363an\344byte\363clas\363foun\344loca\354stor\345take\363valu\345allocatio\356expressio\356implicitl\371incomplet\345unexpecte\344.mp\371arg\363automati\343cod\345hea\360integers\254numberin\347operatio\356redefine\344sel\346negativ\345defaul\364failed\254go\364indice\363intege\362se\364suppor\364befor\345binar\371buffe\362divid\345inden\364manua\354memor\371mktim\345modul\345nativ\345retur\356switc\350unpac\353asyn\343")
+MP_MATCH_COMPRESSED("%c needs int or char", "\377%c\273\265\310char")
+MP_MATCH_COMPRESSED("%q index out of range", "\377\321\225\301\220\254")
+MP_MATCH_COMPRESSED("%q indices must be integers, not %s", "\377\321\356\210\224\345\207\322")
+MP_MATCH_COMPRESSED("%q() takes %d positional arguments but %d were given", "\377%q()\331\231\211\206\262\231were\271")
+MP_MATCH_COMPRESSED("'%q' argument required", "\377\201\204\221")
+MP_MATCH_COMPRESSED("'%s' object doesn't support item assignment", "\377\213\202\251\361item\237")
+MP_MATCH_COMPRESSED("'%s' object doesn't support item deletion", "\377\213\202\251\361item deletion")
+MP_MATCH_COMPRESSED("'%s' object has no attribute '%q'", "\377\213\202\264\260\227\201")
+MP_MATCH_COMPRESSED("'%s' object isn't an iterator", "\377\213\202\234\257iterator")
+MP_MATCH_COMPRESSED("'%s' object isn't callable", "\377\213\202\234callable")
+MP_MATCH_COMPRESSED("'%s' object isn't iterable", "\377\213\202\234iterable")
+MP_MATCH_COMPRESSED("'%s' object isn't subscriptable", "\377\213\202\234subscriptable")
+MP_MATCH_COMPRESSED("'=' alignment not allowed in string format specifier", "\377'=' alignment\207\300\240\217\203\214")
+MP_MATCH_COMPRESSED("'await' outside function", "\377'await'\242\205")
+MP_MATCH_COMPRESSED("'break'/'continue' outside loop", "\377'break'/'continue'\242loop")
+MP_MATCH_COMPRESSED("'not' not implemented", "\377'not'\207\233")
+MP_MATCH_COMPRESSED("'return' outside function", "\377'return'\242\205")
+MP_MATCH_COMPRESSED("'yield' outside function", "\377'yield'\242\205")
+MP_MATCH_COMPRESSED("* arg after **", "\377*\226\267**")
+MP_MATCH_COMPRESSED("*x must be assignment target", "\377*x\210\224\237target")
+MP_MATCH_COMPRESSED("0.0 to a complex power", "\3770.0\215\241\250power")
+MP_MATCH_COMPRESSED("I/O operation on closed file", "\377I/O\347on closed file")
+MP_MATCH_COMPRESSED("LHS of keyword arg must be an id", "\377LHS\220\212\226\210\224\257id")
+MP_MATCH_COMPRESSED("[addrinfo error %d]", "\377[addrinfo\252%d]")
+MP_MATCH_COMPRESSED("__init__() should return None, not '%s'", "\377__init__()\314\374None,\207\213")
+MP_MATCH_COMPRESSED("abort() called", "abort() called")
+MP_MATCH_COMPRESSED("address %08x is not aligned to %d bytes", "\377address %08x\306\207aligned\215\231\324")
+MP_MATCH_COMPRESSED("annotation must be an identifier", "\377annotation\210\224\257\256")
+MP_MATCH_COMPRESSED("arg is an empty sequence", "\377\226\306\257\232\276")
+MP_MATCH_COMPRESSED("arg must be user-type", "\377\226\210\224user-type")
+MP_MATCH_COMPRESSED("argument name reused", "\377\204\266reused")
+MP_MATCH_COMPRESSED("argument num/types mismatch", "\377\204num/types mismatch")
+MP_MATCH_COMPRESSED("argument should be a '%q' not a '%q'", "\377\204\314\224\241\201\207\241\201")
+MP_MATCH_COMPRESSED("array/bytes required on right side", "\377array/bytes\221on right side")
+MP_MATCH_COMPRESSED("async for/with outside async function", "\377\377for/with\242\377\205")
+MP_MATCH_COMPRESSED("attributes not supported", "\377attributes\207\244")
+MP_MATCH_COMPRESSED("bad compile mode", "bad compile mode")
+MP_MATCH_COMPRESSED("bad typecode", "bad typecode")
+MP_MATCH_COMPRESSED("binary op %q not implemented", "\377\363op\321\207\233")
+MP_MATCH_COMPRESSED("bits must be 32 or less", "\377bits\210\22432\310less")
+MP_MATCH_COMPRESSED("buffer too small", "\377\364\303small")
+MP_MATCH_COMPRESSED("bytecode overflow", "\377bytecode\275")
+MP_MATCH_COMPRESSED("bytes value out of range", "\377\324\332\301\220\254")
+MP_MATCH_COMPRESSED("call super().__init__() first", "call super().__init__() first")
+MP_MATCH_COMPRESSED("can't add special method to already-subclassed class", "\377\200add special method\215already-subclassed\325")
+MP_MATCH_COMPRESSED("can't assign to expression", "\377\200assign\215\334")
+MP_MATCH_COMPRESSED("can't cancel self", "\377\200cancel\351")
+MP_MATCH_COMPRESSED("can't convert %s to complex", "\377\200\216\322\215\250")
+MP_MATCH_COMPRESSED("can't convert %s to float", "\377\200\216\322\215float")
+MP_MATCH_COMPRESSED("can't convert %s to int", "\377\200\216\322\215\265")
+MP_MATCH_COMPRESSED("can't convert '%q' object to %q implicitly", "\377\200\216\201\202\215\321\335")
+MP_MATCH_COMPRESSED("can't convert NaN to int", "\377\200\216NaN\215\265")
+MP_MATCH_COMPRESSED("can't convert inf to int", "\377\200\216inf\215\265")
+MP_MATCH_COMPRESSED("can't create '%q' instances", "\377\200create\201instances")
+MP_MATCH_COMPRESSED("can't declare nonlocal in outer code", "\377\200declare\274\240outer\343")
+MP_MATCH_COMPRESSED("can't delete expression", "\377\200delete\334")
+MP_MATCH_COMPRESSED("can't do binary op between '%q' and '%q'", "\377\200do\363op between\201\323\201")
+MP_MATCH_COMPRESSED("can't do unary op of '%q'", "\377\200do unary op\220\201")
+MP_MATCH_COMPRESSED("can't implicitly convert '%q' to 'bool'", "\377\200\335\216\201\215'bool'")
+MP_MATCH_COMPRESSED("can't import name %q", "\377\200\312\266\321")
+MP_MATCH_COMPRESSED("can't load from '%q'", "\377\200load\247\201")
+MP_MATCH_COMPRESSED("can't load with '%q' index", "\377\200load\236\201\225")
+MP_MATCH_COMPRESSED("can't perform relative import", "\377\200perform relative\312")
+MP_MATCH_COMPRESSED("can't send non-None value to a just-started generator", "\377\200send non-None\332\215\241just-started\243")
+MP_MATCH_COMPRESSED("can't set attribute", "\377\200\360\227")
+MP_MATCH_COMPRESSED("can't store '%q'", "\377\200\330\201")
+MP_MATCH_COMPRESSED("can't store to '%q'", "\377\200\330\215\201")
+MP_MATCH_COMPRESSED("can't store with '%q' index", "\377\200\330\236\201\225")
+MP_MATCH_COMPRESSED("can't switch from automatic field numbering to manual field specification", "\377\200\375\247\342\270\346\215\367\270\315")
+MP_MATCH_COMPRESSED("can't switch from manual field specification to automatic field numbering", "\377\200\375\247\367\270\315\215\342\270\346")
+MP_MATCH_COMPRESSED("can't truncate-divide a complex number", "\377\200truncate-divide\241\250\313")
+MP_MATCH_COMPRESSED("can't unambiguously get sizeof scalar", "\377\200unambiguously get sizeof scalar")
+MP_MATCH_COMPRESSED("can't wait", "\377\200wait")
+MP_MATCH_COMPRESSED("casting", "casting")
+MP_MATCH_COMPRESSED("chr() arg not in range(0x110000)", "\377chr()\226\207\240range(0x110000)")
+MP_MATCH_COMPRESSED("comparison of int and uint", "\377comparison\220\265\323uint")
+MP_MATCH_COMPRESSED("complex divide by zero", "\377\250\365by\311")
+MP_MATCH_COMPRESSED("conversion to object", "\377\255\215\202")
+MP_MATCH_COMPRESSED("default 'except' must be last", "\377\353'except'\210\224last")
+MP_MATCH_COMPRESSED("dict update sequence has wrong length", "\377\305update\276\264wrong\245")
+MP_MATCH_COMPRESSED("div/mod not implemented for uint", "\377div/mod\207\233\223uint")
+MP_MATCH_COMPRESSED("divide by zero", "\377\365by\311")
+MP_MATCH_COMPRESSED("empty", "\377\232")
+MP_MATCH_COMPRESSED("empty heap", "\377\232\344")
+MP_MATCH_COMPRESSED("empty separator", "\377\232separator")
+MP_MATCH_COMPRESSED("end of format while looking for conversion specifier", "\377end\220\203while looking\223\255\214")
+MP_MATCH_COMPRESSED("error in regex", "\377\252\240regex")
+MP_MATCH_COMPRESSED("exceptions must derive from BaseException", "\377exceptions\210derive\247BaseException")
+MP_MATCH_COMPRESSED("expected ':' after format specifier", "\377\246':'\267\203\214")
+MP_MATCH_COMPRESSED("expecting a dict for keyword args", "\377\263\241\305\223\212\341")
+MP_MATCH_COMPRESSED("expecting just a value for set", "\377\263just\241\332\223\360")
+MP_MATCH_COMPRESSED("expecting key:value for dict", "\377\263key:value\223\305")
+MP_MATCH_COMPRESSED("extra keyword arguments given", "\377extra\212\206\271")
+MP_MATCH_COMPRESSED("extra positional arguments given", "\377extra\211\206\271")
+MP_MATCH_COMPRESSED("float not supported", "\377float\207\244")
+MP_MATCH_COMPRESSED("format", "\377\203")
+MP_MATCH_COMPRESSED("format needs a dict", "\377\203\273\241\305")
+MP_MATCH_COMPRESSED("format string didn't convert all arguments", "\377\203\217didn't\216all\206")
+MP_MATCH_COMPRESSED("format string needs more arguments", "\377\203\217\273more\206")
+MP_MATCH_COMPRESSED("full", "full")
+MP_MATCH_COMPRESSED("function doesn't take keyword arguments", "\377\205\251take\212\206")
+MP_MATCH_COMPRESSED("function expected at most %d arguments, got %d", "\377\205\246at most\231arguments,\355\231")
+MP_MATCH_COMPRESSED("function got multiple values for argument '%q'", "\377\205\355\272\316\223\204\201")
+MP_MATCH_COMPRESSED("function missing %d required positional arguments", "\377\205\253\231\221\211\206")
+MP_MATCH_COMPRESSED("function missing keyword-only argument", "\377\205\253keyword-only\204")
+MP_MATCH_COMPRESSED("function missing required keyword argument '%q'", "\377\205\253\221\212\204\201")
+MP_MATCH_COMPRESSED("function missing required positional argument #%d", "\377\205\253\221\211\204#%d")
+MP_MATCH_COMPRESSED("function takes %d positional arguments but %d were given", "\377\205\331\231\211\206\262\231were\271")
+MP_MATCH_COMPRESSED("generator already executing", "\377\243already executing")
+MP_MATCH_COMPRESSED("generator ignored GeneratorExit", "\377\243ignored GeneratorExit")
+MP_MATCH_COMPRESSED("generator raised StopIteration", "\377\243raised StopIteration")
+MP_MATCH_COMPRESSED("hash is final", "\377hash\306final")
+MP_MATCH_COMPRESSED("heap must be a list", "\377\344\210\224\241\307")
+MP_MATCH_COMPRESSED("identifier redefined as global", "\377\256\350as global")
+MP_MATCH_COMPRESSED("identifier redefined as nonlocal", "\377\256\350as\274")
+MP_MATCH_COMPRESSED("import * not at module level", "\377\312*\207at\372level")
+MP_MATCH_COMPRESSED("incompatible .mpy arch", "\377\317\340arch")
+MP_MATCH_COMPRESSED("incompatible .mpy file", "\377\317\340file")
+MP_MATCH_COMPRESSED("incomplete format", "\377\336\203")
+MP_MATCH_COMPRESSED("incomplete format key", "\377\336\203key")
+MP_MATCH_COMPRESSED("incorrect padding", "incorrect padding")
+MP_MATCH_COMPRESSED("int() arg 2 must be >= 2 and <= 36", "\377int()\2262\210\224>= 2\323<= 36")
+MP_MATCH_COMPRESSED("integer needed", "\377\357needed")
+MP_MATCH_COMPRESSED("invalid format", "\377\230\203")
+MP_MATCH_COMPRESSED("invalid format specifier", "\377\230\203\214")
+MP_MATCH_COMPRESSED("invalid micropython decorator", "\377\230micropython decorator")
+MP_MATCH_COMPRESSED("invalid mktime usage", "\377\230\371usage")
+MP_MATCH_COMPRESSED("invalid syntax", "\377\230\261")
+MP_MATCH_COMPRESSED("invalid syntax for number", "\377\230\261\223\313")
+MP_MATCH_COMPRESSED("issubclass() arg 1 must be a class", "\377\320\2261\210\224\241\325")
+MP_MATCH_COMPRESSED("issubclass() arg 2 must be a class or a tuple of classes", "\377\320\2262\210\224\241\325\310\241\277\220classes")
+MP_MATCH_COMPRESSED("join expects a list of str/bytes objects consistent with self object", "\377join expects\241\307\220str/bytes objects consistent\236\351\202")
+MP_MATCH_COMPRESSED("keyword argument(s) not implemented - use normal args instead", "\377\212argument(s)\207\233- use normal\341instead")
+MP_MATCH_COMPRESSED("lhs and rhs should be compatible", "\377lhs\323rhs\314\224compatible")
+MP_MATCH_COMPRESSED("local '%q' has type '%q' but source is '%q'", "\377\327\201\264\222\201\262source\306\201")
+MP_MATCH_COMPRESSED("local '%q' used before type known", "\377\327\201used\362\222known")
+MP_MATCH_COMPRESSED("local variable referenced before assignment", "\377\327variable referenced\362\237")
+MP_MATCH_COMPRESSED("malformed f-string", "malformed f-string")
+MP_MATCH_COMPRESSED("math domain error", "\377math domain\252")
+MP_MATCH_COMPRESSED("memory allocation failed, allocating %u bytes", "\377\370\333\354allocating %u\324")
+MP_MATCH_COMPRESSED("memory allocation failed, heap is locked", "\377\370\333\354\344\306locked")
+MP_MATCH_COMPRESSED("memoryview offset too large", "\377memoryview offset\303large")
+MP_MATCH_COMPRESSED("mktime needs a tuple of length 8 or 9", "\377\371\273\241\277\220\2458\3109")
+MP_MATCH_COMPRESSED("multiple *x in assignment", "\377\272*x\240\237")
+MP_MATCH_COMPRESSED("multiple bases have instance lay-out conflict", "\377\272bases have instance lay-out conflict")
+MP_MATCH_COMPRESSED("must raise an object", "\377\210raise\257\202")
+MP_MATCH_COMPRESSED("must use keyword argument for key function", "\377\210use\212\204\223key\205")
+MP_MATCH_COMPRESSED("name '%q' isn't defined", "\377\266\201\234defined")
+MP_MATCH_COMPRESSED("name too long", "\377\266\303long")
+MP_MATCH_COMPRESSED("native code in .mpy unsupported", "\377\373\343\240\340\235")
+MP_MATCH_COMPRESSED("native yield", "\377\373yield")
+MP_MATCH_COMPRESSED("need more than %d values to unpack", "\377need more than\231\316\215\376")
+MP_MATCH_COMPRESSED("negative factorial", "\377\352factorial")
+MP_MATCH_COMPRESSED("negative shift count", "\377\352shift count")
+MP_MATCH_COMPRESSED("no active exception to reraise", "\377\260active exception\215reraise")
+MP_MATCH_COMPRESSED("no binding for nonlocal found", "\377\260binding\223\274\326")
+MP_MATCH_COMPRESSED("no module named '%q'", "\377\260\372named\201")
+MP_MATCH_COMPRESSED("no such attribute", "\377\260such\227")
+MP_MATCH_COMPRESSED("non-default argument follows default argument", "\377non-default\204follows\353\204")
+MP_MATCH_COMPRESSED("non-hex digit", "non-hex digit")
+MP_MATCH_COMPRESSED("not a constant", "\377\207\241constant")
+MP_MATCH_COMPRESSED("object '%s' isn't a tuple or list", "\377\202\213\234\241\277\310\307")
+MP_MATCH_COMPRESSED("object not in sequence", "\377\202\207\240\276")
+MP_MATCH_COMPRESSED("object of type '%s' has no len()", "\377\202\220\222\213\264\260len()")
+MP_MATCH_COMPRESSED("object with buffer protocol required", "\377\202\236\364protocol\221")
+MP_MATCH_COMPRESSED("only slices with step=1 (aka None) are supported", "\377only slices\236step=1 (aka None) are\244")
+MP_MATCH_COMPRESSED("opcode", "opcode")
+MP_MATCH_COMPRESSED("ord() expected a character, but string of length %d found", "\377ord()\246\241character,\262\217\220\245\231\326")
+MP_MATCH_COMPRESSED("overflow converting long int to machine word", "\377\275converting long\265\215machine word")
+MP_MATCH_COMPRESSED("pop from an empty set", "\377pop\247\257\232\360")
+MP_MATCH_COMPRESSED("pop from empty list", "\377pop\247\232\307")
+MP_MATCH_COMPRESSED("popitem(): dictionary is empty", "\377popitem(): dictionary\306\232")
+MP_MATCH_COMPRESSED("positional arg after **", "\377\211\226\267**")
+MP_MATCH_COMPRESSED("positional arg after keyword arg", "\377\211\226\267\212\226")
+MP_MATCH_COMPRESSED("pow() with 3 arguments requires integers", "\377pow()\2363\206requires integers")
+MP_MATCH_COMPRESSED("requested length %d but object has length %d", "\377requested\245\231\262\202\264\245\231")
+MP_MATCH_COMPRESSED("return expected '%q' but got '%q'", "\377\374\246\201\262\355\201")
+MP_MATCH_COMPRESSED("rsplit(None,n)", "rsplit(None,n)")
+MP_MATCH_COMPRESSED("schedule queue full", "schedule queue full")
+MP_MATCH_COMPRESSED("sign not allowed in string format specifier", "\377sign\207\300\240\217\203\214")
+MP_MATCH_COMPRESSED("sign not allowed with integer format specifier 'c'", "\377sign\207\300\236\357\203\214'c'")
+MP_MATCH_COMPRESSED("single '}' encountered in format string", "\377single '}' encountered\240\203\217")
+MP_MATCH_COMPRESSED("slice step can't be zero", "\377slice step\200\224\311")
+MP_MATCH_COMPRESSED("splitting with sub-captures", "\377splitting\236sub-captures")
+MP_MATCH_COMPRESSED("stream operation not supported", "\377stream\347\207\244")
+MP_MATCH_COMPRESSED("string argument without an encoding", "\377\217\204without\257encoding")
+MP_MATCH_COMPRESSED("string index out of range", "\377\217\225\301\220\254")
+MP_MATCH_COMPRESSED("string indices must be integers, not %s", "\377\217\356\210\224\345\207\322")
+MP_MATCH_COMPRESSED("struct: can't index", "\377\302\200\225")
+MP_MATCH_COMPRESSED("struct: index out of range", "\377\302\225\301\220\254")
+MP_MATCH_COMPRESSED("struct: no fields", "\377\302\260fields")
+MP_MATCH_COMPRESSED("substring not found", "\377substring\207\326")
+MP_MATCH_COMPRESSED("super() can't find self", "\377super()\200find\351")
+MP_MATCH_COMPRESSED("syntax error in JSON", "\377\261\252\240JSON")
+MP_MATCH_COMPRESSED("syntax error in uctypes descriptor", "\377\261\252\240uctypes descriptor")
+MP_MATCH_COMPRESSED("ticks interval overflow", "\377ticks interval\275")
+MP_MATCH_COMPRESSED("too many args", "\377\303many\341")
+MP_MATCH_COMPRESSED("too many values to unpack (expected %d)", "\377\303many\316\215\376(expected %d)")
+MP_MATCH_COMPRESSED("tuple index out of range", "\377\277\225\301\220\254")
+MP_MATCH_COMPRESSED("type '%q' isn't an acceptable base type", "\377\222\201\234\257acceptable base\222")
+MP_MATCH_COMPRESSED("type object '%q' has no attribute '%q'", "\377\222\202\201\264\260\227\201")
+MP_MATCH_COMPRESSED("type takes 1 or 3 arguments", "\377\222\3311\3103\206")
+MP_MATCH_COMPRESSED("unexpected indent", "\377\337\366")
+MP_MATCH_COMPRESSED("unexpected keyword argument '%q'", "\377\337\212\204\201")
+MP_MATCH_COMPRESSED("unicode name escapes", "\377unicode\266escapes")
+MP_MATCH_COMPRESSED("unindent doesn't match any outer indent level", "\377unindent\251match any outer\366level")
+MP_MATCH_COMPRESSED("unknown conversion specifier %c", "\377\304\255\214%c")
+MP_MATCH_COMPRESSED("unknown format code '%c' for object of type '%s'", "\377\304\203\343'%c'\223\202\220\222\213")
+MP_MATCH_COMPRESSED("unknown type '%q'", "\377\304\222\201")
+MP_MATCH_COMPRESSED("unmatched '{' in format", "\377unmatched '{'\240\203")
+MP_MATCH_COMPRESSED("unreadable attribute", "\377unreadable\227")
+MP_MATCH_COMPRESSED("unsupported format character '%c' (0x%x) at index %d", "\377\235\203character '%c' (0x%x) at\225\231")
+MP_MATCH_COMPRESSED("unsupported type for %q: '%s'", "\377\235\222\223%q:\213")
+MP_MATCH_COMPRESSED("unsupported types for %q: '%s', '%s'", "\377\235types\223%q: '%s',\213")
+MP_MATCH_COMPRESSED("wbits", "wbits")
+MP_MATCH_COMPRESSED("wrong number of arguments", "\377wrong\313\220\206")
+MP_MATCH_COMPRESSED("zero step", "\377\311step")
+// Total input length:      6498
+// Total compressed length: 3033
+// Total data length:       1153
+// Predicted saving:        2312
+
+// gzip length:             3605
+// Percentage of gzip:      116.1%
+// zlib length:             3593
+// Percentage of zlib:      116.5%
@@ -0,0 +1,4 @@
+// This file was generated by py/makeversionhdr.py
+#define MICROPY_GIT_TAG "7e62eb7-dirty"
+#define MICROPY_GIT_HASH "7e62eb7"
+#define MICROPY_BUILD_DATE "2026-10-18"
@@ -19,6 +19,11 @@
 #include "py/stream.h"
 #include "py/binary.h"
 #include "py/bc.h"
+#include "shared/runtime/eventring.h"
+
+#if MICROPY_PY_THREAD
+#include <pthread.h>
+#endif
 
 // expected output of this file is found in extra_coverage.py.exp
 
@@ -150,6 +155,60 @@ static MP_DEFINE_CONST_OBJ_TYPE(
 static const mp_obj_str_t str_no_hash_obj = {{&mp_type_str}, 0, 10, (const byte *)"0123456789"};
 static const mp_obj_str_t bytes_no_hash_obj = {{&mp_type_bytes}, 0, 10, (const byte *)"0123456789"};
 
+// Push a sequence of events into an event ring, like an ISR would.
+#define EVENT_RING_STRESS_N (200000)
+
+static void *event_ring_producer(void *arg) {
+    mp_event_ring_t *r = arg;
+    for (uint32_t i = 0; i < EVENT_RING_STRESS_N; ++i) {
+        mp_event_ring_put(r, i, i & 1);
+    }
+    return NULL;
+}
+
+// Drain the ring while the producer runs in another thread and check that
+// the events arrive in order, with every missing event counted as overflow.
+static void event_ring_stress_test(void) {
+    mp_event_ring_event_t storage[16];
+    mp_event_ring_t ring;
+    mp_event_ring_init(&ring, storage, MP_ARRAY_SIZE(storage));
+
+    #if MICROPY_PY_THREAD
+    pthread_t producer;
+    pthread_create(&producer, NULL, event_ring_producer, &ring);
+    #endif
+
+    uint32_t received = 0;
+    uint32_t next = 0;
+    bool ordered = true;
+    bool done = false;
+    while (!done) {
+        #if MICROPY_PY_THREAD
+        done = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE) + mp_event_ring_overflow(&ring) == EVENT_RING_STRESS_N;
+        #else
+        event_ring_producer(&ring);
+        done = true;
+        #endif
+        mp_event_ring_event_t ev[5];
+        uint32_t n;
+        while ((n = mp_event_ring_get(&ring, ev, MP_ARRAY_SIZE(ev))) != 0) {
+            for (uint32_t i = 0; i < n; ++i) {
+                if (ev[i].time < next || ev[i].value != (ev[i].time & 1)) {
+                    ordered = false;
+                }
+                next = ev[i].time + 1;
+            }
+            received += n;
+        }
+    }
+
+    #if MICROPY_PY_THREAD
+    pthread_join(producer, NULL);
+    #endif
+
+    mp_printf(&mp_plat_print, "%d %d\n", ordered, received + mp_event_ring_overflow(&ring) == EVENT_RING_STRESS_N);
+}
+
 static int pairheap_lt(mp_pairheap_t *a, mp_pairheap_t *b) {
     return (uintptr_t)a < (uintptr_t)b;
 }
@@ -737,6 +796,35 @@ static mp_obj_t extra_coverage(void) {
         mp_printf(&mp_plat_print, "%d\n", ringbuf_put_bytes(&ringbuf, large, sizeof(large)));
     }
 
+    // eventring
+    {
+        mp_event_ring_event_t storage[4];
+        mp_event_ring_t ring;
+        mp_event_ring_init(&ring, storage, MP_ARRAY_SIZE(storage));
+
+        mp_printf(&mp_plat_print, "# eventring\n");
+
+        // Fill past capacity, the extra events are dropped and counted.
+        for (int i = 0; i < 6; ++i) {
+            mp_printf(&mp_plat_print, "%d", mp_event_ring_put(&ring, 100 + i, i));
+        }
+        mp_printf(&mp_plat_print, " %d %d\n", mp_event_ring_avail(&ring), mp_event_ring_overflow(&ring));
+
+        // Partial drain, then put more so the indices wrap around the storage.
+        mp_event_ring_event_t ev[8];
+        uint32_t n = mp_event_ring_get(&ring, ev, 3);
+        mp_event_ring_put(&ring, 200, 1);
+        mp_event_ring_put(&ring, 201, 0);
+        n += mp_event_ring_get(&ring, ev + n, MP_ARRAY_SIZE(ev) - n);
+        for (uint32_t i = 0; i < n; ++i) {
+            mp_printf(&mp_plat_print, " %u:%u", (uint)ev[i].time, (uint)ev[i].value);
+        }
+        mp_printf(&mp_plat_print, "\n%d\n", mp_event_ring_get(&ring, ev, 1));
+
+        // Concurrent producer and consumer.
+        event_ring_stress_test();
+    }
+
     // pairheap
     {
         mp_printf(&mp_plat_print, "# pairheap\n");
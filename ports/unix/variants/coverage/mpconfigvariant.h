@@ -37,6 +37,12 @@
 #define MICROPY_GC_SPLIT_HEAP          (1)
 #define MICROPY_GC_SPLIT_HEAP_N_HEAPS  (4)
 
+// Enable testing of lazy sweeping.
+#define MICROPY_GC_LAZY_SWEEP          (1)
+
+// Enable testing of allocating floats in batches.
+#define MICROPY_FLOAT_FREELIST         (32)
+
 // Enable additional features.
 #define MICROPY_DEBUG_PARSE_RULE_NAME  (1)
 #define MICROPY_TRACKED_ALLOC          (1)
@@ -33,6 +33,16 @@
 #define MP_ASM_PASS_COMPUTE (1)
 #define MP_ASM_PASS_EMIT    (2)
 
+// Comparisons for ASM_FLOAT_SETCC_REG_REG_REG, in the same order as the
+// MP_BINARY_OP_LESS to MP_BINARY_OP_NOT_EQUAL binary operators.  All of
+// them are false for an unordered (NaN) operand, except NE which is true.
+#define ASM_FLOAT_CC_LT (0)
+#define ASM_FLOAT_CC_GT (1)
+#define ASM_FLOAT_CC_EQ (2)
+#define ASM_FLOAT_CC_LE (3)
+#define ASM_FLOAT_CC_GE (4)
+#define ASM_FLOAT_CC_NE (5)
+
 typedef struct _mp_asm_base_t {
     uint8_t pass;
 
@@ -602,4 +602,69 @@ void asm_rv32_meta_comparison_le(asm_rv32_t *state, mp_uint_t rs1, mp_uint_t rs2
     }
 }
 
+// The float operations below use ft0 (f0) and ft1 (f1) as scratch registers.
+
+void asm_rv32_float_op_reg_reg(asm_rv32_t *state, mp_uint_t op, mp_uint_t rd, mp_uint_t rs) {
+    // fmv.w.x ft0, rd
+    // fmv.w.x ft1, rs
+    // fop.s   ft0, ft0, ft1
+    // fmv.x.w rd, ft0
+    asm_rv32_opcode_fmvwx(state, 0, rd);
+    asm_rv32_opcode_fmvwx(state, 1, rs);
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x07, op, 0, 0, 1));
+    asm_rv32_opcode_fmvxw(state, rd, 0);
+}
+
+void asm_rv32_float_neg_reg(asm_rv32_t *state, mp_uint_t rd) {
+    // fmv.w.x  ft0, rd
+    // fsgnjn.s ft0, ft0, ft0
+    // fmv.x.w  rd, ft0
+    asm_rv32_opcode_fmvwx(state, 0, rd);
+    asm_rv32_opcode_fsgnjns(state, 0, 0, 0);
+    asm_rv32_opcode_fmvxw(state, rd, 0);
+}
+
+void asm_rv32_float_from_int_reg(asm_rv32_t *state, mp_uint_t rd) {
+    // fcvt.s.w ft0, rd
+    // fmv.x.w  rd, ft0
+    asm_rv32_opcode_fcvtsw(state, 0, rd);
+    asm_rv32_opcode_fmvxw(state, rd, 0);
+}
+
+void asm_rv32_float_to_int_reg(asm_rv32_t *state, mp_uint_t rd) {
+    // fmv.w.x  ft0, rd
+    // fcvt.w.s rd, ft0, rtz
+    asm_rv32_opcode_fmvwx(state, 0, rd);
+    asm_rv32_opcode_fcvtws(state, rd, 0);
+}
+
+void asm_rv32_float_setcc_reg_reg_reg(asm_rv32_t *state, mp_uint_t cc, mp_uint_t rd, mp_uint_t rs1, mp_uint_t rs2) {
+    // fmv.w.x ft0, rs1
+    // fmv.w.x ft1, rs2
+    // feq/flt/fle.s rd, ft0, ft1 (or ft1, ft0 for GT and GE)
+    // xori    rd, rd, 1          (for NE)
+    asm_rv32_opcode_fmvwx(state, 0, rs1);
+    asm_rv32_opcode_fmvwx(state, 1, rs2);
+    switch (cc) {
+        case ASM_FLOAT_CC_LT:
+            asm_rv32_opcode_flts(state, rd, 0, 1);
+            break;
+        case ASM_FLOAT_CC_GT:
+            asm_rv32_opcode_flts(state, rd, 1, 0);
+            break;
+        case ASM_FLOAT_CC_LE:
+            asm_rv32_opcode_fles(state, rd, 0, 1);
+            break;
+        case ASM_FLOAT_CC_GE:
+            asm_rv32_opcode_fles(state, rd, 1, 0);
+            break;
+        default:
+            asm_rv32_opcode_feqs(state, rd, 0, 1);
+            if (cc == ASM_FLOAT_CC_NE) {
+                asm_rv32_opcode_xori(state, rd, rd, 1);
+            }
+            break;
+    }
+}
+
 #endif // MICROPY_EMIT_RV32
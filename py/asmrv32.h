@@ -487,6 +487,78 @@ static inline void asm_rv32_opcode_ecall(asm_rv32_t *state) {
     asm_rv32_emit_word_opcode(state, 0x73);
 }
 
+// FADD.S FD, FS1, FS2
+static inline void asm_rv32_opcode_fadds(asm_rv32_t *state, mp_uint_t fd, mp_uint_t fs1, mp_uint_t fs2) {
+    // R: 0000000 ..... ..... 111 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x07, 0x00, fd, fs1, fs2));
+}
+
+// FCVT.S.W FD, RS
+static inline void asm_rv32_opcode_fcvtsw(asm_rv32_t *state, mp_uint_t fd, mp_uint_t rs) {
+    // R: 1101000 00000 ..... 111 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x07, 0x68, fd, rs, 0x00));
+}
+
+// FCVT.W.S RD, FS, RTZ
+static inline void asm_rv32_opcode_fcvtws(asm_rv32_t *state, mp_uint_t rd, mp_uint_t fs) {
+    // R: 1100000 00000 ..... 001 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x01, 0x60, rd, fs, 0x00));
+}
+
+// FDIV.S FD, FS1, FS2
+static inline void asm_rv32_opcode_fdivs(asm_rv32_t *state, mp_uint_t fd, mp_uint_t fs1, mp_uint_t fs2) {
+    // R: 0001100 ..... ..... 111 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x07, 0x0C, fd, fs1, fs2));
+}
+
+// FEQ.S RD, FS1, FS2
+static inline void asm_rv32_opcode_feqs(asm_rv32_t *state, mp_uint_t rd, mp_uint_t fs1, mp_uint_t fs2) {
+    // R: 1010000 ..... ..... 010 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x02, 0x50, rd, fs1, fs2));
+}
+
+// FLE.S RD, FS1, FS2
+static inline void asm_rv32_opcode_fles(asm_rv32_t *state, mp_uint_t rd, mp_uint_t fs1, mp_uint_t fs2) {
+    // R: 1010000 ..... ..... 000 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x00, 0x50, rd, fs1, fs2));
+}
+
+// FLT.S RD, FS1, FS2
+static inline void asm_rv32_opcode_flts(asm_rv32_t *state, mp_uint_t rd, mp_uint_t fs1, mp_uint_t fs2) {
+    // R: 1010000 ..... ..... 001 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x01, 0x50, rd, fs1, fs2));
+}
+
+// FMUL.S FD, FS1, FS2
+static inline void asm_rv32_opcode_fmuls(asm_rv32_t *state, mp_uint_t fd, mp_uint_t fs1, mp_uint_t fs2) {
+    // R: 0001000 ..... ..... 111 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x07, 0x08, fd, fs1, fs2));
+}
+
+// FMV.W.X FD, RS
+static inline void asm_rv32_opcode_fmvwx(asm_rv32_t *state, mp_uint_t fd, mp_uint_t rs) {
+    // R: 1111000 00000 ..... 000 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x00, 0x78, fd, rs, 0x00));
+}
+
+// FMV.X.W RD, FS
+static inline void asm_rv32_opcode_fmvxw(asm_rv32_t *state, mp_uint_t rd, mp_uint_t fs) {
+    // R: 1110000 00000 ..... 000 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x00, 0x70, rd, fs, 0x00));
+}
+
+// FSGNJN.S FD, FS1, FS2
+static inline void asm_rv32_opcode_fsgnjns(asm_rv32_t *state, mp_uint_t fd, mp_uint_t fs1, mp_uint_t fs2) {
+    // R: 0010000 ..... ..... 001 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x01, 0x10, fd, fs1, fs2));
+}
+
+// FSUB.S FD, FS1, FS2
+static inline void asm_rv32_opcode_fsubs(asm_rv32_t *state, mp_uint_t fd, mp_uint_t fs1, mp_uint_t fs2) {
+    // R: 0000100 ..... ..... 111 ..... 1010011
+    asm_rv32_emit_word_opcode(state, RV32_ENCODE_TYPE_R(0x53, 0x07, 0x04, fd, fs1, fs2));
+}
+
 // JAL RD, OFFSET
 static inline void asm_rv32_opcode_jal(asm_rv32_t *state, mp_uint_t rd, mp_int_t offset) {
     // J: ......................... 1101111
@@ -703,6 +775,19 @@ void asm_rv32_meta_comparison_le(asm_rv32_t *state, mp_uint_t rs1, mp_uint_t rs2
 
 void asm_rv32_emit_optimised_load_immediate(asm_rv32_t *state, mp_uint_t rd, mp_int_t immediate);
 
+// These need the F extension and work on floats held as raw bits in integer
+// registers.  The ASM_RV32_FLOAT_OP_xxx values are the FADD.S etc. funct7.
+#define ASM_RV32_FLOAT_OP_ADD (0x00)
+#define ASM_RV32_FLOAT_OP_SUB (0x04)
+#define ASM_RV32_FLOAT_OP_MUL (0x08)
+#define ASM_RV32_FLOAT_OP_DIV (0x0C)
+
+void asm_rv32_float_op_reg_reg(asm_rv32_t *state, mp_uint_t op, mp_uint_t rd, mp_uint_t rs);
+void asm_rv32_float_neg_reg(asm_rv32_t *state, mp_uint_t rd);
+void asm_rv32_float_from_int_reg(asm_rv32_t *state, mp_uint_t rd);
+void asm_rv32_float_to_int_reg(asm_rv32_t *state, mp_uint_t rd);
+void asm_rv32_float_setcc_reg_reg_reg(asm_rv32_t *state, mp_uint_t cc, mp_uint_t rd, mp_uint_t rs1, mp_uint_t rs2);
+
 #ifdef GENERIC_ASM_API
 
 void asm_rv32_emit_call_ind(asm_rv32_t *state, mp_uint_t index);
@@ -755,6 +840,22 @@ void asm_rv32_emit_store_reg_reg_offset(asm_rv32_t *state, mp_uint_t source, mp_
 #define ASM_STORE_REG_REG_OFFSET(state, rd, rs, offset) asm_rv32_emit_store_reg_reg_offset(state, rd, rs, offset)
 #define ASM_SUB_REG_REG(state, rd, rs) asm_rv32_opcode_sub(state, rd, rd, rs)
 #define ASM_XOR_REG_REG(state, rd, rs) asm_rv32_emit_optimised_xor(state, rd, rs)
+
+// Viper floats are single precision floats held in an integer register.  The
+// dynamic compiler targets RV32IMC, which has no F extension.
+#if !MICROPY_DYNAMIC_COMPILER && defined(__riscv_flen) && __riscv_flen >= 32
+#define ASM_FLOAT_ALLOWED(state) (true)
+#else
+#define ASM_FLOAT_ALLOWED(state) (false)
+#endif
+#define ASM_FLOAT_ADD_REG_REG(state, rd, rs) asm_rv32_float_op_reg_reg(state, ASM_RV32_FLOAT_OP_ADD, rd, rs)
+#define ASM_FLOAT_SUB_REG_REG(state, rd, rs) asm_rv32_float_op_reg_reg(state, ASM_RV32_FLOAT_OP_SUB, rd, rs)
+#define ASM_FLOAT_MUL_REG_REG(state, rd, rs) asm_rv32_float_op_reg_reg(state, ASM_RV32_FLOAT_OP_MUL, rd, rs)
+#define ASM_FLOAT_DIV_REG_REG(state, rd, rs) asm_rv32_float_op_reg_reg(state, ASM_RV32_FLOAT_OP_DIV, rd, rs)
+#define ASM_FLOAT_NEG_REG(state, rd) asm_rv32_float_neg_reg(state, rd)
+#define ASM_FLOAT_FROM_INT_REG(state, rd) asm_rv32_float_from_int_reg(state, rd)
+#define ASM_FLOAT_TO_INT_REG(state, rd) asm_rv32_float_to_int_reg(state, rd)
+#define ASM_FLOAT_SETCC_REG_REG_REG(state, cc, rd, rs1, rs2) asm_rv32_float_setcc_reg_reg_reg(state, cc, rd, rs1, rs2)
 #define ASM_CLR_REG(state, rd)
 #define ASM_LOAD16_REG_REG_REG(state, rd, rs1, rs2) \
     do { \
@@ -262,6 +262,64 @@ static void asm_thumb_mov_rlo_i16(asm_thumb_t *as, uint rlo_dest, int i16_src) {
     asm_thumb_add_rlo_i8(as, rlo_dest, i16_src & 0xff);
 }
 
+// The float operations below use s0 and s1 as scratch registers.
+
+static void asm_thumb_vmov_sreg_reg(asm_thumb_t *as, uint sreg, uint reg_src) {
+    // vmov s<sreg>, reg_src, for s0 to s1
+    asm_thumb_op32(as, 0xee00, 0x0a10 | (reg_src << 12) | (sreg << 7));
+}
+
+static void asm_thumb_vmov_reg_s0(asm_thumb_t *as, uint reg_dest) {
+    // vmov reg_dest, s0
+    asm_thumb_op32(as, 0xee10, 0x0a10 | (reg_dest << 12));
+}
+
+void asm_thumb_float_op_reg_reg(asm_thumb_t *as, uint op, uint reg_dest, uint reg_src) {
+    asm_thumb_vmov_sreg_reg(as, 0, reg_dest);
+    asm_thumb_vmov_sreg_reg(as, 1, reg_src);
+    // vadd/vsub/vmul/vdiv.f32 s0, s0, s1
+    asm_thumb_op32(as, 0xee00 | (op & 0xf0), 0x0a20 | ((op & 0x0f) << 4));
+    asm_thumb_vmov_reg_s0(as, reg_dest);
+}
+
+void asm_thumb_float_neg_reg(asm_thumb_t *as, uint reg_dest) {
+    asm_thumb_vmov_sreg_reg(as, 0, reg_dest);
+    asm_thumb_op32(as, 0xeeb1, 0x0a40); // vneg.f32 s0, s0
+    asm_thumb_vmov_reg_s0(as, reg_dest);
+}
+
+void asm_thumb_float_from_int_reg(asm_thumb_t *as, uint reg_dest) {
+    asm_thumb_vmov_sreg_reg(as, 0, reg_dest);
+    asm_thumb_op32(as, 0xeeb8, 0x0ac0); // vcvt.f32.s32 s0, s0
+    asm_thumb_vmov_reg_s0(as, reg_dest);
+}
+
+void asm_thumb_float_to_int_reg(asm_thumb_t *as, uint reg_dest) {
+    asm_thumb_vmov_sreg_reg(as, 0, reg_dest);
+    asm_thumb_op32(as, 0xeebd, 0x0ac0); // vcvt.s32.f32 s0, s0 (round towards zero)
+    asm_thumb_vmov_reg_s0(as, reg_dest);
+}
+
+void asm_thumb_float_setcc_reg_reg_reg(asm_thumb_t *as, uint cc, uint rlo_dest, uint reg_src1, uint reg_src2) {
+    // condition for each ASM_FLOAT_CC_xxx that is false when unordered, except for NE
+    static const uint16_t ite[6] = {
+        ASM_THUMB_OP_ITE_MI,
+        ASM_THUMB_OP_ITE_GT,
+        ASM_THUMB_OP_ITE_EQ,
+        ASM_THUMB_OP_ITE_LS,
+        ASM_THUMB_OP_ITE_GE,
+        ASM_THUMB_OP_ITE_NE,
+    };
+    assert(rlo_dest < ASM_THUMB_REG_R8);
+    asm_thumb_vmov_sreg_reg(as, 0, reg_src1);
+    asm_thumb_vmov_sreg_reg(as, 1, reg_src2);
+    asm_thumb_op32(as, 0xeeb4, 0x0a60); // vcmp.f32 s0, s1
+    asm_thumb_op32(as, 0xeef1, 0xfa10); // vmrs APSR_nzcv, fpscr
+    asm_thumb_op16(as, ite[cc]);
+    asm_thumb_mov_rlo_i8(as, rlo_dest, 1);
+    asm_thumb_mov_rlo_i8(as, rlo_dest, 0);
+}
+
 #define OP_B_N(byte_offset) (0xe000 | (((byte_offset) >> 1) & 0x07ff))
 
 bool asm_thumb_b_n_label(asm_thumb_t *as, uint label) {
@@ -78,12 +78,25 @@ static inline bool asm_thumb_allow_armv7m(asm_thumb_t *as) {
            && mp_dynamic_compiler.native_arch <= MP_NATIVE_ARCH_ARMV7EMDP;
 }
 
+static inline bool asm_thumb_allow_float(asm_thumb_t *as) {
+    return MP_NATIVE_ARCH_ARMV7EMSP <= mp_dynamic_compiler.native_arch
+           && mp_dynamic_compiler.native_arch <= MP_NATIVE_ARCH_ARMV7EMDP;
+}
+
 #else
 
 static inline bool asm_thumb_allow_armv7m(asm_thumb_t *as) {
     return MICROPY_EMIT_THUMB_ARMV7M;
 }
 
+static inline bool asm_thumb_allow_float(asm_thumb_t *as) {
+    #if defined(__ARM_FP) && (__ARM_FP & 4)
+    return true;
+    #else
+    return false;
+    #endif
+}
+
 #endif
 
 static inline void asm_thumb_end_pass(asm_thumb_t *as) {
@@ -391,6 +404,19 @@ void asm_thumb_bl_ind(asm_thumb_t *as, uint fun_id, uint reg_temp); // convenien
 void asm_thumb_bcc_rel9(asm_thumb_t *as, int cc, int rel);
 void asm_thumb_b_rel12(asm_thumb_t *as, int rel);
 
+// VFP single precision operations, for asm_thumb_float_op_reg_reg
+#define ASM_THUMB_FLOAT_OP_ADD (0x30)
+#define ASM_THUMB_FLOAT_OP_SUB (0x34)
+#define ASM_THUMB_FLOAT_OP_MUL (0x20)
+#define ASM_THUMB_FLOAT_OP_DIV (0x80)
+
+// these need asm_thumb_allow_float() and work on floats held as raw bits in core registers
+void asm_thumb_float_op_reg_reg(asm_thumb_t *as, uint op, uint reg_dest, uint reg_src);
+void asm_thumb_float_neg_reg(asm_thumb_t *as, uint reg_dest);
+void asm_thumb_float_from_int_reg(asm_thumb_t *as, uint reg_dest);
+void asm_thumb_float_to_int_reg(asm_thumb_t *as, uint reg_dest);
+void asm_thumb_float_setcc_reg_reg_reg(asm_thumb_t *as, uint cc, uint rlo_dest, uint reg_src1, uint reg_src2);
+
 // Holds a pointer to mp_fun_table
 #define ASM_THUMB_REG_FUN_TABLE ASM_THUMB_REG_R7
 
@@ -462,6 +488,17 @@ void asm_thumb_b_rel12(asm_thumb_t *as, int rel);
 #define ASM_SUB_REG_REG(as, reg_dest, reg_src) asm_thumb_sub_rlo_rlo_rlo((as), (reg_dest), (reg_dest), (reg_src))
 #define ASM_MUL_REG_REG(as, reg_dest, reg_src) asm_thumb_format_4((as), ASM_THUMB_FORMAT_4_MUL, (reg_dest), (reg_src))
 
+// Viper floats are single precision floats held in a core register
+#define ASM_FLOAT_ALLOWED(as) asm_thumb_allow_float(as)
+#define ASM_FLOAT_ADD_REG_REG(as, reg_dest, reg_src) asm_thumb_float_op_reg_reg((as), ASM_THUMB_FLOAT_OP_ADD, (reg_dest), (reg_src))
+#define ASM_FLOAT_SUB_REG_REG(as, reg_dest, reg_src) asm_thumb_float_op_reg_reg((as), ASM_THUMB_FLOAT_OP_SUB, (reg_dest), (reg_src))
+#define ASM_FLOAT_MUL_REG_REG(as, reg_dest, reg_src) asm_thumb_float_op_reg_reg((as), ASM_THUMB_FLOAT_OP_MUL, (reg_dest), (reg_src))
+#define ASM_FLOAT_DIV_REG_REG(as, reg_dest, reg_src) asm_thumb_float_op_reg_reg((as), ASM_THUMB_FLOAT_OP_DIV, (reg_dest), (reg_src))
+#define ASM_FLOAT_NEG_REG(as, reg) asm_thumb_float_neg_reg((as), (reg))
+#define ASM_FLOAT_FROM_INT_REG(as, reg) asm_thumb_float_from_int_reg((as), (reg))
+#define ASM_FLOAT_TO_INT_REG(as, reg) asm_thumb_float_to_int_reg((as), (reg))
+#define ASM_FLOAT_SETCC_REG_REG_REG(as, cc, reg_dest, reg_src1, reg_src2) asm_thumb_float_setcc_reg_reg_reg((as), (cc), (reg_dest), (reg_src1), (reg_src2))
+
 #define ASM_LOAD_REG_REG_OFFSET(as, reg_dest, reg_base, word_offset) asm_thumb_ldr_reg_reg_i12_optimised((as), (reg_dest), (reg_base), (word_offset))
 #define ASM_LOAD8_REG_REG(as, reg_dest, reg_base) asm_thumb_ldrb_rlo_rlo_i5((as), (reg_dest), (reg_base), 0)
 #define ASM_LOAD16_REG_REG(as, reg_dest, reg_base) asm_thumb_ldrh_rlo_rlo_i5((as), (reg_dest), (reg_base), 0)
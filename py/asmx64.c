@@ -410,6 +410,76 @@ void asm_x64_mul_r64_r64(asm_x64_t *as, int dest_r64, int src_r64) {
     asm_x64_write_byte_3(as, 0x0f, 0xaf, MODRM_R64(dest_r64) | MODRM_RM_REG | MODRM_RM_R64(src_r64));
 }
 
+static void asm_x64_movq_xmm_r64(asm_x64_t *as, int dest_xmm, int src_r64) {
+    // movq xmm, r/m64 -- 0x66 REX.W 0x0f 0x6e /r
+    asm_x64_write_byte_2(as, OP_SIZE_PREFIX, REX_PREFIX | REX_W | REX_B_FROM_R64(src_r64));
+    asm_x64_write_byte_3(as, 0x0f, 0x6e, MODRM_R64(dest_xmm) | MODRM_RM_REG | MODRM_RM_R64(src_r64));
+}
+
+static void asm_x64_movq_r64_xmm(asm_x64_t *as, int dest_r64, int src_xmm) {
+    // movq r/m64, xmm -- 0x66 REX.W 0x0f 0x7e /r
+    asm_x64_write_byte_2(as, OP_SIZE_PREFIX, REX_PREFIX | REX_W | REX_B_FROM_R64(dest_r64));
+    asm_x64_write_byte_3(as, 0x0f, 0x7e, MODRM_R64(src_xmm) | MODRM_RM_REG | MODRM_RM_R64(dest_r64));
+}
+
+// The float operations below work on doubles held as raw bits in general
+// purpose registers, and use xmm0 and xmm1 as scratch registers.
+
+void asm_x64_float_op_r64_r64(asm_x64_t *as, int op, int dest_r64, int src_r64) {
+    asm_x64_movq_xmm_r64(as, 0, dest_r64);
+    asm_x64_movq_xmm_r64(as, 1, src_r64);
+    // addsd/subsd/mulsd/divsd xmm0, xmm1 -- 0xf2 0x0f op /r
+    asm_x64_write_byte_1(as, 0xf2);
+    asm_x64_write_byte_3(as, 0x0f, op, MODRM_R64(0) | MODRM_RM_REG | MODRM_RM_R64(1));
+    asm_x64_movq_r64_xmm(as, dest_r64, 0);
+}
+
+void asm_x64_float_neg_r64(asm_x64_t *as, int dest_r64) {
+    // flip the sign bit: btc r/m64, 63 -- REX.W 0x0f 0xba /7 ib
+    asm_x64_write_byte_2(as, REX_PREFIX | REX_W | REX_B_FROM_R64(dest_r64), 0x0f);
+    asm_x64_write_byte_3(as, 0xba, MODRM_R64(7) | MODRM_RM_REG | MODRM_RM_R64(dest_r64), 63);
+}
+
+void asm_x64_float_from_int_r64(asm_x64_t *as, int dest_r64) {
+    // cvtsi2sd xmm0, r/m64 -- 0xf2 REX.W 0x0f 0x2a /r
+    asm_x64_write_byte_2(as, 0xf2, REX_PREFIX | REX_W | REX_B_FROM_R64(dest_r64));
+    asm_x64_write_byte_3(as, 0x0f, 0x2a, MODRM_R64(0) | MODRM_RM_REG | MODRM_RM_R64(dest_r64));
+    asm_x64_movq_r64_xmm(as, dest_r64, 0);
+}
+
+void asm_x64_float_to_int_r64(asm_x64_t *as, int dest_r64) {
+    asm_x64_movq_xmm_r64(as, 0, dest_r64);
+    // cvttsd2si r64, xmm0 -- 0xf2 REX.W 0x0f 0x2c /r
+    asm_x64_write_byte_2(as, 0xf2, REX_PREFIX | REX_W | REX_R_FROM_R64(dest_r64));
+    asm_x64_write_byte_3(as, 0x0f, 0x2c, MODRM_R64(dest_r64) | MODRM_RM_REG | MODRM_RM_R64(0));
+}
+
+void asm_x64_float_setcc_r64(asm_x64_t *as, int cc, int dest_r64, int src1_r64, int src2_r64) {
+    // cmpsd predicate for each ASM_FLOAT_CC_xxx, bit 7 set to swap the operands
+    static const uint8_t predicate[6] = {
+        0x01, // LT
+        0x81, // GT, as swapped LT
+        0x00, // EQ
+        0x02, // LE
+        0x82, // GE, as swapped LE
+        0x04, // NEQ, true when unordered
+    };
+    uint8_t p = predicate[cc];
+    if (p & 0x80) {
+        int r = src1_r64;
+        src1_r64 = src2_r64;
+        src2_r64 = r;
+    }
+    asm_x64_movq_xmm_r64(as, 0, src1_r64);
+    asm_x64_movq_xmm_r64(as, 1, src2_r64);
+    // cmpsd xmm0, xmm1, imm8 -- 0xf2 0x0f 0xc2 /r ib
+    asm_x64_write_byte_2(as, 0xf2, 0x0f);
+    asm_x64_write_byte_3(as, 0xc2, MODRM_R64(0) | MODRM_RM_REG | MODRM_RM_R64(1), p & 0x7f);
+    // the result is a mask of all ones or all zeros, negate it to get 1 or 0
+    asm_x64_movq_r64_xmm(as, dest_r64, 0);
+    asm_x64_neg_r64(as, dest_r64);
+}
+
 /*
 void asm_x64_sub_i32_from_r32(asm_x64_t *as, int src_i32, int dest_r32) {
     if (SIGNED_FIT8(src_i32)) {
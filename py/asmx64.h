@@ -73,6 +73,12 @@
 #define ASM_X64_CC_JLE (0xe) // less or equal, signed
 #define ASM_X64_CC_JG  (0xf) // greater, signed
 
+// scalar double precision operations, for asm_x64_float_op_r64_r64
+#define ASM_X64_FLOAT_OP_ADD (0x58)
+#define ASM_X64_FLOAT_OP_MUL (0x59)
+#define ASM_X64_FLOAT_OP_SUB (0x5c)
+#define ASM_X64_FLOAT_OP_DIV (0x5e)
+
 typedef struct _asm_x64_t {
     mp_asm_base_t base;
     int num_locals;
@@ -108,6 +114,11 @@ void asm_x64_sar_r64_cl(asm_x64_t *as, int dest_r64);
 void asm_x64_add_r64_r64(asm_x64_t *as, int dest_r64, int src_r64);
 void asm_x64_sub_r64_r64(asm_x64_t *as, int dest_r64, int src_r64);
 void asm_x64_mul_r64_r64(asm_x64_t *as, int dest_r64, int src_r64);
+void asm_x64_float_op_r64_r64(asm_x64_t *as, int op, int dest_r64, int src_r64);
+void asm_x64_float_neg_r64(asm_x64_t *as, int dest_r64);
+void asm_x64_float_from_int_r64(asm_x64_t *as, int dest_r64);
+void asm_x64_float_to_int_r64(asm_x64_t *as, int dest_r64);
+void asm_x64_float_setcc_r64(asm_x64_t *as, int cc, int dest_r64, int src1_r64, int src2_r64);
 void asm_x64_cmp_r64_with_r64(asm_x64_t *as, int src_r64_a, int src_r64_b);
 void asm_x64_test_r8_with_r8(asm_x64_t *as, int src_r64_a, int src_r64_b);
 void asm_x64_test_r64_with_r64(asm_x64_t *as, int src_r64_a, int src_r64_b);
@@ -205,6 +216,17 @@ void asm_x64_call_ind(asm_x64_t *as, size_t fun_id, int temp_r32);
 #define ASM_SUB_REG_REG(as, reg_dest, reg_src) asm_x64_sub_r64_r64((as), (reg_dest), (reg_src))
 #define ASM_MUL_REG_REG(as, reg_dest, reg_src) asm_x64_mul_r64_r64((as), (reg_dest), (reg_src))
 
+// Viper floats are doubles held in a general purpose register
+#define ASM_FLOAT_ALLOWED(as) (true)
+#define ASM_FLOAT_ADD_REG_REG(as, reg_dest, reg_src) asm_x64_float_op_r64_r64((as), ASM_X64_FLOAT_OP_ADD, (reg_dest), (reg_src))
+#define ASM_FLOAT_SUB_REG_REG(as, reg_dest, reg_src) asm_x64_float_op_r64_r64((as), ASM_X64_FLOAT_OP_SUB, (reg_dest), (reg_src))
+#define ASM_FLOAT_MUL_REG_REG(as, reg_dest, reg_src) asm_x64_float_op_r64_r64((as), ASM_X64_FLOAT_OP_MUL, (reg_dest), (reg_src))
+#define ASM_FLOAT_DIV_REG_REG(as, reg_dest, reg_src) asm_x64_float_op_r64_r64((as), ASM_X64_FLOAT_OP_DIV, (reg_dest), (reg_src))
+#define ASM_FLOAT_NEG_REG(as, reg) asm_x64_float_neg_r64((as), (reg))
+#define ASM_FLOAT_FROM_INT_REG(as, reg) asm_x64_float_from_int_r64((as), (reg))
+#define ASM_FLOAT_TO_INT_REG(as, reg) asm_x64_float_to_int_r64((as), (reg))
+#define ASM_FLOAT_SETCC_REG_REG_REG(as, cc, reg_dest, reg_src1, reg_src2) asm_x64_float_setcc_r64((as), (cc), (reg_dest), (reg_src1), (reg_src2))
+
 #define ASM_LOAD_REG_REG_OFFSET(as, reg_dest, reg_base, word_offset) asm_x64_mov_mem64_to_r64((as), (reg_base), 8 * (word_offset), (reg_dest))
 #define ASM_LOAD8_REG_REG(as, reg_dest, reg_base) asm_x64_mov_mem8_to_r64zx((as), (reg_base), 0, (reg_dest))
 #define ASM_LOAD16_REG_REG(as, reg_dest, reg_base) asm_x64_mov_mem16_to_r64zx((as), (reg_base), 0, (reg_dest))
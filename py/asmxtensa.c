@@ -177,6 +177,96 @@ void asm_xtensa_setcc_reg_reg_reg(asm_xtensa_t *as, uint cond, uint reg_dest, ui
     asm_xtensa_op_movi_n(as, reg_dest, 0);
 }
 
+// The float operations below use f0 and f1 as scratch registers, and divide uses
+// f0-f8.
+
+// op is the op2 field of the FP0 group: 0 for add.s, 1 for sub.s, 2 for mul.s
+void asm_xtensa_float_op_reg_reg(asm_xtensa_t *as, uint op, uint reg_dest, uint reg_src) {
+    asm_xtensa_op_wfr(as, 0, reg_dest);
+    asm_xtensa_op_wfr(as, 1, reg_src);
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, op, 0, 0, 1));
+    asm_xtensa_op_rfr(as, reg_dest, 0);
+}
+
+// The FPU has no single divide instruction, only steps of a Newton-Raphson
+// iteration.  This is the sequence GCC uses for __divsf3, and it uses f0-f8.
+void asm_xtensa_float_div_reg_reg(asm_xtensa_t *as, uint reg_dest, uint reg_src) {
+    asm_xtensa_op_wfr(as, 1, reg_dest);
+    asm_xtensa_op_wfr(as, 2, reg_src);
+    asm_xtensa_op_div0_s(as, 3, 2);
+    asm_xtensa_op_nexp01_s(as, 4, 2);
+    asm_xtensa_op_const_s(as, 5, 1);
+    asm_xtensa_op_maddn_s(as, 5, 4, 3);
+    asm_xtensa_op_mov_s(as, 6, 3);
+    asm_xtensa_op_mov_s(as, 7, 2);
+    asm_xtensa_op_nexp01_s(as, 2, 1);
+    asm_xtensa_op_maddn_s(as, 6, 5, 6);
+    asm_xtensa_op_const_s(as, 5, 1);
+    asm_xtensa_op_const_s(as, 0, 0);
+    asm_xtensa_op_neg_s(as, 8, 2);
+    asm_xtensa_op_maddn_s(as, 5, 4, 6);
+    asm_xtensa_op_maddn_s(as, 0, 8, 3);
+    asm_xtensa_op_mkdadj_s(as, 7, 1);
+    asm_xtensa_op_maddn_s(as, 6, 5, 6);
+    asm_xtensa_op_maddn_s(as, 8, 4, 0);
+    asm_xtensa_op_const_s(as, 3, 1);
+    asm_xtensa_op_maddn_s(as, 3, 4, 6);
+    asm_xtensa_op_maddn_s(as, 0, 8, 6);
+    asm_xtensa_op_neg_s(as, 2, 2);
+    asm_xtensa_op_maddn_s(as, 6, 3, 6);
+    asm_xtensa_op_maddn_s(as, 2, 4, 0);
+    asm_xtensa_op_addexpm_s(as, 0, 7);
+    asm_xtensa_op_addexp_s(as, 6, 7);
+    asm_xtensa_op_divn_s(as, 0, 2, 6);
+    asm_xtensa_op_rfr(as, reg_dest, 0);
+}
+
+void asm_xtensa_float_neg_reg(asm_xtensa_t *as, uint reg_dest) {
+    asm_xtensa_op_wfr(as, 0, reg_dest);
+    asm_xtensa_op_neg_s(as, 0, 0);
+    asm_xtensa_op_rfr(as, reg_dest, 0);
+}
+
+void asm_xtensa_float_from_int_reg(asm_xtensa_t *as, uint reg_dest) {
+    asm_xtensa_op_float_s(as, 0, reg_dest, 0);
+    asm_xtensa_op_rfr(as, reg_dest, 0);
+}
+
+void asm_xtensa_float_to_int_reg(asm_xtensa_t *as, uint reg_dest) {
+    asm_xtensa_op_wfr(as, 0, reg_dest);
+    asm_xtensa_op_trunc_s(as, reg_dest, 0, 0);
+}
+
+// Uses b0, and reg_src1 as a temporary so it must differ from reg_dest.
+void asm_xtensa_float_setcc_reg_reg_reg(asm_xtensa_t *as, uint cc, uint reg_dest, uint reg_src1, uint reg_src2) {
+    // compare for each ASM_FLOAT_CC_xxx, bit 7 set to swap the operands and
+    // bit 6 set to invert the result
+    static const uint8_t fcc[6] = {
+        ASM_XTENSA_FCC_OLT,
+        0x80 | ASM_XTENSA_FCC_OLT,
+        ASM_XTENSA_FCC_OEQ,
+        ASM_XTENSA_FCC_OLE,
+        0x80 | ASM_XTENSA_FCC_OLE,
+        0x40 | ASM_XTENSA_FCC_OEQ,
+    };
+    assert(reg_dest != reg_src1);
+    uint8_t c = fcc[cc];
+    asm_xtensa_op_wfr(as, 0, reg_src1);
+    asm_xtensa_op_wfr(as, 1, reg_src2);
+    if (c & 0x80) {
+        asm_xtensa_op_fcmp_s(as, c & 0x0f, 0, 1, 0);
+    } else {
+        asm_xtensa_op_fcmp_s(as, c & 0x0f, 0, 0, 1);
+    }
+    asm_xtensa_op_movi_n(as, reg_dest, 0);
+    asm_xtensa_op_movi_n(as, reg_src1, 1);
+    if (c & 0x40) {
+        asm_xtensa_op_movf(as, reg_dest, reg_src1, 0);
+    } else {
+        asm_xtensa_op_movt(as, reg_dest, reg_src1, 0);
+    }
+}
+
 size_t asm_xtensa_mov_reg_i32(asm_xtensa_t *as, uint reg_dest, uint32_t i32) {
     // load the constant
     uint32_t const_table_offset = (uint8_t *)as->const_table - as->base.code_base;
@@ -281,6 +371,15 @@ void asm_xtensa_bit_branch(asm_xtensa_t *as, mp_uint_t reg, mp_uint_t bit, mp_ui
     asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRI8(7, condition | ((bit >> 4) & 0x01), reg, bit & 0x0F, rel & 0xFF));
 }
 
+void asm_xtensa_bool_branch(asm_xtensa_t *as, mp_uint_t breg, mp_uint_t label, bool if_true) {
+    uint32_t dest = get_label_dest(as, label);
+    int32_t rel = dest - as->base.code_offset - 4;
+    if (as->base.pass == MP_ASM_PASS_EMIT && !SIGNED_FIT8(rel)) {
+        mp_raise_msg_varg(&mp_type_RuntimeError, ET_OUT_OF_RANGE, MP_QSTR_bool_branch);
+    }
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRI8(6, if_true, breg, 7, rel & 0xFF));
+}
+
 void asm_xtensa_call0(asm_xtensa_t *as, mp_uint_t label) {
     uint32_t dest = get_label_dest(as, label);
     int32_t rel = dest - as->base.code_offset - 3;
@@ -84,6 +84,15 @@
 #define ASM_XTENSA_CC_NALL  (12)
 #define ASM_XTENSA_CC_BS    (13)
 
+// for fcmp_s
+#define ASM_XTENSA_FCC_UN   (1)
+#define ASM_XTENSA_FCC_OEQ  (2)
+#define ASM_XTENSA_FCC_UEQ  (3)
+#define ASM_XTENSA_FCC_OLT  (4)
+#define ASM_XTENSA_FCC_ULT  (5)
+#define ASM_XTENSA_FCC_OLE  (6)
+#define ASM_XTENSA_FCC_ULE  (7)
+
 // macros for encoding instructions (little endian versions)
 #define ASM_XTENSA_ENCODE_RRR(op0, op1, op2, r, s, t) \
     ((((uint32_t)op2) << 20) | (((uint32_t)op1) << 16) | ((r) << 12) | ((s) << 8) | ((t) << 4) | (op0))
@@ -282,11 +291,102 @@ static inline void asm_xtensa_op_xor(asm_xtensa_t *as, uint reg_dest, uint reg_s
     asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 0, 3, reg_dest, reg_src_a, reg_src_b));
 }
 
+static inline void asm_xtensa_op_movf(asm_xtensa_t *as, uint reg_dest, uint reg_src, uint breg) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 3, 12, reg_dest, reg_src, breg));
+}
+
+static inline void asm_xtensa_op_movt(asm_xtensa_t *as, uint reg_dest, uint reg_src, uint breg) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 3, 13, reg_dest, reg_src, breg));
+}
+
+// single precision floating point coprocessor instructions
+
+static inline void asm_xtensa_op_add_s(asm_xtensa_t *as, uint freg_dest, uint freg_src_a, uint freg_src_b) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 0, freg_dest, freg_src_a, freg_src_b));
+}
+
+static inline void asm_xtensa_op_sub_s(asm_xtensa_t *as, uint freg_dest, uint freg_src_a, uint freg_src_b) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 1, freg_dest, freg_src_a, freg_src_b));
+}
+
+static inline void asm_xtensa_op_mul_s(asm_xtensa_t *as, uint freg_dest, uint freg_src_a, uint freg_src_b) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 2, freg_dest, freg_src_a, freg_src_b));
+}
+
+static inline void asm_xtensa_op_maddn_s(asm_xtensa_t *as, uint freg_dest, uint freg_src_a, uint freg_src_b) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 6, freg_dest, freg_src_a, freg_src_b));
+}
+
+static inline void asm_xtensa_op_divn_s(asm_xtensa_t *as, uint freg_dest, uint freg_src_a, uint freg_src_b) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 7, freg_dest, freg_src_a, freg_src_b));
+}
+
+static inline void asm_xtensa_op_trunc_s(asm_xtensa_t *as, uint reg_dest, uint freg_src, uint scale) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 9, reg_dest, freg_src, scale));
+}
+
+static inline void asm_xtensa_op_float_s(asm_xtensa_t *as, uint freg_dest, uint reg_src, uint scale) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 12, freg_dest, reg_src, scale));
+}
+
+static inline void asm_xtensa_op_mov_s(asm_xtensa_t *as, uint freg_dest, uint freg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, freg_src, 0));
+}
+
+// loads a small constant: 0 is 0.0, 1 is 1.0, 2 is 2.0 and 3 is 0.5
+static inline void asm_xtensa_op_const_s(asm_xtensa_t *as, uint freg_dest, uint imm4) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, imm4, 3));
+}
+
+static inline void asm_xtensa_op_rfr(asm_xtensa_t *as, uint reg_dest, uint freg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, reg_dest, freg_src, 4));
+}
+
+static inline void asm_xtensa_op_wfr(asm_xtensa_t *as, uint freg_dest, uint reg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, reg_src, 5));
+}
+
+static inline void asm_xtensa_op_neg_s(asm_xtensa_t *as, uint freg_dest, uint freg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, freg_src, 6));
+}
+
+// divide steps, which GCC emits for a single precision divide
+static inline void asm_xtensa_op_div0_s(asm_xtensa_t *as, uint freg_dest, uint freg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, freg_src, 7));
+}
+
+static inline void asm_xtensa_op_nexp01_s(asm_xtensa_t *as, uint freg_dest, uint freg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, freg_src, 11));
+}
+
+static inline void asm_xtensa_op_mkdadj_s(asm_xtensa_t *as, uint freg_dest, uint freg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, freg_src, 13));
+}
+
+static inline void asm_xtensa_op_addexp_s(asm_xtensa_t *as, uint freg_dest, uint freg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, freg_src, 14));
+}
+
+static inline void asm_xtensa_op_addexpm_s(asm_xtensa_t *as, uint freg_dest, uint freg_src) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 10, 15, freg_dest, freg_src, 15));
+}
+
+// compares into a boolean register, cond is one of ASM_XTENSA_FCC_xxx
+static inline void asm_xtensa_op_fcmp_s(asm_xtensa_t *as, uint cond, uint breg_dest, uint freg_src_a, uint freg_src_b) {
+    asm_xtensa_op24(as, ASM_XTENSA_ENCODE_RRR(0, 11, cond, breg_dest, freg_src_a, freg_src_b));
+}
+
 // convenience functions
 void asm_xtensa_j_label(asm_xtensa_t *as, uint label);
 void asm_xtensa_bccz_reg_label(asm_xtensa_t *as, uint cond, uint reg, uint label);
 void asm_xtensa_bcc_reg_reg_label(asm_xtensa_t *as, uint cond, uint reg1, uint reg2, uint label);
 void asm_xtensa_setcc_reg_reg_reg(asm_xtensa_t *as, uint cond, uint reg_dest, uint reg_src1, uint reg_src2);
+void asm_xtensa_float_op_reg_reg(asm_xtensa_t *as, uint op, uint reg_dest, uint reg_src);
+void asm_xtensa_float_div_reg_reg(asm_xtensa_t *as, uint reg_dest, uint reg_src);
+void asm_xtensa_float_neg_reg(asm_xtensa_t *as, uint reg_dest);
+void asm_xtensa_float_from_int_reg(asm_xtensa_t *as, uint reg_dest);
+void asm_xtensa_float_to_int_reg(asm_xtensa_t *as, uint reg_dest);
+void asm_xtensa_float_setcc_reg_reg_reg(asm_xtensa_t *as, uint cc, uint reg_dest, uint reg_src1, uint reg_src2);
 size_t asm_xtensa_mov_reg_i32(asm_xtensa_t *as, uint reg_dest, uint32_t i32);
 void asm_xtensa_mov_reg_i32_optimised(asm_xtensa_t *as, uint reg_dest, uint32_t i32);
 void asm_xtensa_mov_local_reg(asm_xtensa_t *as, int local_num, uint reg_src);
@@ -298,6 +398,7 @@ void asm_xtensa_s32i_optimised(asm_xtensa_t *as, uint reg_src, uint reg_base, ui
 void asm_xtensa_call_ind(asm_xtensa_t *as, uint idx);
 void asm_xtensa_call_ind_win(asm_xtensa_t *as, uint idx);
 void asm_xtensa_bit_branch(asm_xtensa_t *as, mp_uint_t reg, mp_uint_t bit, mp_uint_t label, mp_uint_t condition);
+void asm_xtensa_bool_branch(asm_xtensa_t *as, mp_uint_t breg, mp_uint_t label, bool if_true);
 void asm_xtensa_immediate_branch(asm_xtensa_t *as, mp_uint_t reg, mp_uint_t immediate, mp_uint_t label, mp_uint_t cond);
 void asm_xtensa_call0(asm_xtensa_t *as, mp_uint_t label);
 void asm_xtensa_l32r(asm_xtensa_t *as, mp_uint_t reg, mp_uint_t label);
@@ -413,6 +514,25 @@ void asm_xtensa_l32r(asm_xtensa_t *as, mp_uint_t reg, mp_uint_t label);
 #define ASM_SUB_REG_REG(as, reg_dest, reg_src) asm_xtensa_op_sub((as), (reg_dest), (reg_dest), (reg_src))
 #define ASM_MUL_REG_REG(as, reg_dest, reg_src) asm_xtensa_op_mull((as), (reg_dest), (reg_dest), (reg_src))
 
+#if GENERIC_ASM_API_WIN
+// Viper floats are single precision floats held in an address register.
+#if MICROPY_DYNAMIC_COMPILER
+#define ASM_FLOAT_ALLOWED(as) (true)
+#elif defined(__XTENSA_HARD_FLOAT__)
+#define ASM_FLOAT_ALLOWED(as) (true)
+#else
+#define ASM_FLOAT_ALLOWED(as) (false)
+#endif
+#define ASM_FLOAT_ADD_REG_REG(as, reg_dest, reg_src) asm_xtensa_float_op_reg_reg((as), 0, (reg_dest), (reg_src))
+#define ASM_FLOAT_SUB_REG_REG(as, reg_dest, reg_src) asm_xtensa_float_op_reg_reg((as), 1, (reg_dest), (reg_src))
+#define ASM_FLOAT_MUL_REG_REG(as, reg_dest, reg_src) asm_xtensa_float_op_reg_reg((as), 2, (reg_dest), (reg_src))
+#define ASM_FLOAT_DIV_REG_REG(as, reg_dest, reg_src) asm_xtensa_float_div_reg_reg((as), (reg_dest), (reg_src))
+#define ASM_FLOAT_NEG_REG(as, reg) asm_xtensa_float_neg_reg((as), (reg))
+#define ASM_FLOAT_FROM_INT_REG(as, reg) asm_xtensa_float_from_int_reg((as), (reg))
+#define ASM_FLOAT_TO_INT_REG(as, reg) asm_xtensa_float_to_int_reg((as), (reg))
+#define ASM_FLOAT_SETCC_REG_REG_REG(as, cc, reg_dest, reg_src1, reg_src2) asm_xtensa_float_setcc_reg_reg_reg((as), (cc), (reg_dest), (reg_src1), (reg_src2))
+#endif
+
 #define ASM_LOAD_REG_REG_OFFSET(as, reg_dest, reg_base, word_offset) asm_xtensa_l32i_optimised((as), (reg_dest), (reg_base), (word_offset))
 #define ASM_LOAD8_REG_REG(as, reg_dest, reg_base) asm_xtensa_op_l8ui((as), (reg_dest), (reg_base), 0)
 #define ASM_LOAD16_REG_REG(as, reg_dest, reg_base) asm_xtensa_op_l16ui((as), (reg_dest), (reg_base), 0)
@@ -26,6 +26,7 @@
 #ifndef MICROPY_INCLUDED_PY_EMIT_H
 #define MICROPY_INCLUDED_PY_EMIT_H
 
+#include "py/gc.h"
 #include "py/lexer.h"
 #include "py/scope.h"
 
@@ -186,6 +187,7 @@ size_t mp_emit_common_use_const_obj(mp_emit_common_t *emit, mp_obj_t const_obj);
 static inline size_t mp_emit_common_alloc_const_child(mp_emit_common_t *emit, mp_raw_code_t *rc) {
     if (emit->pass == MP_PASS_EMIT) {
         emit->children[emit->ct_cur_child] = rc;
+        MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(rc));
     }
     return emit->ct_cur_child++;
 }
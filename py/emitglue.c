@@ -32,6 +32,7 @@
 #include <assert.h>
 
 #include "py/emitglue.h"
+#include "py/gc.h"
 #include "py/runtime0.h"
 #include "py/bc.h"
 #include "py/objfun.h"
@@ -72,6 +73,8 @@ void mp_emit_glue_assign_bytecode(mp_raw_code_t *rc, const byte *code,
     rc->is_generator = (scope_flags & MP_SCOPE_FLAG_GENERATOR) != 0;
     rc->fun_data = code;
     rc->children = children;
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(code));
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(children));
 
     #if MICROPY_PERSISTENT_CODE_SAVE
     rc->fun_data_len = len;
@@ -136,6 +139,8 @@ void mp_emit_glue_assign_native(mp_raw_code_t *rc, mp_raw_code_kind_t kind, cons
     rc->fun_data_len = fun_len;
     #endif
     rc->children = children;
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(fun_data));
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(children));
 
     #if MICROPY_PERSISTENT_CODE_SAVE
     rc->n_children = n_children;
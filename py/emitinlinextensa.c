@@ -32,6 +32,7 @@
 
 #include "py/emit.h"
 #include "py/asmxtensa.h"
+#include "py/persistentcode.h"
 
 #if MICROPY_EMIT_INLINE_XTENSA
 
@@ -43,6 +44,32 @@ struct _emit_inline_asm_t {
     qstr *label_lookup;
 };
 
+#if MICROPY_DYNAMIC_COMPILER
+
+static inline bool emit_inline_xtensa_is_win(emit_inline_asm_t *emit) {
+    return mp_dynamic_compiler.native_arch == MP_NATIVE_ARCH_XTENSAWIN;
+}
+
+static inline bool emit_inline_xtensa_allow_float(emit_inline_asm_t *emit) {
+    return mp_dynamic_compiler.native_arch == MP_NATIVE_ARCH_XTENSAWIN;
+}
+
+#else
+
+static inline bool emit_inline_xtensa_is_win(emit_inline_asm_t *emit) {
+    return MICROPY_EMIT_XTENSAWIN;
+}
+
+static inline bool emit_inline_xtensa_allow_float(emit_inline_asm_t *emit) {
+    #if defined(__XTENSA_HARD_FLOAT__)
+    return MICROPY_EMIT_INLINE_XTENSA_FLOAT;
+    #else
+    return false;
+    #endif
+}
+
+#endif
+
 static void emit_inline_xtensa_error_msg(emit_inline_asm_t *emit, mp_rom_error_text_t msg) {
     *emit->error_slot = mp_obj_new_exception_msg(&mp_type_SyntaxError, msg);
 }
@@ -73,11 +100,19 @@ static void emit_inline_xtensa_start_pass(emit_inline_asm_t *emit, pass_kind_t p
         memset(emit->label_lookup, 0, emit->max_num_labels * sizeof(qstr));
     }
     mp_asm_base_start_pass(&emit->as.base, pass == MP_PASS_EMIT ? MP_ASM_PASS_EMIT : MP_ASM_PASS_COMPUTE);
-    asm_xtensa_entry(&emit->as, 0);
+    if (emit_inline_xtensa_is_win(emit)) {
+        asm_xtensa_entry_win(&emit->as, 0);
+    } else {
+        asm_xtensa_entry(&emit->as, 0);
+    }
 }
 
 static void emit_inline_xtensa_end_pass(emit_inline_asm_t *emit, mp_uint_t type_sig) {
-    asm_xtensa_exit(&emit->as);
+    if (emit_inline_xtensa_is_win(emit)) {
+        asm_xtensa_exit_win(&emit->as);
+    } else {
+        asm_xtensa_exit(&emit->as);
+    }
     asm_xtensa_end_pass(&emit->as);
 }
 
@@ -136,6 +171,51 @@ static mp_uint_t get_arg_reg(emit_inline_asm_t *emit, const char *op, mp_parse_n
     return 0;
 }
 
+// Returns the number of an FPU (f0-f15) or boolean (b0-b15) register, or -1.
+static int get_arg_numbered_reg(mp_parse_node_t pn, char prefix) {
+    if (!MP_PARSE_NODE_IS_ID(pn)) {
+        return -1;
+    }
+    const char *reg_str = qstr_str(MP_PARSE_NODE_LEAF_ARG(pn));
+    if (reg_str[0] != prefix || reg_str[1] == '\0') {
+        return -1;
+    }
+    int regno = 0;
+    for (++reg_str; *reg_str; ++reg_str) {
+        int v = *reg_str;
+        if (!('0' <= v && v <= '9')) {
+            return -1;
+        }
+        regno = 10 * regno + v - '0';
+        if (regno > 15) {
+            return -1;
+        }
+    }
+    return regno;
+}
+
+static mp_uint_t get_arg_freg(emit_inline_asm_t *emit, const char *op, mp_parse_node_t pn) {
+    int regno = get_arg_numbered_reg(pn, 'f');
+    if (regno < 0) {
+        emit_inline_xtensa_error_exc(emit,
+            mp_obj_new_exception_msg_varg(&mp_type_SyntaxError,
+                MP_ERROR_TEXT("'%s' expects an FPU register"), op));
+        return 0;
+    }
+    return regno;
+}
+
+static mp_uint_t get_arg_breg(emit_inline_asm_t *emit, const char *op, mp_parse_node_t pn) {
+    int regno = get_arg_numbered_reg(pn, 'b');
+    if (regno < 0) {
+        emit_inline_xtensa_error_exc(emit,
+            mp_obj_new_exception_msg_varg(&mp_type_SyntaxError,
+                MP_ERROR_TEXT("'%s' expects a boolean register"), op));
+        return 0;
+    }
+    return regno;
+}
+
 static uint32_t get_arg_i(emit_inline_asm_t *emit, const char *op, mp_parse_node_t pn, int min, int max) {
     mp_obj_t o;
     if (!mp_parse_node_get_int_maybe(pn, &o)) {
@@ -228,6 +308,133 @@ static const qstr_short_t BCCZ_OPCODES[] = {
     MP_QSTR_beqz_n, MP_QSTR_bnez_n
 };
 
+// Argument kinds of the floating point opcodes, for the r, s and t fields.
+#define FP_ARG_NONE (0)
+#define FP_ARG_A (1)
+#define FP_ARG_F (2)
+#define FP_ARG_B (3)
+#define FP_ARG_I (4)
+
+typedef struct _opcode_table_fp_t {
+    qstr_short_t name;
+    uint8_t op1 : 4;
+    uint8_t op2 : 4;
+    uint16_t r : 3;
+    uint16_t s : 3;
+    uint16_t t : 3;
+    // value of the t field when it is not given as an argument
+    uint16_t t_value : 4;
+} opcode_table_fp_t;
+
+// Single-precision FPU opcodes, all in RRR format with op0 = 0.
+static const opcode_table_fp_t opcode_table_fp[] = {
+    // arithmetic: freg, freg, freg
+    {MP_QSTR_add_s, 10, 0, FP_ARG_F, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_sub_s, 10, 1, FP_ARG_F, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_mul_s, 10, 2, FP_ARG_F, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_madd_s, 10, 4, FP_ARG_F, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_msub_s, 10, 5, FP_ARG_F, FP_ARG_F, FP_ARG_F, 0},
+
+    // conversions: reg, freg, scale or freg, reg, scale
+    {MP_QSTR_round_s, 10, 8, FP_ARG_A, FP_ARG_F, FP_ARG_I, 0},
+    {MP_QSTR_trunc_s, 10, 9, FP_ARG_A, FP_ARG_F, FP_ARG_I, 0},
+    {MP_QSTR_floor_s, 10, 10, FP_ARG_A, FP_ARG_F, FP_ARG_I, 0},
+    {MP_QSTR_ceil_s, 10, 11, FP_ARG_A, FP_ARG_F, FP_ARG_I, 0},
+    {MP_QSTR_float_s, 10, 12, FP_ARG_F, FP_ARG_A, FP_ARG_I, 0},
+    {MP_QSTR_ufloat_s, 10, 13, FP_ARG_F, FP_ARG_A, FP_ARG_I, 0},
+    {MP_QSTR_utrunc_s, 10, 14, FP_ARG_A, FP_ARG_F, FP_ARG_I, 0},
+
+    // two operand opcodes, selected by the t field
+    {MP_QSTR_mov_s, 10, 15, FP_ARG_F, FP_ARG_F, FP_ARG_NONE, 0},
+    {MP_QSTR_abs_s, 10, 15, FP_ARG_F, FP_ARG_F, FP_ARG_NONE, 1},
+    {MP_QSTR_rfr, 10, 15, FP_ARG_A, FP_ARG_F, FP_ARG_NONE, 4},
+    {MP_QSTR_wfr, 10, 15, FP_ARG_F, FP_ARG_A, FP_ARG_NONE, 5},
+    {MP_QSTR_neg_s, 10, 15, FP_ARG_F, FP_ARG_F, FP_ARG_NONE, 6},
+
+    // comparisons: breg, freg, freg
+    {MP_QSTR_un_s, 11, 1, FP_ARG_B, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_oeq_s, 11, 2, FP_ARG_B, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_ueq_s, 11, 3, FP_ARG_B, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_olt_s, 11, 4, FP_ARG_B, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_ult_s, 11, 5, FP_ARG_B, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_ole_s, 11, 6, FP_ARG_B, FP_ARG_F, FP_ARG_F, 0},
+    {MP_QSTR_ule_s, 11, 7, FP_ARG_B, FP_ARG_F, FP_ARG_F, 0},
+
+    // conditional moves: freg, freg, reg or freg, freg, breg
+    {MP_QSTR_moveqz_s, 11, 8, FP_ARG_F, FP_ARG_F, FP_ARG_A, 0},
+    {MP_QSTR_movnez_s, 11, 9, FP_ARG_F, FP_ARG_F, FP_ARG_A, 0},
+    {MP_QSTR_movltz_s, 11, 10, FP_ARG_F, FP_ARG_F, FP_ARG_A, 0},
+    {MP_QSTR_movgez_s, 11, 11, FP_ARG_F, FP_ARG_F, FP_ARG_A, 0},
+    {MP_QSTR_movf_s, 11, 12, FP_ARG_F, FP_ARG_F, FP_ARG_B, 0},
+    {MP_QSTR_movt_s, 11, 13, FP_ARG_F, FP_ARG_F, FP_ARG_B, 0},
+
+    // indexed load/store: freg, reg, reg
+    {MP_QSTR_lsx, 8, 0, FP_ARG_F, FP_ARG_A, FP_ARG_A, 0},
+    {MP_QSTR_lsxu, 8, 1, FP_ARG_F, FP_ARG_A, FP_ARG_A, 0},
+    {MP_QSTR_ssx, 8, 4, FP_ARG_F, FP_ARG_A, FP_ARG_A, 0},
+    {MP_QSTR_ssxu, 8, 5, FP_ARG_F, FP_ARG_A, FP_ARG_A, 0},
+};
+
+// The index of these qstrs times 4 is the r field of the LSCI opcode.
+static const qstr_short_t LSCI_OPCODES[] = {
+    MP_QSTR_lsi, MP_QSTR_ssi, MP_QSTR_lsiu, MP_QSTR_ssiu
+};
+
+static mp_uint_t get_arg_fp(emit_inline_asm_t *emit, const char *op, mp_parse_node_t pn, uint kind) {
+    switch (kind) {
+        case FP_ARG_A:
+            return get_arg_reg(emit, op, pn);
+        case FP_ARG_F:
+            return get_arg_freg(emit, op, pn);
+        case FP_ARG_B:
+            return get_arg_breg(emit, op, pn);
+        default:
+            return get_arg_i(emit, op, pn, 0, 15);
+    }
+}
+
+// Emits a floating point opcode, returning false if op isn't one.
+static bool emit_inline_xtensa_fp_op(emit_inline_asm_t *emit, qstr op, const char *op_str, mp_uint_t n_args, mp_parse_node_t *pn_args) {
+    for (size_t i = 0; i < MP_ARRAY_SIZE(opcode_table_fp); i++) {
+        const opcode_table_fp_t *o = &opcode_table_fp[i];
+        if (op == o->name) {
+            if (n_args != (o->t == FP_ARG_NONE ? 2 : 3)) {
+                return false;
+            }
+            mp_uint_t r = get_arg_fp(emit, op_str, pn_args[0], o->r);
+            mp_uint_t s = get_arg_fp(emit, op_str, pn_args[1], o->s);
+            mp_uint_t t = o->t == FP_ARG_NONE ? o->t_value : get_arg_fp(emit, op_str, pn_args[2], o->t);
+            asm_xtensa_op24(&emit->as, ASM_XTENSA_ENCODE_RRR(0, o->op1, o->op2, r, s, t));
+            return true;
+        }
+    }
+
+    if (n_args == 2 && (op == MP_QSTR_bt || op == MP_QSTR_bf)) {
+        mp_uint_t b = get_arg_breg(emit, op_str, pn_args[0]);
+        mp_uint_t label = get_arg_label(emit, op_str, pn_args[1]);
+        asm_xtensa_bool_branch(&emit->as, b, label, op == MP_QSTR_bt);
+        return true;
+    }
+
+    if (n_args == 3) {
+        for (size_t index = 0; index < MP_ARRAY_SIZE(LSCI_OPCODES); index++) {
+            if (op == LSCI_OPCODES[index]) {
+                mp_uint_t f = get_arg_freg(emit, op_str, pn_args[0]);
+                mp_uint_t r = get_arg_reg(emit, op_str, pn_args[1]);
+                mp_uint_t imm = get_arg_i(emit, op_str, pn_args[2], 0, 1020);
+                if ((imm & 0x03) != 0) {
+                    emit_inline_xtensa_error_exc(emit, mp_obj_new_exception_msg_varg(&mp_type_SyntaxError, MP_ERROR_TEXT("%d is not a multiple of %d"), imm, 4));
+                } else {
+                    asm_xtensa_op24(&emit->as, ASM_XTENSA_ENCODE_RRI8(3, index * 4, r, f, imm >> 2));
+                }
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 #if MICROPY_EMIT_INLINE_XTENSA_UNCOMMON_OPCODES
 typedef struct _single_opcode_t {
     qstr_short_t name;
@@ -249,9 +456,18 @@ static void emit_inline_xtensa_op(emit_inline_asm_t *emit, qstr op, mp_uint_t n_
     size_t op_len;
     const char *op_str = (const char *)qstr_data(op, &op_len);
 
+    if (emit_inline_xtensa_allow_float(emit) && emit_inline_xtensa_fp_op(emit, op, op_str, n_args, pn_args)) {
+        return;
+    }
+
     if (n_args == 0) {
         if (op == MP_QSTR_ret_n || op == MP_QSTR_ret) {
-            asm_xtensa_op_ret_n(&emit->as);
+            if (emit_inline_xtensa_is_win(emit)) {
+                // restore a0 and return to the caller's register window
+                asm_xtensa_exit_win(&emit->as);
+            } else {
+                asm_xtensa_op_ret_n(&emit->as);
+            }
             return;
         } else if (op == MP_QSTR_nop) {
             asm_xtensa_op24(&emit->as, 0x20F0);
@@ -180,6 +180,21 @@ static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, RE
         *emit->error_slot = mp_obj_new_exception_msg_varg(&mp_type_ViperTypeError, __VA_ARGS__); \
 } while (0)
 
+// Viper floats are held as the raw bits of a float in a machine word (see
+// mp_native_to_obj) and are only available if the target has an FPU.
+#if MICROPY_PY_BUILTINS_FLOAT && defined(ASM_FLOAT_ADD_REG_REG)
+#define N_VIPER_FLOAT (1)
+#define VIPER_FLOAT_ALLOWED(emit) (ASM_FLOAT_ALLOWED((emit)->as))
+#else
+#define N_VIPER_FLOAT (0)
+#define VIPER_FLOAT_ALLOWED(emit) (false)
+#endif
+
+// If floats are not allowed then an error was raised for the float params or
+// return type, so don't replace it with an error about ops on those values.
+#define VIPER_FLOAT_ERROR_RAISED(emit, vtype_a, vtype_b) \
+    (((vtype_a) == VTYPE_FLOAT || (vtype_b) == VTYPE_FLOAT) && !VIPER_FLOAT_ALLOWED(emit))
+
 #if N_RV32
 #define FIT_SIGNED(value, bits)                                                                                     \
     ((((value) & ~((1U << ((bits) - 1)) - 1)) == 0) ||                                      \
@@ -203,6 +218,7 @@ typedef enum {
     VTYPE_PTR8 = 0x00 | MP_NATIVE_TYPE_PTR8,
     VTYPE_PTR16 = 0x00 | MP_NATIVE_TYPE_PTR16,
     VTYPE_PTR32 = 0x00 | MP_NATIVE_TYPE_PTR32,
+    VTYPE_FLOAT = 0x00 | MP_NATIVE_TYPE_FLOAT,
 
     VTYPE_PTR_NONE = 0x50 | MP_NATIVE_TYPE_PTR,
 
@@ -228,6 +244,10 @@ static qstr vtype_to_qstr(vtype_kind_t vtype) {
             return MP_QSTR_ptr16;
         case VTYPE_PTR32:
             return MP_QSTR_ptr32;
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case VTYPE_FLOAT:
+            return MP_QSTR_float;
+        #endif
         case VTYPE_PTR_NONE:
         default:
             return MP_QSTR_None;
@@ -410,8 +430,14 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
             if (id->flags & ID_FLAG_IS_PARAM) {
                 assert(id->local_num < emit->local_vtype_alloc);
                 emit->local_vtype[id->local_num] = id->flags >> ID_FLAG_VIPER_TYPE_POS;
+                if (emit->local_vtype[id->local_num] == VTYPE_FLOAT && !VIPER_FLOAT_ALLOWED(emit)) {
+                    EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("float not supported"));
+                }
             }
         }
+        if ((emit->scope->scope_flags >> MP_SCOPE_FLAG_VIPERRET_POS) == VTYPE_FLOAT && !VIPER_FLOAT_ALLOWED(emit)) {
+            EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("float not supported"));
+        }
     }
 
     // local variables begin unbound, and have unknown type
@@ -1396,8 +1422,30 @@ static void emit_native_load_const_str(emit_t *emit, qstr qst) {
     }
 }
 
+#if N_VIPER_FLOAT
+// Returns the bits of a native float for the target, see mp_native_to_obj.
+static mp_uint_t emit_native_float_bits(mp_float_t f) {
+    #if ASM_WORD_SIZE == 8
+    union { double f; uint64_t u; } u = { .f = (double)f };
+    #else
+    union { float f; uint32_t u; } u = { .f = (float)f };
+    #endif
+    return (mp_uint_t)u.u;
+}
+#endif
+
 static void emit_native_load_const_obj(emit_t *emit, mp_obj_t obj) {
     emit_native_pre(emit);
+    #if N_VIPER_FLOAT
+    if (emit->do_viper_types && mp_obj_is_float(obj)
+        && VIPER_FLOAT_ALLOWED(emit) && ASM_WORD_SIZE <= sizeof(mp_uint_t)) {
+        // like int constants, float constants are native values in viper
+        need_reg_single(emit, REG_TEMP0, 0);
+        ASM_MOV_REG_IMM(emit->as, REG_TEMP0, emit_native_float_bits(mp_obj_float_get(obj)));
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_TEMP0);
+        return;
+    }
+    #endif
     need_reg_single(emit, REG_TEMP0, 0);
     emit_load_reg_with_object(emit, REG_TEMP0, obj);
     emit_post_push_reg(emit, VTYPE_PYOBJ, REG_TEMP0);
@@ -1455,7 +1503,9 @@ static void emit_native_load_global(emit_t *emit, qstr qst, int kind) {
         if (emit->do_viper_types) {
             // check for builtin casting operators
             int native_type = mp_native_type_from_qstr(qst);
-            if (native_type >= MP_NATIVE_TYPE_BOOL) {
+            if (native_type == MP_NATIVE_TYPE_FLOAT && !VIPER_FLOAT_ALLOWED(emit)) {
+                // no native floats, so float is just the builtin type
+            } else if (native_type >= MP_NATIVE_TYPE_BOOL) {
                 emit_post_push_imm(emit, VTYPE_BUILTIN_CAST, native_type);
                 return;
             }
@@ -2414,12 +2464,91 @@ static void emit_native_unary_op(emit_t *emit, mp_unary_op_t op) {
         emit_pre_pop_reg(emit, &vtype, REG_ARG_2);
         emit_call_with_imm_arg(emit, MP_F_UNARY_OP, op, REG_ARG_1);
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
-    } else {
+    #if N_VIPER_FLOAT
+    } else if (vtype == VTYPE_FLOAT && (op == MP_UNARY_OP_POSITIVE || op == MP_UNARY_OP_NEGATIVE)) {
+        if (op == MP_UNARY_OP_NEGATIVE) {
+            emit_pre_pop_reg(emit, &vtype, REG_RET);
+            ASM_FLOAT_NEG_REG(emit->as, REG_RET);
+            emit_post_push_reg(emit, VTYPE_FLOAT, REG_RET);
+        }
+    #endif
+    } else if (!VIPER_FLOAT_ERROR_RAISED(emit, vtype, vtype)) {
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
             MP_ERROR_TEXT("can't do unary op of '%q'"), vtype_to_qstr(vtype));
     }
 }
 
+#if N_VIPER_FLOAT
+
+// Converts the object at the given stack position (1 is TOS) to a native float.
+static void emit_native_unbox_float(emit_t *emit, int pos) {
+    need_stack_settled(emit);
+    mp_uint_t local_num = emit->stack_start + emit->stack_size - pos;
+    emit_native_mov_reg_state(emit, REG_ARG_1, local_num);
+    emit_call_with_imm_arg(emit, MP_F_CONVERT_OBJ_TO_NATIVE, VTYPE_FLOAT, REG_ARG_2); // arg2 = type
+    emit_native_mov_state_reg(emit, local_num, REG_RET);
+    emit->stack_info[emit->stack_size - pos].vtype = VTYPE_FLOAT;
+}
+
+// At least one of the operands is a float and the other is a float, int or object.
+// Ints are converted to floats inline and objects are converted by the runtime.
+static void emit_native_binary_op_float(emit_t *emit, mp_binary_op_t op) {
+    // for floats, inplace and normal ops are equivalent, so use just normal ops
+    if (MP_BINARY_OP_INPLACE_OR <= op && op <= MP_BINARY_OP_INPLACE_POWER) {
+        op += MP_BINARY_OP_OR - MP_BINARY_OP_INPLACE_OR;
+    }
+
+    if (!(MP_BINARY_OP_LESS <= op && op <= MP_BINARY_OP_NOT_EQUAL)
+        && op != MP_BINARY_OP_ADD && op != MP_BINARY_OP_SUBTRACT
+        && op != MP_BINARY_OP_MULTIPLY && op != MP_BINARY_OP_TRUE_DIVIDE) {
+        adjust_stack(emit, -1);
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("binary op %q not implemented"), mp_binary_op_method_name[op]);
+        return;
+    }
+
+    if (peek_vtype(emit, 1) == VTYPE_PYOBJ) {
+        emit_native_unbox_float(emit, 2);
+    }
+    if (peek_vtype(emit, 0) == VTYPE_PYOBJ) {
+        emit_native_unbox_float(emit, 1);
+    }
+
+    vtype_kind_t vtype_lhs, vtype_rhs;
+    emit_pre_pop_reg(emit, &vtype_rhs, REG_ARG_3);
+    if (vtype_rhs == VTYPE_INT) {
+        ASM_FLOAT_FROM_INT_REG(emit->as, REG_ARG_3);
+    }
+    emit_pre_pop_reg(emit, &vtype_lhs, REG_ARG_2);
+    if (vtype_lhs == VTYPE_INT) {
+        ASM_FLOAT_FROM_INT_REG(emit->as, REG_ARG_2);
+    }
+
+    switch (op) {
+        case MP_BINARY_OP_ADD:
+            ASM_FLOAT_ADD_REG_REG(emit->as, REG_ARG_2, REG_ARG_3);
+            break;
+        case MP_BINARY_OP_SUBTRACT:
+            ASM_FLOAT_SUB_REG_REG(emit->as, REG_ARG_2, REG_ARG_3);
+            break;
+        case MP_BINARY_OP_MULTIPLY:
+            ASM_FLOAT_MUL_REG_REG(emit->as, REG_ARG_2, REG_ARG_3);
+            break;
+        case MP_BINARY_OP_TRUE_DIVIDE:
+            ASM_FLOAT_DIV_REG_REG(emit->as, REG_ARG_2, REG_ARG_3);
+            break;
+        default:
+            // a comparison, ASM_FLOAT_CC_xxx are in the same order as the ops
+            need_reg_single(emit, REG_RET, 0);
+            ASM_FLOAT_SETCC_REG_REG_REG(emit->as, op - MP_BINARY_OP_LESS, REG_RET, REG_ARG_2, REG_ARG_3);
+            emit_post_push_reg(emit, VTYPE_BOOL, REG_RET);
+            return;
+    }
+    emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_2);
+}
+
+#endif
+
 static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
     DEBUG_printf("binary_op(" UINT_FMT ")\n", op);
     vtype_kind_t vtype_lhs = peek_vtype(emit, 1);
@@ -2690,6 +2819,12 @@ static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
             EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                 MP_ERROR_TEXT("binary op %q not implemented"), mp_binary_op_method_name[op]);
         }
+    #if N_VIPER_FLOAT
+    } else if ((vtype_lhs == VTYPE_FLOAT || vtype_rhs == VTYPE_FLOAT)
+               && (vtype_lhs == VTYPE_FLOAT || vtype_lhs == VTYPE_INT || vtype_lhs == VTYPE_PYOBJ)
+               && (vtype_rhs == VTYPE_FLOAT || vtype_rhs == VTYPE_INT || vtype_rhs == VTYPE_PYOBJ)) {
+        emit_native_binary_op_float(emit, op);
+    #endif
     } else if (vtype_lhs == VTYPE_PYOBJ && vtype_rhs == VTYPE_PYOBJ) {
         emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_3, &vtype_lhs, REG_ARG_2);
         bool invert = false;
@@ -2708,9 +2843,11 @@ static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
     } else {
         adjust_stack(emit, -1);
-        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
-            MP_ERROR_TEXT("can't do binary op between '%q' and '%q'"),
-            vtype_to_qstr(vtype_lhs), vtype_to_qstr(vtype_rhs));
+        if (!VIPER_FLOAT_ERROR_RAISED(emit, vtype_lhs, vtype_rhs)) {
+            EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                MP_ERROR_TEXT("can't do binary op between '%q' and '%q'"),
+                vtype_to_qstr(vtype_lhs), vtype_to_qstr(vtype_rhs));
+        }
     }
 }
 
@@ -2887,18 +3024,56 @@ static void emit_native_call_function(emit_t *emit, mp_uint_t n_positional, mp_u
                 emit_post_push_reg(emit, vtype_cast, REG_RET);
                 break;
             }
+            #if N_VIPER_FLOAT
+            case VTYPE_BOOL:
+            case VTYPE_INT:
+            case VTYPE_UINT:
+                if (vtype_cast == VTYPE_FLOAT) {
+                    vtype_kind_t vtype;
+                    emit_pre_pop_reg(emit, &vtype, REG_RET);
+                    emit_pre_pop_discard(emit);
+                    ASM_FLOAT_FROM_INT_REG(emit->as, REG_RET);
+                    emit_post_push_reg(emit, VTYPE_FLOAT, REG_RET);
+                    break;
+                }
+                MP_FALLTHROUGH
+            #else
             case VTYPE_BOOL:
             case VTYPE_INT:
             case VTYPE_UINT:
+            #endif
             case VTYPE_PTR:
             case VTYPE_PTR8:
             case VTYPE_PTR16:
             case VTYPE_PTR32:
             case VTYPE_PTR_NONE:
+                if (vtype_cast == VTYPE_FLOAT) {
+                    mp_raise_NotImplementedError(MP_ERROR_TEXT("casting"));
+                }
                 emit_fold_stack_top(emit, REG_ARG_1);
                 emit_post_top_set_vtype(emit, vtype_cast);
                 break;
+            #if N_VIPER_FLOAT
+            case VTYPE_FLOAT:
+                if (vtype_cast == VTYPE_FLOAT) {
+                    emit_fold_stack_top(emit, REG_ARG_1);
+                } else if (vtype_cast == VTYPE_INT || vtype_cast == VTYPE_UINT) {
+                    vtype_kind_t vtype;
+                    emit_pre_pop_reg(emit, &vtype, REG_RET);
+                    emit_pre_pop_discard(emit);
+                    ASM_FLOAT_TO_INT_REG(emit->as, REG_RET);
+                    emit_post_push_reg(emit, vtype_cast, REG_RET);
+                } else {
+                    mp_raise_NotImplementedError(MP_ERROR_TEXT("casting"));
+                }
+                break;
+            #endif
             default:
+                if (VIPER_FLOAT_ERROR_RAISED(emit, peek_vtype(emit, 0), peek_vtype(emit, 0))) {
+                    emit_fold_stack_top(emit, REG_ARG_1);
+                    emit_post_top_set_vtype(emit, vtype_cast);
+                    break;
+                }
                 // this can happen when casting a cast: int(int)
                 mp_raise_NotImplementedError(MP_ERROR_TEXT("casting"));
         }
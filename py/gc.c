@@ -36,6 +36,10 @@
 #include <valgrind/memcheck.h>
 #endif
 
+#if MICROPY_GC_INCREMENTAL
+#include "py/mphal.h"
+#endif
+
 #if MICROPY_ENABLE_GC
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -123,6 +127,31 @@
 #define GC_EXIT()
 #endif
 
+#if MICROPY_GC_INCREMENTAL
+#if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+#error "MICROPY_GC_INCREMENTAL requires the GIL"
+#endif
+
+// Phases of an incremental collection:
+// - IDLE: no collection in progress;
+// - MARK: marking in steps of gc_inc_trace(), the program runs in between
+//   and the write barriers are active;
+// - FINISH: the rest of the collection, done by gc_collect() as usual except
+//   that it starts from the marks made so far and traces the roots again.
+//
+// Objects allocated during the MARK phase are unmarked, and are kept if they
+// are found from the roots at the end, or from another object through a write
+// barrier.  So the program may keep pointers to new objects on the C stack or
+// in the roots freely, but storing a pointer into a heap object that has
+// already been traced must shade the stored object (MP_GC_WRITE_BARRIER).
+#define GC_INC_IDLE (0)
+#define GC_INC_MARK (1)
+#define GC_INC_FINISH (2)
+
+// How many blocks to trace between looks at the clock
+#define GC_INC_CHECK_INTERVAL (16)
+#endif
+
 // Static functions for individual steps of the GC mark/sweep sequence
 static void gc_collect_start_common(void);
 static void *gc_get_ptr(void **ptrs, int i);
@@ -134,6 +163,13 @@ static void gc_mark_subtree(size_t block);
 static void gc_deal_with_stack_overflow(void);
 static void gc_sweep_run_finalisers(void);
 static void gc_sweep_free_blocks(void);
+#if MICROPY_GC_INCREMENTAL
+static bool gc_inc_trace(mp_uint_t budget_us);
+#endif
+#if MICROPY_GC_LAZY_SWEEP
+static void gc_sweep_lazy_start(void);
+static bool gc_sweep_lazy_step(size_t n_blocks);
+#endif
 
 // TODO waste less memory; currently requires that all entries in alloc_table have a corresponding block in pool
 static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
@@ -178,7 +214,10 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     memset(area->gc_alloc_table_start, 0, area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE);
     #endif
 
-    area->gc_last_free_atb_index = 0;
+    memset(area->gc_last_free_atb_index, 0, sizeof(area->gc_last_free_atb_index));
+    #if MICROPY_FLOAT_FREELIST
+    area->gc_float_free_atb_index = 0;
+    #endif
     area->gc_last_used_block = 0;
 
     #if MICROPY_GC_SPLIT_HEAP
@@ -201,6 +240,18 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
         gc_pool_block_len * BYTES_PER_BLOCK, gc_pool_block_len);
 }
 
+// Blocks from the given one on were freed, so a run of n free blocks can now
+// start up to n - 1 blocks earlier.  Move the places to look for free blocks
+// from back where needed.
+static void gc_lower_last_free_atb_index(mp_state_mem_area_t *area, size_t block) {
+    for (size_t n = 1; n <= MICROPY_GC_ALLOC_SIZE_CLASSES; n++) {
+        size_t atb_index = (block < n ? 0 : block - (n - 1)) / BLOCKS_PER_ATB;
+        if (atb_index < area->gc_last_free_atb_index[n - 1]) {
+            area->gc_last_free_atb_index[n - 1] = atb_index;
+        }
+    }
+}
+
 void gc_init(void *start, void *end) {
     // align end pointer on block boundary
     end = (void *)((uintptr_t)end & (~(BYTES_PER_BLOCK - 1)));
@@ -225,6 +276,26 @@ void gc_init(void *start, void *end) {
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
 
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_inc_phase) = GC_INC_IDLE;
+    MP_STATE_MEM(gc_inc_budget_us) = MICROPY_GC_INCREMENTAL_BUDGET_US;
+    MP_STATE_MEM(gc_inc_alloc) = 0;
+    MP_STATE_MEM(gc_inc_next) = MP_STATE_MEM(area).gc_alloc_table_byte_len * BLOCKS_PER_ATB
+        / 100 * MICROPY_GC_INCREMENTAL_START_PERCENT;
+    #endif
+
+    #if MICROPY_GC_LAZY_SWEEP
+    MP_STATE_MEM(gc_sweep_lazy) = false;
+    MP_STATE_MEM(gc_sweep_area) = NULL;
+    #if MICROPY_ENABLE_FINALISER
+    MP_STATE_MEM(gc_finaliser_area) = NULL;
+    #endif
+    #endif
+
+    #if MICROPY_FLOAT_FREELIST
+    MP_STATE_MEM(gc_float_free_len) = 0;
+    #endif
+
     GC_MUTEX_INIT();
 }
 
@@ -414,8 +485,27 @@ void gc_collect_start(void) {
 
 static void gc_collect_start_common(void) {
     GC_ENTER();
+    #if MICROPY_GC_LAZY_SWEEP
+    // the marks of the last collection must be gone before marking again
+    if (MP_STATE_MEM(gc_sweep_area) != NULL) {
+        gc_sweep_lazy_step((size_t)-1);
+    }
+    #endif
+    #if MICROPY_FLOAT_FREELIST
+    // the blocks kept for floats are garbage again, the sweep frees them
+    MP_STATE_MEM(gc_float_free_len) = 0;
+    #endif
     assert((MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG) == 0);
     MP_STATE_THREAD(gc_lock_depth) |= GC_COLLECT_FLAG;
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK) {
+        // Finish the incremental collection in progress: trace whatever is
+        // still queued, keeping the marks, and let the caller trace the roots.
+        gc_inc_trace(0);
+        MP_STATE_MEM(gc_inc_phase) = GC_INC_FINISH;
+        return;
+    }
+    #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
 }
 
@@ -446,9 +536,79 @@ void gc_collect_root(void **ptrs, size_t len) {
             gc_mark_subtree(block);
             #endif
         }
+        #if MICROPY_GC_INCREMENTAL
+        else if (MP_STATE_MEM(gc_inc_phase) == GC_INC_FINISH && ATB_GET_KIND(area, block) == AT_MARK) {
+            // Marked during the incremental phase, but code that still holds
+            // it may have changed it since: check its children again.
+            #if MICROPY_GC_SPLIT_HEAP
+            gc_mark_subtree(area, block);
+            #else
+            gc_mark_subtree(block);
+            #endif
+        }
+        #endif
     }
 }
 
+// Check the given words for pointers to unmarked heads: mark them and push
+// them on the stack, which has sp entries.  Returns the new number of entries.
+static inline MP_ALWAYSINLINE size_t gc_mark_ptrs(void **ptrs, size_t n_ptrs, size_t sp) {
+    #if !MICROPY_GC_SPLIT_HEAP
+    mp_state_mem_area_t *ptr_area = &MP_STATE_MEM(area);
+    #endif
+    for (size_t i = n_ptrs; i > 0; i--, ptrs++) {
+        MICROPY_GC_HOOK_LOOP(i);
+        void *ptr = *ptrs;
+        // If this is a heap pointer that hasn't been marked, mark it and push
+        // it's children to the stack.
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
+        if (!ptr_area) {
+            // Not a heap-allocated pointer (might even be random data).
+            continue;
+        }
+        #else
+        if (!VERIFY_PTR(ptr)) {
+            continue;
+        }
+        #endif
+        size_t ptr_block = BLOCK_FROM_PTR(ptr_area, ptr);
+        if (ATB_GET_KIND(ptr_area, ptr_block) != AT_HEAD) {
+            // This block is already marked.
+            continue;
+        }
+        // An unmarked head. Mark it, and push it on gc stack.
+        TRACE_MARK(ptr_block, ptr);
+        ATB_HEAD_TO_MARK(ptr_area, ptr_block);
+        if (sp < MICROPY_ALLOC_GC_STACK_SIZE) {
+            MP_STATE_MEM(gc_block_stack)[sp] = ptr_block;
+            #if MICROPY_GC_SPLIT_HEAP
+            MP_STATE_MEM(gc_area_stack)[sp] = ptr_area;
+            #endif
+            sp += 1;
+        } else {
+            MP_STATE_MEM(gc_stack_overflow) = 1;
+        }
+    }
+    return sp;
+}
+
+// Mark the unmarked children of the given block, see gc_mark_ptrs().
+static inline MP_ALWAYSINLINE size_t gc_mark_children(mp_state_mem_area_t *area, size_t block, size_t sp) {
+    // work out number of consecutive blocks in the chain starting with this one
+    size_t n_blocks = 0;
+    do {
+        n_blocks += 1;
+    } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
+
+    // check that the consecutive blocks didn't overflow past the end of the area
+    assert(area->gc_pool_start + (block + n_blocks) * BYTES_PER_BLOCK <= area->gc_pool_end);
+
+    // check this block's children
+    void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+    return gc_mark_ptrs(ptrs, n_blocks * BYTES_PER_BLOCK / sizeof(void *), sp);
+}
+
 // Take the given block as the topmost block on the stack. Check all it's
 // children: mark the unmarked child blocks and put those newly marked
 // blocks on the stack. When all children have been checked, pop off the
@@ -466,52 +626,7 @@ static void gc_mark_subtree(size_t block)
         mp_state_mem_area_t *area = &MP_STATE_MEM(area);
         #endif
 
-        // work out number of consecutive blocks in the chain starting with this one
-        size_t n_blocks = 0;
-        do {
-            n_blocks += 1;
-        } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
-
-        // check that the consecutive blocks didn't overflow past the end of the area
-        assert(area->gc_pool_start + (block + n_blocks) * BYTES_PER_BLOCK <= area->gc_pool_end);
-
-        // check this block's children
-        void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
-        for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
-            MICROPY_GC_HOOK_LOOP(i);
-            void *ptr = *ptrs;
-            // If this is a heap pointer that hasn't been marked, mark it and push
-            // it's children to the stack.
-            #if MICROPY_GC_SPLIT_HEAP
-            mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
-            if (!ptr_area) {
-                // Not a heap-allocated pointer (might even be random data).
-                continue;
-            }
-            #else
-            if (!VERIFY_PTR(ptr)) {
-                continue;
-            }
-            mp_state_mem_area_t *ptr_area = area;
-            #endif
-            size_t ptr_block = BLOCK_FROM_PTR(ptr_area, ptr);
-            if (ATB_GET_KIND(ptr_area, ptr_block) != AT_HEAD) {
-                // This block is already marked.
-                continue;
-            }
-            // An unmarked head. Mark it, and push it on gc stack.
-            TRACE_MARK(ptr_block, ptr);
-            ATB_HEAD_TO_MARK(ptr_area, ptr_block);
-            if (sp < MICROPY_ALLOC_GC_STACK_SIZE) {
-                MP_STATE_MEM(gc_block_stack)[sp] = ptr_block;
-                #if MICROPY_GC_SPLIT_HEAP
-                MP_STATE_MEM(gc_area_stack)[sp] = ptr_area;
-                #endif
-                sp += 1;
-            } else {
-                MP_STATE_MEM(gc_stack_overflow) = 1;
-            }
-        }
+        sp = gc_mark_children(area, block, sp);
 
         // Are there any blocks on the stack?
         if (sp == 0) {
@@ -527,20 +642,325 @@ static void gc_mark_subtree(size_t block)
     }
 }
 
+// Collect because the allocator needs memory.
+static void gc_collect_for_alloc(void) {
+    #if MICROPY_GC_LAZY_SWEEP
+    MP_STATE_MEM(gc_sweep_lazy) = true;
+    gc_collect();
+    MP_STATE_MEM(gc_sweep_lazy) = false;
+    #else
+    gc_collect();
+    #endif
+}
+
+#if MICROPY_GC_INCREMENTAL
+
+// Push a marked block on the stack of blocks still to be traced.
+static void gc_inc_push(mp_state_mem_area_t *area, size_t block) {
+    size_t sp = MP_STATE_MEM(gc_inc_sp);
+    if (sp < MICROPY_ALLOC_GC_STACK_SIZE) {
+        MP_STATE_MEM(gc_block_stack)[sp] = block;
+        #if MICROPY_GC_SPLIT_HEAP
+        MP_STATE_MEM(gc_area_stack)[sp] = area;
+        #else
+        (void)area;
+        #endif
+        MP_STATE_MEM(gc_inc_sp) = sp + 1;
+    } else {
+        MP_STATE_MEM(gc_stack_overflow) = 1;
+    }
+}
+
+// Find the next marked block from the gc_inc_scan_* position, for tracing the
+// heap again after the stack overflowed.  Returns false at the end of the heap.
+static bool gc_inc_scan_next(mp_state_mem_area_t **area_out, size_t *block_out) {
+    mp_state_mem_area_t *area = MP_STATE_MEM(gc_inc_scan_area);
+    size_t block = MP_STATE_MEM(gc_inc_scan_block);
+    for (;;) {
+        if (block > area->gc_last_used_block) {
+            area = NEXT_AREA(area);
+            block = 0;
+            if (area == NULL) {
+                MP_STATE_MEM(gc_inc_scan_area) = NULL;
+                return false;
+            }
+        } else if (ATB_GET_KIND(area, block) == AT_MARK) {
+            break;
+        } else {
+            block += 1;
+        }
+    }
+    MP_STATE_MEM(gc_inc_scan_area) = area;
+    MP_STATE_MEM(gc_inc_scan_block) = block + 1;
+    *area_out = area;
+    *block_out = block;
+    return true;
+}
+
+// Trace from the roots and the queued blocks for at most budget_us (0 for no
+// limit).  Returns true when there is nothing left to trace.
+static bool gc_inc_trace(mp_uint_t budget_us) {
+    void **roots = (void **)(void *)&mp_state_ctx + offsetof(mp_state_ctx_t, thread.dict_locals) / sizeof(void *);
+    size_t n_roots = (offsetof(mp_state_ctx_t, vm.qstr_last_chunk) - offsetof(mp_state_ctx_t, thread.dict_locals)) / sizeof(void *);
+    mp_uint_t t_start = mp_hal_ticks_us();
+    size_t sp = MP_STATE_MEM(gc_inc_sp);
+    for (size_t n = 1;; n++) {
+        if (sp > 0) {
+            // pop the next block off the stack and trace its children
+            sp -= 1;
+            size_t block = MP_STATE_MEM(gc_block_stack)[sp];
+            #if MICROPY_GC_SPLIT_HEAP
+            mp_state_mem_area_t *area = MP_STATE_MEM(gc_area_stack)[sp];
+            #else
+            mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+            #endif
+            sp = gc_mark_children(area, block, sp);
+        } else if (MP_STATE_MEM(gc_inc_root) < n_roots) {
+            // the static roots are taken a few at a time as the stack empties
+            size_t i = MP_STATE_MEM(gc_inc_root);
+            size_t len = MIN(n_roots - i, (size_t)GC_INC_CHECK_INTERVAL);
+            MP_STATE_MEM(gc_inc_root) = i + len;
+            sp = gc_mark_ptrs(roots + i, len, sp);
+        } else if (MP_STATE_MEM(gc_stack_overflow) || MP_STATE_MEM(gc_inc_scan_area) != NULL) {
+            // some marked blocks didn't fit on the stack: go over the heap
+            // tracing all marked blocks again, until a pass has no overflow
+            if (MP_STATE_MEM(gc_inc_scan_area) == NULL) {
+                MP_STATE_MEM(gc_stack_overflow) = 0;
+                MP_STATE_MEM(gc_inc_scan_area) = &MP_STATE_MEM(area);
+                MP_STATE_MEM(gc_inc_scan_block) = 0;
+            }
+            mp_state_mem_area_t *area;
+            size_t block;
+            if (gc_inc_scan_next(&area, &block)) {
+                sp = gc_mark_children(area, block, sp);
+            }
+        } else {
+            MP_STATE_MEM(gc_inc_sp) = 0;
+            return true;
+        }
+        if (budget_us != 0 && n % GC_INC_CHECK_INTERVAL == 0
+            && mp_hal_ticks_us() - t_start >= budget_us) {
+            MP_STATE_MEM(gc_inc_sp) = sp;
+            return false;
+        }
+    }
+}
+
+// Run one step of incremental collection: start a collection if none is in
+// progress, trace for up to budget_us, or finish the collection once all is
+// traced.  The last one is a stop-the-world collection of the remaining work.
+static void gc_inc_step(mp_uint_t budget_us) {
+    GC_ENTER();
+    bool traced = false;
+    #if MICROPY_GC_LAZY_SWEEP
+    if (MP_STATE_MEM(gc_sweep_area) != NULL) {
+        // finish sweeping the last collection before starting the next one
+        mp_uint_t t_start = mp_hal_ticks_us();
+        while (!gc_sweep_lazy_step(MICROPY_GC_LAZY_SWEEP_BLOCKS)
+               && mp_hal_ticks_us() - t_start < budget_us) {
+        }
+        MP_STATE_MEM(gc_inc_next) = MP_STATE_MEM(gc_inc_alloc) + MICROPY_GC_INCREMENTAL_STEP_BYTES / BYTES_PER_BLOCK;
+        GC_EXIT();
+        return;
+    }
+    #endif
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_IDLE) {
+        DEBUG_printf("gc_inc_step: start\n");
+        MP_STATE_MEM(gc_inc_phase) = GC_INC_MARK;
+        MP_STATE_MEM(gc_inc_sp) = 0;
+        MP_STATE_MEM(gc_inc_root) = 0;
+        MP_STATE_MEM(gc_inc_scan_area) = NULL;
+        MP_STATE_MEM(gc_stack_overflow) = 0;
+        #if MICROPY_FLOAT_FREELIST
+        MP_STATE_MEM(gc_float_free_len) = 0;
+        #endif
+    } else if (MP_STATE_MEM(gc_inc_sp) == 0
+               && MP_STATE_MEM(gc_inc_root) == (offsetof(mp_state_ctx_t, vm.qstr_last_chunk) - offsetof(mp_state_ctx_t, thread.dict_locals)) / sizeof(void *)
+               && !MP_STATE_MEM(gc_stack_overflow)
+               && MP_STATE_MEM(gc_inc_scan_area) == NULL) {
+        traced = true;
+    }
+    if (!traced) {
+        gc_inc_trace(budget_us);
+        MP_STATE_MEM(gc_inc_next) = MP_STATE_MEM(gc_inc_alloc) + MICROPY_GC_INCREMENTAL_STEP_BYTES / BYTES_PER_BLOCK;
+    }
+    GC_EXIT();
+    if (traced) {
+        DEBUG_printf("gc_inc_step: finish\n");
+        gc_collect_for_alloc();
+    }
+}
+
+void gc_incremental_idle(mp_uint_t idle_us) {
+    mp_uint_t budget_us = MP_STATE_MEM(gc_inc_budget_us);
+    if (budget_us == 0 || idle_us == 0 || !MP_STATE_MEM(gc_auto_collect_enabled)
+        || MP_STATE_THREAD(gc_lock_depth) != 0) {
+        return;
+    }
+    // Start a collection early if one is at least half due, otherwise
+    // continue the one (or the sweep) in progress.
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_IDLE
+        #if MICROPY_GC_LAZY_SWEEP
+        && MP_STATE_MEM(gc_sweep_area) == NULL
+        #endif
+        && MP_STATE_MEM(gc_inc_alloc) < MP_STATE_MEM(gc_inc_next) / 2) {
+        return;
+    }
+    gc_inc_step(MIN(budget_us, idle_us));
+}
+
+void gc_write_barrier(const void *ptr) {
+    if (MP_STATE_MEM(gc_inc_phase) != GC_INC_MARK) {
+        return;
+    }
+    mp_state_mem_area_t *area;
+    #if MICROPY_GC_SPLIT_HEAP
+    area = gc_get_ptr_area(ptr);
+    if (!area) {
+        return;
+    }
+    #else
+    if (!VERIFY_PTR(ptr)) {
+        return;
+    }
+    area = &MP_STATE_MEM(area);
+    #endif
+    size_t block = BLOCK_FROM_PTR(area, ptr);
+    if (ATB_GET_KIND(area, block) != AT_HEAD) {
+        return;
+    }
+    ATB_HEAD_TO_MARK(area, block);
+    if (MP_STATE_THREAD(gc_lock_depth) != 0) {
+        // Maybe called from a hard IRQ during a step, so don't touch the
+        // stack; having it overflow makes the step trace this block later.
+        MP_STATE_MEM(gc_stack_overflow) = 1;
+    } else {
+        gc_inc_push(area, block);
+    }
+}
+
+void gc_write_barrier_rescan(const void *ptr) {
+    if (MP_STATE_MEM(gc_inc_phase) != GC_INC_MARK) {
+        return;
+    }
+    mp_state_mem_area_t *area;
+    #if MICROPY_GC_SPLIT_HEAP
+    area = gc_get_ptr_area(ptr);
+    if (!area) {
+        return;
+    }
+    #else
+    if (!VERIFY_PTR(ptr)) {
+        return;
+    }
+    area = &MP_STATE_MEM(area);
+    #endif
+    size_t block = BLOCK_FROM_PTR(area, ptr);
+    if (ATB_GET_KIND(area, block) == AT_HEAD) {
+        ATB_HEAD_TO_MARK(area, block);
+    }
+    if (MP_STATE_THREAD(gc_lock_depth) != 0) {
+        MP_STATE_MEM(gc_stack_overflow) = 1;
+    } else {
+        gc_inc_push(area, block);
+    }
+}
+
+#if MICROPY_GC_INCREMENTAL_VERIFY
+// Check that no marked block points to an unmarked head.  Such a pointer was
+// stored after the block was traced without going through a write barrier.
+static void gc_inc_verify(void) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        for (size_t block = 0; block <= area->gc_last_used_block; block++) {
+            if (ATB_GET_KIND(area, block) != AT_MARK) {
+                continue;
+            }
+            size_t n_blocks = 0;
+            do {
+                n_blocks += 1;
+            } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
+            void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+            for (size_t i = 0; i < n_blocks * BYTES_PER_BLOCK / sizeof(void *); i++) {
+                void *ptr = ptrs[i];
+                #if MICROPY_GC_SPLIT_HEAP
+                mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
+                if (!ptr_area) {
+                    continue;
+                }
+                #else
+                if (!VERIFY_PTR(ptr)) {
+                    continue;
+                }
+                mp_state_mem_area_t *ptr_area = area;
+                #endif
+                size_t ptr_block = BLOCK_FROM_PTR(ptr_area, ptr);
+                if (ATB_GET_KIND(ptr_area, ptr_block) == AT_HEAD) {
+                    mp_printf(&mp_plat_print, "GC: %p[%u] -> %p missed the write barrier\n",
+                        ptrs, (uint)i, ptr);
+                    ATB_HEAD_TO_MARK(ptr_area, ptr_block);
+                    #if MICROPY_GC_SPLIT_HEAP
+                    gc_mark_subtree(ptr_area, ptr_block);
+                    #else
+                    gc_mark_subtree(ptr_block);
+                    #endif
+                }
+            }
+        }
+    }
+}
+#endif
+
+// Drop an unfinished incremental collection, clearing its marks.
+static void gc_inc_abandon(void) {
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        for (size_t block = 0; block <= area->gc_last_used_block; block++) {
+            if (ATB_GET_KIND(area, block) == AT_MARK) {
+                ATB_MARK_TO_HEAD(area, block);
+            }
+        }
+    }
+    MP_STATE_MEM(gc_inc_phase) = GC_INC_IDLE;
+    MP_STATE_MEM(gc_inc_sp) = 0;
+    MP_STATE_MEM(gc_inc_scan_area) = NULL;
+}
+
+#endif // MICROPY_GC_INCREMENTAL
+
 void gc_sweep_all(void) {
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_phase) != GC_INC_IDLE) {
+        gc_inc_abandon();
+    }
+    #endif
     gc_collect_start_common();
     gc_collect_end();
 }
 
 void gc_collect_end(void) {
     gc_deal_with_stack_overflow();
-    gc_sweep_run_finalisers();
-    gc_sweep_free_blocks();
-    #if MICROPY_GC_SPLIT_HEAP
-    MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+    #if MICROPY_GC_INCREMENTAL
+    #if MICROPY_GC_INCREMENTAL_VERIFY
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_FINISH) {
+        gc_inc_verify();
+    }
     #endif
-    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
-        area->gc_last_free_atb_index = 0;
+    // marking is complete, the write barriers can be switched off
+    MP_STATE_MEM(gc_inc_phase) = GC_INC_IDLE;
+    #endif
+    #if MICROPY_GC_LAZY_SWEEP
+    if (MP_STATE_MEM(gc_sweep_lazy)) {
+        gc_sweep_lazy_start();
+    } else
+    #endif
+    {
+        gc_sweep_run_finalisers();
+        gc_sweep_free_blocks();
+        #if MICROPY_GC_SPLIT_HEAP
+        MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+        #endif
+        for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+            memset(area->gc_last_free_atb_index, 0, sizeof(area->gc_last_free_atb_index));
+        }
     }
     MP_STATE_THREAD(gc_lock_depth) &= ~GC_COLLECT_FLAG;
     GC_EXIT();
@@ -567,6 +987,30 @@ static void gc_deal_with_stack_overflow(void) {
     }
 }
 
+#if MICROPY_ENABLE_FINALISER
+// Run the finaliser of the given to-be-freed block
+static void gc_sweep_run_finaliser(const mp_state_mem_area_t *area, size_t block) {
+    mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
+    if (obj->type != NULL) {
+        // if the object has a type then see if it has a __del__ method
+        mp_obj_t dest[2];
+        mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
+        if (dest[0] != MP_OBJ_NULL) {
+            // load_method returned a method, execute it in a protected environment
+            #if MICROPY_ENABLE_SCHEDULER
+            mp_sched_lock();
+            #endif
+            mp_call_function_1_protected(dest[0], dest[1]);
+            #if MICROPY_ENABLE_SCHEDULER
+            mp_sched_unlock();
+            #endif
+        }
+    }
+    // clear finaliser flag
+    FTB_CLEAR(area, block);
+}
+#endif
+
 // Run finalisers for all to-be-freed blocks
 static void gc_sweep_run_finalisers(void) {
     #if MICROPY_ENABLE_FINALISER
@@ -581,24 +1025,7 @@ static void gc_sweep_run_finalisers(void) {
                 MICROPY_GC_HOOK_LOOP(block);
                 if (ftb & 1) { // FTB_GET(area, block) shortcut
                     if (ATB_GET_KIND(area, block) == AT_HEAD) {
-                        mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
-                        if (obj->type != NULL) {
-                            // if the object has a type then see if it has a __del__ method
-                            mp_obj_t dest[2];
-                            mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
-                            if (dest[0] != MP_OBJ_NULL) {
-                                // load_method returned a method, execute it in a protected environment
-                                #if MICROPY_ENABLE_SCHEDULER
-                                mp_sched_lock();
-                                #endif
-                                mp_call_function_1_protected(dest[0], dest[1]);
-                                #if MICROPY_ENABLE_SCHEDULER
-                                mp_sched_unlock();
-                                #endif
-                            }
-                        }
-                        // clear finaliser flag
-                        FTB_CLEAR(area, block);
+                        gc_sweep_run_finaliser(area, block);
                     }
                 }
                 ftb >>= 1;
@@ -609,52 +1036,72 @@ static void gc_sweep_run_finalisers(void) {
     #endif // MICROPY_ENABLE_FINALISER
 }
 
+// Free unmarked heads and their tails in the blocks from start up to end,
+// which must not start in the middle of a chain.  Returns the last block
+// still in use, or 0 if there is none, and adds the used blocks to *n_used
+// (only counted for incremental collection).
+static size_t gc_sweep_free_range(mp_state_mem_area_t *area, size_t start, size_t end, size_t *n_used) {
+    size_t last_used_block = 0;
+    int free_tail = 0;
+    for (size_t block = start; block < end; block++) {
+        MICROPY_GC_HOOK_LOOP(block);
+        switch (ATB_GET_KIND(area, block)) {
+            case AT_HEAD:
+                free_tail = 1;
+                DEBUG_printf("gc_sweep_free_blocks(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
+                #if MICROPY_PY_GC_COLLECT_RETVAL
+                MP_STATE_MEM(gc_collected)++;
+                #endif
+                // fall through to free the head
+                MP_FALLTHROUGH
+
+            case AT_TAIL:
+                if (free_tail) {
+                    ATB_ANY_TO_FREE(area, block);
+                    #if CLEAR_ON_SWEEP
+                    memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
+                    #endif
+                } else {
+                    last_used_block = block;
+                    #if MICROPY_GC_INCREMENTAL
+                    *n_used += 1;
+                    #endif
+                }
+                break;
+
+            case AT_MARK:
+                ATB_MARK_TO_HEAD(area, block);
+                free_tail = 0;
+                last_used_block = block;
+                #if MICROPY_GC_INCREMENTAL
+                *n_used += 1;
+                #endif
+                break;
+        }
+    }
+    return last_used_block;
+}
+
 // Free unmarked heads and their tails
 static void gc_sweep_free_blocks(void) {
     #if MICROPY_PY_GC_COLLECT_RETVAL
     MP_STATE_MEM(gc_collected) = 0;
     #endif
-    int free_tail = 0;
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     mp_state_mem_area_t *prev_area = NULL;
     #endif
+    #if MICROPY_GC_INCREMENTAL
+    size_t n_total = 0;
+    #endif
+    size_t n_used = 0;
 
     for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
-        size_t last_used_block = 0;
         assert(area->gc_last_used_block <= area->gc_alloc_table_byte_len * BLOCKS_PER_ATB);
-
-        for (size_t block = 0; block <= area->gc_last_used_block; block++) {
-            MICROPY_GC_HOOK_LOOP(block);
-            switch (ATB_GET_KIND(area, block)) {
-                case AT_HEAD:
-                    free_tail = 1;
-                    DEBUG_printf("gc_sweep_free_blocks(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
-                    #if MICROPY_PY_GC_COLLECT_RETVAL
-                    MP_STATE_MEM(gc_collected)++;
-                    #endif
-                    // fall through to free the head
-                    MP_FALLTHROUGH
-
-                case AT_TAIL:
-                    if (free_tail) {
-                        ATB_ANY_TO_FREE(area, block);
-                        #if CLEAR_ON_SWEEP
-                        memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
-                        #endif
-                    } else {
-                        last_used_block = block;
-                    }
-                    break;
-
-                case AT_MARK:
-                    ATB_MARK_TO_HEAD(area, block);
-                    free_tail = 0;
-                    last_used_block = block;
-                    break;
-            }
-        }
-
+        size_t last_used_block = gc_sweep_free_range(area, 0, area->gc_last_used_block + 1, &n_used);
         area->gc_last_used_block = last_used_block;
+        #if MICROPY_GC_INCREMENTAL
+        n_total += area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        #endif
 
         #if MICROPY_GC_SPLIT_HEAP_AUTO
         // Free any empty area, aside from the first one
@@ -667,8 +1114,196 @@ static void gc_sweep_free_blocks(void) {
         prev_area = area;
         #endif
     }
+
+    #if MICROPY_GC_INCREMENTAL
+    // start the next incremental collection once a share of the free heap
+    // has been allocated
+    MP_STATE_MEM(gc_inc_alloc) = 0;
+    MP_STATE_MEM(gc_inc_next) = (n_total - n_used) / 100 * MICROPY_GC_INCREMENTAL_START_PERCENT;
+    #endif
 }
 
+#if MICROPY_GC_LAZY_SWEEP
+
+// Lazy sweeping: a collection run for the allocator ends with the marks
+// still in the heap.  The garbage is the unmarked heads and their tails in
+// the part of the heap not yet swept, from gc_sweep_area/gc_sweep_block on.
+// When the allocator can't find memory it sweeps some more and looks again,
+// and the next collection first sweeps whatever is left.  Blocks allocated
+// in the unswept part are marked so that the sweep keeps them.  Finalisers
+// may look at other garbage, so they all run before the first block is
+// freed, in batches from the scheduler unless the allocator needs memory
+// before that.
+
+// Whether the sweep in progress has still to get to the given block.
+static bool gc_sweep_lazy_pending(const mp_state_mem_area_t *area, size_t block) {
+    const mp_state_mem_area_t *sweep_area = MP_STATE_MEM(gc_sweep_area);
+    if (sweep_area == area) {
+        return block >= MP_STATE_MEM(gc_sweep_block);
+    }
+    if (sweep_area == NULL) {
+        return false;
+    }
+    #if MICROPY_GC_SPLIT_HEAP
+    // a later area hasn't been swept yet
+    for (sweep_area = NEXT_AREA(sweep_area); sweep_area != NULL; sweep_area = NEXT_AREA(sweep_area)) {
+        if (sweep_area == area) {
+            return true;
+        }
+    }
+    #endif
+    return false;
+}
+
+// Get the end, as an ATB index, of the part of the area the allocator looks
+// in.  During the sweep that's the part already swept, as the rest holds
+// little but garbage.  Before, while there are finalisers to run, it's all of
+// it, and what was free before the collection can be used.
+static size_t gc_sweep_lazy_alloc_end(const mp_state_mem_area_t *area) {
+    #if MICROPY_ENABLE_FINALISER
+    if (MP_STATE_MEM(gc_finaliser_area) != NULL) {
+        return area->gc_alloc_table_byte_len;
+    }
+    #endif
+    if (area == MP_STATE_MEM(gc_sweep_area)) {
+        return MP_STATE_MEM(gc_sweep_block) / BLOCKS_PER_ATB;
+    }
+    if (gc_sweep_lazy_pending(area, 0)) {
+        return 0;
+    }
+    return area->gc_alloc_table_byte_len;
+}
+
+#if MICROPY_ENABLE_FINALISER
+// Run the finalisers of up to n to-be-freed blocks, continuing from where
+// the last call stopped.  Returns true once there are none left.
+static bool gc_sweep_lazy_run_finalisers(size_t n) {
+    mp_state_mem_area_t *area = MP_STATE_MEM(gc_finaliser_area);
+    size_t block = MP_STATE_MEM(gc_finaliser_block);
+    // finalisers can't allocate, just like during a collection
+    MP_STATE_THREAD(gc_lock_depth) |= GC_COLLECT_FLAG;
+    while (area != NULL) {
+        if (block > area->gc_last_used_block) {
+            area = NEXT_AREA(area);
+            block = 0;
+            continue;
+        }
+        byte ftb = area->gc_finaliser_table_start[block / BLOCKS_PER_FTB] >> (block & (BLOCKS_PER_FTB - 1));
+        if (ftb == 0) {
+            // skip to the next FTB
+            block = (block | (BLOCKS_PER_FTB - 1)) + 1;
+            continue;
+        }
+        if ((ftb & 1) && ATB_GET_KIND(area, block) == AT_HEAD) {
+            if (n == 0) {
+                break;
+            }
+            n -= 1;
+            gc_sweep_run_finaliser(area, block);
+        }
+        block += 1;
+    }
+    MP_STATE_THREAD(gc_lock_depth) &= ~GC_COLLECT_FLAG;
+    MP_STATE_MEM(gc_finaliser_area) = area;
+    MP_STATE_MEM(gc_finaliser_block) = block;
+    return area == NULL;
+}
+
+#if MICROPY_SCHEDULER_STATIC_NODES
+static mp_sched_node_t gc_finaliser_sched_node;
+
+static void gc_sweep_lazy_sched_finalisers(mp_sched_node_t *node) {
+    GC_ENTER();
+    if (MP_STATE_MEM(gc_finaliser_area) != NULL
+        && !gc_sweep_lazy_run_finalisers(MICROPY_GC_LAZY_SWEEP_FINALISERS)) {
+        mp_sched_schedule_node(node, gc_sweep_lazy_sched_finalisers);
+    }
+    GC_EXIT();
+}
+#endif
+#endif // MICROPY_ENABLE_FINALISER
+
+// Called at the end of a collection instead of sweeping.
+static void gc_sweep_lazy_start(void) {
+    MP_STATE_MEM(gc_sweep_area) = &MP_STATE_MEM(area);
+    MP_STATE_MEM(gc_sweep_block) = 0;
+    #if MICROPY_PY_GC_COLLECT_RETVAL
+    MP_STATE_MEM(gc_collected) = 0;
+    #endif
+    #if MICROPY_GC_INCREMENTAL
+    // the next incremental collection is due as after the last one until
+    // the sweep can tell how much is free
+    MP_STATE_MEM(gc_inc_alloc) = 0;
+    MP_STATE_MEM(gc_sweep_n_used) = 0;
+    #endif
+    #if MICROPY_ENABLE_FINALISER
+    MP_STATE_MEM(gc_finaliser_area) = &MP_STATE_MEM(area);
+    MP_STATE_MEM(gc_finaliser_block) = 0;
+    #if MICROPY_SCHEDULER_STATIC_NODES
+    mp_sched_schedule_node(&gc_finaliser_sched_node, gc_sweep_lazy_sched_finalisers);
+    #endif
+    #endif
+}
+
+// Sweep at least n_blocks more blocks, running any finalisers left first.
+// Returns true when the sweep is complete.
+static bool gc_sweep_lazy_step(size_t n_blocks) {
+    #if MICROPY_ENABLE_FINALISER
+    if (MP_STATE_MEM(gc_finaliser_area) != NULL) {
+        gc_sweep_lazy_run_finalisers((size_t)-1);
+    }
+    #endif
+    mp_state_mem_area_t *area = MP_STATE_MEM(gc_sweep_area);
+    size_t block = MP_STATE_MEM(gc_sweep_block);
+    size_t n_used = 0;
+    while (area != NULL && n_blocks > 0) {
+        size_t end = area->gc_last_used_block + 1;
+        if (n_blocks < end - block) {
+            // stop at the end of a chain, so the next step starts at a head
+            end = block + n_blocks;
+            while (ATB_GET_KIND(area, end) == AT_TAIL) {
+                end += 1;
+            }
+        }
+        n_blocks -= MIN(n_blocks, end - block);
+        gc_sweep_free_range(area, block, end, &n_used);
+        gc_lower_last_free_atb_index(area, block);
+        #if MICROPY_GC_SPLIT_HEAP
+        if (MP_STATE_MEM(gc_last_free_area) != area) {
+            // See comment in gc_free.
+            MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+        }
+        #endif
+        block = end;
+        if (block > area->gc_last_used_block) {
+            // the area is swept: the allocations made meanwhile are in use too
+            size_t last_used_block = area->gc_last_used_block;
+            while (last_used_block > 0 && ATB_GET_KIND(area, last_used_block) == AT_FREE) {
+                last_used_block -= 1;
+            }
+            area->gc_last_used_block = last_used_block;
+            area = NEXT_AREA(area);
+            block = 0;
+        }
+    }
+    MP_STATE_MEM(gc_sweep_area) = area;
+    MP_STATE_MEM(gc_sweep_block) = block;
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_sweep_n_used) += n_used;
+    if (area == NULL) {
+        // as in gc_sweep_free_blocks, but counting from the collection
+        size_t n_total = 0;
+        for (mp_state_mem_area_t *a = &MP_STATE_MEM(area); a != NULL; a = NEXT_AREA(a)) {
+            n_total += a->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        }
+        MP_STATE_MEM(gc_inc_next) = (n_total - MIN(n_total, MP_STATE_MEM(gc_sweep_n_used))) / 100 * MICROPY_GC_INCREMENTAL_START_PERCENT;
+    }
+    #endif
+    return area == NULL;
+}
+
+#endif // MICROPY_GC_LAZY_SWEEP
+
 // Address sanitizer needs to know that the access to ptrs[i] must always be
 // considered OK, even if it's a load from an address that would normally be
 // prohibited (due to being undefined, in a red zone, etc).
@@ -684,6 +1319,29 @@ static void *gc_get_ptr(void **ptrs, int i) {
     return ptrs[i];
 }
 
+#if MICROPY_GC_LAZY_SWEEP
+// Get the kind of the given block for gc_info(), which counts the garbage
+// from block unswept on as free.  *garbage tracks if a tail is garbage.
+static size_t gc_info_get_kind(const mp_state_mem_area_t *area, size_t block, size_t unswept, bool *garbage) {
+    size_t kind = ATB_GET_KIND(area, block);
+    if (block < unswept) {
+        return kind;
+    }
+    switch (kind) {
+        case AT_HEAD:
+            *garbage = true;
+            return AT_FREE;
+        case AT_MARK:
+            *garbage = false;
+            return AT_HEAD;
+        case AT_TAIL:
+            return *garbage ? AT_FREE : AT_TAIL;
+        default:
+            return AT_FREE;
+    }
+}
+#endif
+
 void gc_info(gc_info_t *info) {
     GC_ENTER();
     info->total = 0;
@@ -696,9 +1354,21 @@ void gc_info(gc_info_t *info) {
     for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
         bool finish = false;
         info->total += area->gc_pool_end - area->gc_pool_start;
+        #if MICROPY_GC_LAZY_SWEEP
+        size_t unswept = (size_t)-1;
+        if (area == MP_STATE_MEM(gc_sweep_area)) {
+            unswept = MP_STATE_MEM(gc_sweep_block);
+        } else if (gc_sweep_lazy_pending(area, 0)) {
+            unswept = 0;
+        }
+        bool garbage = false;
+        #define GC_INFO_GET_KIND(area, block) gc_info_get_kind(area, block, unswept, &garbage)
+        #else
+        #define GC_INFO_GET_KIND(area, block) ATB_GET_KIND(area, block)
+        #endif
         for (size_t block = 0, len = 0, len_free = 0; !finish;) {
             MICROPY_GC_HOOK_LOOP(block);
-            size_t kind = ATB_GET_KIND(area, block);
+            size_t kind = GC_INFO_GET_KIND(area, block);
             switch (kind) {
                 case AT_FREE:
                     info->free += 1;
@@ -706,6 +1376,9 @@ void gc_info(gc_info_t *info) {
                     len = 0;
                     break;
 
+                #if MICROPY_GC_INCREMENTAL
+                case AT_MARK: // an incremental collection is in progress
+                #endif
                 case AT_HEAD:
                     info->used += 1;
                     len = 1;
@@ -716,19 +1389,21 @@ void gc_info(gc_info_t *info) {
                     len += 1;
                     break;
 
+                #if !MICROPY_GC_INCREMENTAL
                 case AT_MARK:
                     // shouldn't happen
                     break;
+                #endif
             }
 
             block++;
             finish = (block == area->gc_alloc_table_byte_len * BLOCKS_PER_ATB);
             // Get next block type if possible
             if (!finish) {
-                kind = ATB_GET_KIND(area, block);
+                kind = GC_INFO_GET_KIND(area, block);
             }
 
-            if (finish || kind == AT_FREE || kind == AT_HEAD) {
+            if (finish || kind != AT_TAIL) {
                 if (len == 1) {
                     info->num_1block += 1;
                 } else if (len == 2) {
@@ -737,7 +1412,7 @@ void gc_info(gc_info_t *info) {
                 if (len > info->max_block) {
                     info->max_block = len;
                 }
-                if (finish || kind == AT_HEAD) {
+                if (finish || kind != AT_FREE) {
                     if (len_free > info->max_free) {
                         info->max_free = len_free;
                     }
@@ -745,6 +1420,7 @@ void gc_info(gc_info_t *info) {
                 }
             }
         }
+        #undef GC_INFO_GET_KIND
     }
 
     info->used *= BYTES_PER_BLOCK;
@@ -772,6 +1448,13 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
         return NULL;
     }
 
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_alloc) >= MP_STATE_MEM(gc_inc_next)
+        && MP_STATE_MEM(gc_inc_budget_us) != 0 && MP_STATE_MEM(gc_auto_collect_enabled)) {
+        gc_inc_step(MP_STATE_MEM(gc_inc_budget_us));
+    }
+    #endif
+
     GC_ENTER();
 
     mp_state_mem_area_t *area;
@@ -779,15 +1462,19 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     size_t end_block;
     size_t start_block;
     size_t n_free;
+    size_t size_class = MIN(n_blocks, MICROPY_GC_ALLOC_SIZE_CLASSES) - 1;
     int collected = !MP_STATE_MEM(gc_auto_collect_enabled);
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     bool added = false;
     #endif
+    #if MICROPY_GC_LAZY_SWEEP
+    size_t sweep_blocks = MICROPY_GC_LAZY_SWEEP_BLOCKS;
+    #endif
 
     #if MICROPY_GC_ALLOC_THRESHOLD
     if (!collected && MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
         GC_EXIT();
-        gc_collect();
+        gc_collect_for_alloc();
         collected = 1;
         GC_ENTER();
     }
@@ -803,8 +1490,16 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
 
         // look for a run of n_blocks available blocks
         for (; area != NULL; area = NEXT_AREA(area), i = 0) {
+            #if MICROPY_GC_LAZY_SWEEP
+            size_t atb_end = gc_sweep_lazy_alloc_end(area);
+            #else
+            size_t atb_end = area->gc_alloc_table_byte_len;
+            #endif
             n_free = 0;
-            for (i = area->gc_last_free_atb_index; i < area->gc_alloc_table_byte_len; i++) {
+            // No free block comes before the index of single blocks, and no
+            // run long enough comes before the index of this size.
+            i = MAX(area->gc_last_free_atb_index[0], area->gc_last_free_atb_index[size_class]);
+            for (; i < atb_end; i++) {
                 MICROPY_GC_HOOK_LOOP(i);
                 byte a = area->gc_alloc_table_start[i];
                 // *FORMAT-OFF*
@@ -818,13 +1513,22 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
             // No free blocks found on this heap. Mark this heap as
             // filled, so we won't try to find free space here again until
             // space is freed.
-            #if MICROPY_GC_SPLIT_HEAP
-            if (n_blocks == 1) {
-                area->gc_last_free_atb_index = (i + 1) / BLOCKS_PER_ATB; // or (size_t)-1
+            if (n_blocks <= MICROPY_GC_ALLOC_SIZE_CLASSES && atb_end == area->gc_alloc_table_byte_len) {
+                area->gc_last_free_atb_index[size_class] = i;
             }
-            #endif
         }
 
+        #if MICROPY_GC_LAZY_SWEEP
+        if (MP_STATE_MEM(gc_sweep_area) != NULL) {
+            // Free more of the garbage of the last collection and look
+            // again, sweeping twice as much each time so that a heap with
+            // little garbage isn't scanned over and over.
+            gc_sweep_lazy_step(sweep_blocks);
+            sweep_blocks *= 2;
+            continue;
+        }
+        #endif
+
         GC_EXIT();
         // nothing found!
         if (collected) {
@@ -837,8 +1541,14 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
             return NULL;
         }
         DEBUG_printf("gc_alloc(" UINT_FMT "): no free mem, triggering GC\n", n_bytes);
-        gc_collect();
+        #if MICROPY_GC_INCREMENTAL
+        // Finishing an incremental collection keeps everything that became
+        // garbage while it ran, so if that's not enough do a full one.
+        collected = MP_STATE_MEM(gc_inc_phase) == GC_INC_IDLE;
+        #else
         collected = 1;
+        #endif
+        gc_collect_for_alloc();
         GC_ENTER();
     }
 
@@ -848,22 +1558,33 @@ found:
     end_block = i;
     start_block = i - n_free + 1;
 
-    // Set last free ATB index to block after last block we found, for start of
-    // next scan.  To reduce fragmentation, we only do this if we were looking
-    // for a single free block, which guarantees that there are no free blocks
-    // before this one.  Also, whenever we free or shink a block we must check
-    // if this index needs adjusting (see gc_realloc and gc_free).
+    // Set last free ATB index of this size to block after last block we found,
+    // for start of next scan.  This was the first run that was long enough, so
+    // there is no other one before it, and the blocks are still allocated in
+    // the same places as scanning from the start would give.  Larger
+    // allocations can't tell that they found the first run of their size, so
+    // they don't set an index.  Whenever we free or shink a block we must
+    // check if the indices need adjusting (see gc_realloc and gc_free).
+    if (n_free <= MICROPY_GC_ALLOC_SIZE_CLASSES) {
+        area->gc_last_free_atb_index[size_class] = (i + 1) / BLOCKS_PER_ATB;
+    }
+    #if MICROPY_GC_SPLIT_HEAP
     if (n_free == 1) {
-        #if MICROPY_GC_SPLIT_HEAP
+        // there are no free blocks in the areas before this one
         MP_STATE_MEM(gc_last_free_area) = area;
-        #endif
-        area->gc_last_free_atb_index = (i + 1) / BLOCKS_PER_ATB;
     }
+    #endif
 
     area->gc_last_used_block = MAX(area->gc_last_used_block, end_block);
 
     // mark first block as used head
     ATB_FREE_TO_HEAD(area, start_block);
+    #if MICROPY_GC_LAZY_SWEEP
+    if (gc_sweep_lazy_pending(area, start_block)) {
+        // the sweep would take an unmarked head for garbage
+        ATB_HEAD_TO_MARK(area, start_block);
+    }
+    #endif
 
     // mark rest of blocks as used tail
     // TODO for a run of many blocks can make this more efficient
@@ -880,6 +1601,10 @@ found:
     MP_STATE_MEM(gc_alloc_amount) += n_blocks;
     #endif
 
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_inc_alloc) += n_blocks;
+    #endif
+
     GC_EXIT();
 
     #if MICROPY_GC_CONSERVATIVE_CLEAR
@@ -914,6 +1639,125 @@ found:
     return ret_ptr;
 }
 
+#if MICROPY_FLOAT_FREELIST
+// Allocate the free blocks from ATB i up to atb_end for floats, until there
+// are MICROPY_FLOAT_FREELIST of them.  Returns the ATB it stopped at.
+static size_t gc_float_free_take(mp_state_mem_area_t *area, size_t i, size_t atb_end) {
+    size_t n = MP_STATE_MEM(gc_float_free_len);
+    for (; i < atb_end; i++) {
+        MICROPY_GC_HOOK_LOOP(i);
+        byte a = area->gc_alloc_table_start[i];
+        if (((a | a >> 1) & 0x55) == 0x55) {
+            // no free block in this ATB
+            continue;
+        }
+        for (size_t block = i * BLOCKS_PER_ATB; block < (i + 1) * BLOCKS_PER_ATB; block++) {
+            if (ATB_GET_KIND(area, block) == AT_FREE) {
+                ATB_FREE_TO_HEAD(area, block);
+                area->gc_last_used_block = MAX(area->gc_last_used_block, block);
+                MP_STATE_MEM(gc_float_free)[n++] = (void *)PTR_FROM_BLOCK(area, block);
+                if (n == MICROPY_FLOAT_FREELIST) {
+                    // there may be more free blocks in this ATB
+                    MP_STATE_MEM(gc_float_free_len) = n;
+                    return i;
+                }
+            }
+        }
+    }
+    MP_STATE_MEM(gc_float_free_len) = n;
+    return i;
+}
+
+// Allocate up to MICROPY_FLOAT_FREELIST single blocks for floats in one pass
+// over the ATB.  The pass carries on from where the last one stopped, rather
+// than from the first free block like gc_alloc, so that a hole that other
+// allocations keep freeing and taking again (the state of a function call,
+// for example) doesn't make it go over the same used blocks each time.
+// Anything out of the ordinary (a collection or sweep due or in progress)
+// is left to gc_alloc by allocating nothing.
+static void gc_float_free_refill(void) {
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    if (MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
+        return;
+    }
+    #endif
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_phase) != GC_INC_IDLE || MP_STATE_MEM(gc_inc_alloc) >= MP_STATE_MEM(gc_inc_next)) {
+        return;
+    }
+    #endif
+    #if MICROPY_GC_LAZY_SWEEP && MICROPY_ENABLE_FINALISER
+    if (MP_STATE_MEM(gc_finaliser_area) != NULL) {
+        return;
+    }
+    #endif
+
+    #if MICROPY_GC_SPLIT_HEAP
+    mp_state_mem_area_t *area = MP_STATE_MEM(gc_last_free_area);
+    #else
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    #endif
+    for (; area != NULL; area = NEXT_AREA(area)) {
+        #if MICROPY_GC_LAZY_SWEEP
+        size_t atb_end = gc_sweep_lazy_alloc_end(area);
+        #else
+        size_t atb_end = area->gc_alloc_table_byte_len;
+        #endif
+        size_t first = area->gc_last_free_atb_index[0];
+        size_t start = MAX(first, area->gc_float_free_atb_index);
+        size_t i = gc_float_free_take(area, start, atb_end);
+        if (start == first) {
+            // all free blocks before ATB i are allocated now
+            area->gc_last_free_atb_index[0] = i;
+        } else if (MP_STATE_MEM(gc_float_free_len) < MICROPY_FLOAT_FREELIST) {
+            // go round to the free blocks before
+            i = gc_float_free_take(area, first, MIN(start, atb_end));
+            area->gc_last_free_atb_index[0] = i;
+        }
+        area->gc_float_free_atb_index = i;
+        if (MP_STATE_MEM(gc_float_free_len) == MICROPY_FLOAT_FREELIST) {
+            #if MICROPY_GC_SPLIT_HEAP
+            MP_STATE_MEM(gc_last_free_area) = area;
+            #endif
+            break;
+        }
+    }
+
+    size_t n = MP_STATE_MEM(gc_float_free_len);
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    MP_STATE_MEM(gc_alloc_amount) += n;
+    #endif
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_inc_alloc) += n;
+    #endif
+
+    // taken from the end, so put the first block there
+    for (size_t j = 0; j < n / 2; j++) {
+        void *ptr = MP_STATE_MEM(gc_float_free)[j];
+        MP_STATE_MEM(gc_float_free)[j] = MP_STATE_MEM(gc_float_free)[n - 1 - j];
+        MP_STATE_MEM(gc_float_free)[n - 1 - j] = ptr;
+    }
+}
+
+void *gc_alloc_float_block(void) {
+    if (MP_STATE_THREAD(gc_lock_depth) > 0) {
+        return NULL;
+    }
+    void *ptr = NULL;
+    GC_ENTER();
+    if (MP_STATE_MEM(gc_float_free_len) == 0) {
+        gc_float_free_refill();
+    }
+    if (MP_STATE_MEM(gc_float_free_len) > 0) {
+        ptr = MP_STATE_MEM(gc_float_free)[--MP_STATE_MEM(gc_float_free_len)];
+        // the dead object may hold pointers to the heap (see gc_alloc)
+        memset(ptr, 0, BYTES_PER_BLOCK);
+    }
+    GC_EXIT();
+    return ptr;
+}
+#endif
+
 // force the freeing of a piece of memory
 // TODO: freeing here does not call finaliser
 void gc_free(void *ptr) {
@@ -948,8 +1792,23 @@ void gc_free(void *ptr) {
     #endif
 
     size_t block = BLOCK_FROM_PTR(area, ptr);
+    #if MICROPY_GC_INCREMENTAL && MICROPY_GC_LAZY_SWEEP
+    assert(ATB_GET_KIND(area, block) == AT_HEAD
+        || (ATB_GET_KIND(area, block) == AT_MARK && ((MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG) || MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK || gc_sweep_lazy_pending(area, block))));
+    #elif MICROPY_GC_INCREMENTAL
+    // The block may have been marked by an incremental collection; if it's
+    // still on the mark stack then it's traced as a free block, which is
+    // harmless.
+    assert(ATB_GET_KIND(area, block) == AT_HEAD
+        || (ATB_GET_KIND(area, block) == AT_MARK && ((MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG) || MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK)));
+    #elif MICROPY_GC_LAZY_SWEEP
+    // The block is marked if the sweep hasn't got to it yet.
+    assert(ATB_GET_KIND(area, block) == AT_HEAD
+        || (ATB_GET_KIND(area, block) == AT_MARK && ((MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG) || gc_sweep_lazy_pending(area, block))));
+    #else
     assert(ATB_GET_KIND(area, block) == AT_HEAD
         || (ATB_GET_KIND(area, block) == AT_MARK && (MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG)));
+    #endif
 
     #if MICROPY_ENABLE_FINALISER
     FTB_CLEAR(area, block);
@@ -970,10 +1829,8 @@ void gc_free(void *ptr) {
     }
     #endif
 
-    // set the last_free pointer to this block if it's earlier in the heap
-    if (block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
-        area->gc_last_free_atb_index = block / BLOCKS_PER_ATB;
-    }
+    // set the last_free pointers to this block if it's earlier in the heap
+    gc_lower_last_free_atb_index(area, block);
 
     // free head and all of its tail blocks
     do {
@@ -1004,7 +1861,11 @@ size_t gc_nbytes(const void *ptr) {
 
     if (area) {
         size_t block = BLOCK_FROM_PTR(area, ptr);
-        if (ATB_GET_KIND(area, block) == AT_HEAD) {
+        if (ATB_GET_KIND(area, block) == AT_HEAD
+            #if MICROPY_GC_INCREMENTAL || MICROPY_GC_LAZY_SWEEP
+            || ATB_GET_KIND(area, block) == AT_MARK
+            #endif
+            ) {
             // work out number of consecutive blocks in the chain starting with this on
             size_t n_blocks = 0;
             do {
@@ -1050,7 +1911,11 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     area = &MP_STATE_MEM(area);
     #endif
     size_t block = BLOCK_FROM_PTR(area, ptr);
+    #if MICROPY_GC_INCREMENTAL || MICROPY_GC_LAZY_SWEEP
+    assert(ATB_GET_KIND(area, block) == AT_HEAD || ATB_GET_KIND(area, block) == AT_MARK);
+    #else
     assert(ATB_GET_KIND(area, block) == AT_HEAD);
+    #endif
 
     // compute number of new blocks that are requested
     size_t new_blocks = (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
@@ -1101,10 +1966,8 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
         }
         #endif
 
-        // set the last_free pointer to end of this block if it's earlier in the heap
-        if ((block + new_blocks) / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
-            area->gc_last_free_atb_index = (block + new_blocks) / BLOCKS_PER_ATB;
-        }
+        // set the last_free pointers to end of this block if it's earlier in the heap
+        gc_lower_last_free_atb_index(area, block + new_blocks);
 
         GC_EXIT();
 
@@ -1166,6 +2029,14 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
 
     DEBUG_printf("gc_realloc(%p -> %p)\n", ptr_in, ptr_out);
     memcpy(ptr_out, ptr_in, n_blocks * BYTES_PER_BLOCK);
+    #if MICROPY_GC_INCREMENTAL
+    // The owner of the memory doesn't use a write barrier when it replaces
+    // the old pointer, so if the old chunk was marked then mark the new one,
+    // and trace it as the old one may have been traced already.
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK && ATB_GET_KIND(area, block) == AT_MARK) {
+        gc_write_barrier(ptr_out);
+    }
+    #endif
     gc_free(ptr_in);
     return ptr_out;
 }
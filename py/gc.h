@@ -58,6 +58,34 @@ void gc_collect_end(void);
 // Use this function to sweep the whole heap and run all finalisers
 void gc_sweep_all(void);
 
+#if MICROPY_GC_INCREMENTAL
+// Give the incremental collector up to idle_us microseconds of idle time.
+void gc_incremental_idle(mp_uint_t idle_us);
+
+// Write barriers, needed while an incremental collection is marking.  After
+// storing a heap pointer into a heap object use MP_GC_WRITE_BARRIER on the
+// stored object.  After changing many pointers of an object at once (with
+// memcpy and friends) use MP_GC_WRITE_BARRIER_RESCAN on the object itself,
+// which keeps it and traces it (again).
+void gc_write_barrier(const void *ptr);
+void gc_write_barrier_rescan(const void *ptr);
+#define MP_GC_WRITE_BARRIER(obj) \
+    do { \
+        if (MP_STATE_MEM(gc_inc_phase)) { \
+            gc_write_barrier(MP_OBJ_TO_PTR(obj)); \
+        } \
+    } while (0)
+#define MP_GC_WRITE_BARRIER_RESCAN(ptr) \
+    do { \
+        if (MP_STATE_MEM(gc_inc_phase)) { \
+            gc_write_barrier_rescan(ptr); \
+        } \
+    } while (0)
+#else
+#define MP_GC_WRITE_BARRIER(obj) (void)0
+#define MP_GC_WRITE_BARRIER_RESCAN(ptr) (void)0
+#endif
+
 enum {
     GC_ALLOC_FLAG_HAS_FINALISER = 1,
 };
@@ -67,6 +95,11 @@ void gc_free(void *ptr); // does not call finaliser
 size_t gc_nbytes(const void *ptr);
 void *gc_realloc(void *ptr, size_t n_bytes, bool allow_move);
 
+#if MICROPY_FLOAT_FREELIST
+// Allocate a single block for a float, or return NULL to use gc_alloc.
+void *gc_alloc_float_block(void);
+#endif
+
 typedef struct _gc_info_t {
     size_t total;
     size_t used;
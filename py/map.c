@@ -31,6 +31,7 @@
 
 #include "py/mpconfig.h"
 #include "py/misc.h"
+#include "py/gc.h"
 #include "py/runtime.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -61,6 +62,84 @@
 #define MAP_CACHE_SET(index, pos)
 #endif
 
+#if MICROPY_OPT_MAP_ROM_INDEX
+// Constant maps get an index (see mp_map_rom_index_t) the first time they are
+// searched.  Indexes are kept in a direct-mapped cache in the VM state, looked
+// up by table address, so searching never allocates.
+
+#define MAP_ROM_INDEX_ENTRY(table) (&MP_STATE_VM(map_rom_index)[((uintptr_t)(table) >> 3) % MICROPY_OPT_MAP_ROM_INDEX_SIZE])
+
+// How many times in a row another map must want a cache entry to take it over.
+// This stops two maps that share an entry from rebuilding their indexes on
+// every lookup, instead one keeps the entry and the other is searched linearly.
+#define MAP_ROM_INDEX_EVICT_CONFLICTS (16)
+
+#if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+// Without the GIL other threads may search an index while one is built, so
+// builds are serialised, an index is published by setting its table last, and
+// an entry is never reused once it holds an index.
+#define MAP_ROM_INDEX_GET_TABLE(index) __atomic_load_n(&(index)->table, __ATOMIC_ACQUIRE)
+#define MAP_ROM_INDEX_SET_TABLE(index, t) __atomic_store_n(&(index)->table, (t), __ATOMIC_RELEASE)
+#define MAP_ROM_INDEX_ENTER() mp_thread_mutex_lock(&MP_STATE_VM(map_rom_index_mutex), 1)
+#define MAP_ROM_INDEX_EXIT() mp_thread_mutex_unlock(&MP_STATE_VM(map_rom_index_mutex))
+#define MAP_ROM_INDEX_CAN_EVICT (0)
+#else
+#define MAP_ROM_INDEX_GET_TABLE(index) ((index)->table)
+#define MAP_ROM_INDEX_SET_TABLE(index, t) ((index)->table = (t))
+#define MAP_ROM_INDEX_ENTER()
+#define MAP_ROM_INDEX_EXIT()
+#define MAP_ROM_INDEX_CAN_EVICT (1)
+#endif
+
+static inline size_t map_rom_index_hash(mp_obj_t key) {
+    // Keys that aren't qstrs never match a qstr, so any hash will do for them.
+    return mp_obj_is_qstr(key) ? MP_OBJ_QSTR_VALUE(key) : (uintptr_t)key >> 2;
+}
+
+static void map_rom_index_build(mp_map_rom_index_t *index, const mp_map_t *map) {
+    size_t n_slots = 1;
+    while (n_slots < 2 * map->used) {
+        n_slots <<= 1;
+    }
+    index->mask = n_slots - 1;
+    index->conflicts = 0;
+    memset(index->slots, 0, n_slots);
+    for (size_t pos = 0; pos < map->used; pos++) {
+        size_t slot = map_rom_index_hash(map->table[pos].key) & index->mask;
+        while (index->slots[slot] != 0) {
+            slot = (slot + 1) & index->mask;
+        }
+        index->slots[slot] = pos + 1;
+    }
+    MAP_ROM_INDEX_SET_TABLE(index, map->table);
+}
+
+// Returns the index for the given constant map, or NULL if it doesn't have one
+// and can't have one now.
+static mp_map_rom_index_t *map_rom_index_get(const mp_map_t *map) {
+    mp_map_rom_index_t *index = MAP_ROM_INDEX_ENTRY(map->table);
+    const mp_map_elem_t *table = MAP_ROM_INDEX_GET_TABLE(index);
+    if (table == map->table) {
+        index->conflicts = 0;
+        return index;
+    }
+    if (table != NULL && (!MAP_ROM_INDEX_CAN_EVICT || ++index->conflicts < MAP_ROM_INDEX_EVICT_CONFLICTS)) {
+        return NULL;
+    }
+    // Don't build while the heap is locked: that's where hard interrupt
+    // handlers run, and they may have interrupted a search of this entry.
+    if (gc_is_locked()) {
+        return NULL;
+    }
+    MAP_ROM_INDEX_ENTER();
+    if (MAP_ROM_INDEX_CAN_EVICT || index->table == NULL) {
+        map_rom_index_build(index, map);
+    }
+    MAP_ROM_INDEX_EXIT();
+    return index->table == map->table ? index : NULL;
+}
+#endif
+
 // This table of sizes is used to control the growth of hash tables.
 // The first set of sizes are chosen so the allocation fits exactly in a
 // 4-word GC block, and it's not so important for these small values to be
@@ -83,6 +162,72 @@ static size_t get_hash_alloc_greater_or_equal_to(size_t x) {
     return (x + x / 2) | 1;
 }
 
+#if MICROPY_OPT_MAP_COMPACT
+// A hash map (one that is not ordered) keeps its entries densely in insertion
+// order at the start of its table, with the unused entries after them having
+// a NULL key.  Removing an entry sets its key to MP_OBJ_SENTINEL so positions
+// don't change until the next rehash, which drops the removed entries.
+//
+// Small tables are searched linearly.  Larger ones are followed by the number
+// of filled entries (including removed ones) and a hash index into them:
+//     mp_map_elem_t entries[alloc];
+//     size_t filled;
+//     uintN_t index[MAP_INDEX_LEN(alloc)];
+// where each index slot is 0 if empty, else the position of its entry plus 1,
+// and N is 8, 16 or 32 depending on alloc.
+#define MAP_LINEAR_MAX (8)
+#define MAP_IS_INDEXED(alloc) ((alloc) > MAP_LINEAR_MAX)
+#define MAP_INDEX_LEN(alloc) ((alloc) + (alloc) / 2 + 1)
+#define MAP_INDEX_WIDTH(alloc) ((alloc) < 0xff ? 1 : (alloc) < 0xffff ? 2 : 4)
+#define MAP_FILLED(map) (*(size_t *)&(map)->table[(map)->alloc])
+#define MAP_INDEX(map) ((void *)(&MAP_FILLED(map) + 1))
+
+static size_t map_table_bytes(size_t alloc) {
+    size_t n = alloc * sizeof(mp_map_elem_t);
+    if (MAP_IS_INDEXED(alloc)) {
+        n += sizeof(size_t) + MAP_INDEX_LEN(alloc) * MAP_INDEX_WIDTH(alloc);
+    }
+    return n;
+}
+
+static inline size_t map_index_get(const mp_map_t *map, size_t slot) {
+    size_t width = MAP_INDEX_WIDTH(map->alloc);
+    if (width == 1) {
+        return ((uint8_t *)MAP_INDEX(map))[slot];
+    } else if (width == 2) {
+        return ((uint16_t *)MAP_INDEX(map))[slot];
+    } else {
+        return ((uint32_t *)MAP_INDEX(map))[slot];
+    }
+}
+
+static inline void map_index_set(mp_map_t *map, size_t slot, size_t value) {
+    size_t width = MAP_INDEX_WIDTH(map->alloc);
+    if (width == 1) {
+        ((uint8_t *)MAP_INDEX(map))[slot] = value;
+    } else if (width == 2) {
+        ((uint16_t *)MAP_INDEX(map))[slot] = value;
+    } else {
+        ((uint32_t *)MAP_INDEX(map))[slot] = value;
+    }
+}
+
+static inline mp_uint_t map_hash(mp_obj_t index) {
+    // fast path for common case of qstr
+    if (mp_obj_is_qstr(index)) {
+        return qstr_hash(MP_OBJ_QSTR_VALUE(index));
+    } else {
+        return MP_OBJ_SMALL_INT_VALUE(mp_unary_op(MP_UNARY_OP_HASH, index));
+    }
+}
+
+#define MAP_TABLE_NEW(alloc) ((mp_map_elem_t *)m_malloc0(map_table_bytes(alloc)))
+#define MAP_TABLE_DEL(map) m_del(uint8_t, (map)->table, mp_map_table_bytes(map))
+#else
+#define MAP_TABLE_NEW(alloc) m_new0(mp_map_elem_t, (alloc))
+#define MAP_TABLE_DEL(map) m_del(mp_map_elem_t, (map)->table, (map)->alloc)
+#endif
+
 /******************************************************************************/
 /* map                                                                        */
 
@@ -92,12 +237,13 @@ void mp_map_init(mp_map_t *map, size_t n) {
         map->table = NULL;
     } else {
         map->alloc = n;
-        map->table = m_new0(mp_map_elem_t, map->alloc);
+        map->table = MAP_TABLE_NEW(n);
     }
     map->used = 0;
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 0;
     map->is_ordered = 0;
+    map->is_rom = 0;
 }
 
 void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
@@ -106,20 +252,21 @@ void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 1;
     map->is_ordered = 1;
+    map->is_rom = 0;
     map->table = (mp_map_elem_t *)table;
 }
 
 // Differentiate from mp_map_clear() - semantics is different
 void mp_map_deinit(mp_map_t *map) {
     if (!map->is_fixed) {
-        m_del(mp_map_elem_t, map->table, map->alloc);
+        MAP_TABLE_DEL(map);
     }
     map->used = map->alloc = 0;
 }
 
 void mp_map_clear(mp_map_t *map) {
     if (!map->is_fixed) {
-        m_del(mp_map_elem_t, map->table, map->alloc);
+        MAP_TABLE_DEL(map);
     }
     map->alloc = 0;
     map->used = 0;
@@ -128,6 +275,170 @@ void mp_map_clear(mp_map_t *map) {
     map->table = NULL;
 }
 
+size_t mp_map_table_bytes(const mp_map_t *map) {
+    #if MICROPY_OPT_MAP_COMPACT
+    if (!map->is_ordered) {
+        return map_table_bytes(map->alloc);
+    }
+    #endif
+    return map->alloc * sizeof(mp_map_elem_t);
+}
+
+#if MICROPY_OPT_MAP_COMPACT
+static void mp_map_rehash(mp_map_t *map) {
+    // Grow the table unless enough entries were removed to leave some room.
+    size_t old_alloc = map->alloc;
+    size_t new_alloc = get_hash_alloc_greater_or_equal_to(map->used + map->used / 8 + 1);
+    DEBUG_printf("mp_map_rehash(%p): " UINT_FMT " -> " UINT_FMT "\n", map, old_alloc, new_alloc);
+    mp_map_elem_t *old_table = map->table;
+    mp_map_elem_t *new_table = old_table;
+    size_t old_bytes = mp_map_table_bytes(map);
+    if (new_alloc > old_alloc) {
+        new_table = m_malloc_maybe(map_table_bytes(new_alloc));
+        if (new_table != NULL) {
+            memset(new_table, 0, map_table_bytes(new_alloc));
+        } else if (map->used < old_alloc) {
+            // Can't grow (eg the heap is locked) but there are removed entries,
+            // so make room by dropping them instead.
+            new_table = old_table;
+        } else {
+            m_malloc_fail(map_table_bytes(new_alloc));
+        }
+    }
+    if (new_table == old_table) {
+        new_alloc = old_alloc;
+    }
+    // If we reach this point, we have the table, now we can edit the old map.
+    map->alloc = new_alloc;
+    map->all_keys_are_qstrs = 1;
+    map->table = new_table;
+    // Move the filled entries to the start of the new table, in order.
+    size_t pos = 0;
+    for (size_t i = 0; i < old_alloc; i++) {
+        mp_obj_t key = old_table[i].key;
+        if (key == MP_OBJ_NULL) {
+            break;
+        }
+        if (key != MP_OBJ_SENTINEL) {
+            new_table[pos] = old_table[i];
+            if (!mp_obj_is_qstr(key)) {
+                map->all_keys_are_qstrs = 0;
+            }
+            pos++;
+        }
+    }
+    if (new_table == old_table) {
+        // compacted in place, so clear the rest of the old entries and the index
+        memset(&new_table[pos], 0, old_bytes - pos * sizeof(mp_map_elem_t));
+    }
+    if (MAP_IS_INDEXED(new_alloc)) {
+        // The keys are all different, so each just needs an empty index slot.
+        size_t n_index = MAP_INDEX_LEN(new_alloc);
+        for (size_t i = 0; i < pos; i++) {
+            size_t slot = map_hash(new_table[i].key) % n_index;
+            while (map_index_get(map, slot) != 0) {
+                if (++slot == n_index) {
+                    slot = 0;
+                }
+            }
+            map_index_set(map, slot, i + 1);
+        }
+        MAP_FILLED(map) = pos;
+    }
+    MP_GC_WRITE_BARRIER_RESCAN(new_table);
+    if (new_table != old_table) {
+        m_del(uint8_t, old_table, old_bytes);
+    }
+}
+
+// Lookup in a hash map with the compact layout, see mp_map_lookup for the
+// behaviour of each lookup_kind.
+static mp_map_elem_t *mp_map_lookup_compact(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind, bool compare_only_ptrs) {
+    if (map->alloc == 0) {
+        if (lookup_kind == MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+            mp_map_rehash(map);
+        } else {
+            return NULL;
+        }
+    }
+
+    mp_map_elem_t *elem;
+    if (!MAP_IS_INDEXED(map->alloc)) {
+        if (!mp_obj_is_qstr(index)) {
+            // the index isn't needed to search, but it must be hashable
+            (void)map_hash(index);
+        }
+        // search the entries up to the first unused one
+        mp_map_elem_t *top = &map->table[map->alloc];
+        for (elem = &map->table[0]; elem < top && elem->key != MP_OBJ_NULL; elem++) {
+            if (elem->key != MP_OBJ_SENTINEL
+                && (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index)))) {
+                goto found;
+            }
+        }
+        if (lookup_kind != MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+            return NULL;
+        }
+        if (elem == top) {
+            // no unused entries left, so rehash and search again for a free one
+            mp_map_rehash(map);
+            return mp_map_lookup_compact(map, index, lookup_kind, compare_only_ptrs);
+        }
+    } else {
+        size_t n_index = MAP_INDEX_LEN(map->alloc);
+        size_t slot = map_hash(index) % n_index;
+        size_t avail_slot = n_index;
+        size_t entry;
+        while ((entry = map_index_get(map, slot)) != 0) {
+            elem = &map->table[entry - 1];
+            if (elem->key == MP_OBJ_SENTINEL) {
+                // slot of a removed entry, remember for later
+                if (avail_slot == n_index) {
+                    avail_slot = slot;
+                }
+            } else if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
+                goto found;
+            }
+            if (++slot == n_index) {
+                slot = 0;
+            }
+        }
+        if (lookup_kind != MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+            return NULL;
+        }
+        if (MAP_FILLED(map) == map->alloc) {
+            // no unused entries left, so rehash and search again for a free slot
+            mp_map_rehash(map);
+            return mp_map_lookup_compact(map, index, lookup_kind, compare_only_ptrs);
+        }
+        if (avail_slot == n_index) {
+            avail_slot = slot;
+        }
+        elem = &map->table[MAP_FILLED(map)++];
+        map_index_set(map, avail_slot, elem - map->table + 1);
+    }
+
+    // add the index as a new entry at the end
+    map->used++;
+    elem->key = index;
+    elem->value = MP_OBJ_NULL;
+    MP_GC_WRITE_BARRIER(index);
+    if (!mp_obj_is_qstr(index)) {
+        map->all_keys_are_qstrs = 0;
+    }
+    return elem;
+
+found:
+    // Note: CPython does not replace the index; try x={True:'true'};x[1]='one';x
+    if (lookup_kind == MP_MAP_LOOKUP_REMOVE_IF_FOUND) {
+        // mark the entry as removed, keeping elem->value so that caller can access it if needed
+        map->used--;
+        elem->key = MP_OBJ_SENTINEL;
+    }
+    MAP_CACHE_SET(index, elem - map->table);
+    return elem;
+}
+#else
 static void mp_map_rehash(mp_map_t *map) {
     size_t old_alloc = map->alloc;
     size_t new_alloc = get_hash_alloc_greater_or_equal_to(map->alloc + 1);
@@ -144,9 +455,12 @@ static void mp_map_rehash(mp_map_t *map) {
             mp_map_lookup(map, old_table[i].key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = old_table[i].value;
         }
     }
+    MP_GC_WRITE_BARRIER_RESCAN(new_table);
     m_del(mp_map_elem_t, old_table, old_alloc);
 }
 
+#endif
+
 // MP_MAP_LOOKUP behaviour:
 //  - returns NULL if not found, else the slot it was found in with key,value non-null
 // MP_MAP_LOOKUP_ADD_IF_NOT_FOUND behaviour:
@@ -190,6 +504,24 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
 
     // if the map is an ordered array then we must do a brute force linear search
     if (map->is_ordered) {
+        #if MICROPY_OPT_MAP_ROM_INDEX
+        // unless it's a large constant map searched by qstr, which can be indexed
+        if (map->is_rom && compare_only_ptrs && map->used >= MICROPY_OPT_MAP_ROM_INDEX_MIN && map->used <= MP_MAP_ROM_INDEX_SLOTS / 2) {
+            mp_map_rom_index_t *rom_index = map_rom_index_get(map);
+            if (rom_index != NULL) {
+                size_t slot = map_rom_index_hash(index) & rom_index->mask;
+                while (rom_index->slots[slot] != 0) {
+                    mp_map_elem_t *elem = &map->table[rom_index->slots[slot] - 1];
+                    if (elem->key == index) {
+                        MAP_CACHE_SET(index, elem - map->table);
+                        return elem;
+                    }
+                    slot = (slot + 1) & rom_index->mask;
+                }
+                return NULL;
+            }
+        }
+        #endif
         for (mp_map_elem_t *elem = &map->table[0], *top = &map->table[map->used]; elem < top; elem++) {
             if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
                 #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
@@ -218,10 +550,12 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
             map->alloc += 4;
             map->table = m_renew(mp_map_elem_t, map->table, map->used, map->alloc);
             mp_seq_clear(map->table, map->used, map->alloc, sizeof(*map->table));
+            MP_GC_WRITE_BARRIER(map->table);
         }
         mp_map_elem_t *elem = map->table + map->used++;
         elem->key = index;
         elem->value = MP_OBJ_NULL;
+        MP_GC_WRITE_BARRIER(index);
         if (!mp_obj_is_qstr(index)) {
             map->all_keys_are_qstrs = 0;
         }
@@ -233,6 +567,9 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
 
     // map is a hash table (not an ordered array), so do a hash lookup
 
+    #if MICROPY_OPT_MAP_COMPACT
+    return mp_map_lookup_compact(map, index, lookup_kind, compare_only_ptrs);
+    #else
     if (map->alloc == 0) {
         if (lookup_kind == MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
             mp_map_rehash(map);
@@ -263,6 +600,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                 }
                 avail_slot->key = index;
                 avail_slot->value = MP_OBJ_NULL;
+                MP_GC_WRITE_BARRIER(index);
                 if (!mp_obj_is_qstr(index)) {
                     map->all_keys_are_qstrs = 0;
                 }
@@ -304,6 +642,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                     map->used++;
                     avail_slot->key = index;
                     avail_slot->value = MP_OBJ_NULL;
+                    MP_GC_WRITE_BARRIER(index);
                     if (!mp_obj_is_qstr(index)) {
                         map->all_keys_are_qstrs = 0;
                     }
@@ -319,6 +658,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
             }
         }
     }
+    #endif
 }
 
 /******************************************************************************/
@@ -343,6 +683,7 @@ static void mp_set_rehash(mp_set_t *set) {
             mp_set_lookup(set, old_table[i], MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
         }
     }
+    MP_GC_WRITE_BARRIER_RESCAN(set->table);
     m_del(mp_obj_t, old_table, old_alloc);
 }
 
@@ -371,6 +712,7 @@ mp_obj_t mp_set_lookup(mp_set_t *set, mp_obj_t index, mp_map_lookup_kind_t looku
                 }
                 set->used++;
                 *avail_slot = index;
+                MP_GC_WRITE_BARRIER(index);
                 return index;
             } else {
                 return MP_OBJ_NULL;
@@ -405,6 +747,7 @@ mp_obj_t mp_set_lookup(mp_set_t *set, mp_obj_t index, mp_map_lookup_kind_t looku
                     // there was an available slot, so use that
                     set->used++;
                     *avail_slot = index;
+                    MP_GC_WRITE_BARRIER(index);
                     return index;
                 } else {
                     // not enough room in table, rehash it
@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <assert.h>
 
+#include "py/gc.h"
 #include "py/smallint.h"
 #include "py/objint.h"
 #include "py/objstr.h"
@@ -82,6 +83,7 @@ static mp_obj_t mp_builtin___build_class__(size_t n_args, const mp_obj_t *args)
     // store into cell if needed
     if (cell != mp_const_none) {
         mp_obj_cell_set(cell, new_class);
+        MP_GC_WRITE_BARRIER(new_class);
     }
 
     return new_class;
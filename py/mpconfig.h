@@ -299,6 +299,12 @@
 #endif
 #endif
 
+// Whether dynamically allocated qstr pools have a hash index, so that looking
+// up a string doesn't compare it with every qstr created at runtime
+#ifndef MICROPY_QSTR_POOL_INDEX
+#define MICROPY_QSTR_POOL_INDEX (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 // Avoid using C stack when making Python function calls. C stack still
 // may be used if there's no free heap.
 #ifndef MICROPY_STACKLESS
@@ -411,6 +417,12 @@
 #define MICROPY_EMIT_INLINE_XTENSA_UNCOMMON_OPCODES (0)
 #endif
 
+// Whether to enable float support in the Xtensa inline assembler (only
+// available when the target has the single-precision FPU option)
+#ifndef MICROPY_EMIT_INLINE_XTENSA_FLOAT
+#define MICROPY_EMIT_INLINE_XTENSA_FLOAT (1)
+#endif
+
 // Whether to emit Xtensa-Windowed native code
 #ifndef MICROPY_EMIT_XTENSAWIN
 #define MICROPY_EMIT_XTENSAWIN (0)
@@ -580,6 +592,49 @@
 #define MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE (128)
 #endif
 
+// Store the entries of hash maps (dicts, instance members, module globals) in
+// insertion order, with a separate hash index of 8, 16 or 32-bit positions for
+// tables of more than 8 entries.  Lookups that miss stay short however full
+// the table is, and iteration and rehashing only touch the filled entries.
+// The index uses about 1.5 bytes per entry of RAM in tables up to 254 entries.
+#ifndef MICROPY_OPT_MAP_COMPACT
+#define MICROPY_OPT_MAP_COMPACT (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Use extra RAM to index large constant maps (module globals and type locals
+// defined with MP_DEFINE_CONST_DICT) by qstr the first time they are searched,
+// so lookups in them, including failed ones, don't need a linear search.  The
+// indexes are kept in a small direct-mapped cache in the VM state, taking
+// about 264 bytes each, and a map that can't get one (eg it has more than 128
+// entries, or the heap is locked) is searched linearly as before.
+#ifndef MICROPY_OPT_MAP_ROM_INDEX
+#define MICROPY_OPT_MAP_ROM_INDEX (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Number of constant map indexes to keep at once.
+#ifndef MICROPY_OPT_MAP_ROM_INDEX_SIZE
+#define MICROPY_OPT_MAP_ROM_INDEX_SIZE (8)
+#endif
+
+// Constant maps with fewer entries than this are always searched linearly.
+#ifndef MICROPY_OPT_MAP_ROM_INDEX_MIN
+#define MICROPY_OPT_MAP_ROM_INDEX_MIN (16)
+#endif
+
+// Use extra RAM to remember, for each LOAD_ATTR and STORE_ATTR in bytecode,
+// where the attribute was last found in an instance's members map.  Skips
+// the map lookup for instance attributes, and the attribute store machinery
+// for instances of classes without properties, descriptors or __setattr__.
+// Loads need MICROPY_OPT_LOAD_ATTR_FAST_PATH.
+#ifndef MICROPY_OPT_ATTR_SITE_CACHE
+#define MICROPY_OPT_ATTR_SITE_CACHE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// How much RAM (in bytes) to use for the attribute site cache.
+#ifndef MICROPY_OPT_ATTR_SITE_CACHE_SIZE
+#define MICROPY_OPT_ATTR_SITE_CACHE_SIZE (128)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
@@ -666,6 +721,65 @@
 #define MICROPY_GC_HOOK_LOOP(i)
 #endif
 
+// Number of allocation sizes, from 1 block up to this many, that each keep
+// their own position to resume looking for free blocks from, so that small
+// allocations don't rescan the full part of the heap every time
+#ifndef MICROPY_GC_ALLOC_SIZE_CLASSES
+#define MICROPY_GC_ALLOC_SIZE_CLASSES (4)
+#endif
+
+// Whether the garbage collector can mark the heap in short steps interleaved
+// with the program, so that only the end of a collection stops the world.
+// Needs the port to provide mp_hal_ticks_us() and, if threads are enabled,
+// the GIL.  Code that stores a heap pointer into a heap object other than
+// through the core object types must use MP_GC_WRITE_BARRIER, see py/gc.h.
+#ifndef MICROPY_GC_INCREMENTAL
+#define MICROPY_GC_INCREMENTAL (0)
+#endif
+
+// Initial time limit of each incremental step, in microseconds; 0 starts
+// with incremental collection turned off (see gc.incremental()).
+#ifndef MICROPY_GC_INCREMENTAL_BUDGET_US
+#define MICROPY_GC_INCREMENTAL_BUDGET_US (1000)
+#endif
+
+// Number of bytes to allocate between incremental steps
+#ifndef MICROPY_GC_INCREMENTAL_STEP_BYTES
+#define MICROPY_GC_INCREMENTAL_STEP_BYTES (1024)
+#endif
+
+// An incremental collection starts once this percentage of the memory that
+// was free after the previous collection has been allocated
+#ifndef MICROPY_GC_INCREMENTAL_START_PERCENT
+#define MICROPY_GC_INCREMENTAL_START_PERCENT (50)
+#endif
+
+// Whether to check at the end of each incremental collection that no marked
+// object points to an unmarked one, reporting stores that missed the write
+// barrier (slow, for debugging)
+#ifndef MICROPY_GC_INCREMENTAL_VERIFY
+#define MICROPY_GC_INCREMENTAL_VERIFY (0)
+#endif
+
+// Whether collections started by the allocator leave the sweep to later
+// allocations, which free the garbage as they need memory, so that the pause
+// is only the mark phase.  The finalisers of the garbage then run in batches
+// from the scheduler if MICROPY_SCHEDULER_STATIC_NODES is enabled, and any
+// left run before the first block is freed.  gc.collect() sweeps straight away.
+#ifndef MICROPY_GC_LAZY_SWEEP
+#define MICROPY_GC_LAZY_SWEEP (0)
+#endif
+
+// Number of blocks the allocator sweeps before it looks for memory again
+#ifndef MICROPY_GC_LAZY_SWEEP_BLOCKS
+#define MICROPY_GC_LAZY_SWEEP_BLOCKS (256)
+#endif
+
+// Number of finalisers run by each scheduled batch
+#ifndef MICROPY_GC_LAZY_SWEEP_FINALISERS
+#define MICROPY_GC_LAZY_SWEEP_FINALISERS (8)
+#endif
+
 // Whether to provide m_tracked_calloc, m_tracked_free functions
 #ifndef MICROPY_TRACKED_ALLOC
 #define MICROPY_TRACKED_ALLOC (0)
@@ -871,6 +985,14 @@ typedef double mp_float_t;
 #define MICROPY_FLOAT_HIGH_QUALITY_HASH (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
 #endif
 
+// Number of heap blocks the GC allocates at a time for new floats, so that
+// most float results take one from a list instead of searching the heap (0
+// to disable).  The unused ones are freed by the next collection.  Only used
+// with boxed floats, ie not with MICROPY_OBJ_REPR_C or D.
+#ifndef MICROPY_FLOAT_FREELIST
+#define MICROPY_FLOAT_FREELIST (0)
+#endif
+
 // Enable features which improve CPython compatibility
 // but may lead to more code size/memory usage.
 // TODO: Originally intended as generic category to not
@@ -1036,6 +1158,11 @@ typedef double mp_float_t;
 #define MICROPY_VFS_LFS2 (0)
 #endif
 
+// Support for wrapping an LFSv2 filesystem mounted by the port, see mp_vfs_lfs2_adopt
+#ifndef MICROPY_VFS_LFS2_ADOPT
+#define MICROPY_VFS_LFS2_ADOPT (0)
+#endif
+
 // Support for ROMFS.
 #ifndef MICROPY_VFS_ROM
 #define MICROPY_VFS_ROM (0)
@@ -104,7 +104,13 @@ typedef struct _mp_state_mem_area_t {
     byte *gc_pool_start;
     byte *gc_pool_end;
 
-    size_t gc_last_free_atb_index;
+    // Entry n-1 is where to start looking for n free blocks: no run of n or
+    // more free blocks starts before this ATB.  The last entry is also used
+    // for larger allocations.
+    size_t gc_last_free_atb_index[MICROPY_GC_ALLOC_SIZE_CLASSES];
+    #if MICROPY_FLOAT_FREELIST
+    size_t gc_float_free_atb_index; // Where the GC last allocated blocks for floats
+    #endif
     size_t gc_last_used_block; // The block ID of the highest block allocated in the area
 } mp_state_mem_area_t;
 
@@ -143,12 +149,63 @@ typedef struct _mp_state_mem_t {
     size_t gc_collected;
     #endif
 
+    #if MICROPY_GC_INCREMENTAL
+    // State of an incremental collection, see gc.c.  Between steps the
+    // blocks still to be traced are on gc_block_stack.
+    uint8_t gc_inc_phase;
+    size_t gc_inc_sp;
+    size_t gc_inc_root;
+    mp_state_mem_area_t *gc_inc_scan_area;
+    size_t gc_inc_scan_block;
+    size_t gc_inc_alloc;
+    size_t gc_inc_next;
+    mp_uint_t gc_inc_budget_us;
+    #endif
+
+    #if MICROPY_GC_LAZY_SWEEP
+    // Set while the allocator runs a collection, to leave the sweep to it.
+    uint8_t gc_sweep_lazy;
+    // While gc_sweep_area isn't NULL a sweep is in progress: from block
+    // gc_sweep_block of that area on, and in all later areas, the blocks
+    // still hold the marks of the last collection.
+    mp_state_mem_area_t *gc_sweep_area;
+    size_t gc_sweep_block;
+    #if MICROPY_GC_INCREMENTAL
+    size_t gc_sweep_n_used;
+    #endif
+    #if MICROPY_ENABLE_FINALISER
+    // Finalisers still to run before the sweep can start, from this block on.
+    mp_state_mem_area_t *gc_finaliser_area;
+    size_t gc_finaliser_block;
+    #endif
+    #endif
+
+    #if MICROPY_FLOAT_FREELIST
+    // Blocks allocated for floats and not used yet, dropped by a collection.
+    void *gc_float_free[MICROPY_FLOAT_FREELIST];
+    size_t gc_float_free_len;
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_recursive_mutex_t gc_mutex;
     #endif
 } mp_state_mem_t;
 
+#if MICROPY_OPT_MAP_ROM_INDEX
+// An index of a constant map: an open-addressed hash table keyed by the qstr
+// value of the key, each slot holding the position in the map's table plus
+// one, or 0 if empty.  Maps with up to half as many entries as there are slots
+// can be indexed.
+#define MP_MAP_ROM_INDEX_SLOTS (256)
+typedef struct _mp_map_rom_index_t {
+    const mp_map_elem_t *table;
+    uint8_t mask;
+    uint8_t conflicts;
+    uint8_t slots[MP_MAP_ROM_INDEX_SLOTS];
+} mp_map_rom_index_t;
+#endif
+
 // This structure hold runtime and VM information.  It includes a section
 // which contains root pointers that must be scanned by the GC.
 typedef struct _mp_state_vm_t {
@@ -217,6 +274,14 @@ typedef struct _mp_state_vm_t {
     mp_thread_mutex_t qstr_mutex;
     #endif
 
+    #if MICROPY_OPT_MAP_ROM_INDEX
+    // indexes of constant maps, see map.c
+    mp_map_rom_index_t map_rom_index[MICROPY_OPT_MAP_ROM_INDEX_SIZE];
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    mp_thread_mutex_t map_rom_index_mutex;
+    #endif
+    #endif
+
     #if MICROPY_ENABLE_COMPILER
     mp_uint_t mp_optimise_value;
     #if MICROPY_EMIT_NATIVE
@@ -259,6 +324,11 @@ typedef struct _mp_state_vm_t {
     // See mp_map_lookup.
     uint8_t map_lookup_cache[MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE];
     #endif
+
+    #if MICROPY_OPT_ATTR_SITE_CACHE
+    // See attr_site_lookup in vm.c.
+    uint8_t attr_site_cache[MICROPY_OPT_ATTR_SITE_CACHE_SIZE];
+    #endif
 } mp_state_vm_t;
 
 // This structure holds state that is specific to a given thread. Everything
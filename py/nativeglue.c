@@ -41,6 +41,16 @@
 #define DEBUG_printf(...) (void)0
 #endif
 
+#if MICROPY_EMIT_MACHINE_CODE && MICROPY_PY_BUILTINS_FLOAT
+// A native float is the raw bits of a float held in a machine word: a double
+// on 64-bit machines and a single precision float on 32-bit machines.
+typedef union _mp_native_float_t {
+    mp_uint_t u;
+    float f;
+    double d;
+} mp_native_float_t;
+#endif
+
 #if MICROPY_EMIT_NATIVE
 
 int mp_native_type_from_qstr(qstr qst) {
@@ -61,6 +71,10 @@ int mp_native_type_from_qstr(qstr qst) {
             return MP_NATIVE_TYPE_PTR16;
         case MP_QSTR_ptr32:
             return MP_NATIVE_TYPE_PTR32;
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case MP_QSTR_float:
+            return MP_NATIVE_TYPE_FLOAT;
+        #endif
         default:
             return -1;
     }
@@ -77,6 +91,17 @@ mp_uint_t mp_native_from_obj(mp_obj_t obj, mp_uint_t type) {
         case MP_NATIVE_TYPE_INT:
         case MP_NATIVE_TYPE_UINT:
             return mp_obj_get_int_truncated(obj);
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case MP_NATIVE_TYPE_FLOAT: {
+            mp_native_float_t f = { .u = 0 };
+            if (sizeof(mp_uint_t) == sizeof(double)) {
+                f.d = mp_obj_get_float(obj);
+            } else {
+                f.f = (float)mp_obj_get_float(obj);
+            }
+            return f.u;
+        }
+        #endif
         default: { // cast obj to a pointer
             mp_buffer_info_t bufinfo;
             if (mp_get_buffer(obj, &bufinfo, MP_BUFFER_READ)) {
@@ -107,6 +132,16 @@ mp_obj_t mp_native_to_obj(mp_uint_t val, mp_uint_t type) {
             return mp_obj_new_int_from_uint(val);
         case MP_NATIVE_TYPE_QSTR:
             return MP_OBJ_NEW_QSTR(val);
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case MP_NATIVE_TYPE_FLOAT: {
+            mp_native_float_t f = { .u = val };
+            if (sizeof(mp_uint_t) == sizeof(double)) {
+                return mp_obj_new_float((mp_float_t)f.d);
+            } else {
+                return mp_obj_new_float((mp_float_t)f.f);
+            }
+        }
+        #endif
         default: // a pointer
             // we return just the value of the pointer as an integer
             return mp_obj_new_int_from_uint(val);
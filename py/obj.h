@@ -394,12 +394,21 @@ typedef struct _mp_rom_obj_t { mp_const_obj_t o; } mp_rom_obj_t;
 // These macros are used to define constant map/dict objects
 // You can put "static" in front of the definition to make it local
 
+// Maps in native modules must also work in firmware that doesn't know about
+// is_rom, so they leave it clear and are searched linearly.
+#if MICROPY_ENABLE_DYNRUNTIME
+#define MP_MAP_IS_ROM (0)
+#else
+#define MP_MAP_IS_ROM (1)
+#endif
+
 #define MP_DEFINE_CONST_MAP(map_name, table_name) \
     const mp_map_t map_name = { \
         .all_keys_are_qstrs = 1, \
         .is_fixed = 1, \
         .is_ordered = 1, \
         .used = MP_ARRAY_SIZE(table_name), \
+        .is_rom = MP_MAP_IS_ROM, \
         .alloc = MP_ARRAY_SIZE(table_name), \
         .table = (mp_map_elem_t *)(mp_rom_map_elem_t *)table_name, \
     }
@@ -412,6 +421,7 @@ typedef struct _mp_rom_obj_t { mp_const_obj_t o; } mp_rom_obj_t;
             .is_fixed = 1, \
             .is_ordered = 1, \
             .used = n, \
+            .is_rom = MP_MAP_IS_ROM, \
             .alloc = n, \
             .table = (mp_map_elem_t *)(mp_rom_map_elem_t *)table_name, \
         }, \
@@ -464,7 +474,8 @@ typedef struct _mp_map_t {
     size_t all_keys_are_qstrs : 1;
     size_t is_fixed : 1;    // if set, table is fixed/read-only and can't be modified
     size_t is_ordered : 1;  // if set, table is an ordered array, not a hash map
-    size_t used : (8 * sizeof(size_t) - 3);
+    size_t used : (8 * sizeof(size_t) - 4);
+    size_t is_rom : 1;      // if set, table is a constant array that never changes
     size_t alloc;
     mp_map_elem_t *table;
 } mp_map_t;
@@ -489,6 +500,7 @@ void mp_map_deinit(mp_map_t *map);
 void mp_map_free(mp_map_t *map);
 mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind);
 void mp_map_clear(mp_map_t *map);
+size_t mp_map_table_bytes(const mp_map_t *map);
 void mp_map_dump(mp_map_t *map);
 
 // Underlying set implementation (not set object)
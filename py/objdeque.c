@@ -26,6 +26,7 @@
 
 #include <unistd.h> // for ssize_t
 
+#include "py/gc.h"
 #include "py/runtime.h"
 
 #if MICROPY_PY_COLLECTIONS_DEQUE
@@ -109,6 +110,7 @@ static mp_obj_t mp_obj_deque_append(mp_obj_t self_in, mp_obj_t arg) {
     }
 
     self->items[self->i_put] = arg;
+    MP_GC_WRITE_BARRIER(arg);
     self->i_put = new_i_put;
 
     if (self->i_get == new_i_put) {
@@ -135,6 +137,7 @@ static mp_obj_t mp_obj_deque_appendleft(mp_obj_t self_in, mp_obj_t arg) {
 
     self->i_get = new_i_get;
     self->items[self->i_get] = arg;
+    MP_GC_WRITE_BARRIER(arg);
 
     // overwriting first element in deque
     if (self->i_put == new_i_get) {
@@ -218,6 +221,7 @@ static mp_obj_t deque_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     } else {
         // store into deque
         self->items[index_val] = value;
+        MP_GC_WRITE_BARRIER(value);
         return mp_const_none;
     }
 }
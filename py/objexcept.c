@@ -149,6 +149,7 @@ static void decompress_error_text_maybe(mp_obj_exception_t *o) {
             }
             mp_decompress_rom_string(buf, (mp_rom_error_text_t)o_str->data);
             o_str->data = buf;
+            MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(buf));
             o_str->len = strlen((const char *)buf);
             o_str->hash = 0;
         }
@@ -613,6 +614,7 @@ void mp_obj_exception_add_traceback(mp_obj_t self_in, qstr file, size_t line, qs
         } else {
             // Allocated the traceback data on the heap
             self->traceback_alloc = TRACEBACK_ENTRY_LEN;
+            MP_GC_WRITE_BARRIER(self->traceback_data);
         }
         self->traceback_len = 0;
     } else if (self->traceback_len + TRACEBACK_ENTRY_LEN > self->traceback_alloc) {
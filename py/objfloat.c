@@ -29,6 +29,7 @@
 #include <string.h>
 #include <assert.h>
 
+#include "py/gc.h"
 #include "py/parsenum.h"
 #include "py/runtime.h"
 
@@ -200,8 +201,16 @@ MP_DEFINE_CONST_OBJ_TYPE(
 #if MICROPY_OBJ_REPR != MICROPY_OBJ_REPR_C && MICROPY_OBJ_REPR != MICROPY_OBJ_REPR_D
 
 mp_obj_t mp_obj_new_float(mp_float_t value) {
+    #if MICROPY_FLOAT_FREELIST
+    // Take one of the blocks the GC allocates for floats a batch at a time.
+    mp_obj_float_t *o = gc_alloc_float_block();
+    if (o == NULL) {
+        o = m_new_obj(mp_obj_float_t);
+    }
+    #else
     // Don't use mp_obj_malloc here to avoid extra function call overhead.
     mp_obj_float_t *o = m_new_obj(mp_obj_float_t);
+    #endif
     o->base.type = &mp_type_float;
     o->value = value;
     return MP_OBJ_FROM_PTR(o);
@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <assert.h>
 
+#include "py/gc.h"
 #include "py/runtime.h"
 #include "py/bc.h"
 #include "py/objstr.h"
@@ -212,6 +213,9 @@ mp_vm_return_kind_t mp_obj_gen_resume(mp_obj_t self_in, mp_obj_t send_value, mp_
 
     mp_globals_set(self->code_state.old_globals);
 
+    // The generator's state was written to without write barriers
+    MP_GC_WRITE_BARRIER_RESCAN(self);
+
     // Mark as not running
     self->pend_exc = mp_const_none;
 
@@ -338,6 +342,7 @@ static mp_obj_t gen_instance_pend_throw(mp_obj_t self_in, mp_obj_t exc_in) {
     }
     mp_obj_t prev = self->pend_exc;
     self->pend_exc = exc_in;
+    MP_GC_WRITE_BARRIER(exc_in);
     return prev;
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(gen_instance_pend_throw_obj, gen_instance_pend_throw);
@@ -30,6 +30,7 @@
 #include <assert.h>
 
 #include "py/bc.h"
+#include "py/gc.h"
 #include "py/objmodule.h"
 #include "py/runtime.h"
 #include "py/builtin.h"
@@ -138,6 +139,7 @@ mp_obj_t mp_obj_new_module(qstr module_name) {
 
     // store the new module into the slot in the global dict holding all modules
     el->value = MP_OBJ_FROM_PTR(o);
+    MP_GC_WRITE_BARRIER(el->value);
 
     // return the new module
     return MP_OBJ_FROM_PTR(o);
@@ -27,6 +27,7 @@
 #include <stdlib.h>
 
 #include "py/objtype.h"
+#include "py/gc.h"
 #include "py/runtime.h"
 
 typedef struct _mp_obj_object_t {
@@ -73,6 +74,7 @@ static mp_obj_t object___setattr__(mp_obj_t self_in, mp_obj_t attr, mp_obj_t val
 
     mp_obj_instance_t *self = MP_OBJ_TO_PTR(self_in);
     mp_map_lookup(&self->members, attr, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = value;
+    MP_GC_WRITE_BARRIER(value);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_3(object___setattr___obj, object___setattr__);
@@ -31,6 +31,7 @@
 #include <assert.h>
 
 #include "py/objtype.h"
+#include "py/gc.h"
 #include "py/runtime.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -411,7 +412,7 @@ static mp_obj_t instance_unary_op(mp_unary_op_t op, mp_obj_t self_in) {
         size_t num_native_bases = instance_count_native_bases(mp_obj_get_type(self_in), &native_base);
 
         size_t sz = sizeof(*self) + sizeof(*self->subobj) * num_native_bases
-            + sizeof(*self->members.table) * self->members.alloc;
+            + mp_map_table_bytes(&self->members);
         return MP_OBJ_NEW_SMALL_INT(sz);
     }
     #endif
@@ -806,6 +807,7 @@ skip_special_accessors:
     } else {
         // store attribute
         mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = value;
+        MP_GC_WRITE_BARRIER(value);
         return true;
     }
 }
@@ -1106,6 +1108,7 @@ static void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
                 // store attribute
                 mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
                 elem->value = dest[1];
+                MP_GC_WRITE_BARRIER(dest[1]);
                 dest[0] = MP_OBJ_NULL; // indicate success
             }
         }
@@ -1238,6 +1241,7 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
         if (mp_obj_is_fun(elem->value)) {
             // __new__ is a function, wrap it in a staticmethod decorator
             elem->value = static_class_method_make_new(&mp_type_staticmethod, 1, 0, &elem->value);
+            MP_GC_WRITE_BARRIER(elem->value);
         }
     }
 
@@ -24,7 +24,9 @@
  * THE SOFTWARE.
  */
 
+#include "py/gc.h"
 #include "py/pairheap.h"
+#include "py/runtime.h"
 
 // The mp_pairheap_t.next pointer can take one of the following values:
 //   - NULL: the node is the top of the heap
@@ -35,6 +37,10 @@
 #define NEXT_IS_RIGHTMOST_PARENT(next) ((uintptr_t)(next) & 1)
 #define NEXT_GET_RIGHTMOST_PARENT(next) ((void *)((uintptr_t)(next) & ~1))
 
+// Nodes are moved around without their owners knowing, so every node that
+// gets a new parent or sibling is shaded for the incremental GC.
+#define SHADE(node) MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(node))
+
 // O(1), stable
 mp_pairheap_t *mp_pairheap_meld(mp_pairheap_lt_t lt, mp_pairheap_t *heap1, mp_pairheap_t *heap2) {
     if (heap1 == NULL) {
@@ -43,6 +49,8 @@ mp_pairheap_t *mp_pairheap_meld(mp_pairheap_lt_t lt, mp_pairheap_t *heap1, mp_pa
     if (heap2 == NULL) {
         return heap1;
     }
+    SHADE(heap1);
+    SHADE(heap2);
     if (lt(heap1, heap2)) {
         if (heap1->child == NULL) {
             heap1->child = heap2;
@@ -54,6 +62,7 @@ mp_pairheap_t *mp_pairheap_meld(mp_pairheap_lt_t lt, mp_pairheap_t *heap1, mp_pa
         return heap1;
     } else {
         heap1->next = heap2->child;
+        SHADE(heap1->next);
         heap2->child = heap1;
         if (heap1->next == NULL) {
             heap2->child_last = heap1;
@@ -113,6 +122,7 @@ mp_pairheap_t *mp_pairheap_delete(mp_pairheap_lt_t lt, mp_pairheap_t *heap, mp_p
             parent->child = NULL;
         } else {
             parent->child = node->next;
+            SHADE(node->next);
         }
         node->next = NULL;
         return heap;
@@ -123,6 +133,7 @@ mp_pairheap_t *mp_pairheap_delete(mp_pairheap_lt_t lt, mp_pairheap_t *heap, mp_p
         node->next = NULL;
         node = mp_pairheap_pairing(lt, child);
         parent->child = node;
+        SHADE(node);
     } else {
         mp_pairheap_t *n = parent->child;
         while (node != n->next) {
@@ -137,9 +148,11 @@ mp_pairheap_t *mp_pairheap_delete(mp_pairheap_lt_t lt, mp_pairheap_t *heap, mp_p
             node = n;
         } else {
             n->next = node;
+            SHADE(node);
         }
     }
     node->next = next;
+    SHADE(next);
     if (NEXT_IS_RIGHTMOST_PARENT(next)) {
         parent->child_last = node;
     }
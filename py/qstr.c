@@ -60,13 +60,35 @@
 // allocated pool is twice this size.  The value here must be <= MP_QSTRnumber_of.
 #define MICROPY_ALLOC_QSTR_ENTRIES_INIT (10)
 
-// this must match the equivalent function in makeqstrdata.py
-size_t qstr_compute_hash(const byte *data, size_t len) {
-    // djb2 algorithm; see http://www.cse.yorku.ca/~oz/hash.html
+#if MICROPY_QSTR_POOL_INDEX
+// Each dynamically allocated pool has an open-addressed hash index, placed
+// between its qstrs and hashes arrays.  The index has a power of two number
+// of slots, at least 1.5 times the pool's alloc, so it is never more than 2/3
+// full.  A slot holds 1 + the position of a qstr in the pool, or 0 if empty.
+// Pools never grow once allocated, so the index is never rebuilt.
+typedef uint16_t qstr_index_t;
+#define QSTR_POOL_INDEX_MAX_ALLOC (0xffff)
+
+static inline size_t qstr_pool_index_size(size_t alloc) {
+    return (size_t)1 << (32 - mp_clz((uint32_t)(alloc + alloc / 2 - 1)));
+}
+
+static inline qstr_index_t *qstr_pool_index(const qstr_pool_t *pool) {
+    return (qstr_index_t *)(pool->qstrs + pool->alloc);
+}
+#endif
+
+// djb2 algorithm; see http://www.cse.yorku.ca/~oz/hash.html
+static size_t qstr_hash_data(const byte *data, size_t len) {
     size_t hash = 5381;
     for (const byte *top = data + len; data < top; data++) {
         hash = ((hash << 5) + hash) ^ (*data); // hash * 33 ^ data
     }
+    return hash;
+}
+
+// Reduce the hash of the data to the value stored for a qstr.
+static inline size_t qstr_hash_reduce(size_t hash) {
     hash &= Q_HASH_MASK;
     // Make sure that valid hash is never zero, zero means "hash not computed"
     if (hash == 0) {
@@ -75,6 +97,11 @@ size_t qstr_compute_hash(const byte *data, size_t len) {
     return hash;
 }
 
+// this must match the equivalent function in makeqstrdata.py
+size_t qstr_compute_hash(const byte *data, size_t len) {
+    return qstr_hash_reduce(qstr_hash_data(data, len));
+}
+
 // The first pool is the static qstr table. The contents must remain stable as
 // it is part of the .mpy ABI. See the top of py/persistentcode.c and
 // static_qstr_list in makeqstrdata.py. This pool is unsorted (although in a
@@ -201,8 +228,11 @@ static const qstr_pool_t *find_qstr(qstr *q) {
 
 // qstr_mutex must be taken while in this function
 static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
+    #if MICROPY_QSTR_BYTES_IN_HASH || MICROPY_QSTR_POOL_INDEX
+    size_t data_hash = qstr_hash_data((const byte *)q_ptr, len);
+    #endif
     #if MICROPY_QSTR_BYTES_IN_HASH
-    mp_uint_t hash = qstr_compute_hash((const byte *)q_ptr, len);
+    mp_uint_t hash = qstr_hash_reduce(data_hash);
     DEBUG_printf("QSTR: add hash=%d len=%d data=%.*s\n", hash, len, len, q_ptr);
     #else
     DEBUG_printf("QSTR: add len=%d data=%.*s\n", len, len, q_ptr);
@@ -215,12 +245,19 @@ static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
         // Put a lower bound on the allocation size in case the extra qstr pool has few entries
         new_alloc = MAX(MICROPY_ALLOC_QSTR_ENTRIES_INIT, new_alloc);
         #endif
+        #if MICROPY_QSTR_POOL_INDEX
+        // Index slots must be able to hold any position in the pool
+        new_alloc = MIN(QSTR_POOL_INDEX_MAX_ALLOC, new_alloc);
+        #endif
         mp_uint_t pool_size = sizeof(qstr_pool_t)
             + (sizeof(const char *)
                 #if MICROPY_QSTR_BYTES_IN_HASH
                 + sizeof(qstr_hash_t)
                 #endif
                 + sizeof(qstr_len_t)) * new_alloc;
+        #if MICROPY_QSTR_POOL_INDEX
+        pool_size += sizeof(qstr_index_t) * qstr_pool_index_size(new_alloc);
+        #endif
         qstr_pool_t *pool = (qstr_pool_t *)m_malloc_maybe(pool_size);
         if (pool == NULL) {
             // Keep qstr_last_chunk consistent with qstr_pool_t: qstr_last_chunk is not scanned
@@ -232,15 +269,20 @@ static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
             QSTR_EXIT();
             m_malloc_fail(new_alloc);
         }
+        pool->alloc = new_alloc;
+        void *arrays = pool->qstrs + new_alloc;
+        #if MICROPY_QSTR_POOL_INDEX
+        memset(arrays, 0, sizeof(qstr_index_t) * qstr_pool_index_size(new_alloc));
+        arrays = qstr_pool_index(pool) + qstr_pool_index_size(new_alloc);
+        #endif
         #if MICROPY_QSTR_BYTES_IN_HASH
-        pool->hashes = (qstr_hash_t *)(pool->qstrs + new_alloc);
+        pool->hashes = (qstr_hash_t *)arrays;
         pool->lengths = (qstr_len_t *)(pool->hashes + new_alloc);
         #else
-        pool->lengths = (qstr_len_t *)(pool->qstrs + new_alloc);
+        pool->lengths = (qstr_len_t *)arrays;
         #endif
         pool->prev = MP_STATE_VM(last_pool);
         pool->total_prev_len = MP_STATE_VM(last_pool)->total_prev_len + MP_STATE_VM(last_pool)->len;
-        pool->alloc = new_alloc;
         pool->len = 0;
         MP_STATE_VM(last_pool) = pool;
         DEBUG_printf("QSTR: allocate new pool of size %d\n", MP_STATE_VM(last_pool)->alloc);
@@ -253,8 +295,20 @@ static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
     #endif
     MP_STATE_VM(last_pool)->lengths[at] = len;
     MP_STATE_VM(last_pool)->qstrs[at] = q_ptr;
+    // The pool reaches the chunk of interned strings through its first string.
+    MP_GC_WRITE_BARRIER(MP_OBJ_FROM_PTR(q_ptr));
     MP_STATE_VM(last_pool)->len++;
 
+    #if MICROPY_QSTR_POOL_INDEX
+    qstr_index_t *index = qstr_pool_index(MP_STATE_VM(last_pool));
+    size_t mask = qstr_pool_index_size(MP_STATE_VM(last_pool)->alloc) - 1;
+    size_t slot = data_hash & mask;
+    while (index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    index[slot] = at + 1;
+    #endif
+
     // return id for the newly-added qstr
     return MP_STATE_VM(last_pool)->total_prev_len + at;
 }
@@ -265,13 +319,37 @@ qstr qstr_find_strn(const char *str, size_t str_len) {
         return MP_QSTR_;
     }
 
-    #if MICROPY_QSTR_BYTES_IN_HASH
     // work out hash of str
-    size_t str_hash = qstr_compute_hash((const byte *)str, str_len);
+    #if MICROPY_QSTR_BYTES_IN_HASH || MICROPY_QSTR_POOL_INDEX
+    size_t data_hash = qstr_hash_data((const byte *)str, str_len);
+    #endif
+    #if MICROPY_QSTR_BYTES_IN_HASH
+    size_t str_hash = qstr_hash_reduce(data_hash);
+    #endif
+
+    const qstr_pool_t *pool = MP_STATE_VM(last_pool);
+
+    #if MICROPY_QSTR_POOL_INDEX
+    // look up the dynamically allocated pools in their index
+    for (; pool != &CONST_POOL; pool = pool->prev) {
+        const qstr_index_t *index = qstr_pool_index(pool);
+        size_t mask = qstr_pool_index_size(pool->alloc) - 1;
+        for (size_t slot = data_hash & mask; index[slot] != 0; slot = (slot + 1) & mask) {
+            mp_uint_t at = index[slot] - 1;
+            if (
+                #if MICROPY_QSTR_BYTES_IN_HASH
+                pool->hashes[at] == str_hash &&
+                #endif
+                pool->lengths[at] == str_len
+                && memcmp(pool->qstrs[at], str, str_len) == 0) {
+                return pool->total_prev_len + at;
+            }
+        }
+    }
     #endif
 
     // search pools for the data
-    for (const qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != NULL; pool = pool->prev) {
+    for (; pool != NULL; pool = pool->prev) {
         size_t low = 0;
         size_t high = pool->len - 1;
 
@@ -436,6 +514,9 @@ void qstr_pool_info(size_t *n_pool, size_t *n_qstr, size_t *n_str_data_bytes, si
                 + sizeof(qstr_hash_t)
                 #endif
                 + sizeof(qstr_len_t)) * pool->alloc;
+        #if MICROPY_QSTR_POOL_INDEX
+        *n_total_bytes += sizeof(qstr_index_t) * qstr_pool_index_size(pool->alloc);
+        #endif
         #endif
     }
     *n_total_bytes += *n_str_data_bytes;
@@ -123,6 +123,14 @@ void mp_init(void) {
     MP_STATE_VM(mp_module_builtins_override_dict) = NULL;
     #endif
 
+    #if MICROPY_OPT_MAP_ROM_INDEX
+    // no constant maps indexed yet
+    memset(MP_STATE_VM(map_rom_index), 0, sizeof(MP_STATE_VM(map_rom_index)));
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    mp_thread_mutex_init(&MP_STATE_VM(map_rom_index_mutex));
+    #endif
+    #endif
+
     #if MICROPY_EMIT_MACHINE_CODE && (MICROPY_PERSISTENT_CODE_TRACK_FUN_DATA || MICROPY_PERSISTENT_CODE_TRACK_BSS_RODATA)
     MP_STATE_VM(persistent_code_root_pointers) = MP_OBJ_NULL;
     #endif
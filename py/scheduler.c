@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 
+#include "py/gc.h"
 #include "py/mphal.h"
 #include "py/runtime.h"
 
@@ -267,6 +268,9 @@ void mp_event_handle_nowait(void) {
 // Handles any pending MicroPython events and then suspends execution until the
 // next interrupt or event.
 void mp_event_wait_indefinite(void) {
+    #if MICROPY_GC_INCREMENTAL
+    gc_incremental_idle((mp_uint_t)-1);
+    #endif
     #if defined(MICROPY_EVENT_POLL_HOOK) && !MICROPY_PREVIEW_VERSION_2
     // For ports still using the old macros.
     MICROPY_EVENT_POLL_HOOK
@@ -279,6 +283,9 @@ void mp_event_wait_indefinite(void) {
 // Handle any pending MicroPython events and then suspends execution until the
 // next interrupt or event, or until timeout_ms milliseconds have elapsed.
 void mp_event_wait_ms(mp_uint_t timeout_ms) {
+    #if MICROPY_GC_INCREMENTAL
+    gc_incremental_idle(MIN(timeout_ms, (mp_uint_t)-1 / 1000) * 1000);
+    #endif
     #if defined(MICROPY_EVENT_POLL_HOOK) && !MICROPY_PREVIEW_VERSION_2
     // For ports still using the old macros.
     MICROPY_EVENT_POLL_HOOK
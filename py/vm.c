@@ -30,6 +30,7 @@
 #include <assert.h>
 
 #include "py/emitglue.h"
+#include "py/gc.h"
 #include "py/objtype.h"
 #include "py/objfun.h"
 #include "py/runtime.h"
@@ -195,6 +196,30 @@
 #define TRACE_TICK(current_ip, current_sp, is_exception)
 #endif // MICROPY_PY_SYS_SETTRACE
 
+#if MICROPY_OPT_ATTR_SITE_CACHE
+// MP_STATE_VM(attr_site_cache) remembers, for each LOAD_ATTR and STORE_ATTR
+// told apart by the address following it in the bytecode, the position in an
+// instance's members map where it last found its attribute.  Instances of a
+// class mostly get their attributes in the same order, so the position is
+// usually right for all of them.  It's checked against the key there, so a
+// stale or shared entry only costs a normal lookup.  This works for bytecode
+// in ROM, which can't hold the cache itself.
+#define ATTR_SITE_CACHE_ENTRY(ip) (MP_STATE_VM(attr_site_cache)[(uintptr_t)(ip) % MICROPY_OPT_ATTR_SITE_CACHE_SIZE])
+
+static inline mp_map_elem_t *attr_site_lookup(mp_map_t *map, qstr attr, const byte *ip, mp_map_lookup_kind_t lookup_kind) {
+    mp_obj_t key = MP_OBJ_NEW_QSTR(attr);
+    size_t pos = ATTR_SITE_CACHE_ENTRY(ip);
+    if (pos < map->alloc && map->table[pos].key == key) {
+        return &map->table[pos];
+    }
+    mp_map_elem_t *elem = mp_map_lookup(map, key, lookup_kind);
+    if (elem != NULL) {
+        ATTR_SITE_CACHE_ENTRY(ip) = (elem - map->table) & 0xff;
+    }
+    return elem;
+}
+#endif
+
 // fastn has items in reverse order (fastn[0] is local[0], fastn[-1] is local[1], etc)
 // sp points to bottom of stack which grows up
 // returns:
@@ -406,7 +431,11 @@ dispatch_loop:
                     mp_map_elem_t *elem = NULL;
                     if (mp_obj_is_instance_type(mp_obj_get_type(top))) {
                         mp_obj_instance_t *self = MP_OBJ_TO_PTR(top);
+                        #if MICROPY_OPT_ATTR_SITE_CACHE
+                        elem = attr_site_lookup(&self->members, qst, ip, MP_MAP_LOOKUP);
+                        #else
                         elem = mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+                        #endif
                     }
                     if (elem) {
                         obj = elem->value;
@@ -455,7 +484,9 @@ dispatch_loop:
 
                 ENTRY(MP_BC_STORE_DEREF): {
                     DECODE_UINT;
-                    mp_obj_cell_set(fastn[-unum], POP());
+                    mp_obj_t obj = POP();
+                    mp_obj_cell_set(fastn[-unum], obj);
+                    MP_GC_WRITE_BARRIER(obj);
                     DISPATCH();
                 }
 
@@ -477,7 +508,21 @@ dispatch_loop:
                     FRAME_UPDATE();
                     MARK_EXC_IP_SELECTIVE();
                     DECODE_QSTR;
-                    mp_store_attr(sp[0], qst, sp[-1]);
+                    #if MICROPY_OPT_ATTR_SITE_CACHE
+                    // An instance whose class has no special accessors stores
+                    // all attributes in its members map, see
+                    // mp_obj_instance_store_attr.  A null value is a delete.
+                    const mp_obj_type_t *type = mp_obj_get_type(sp[0]);
+                    if ((type->flags & (MP_TYPE_FLAG_INSTANCE_TYPE | MP_TYPE_FLAG_HAS_SPECIAL_ACCESSORS)) == MP_TYPE_FLAG_INSTANCE_TYPE
+                        && sp[-1] != MP_OBJ_NULL) {
+                        mp_obj_instance_t *self = MP_OBJ_TO_PTR(sp[0]);
+                        attr_site_lookup(&self->members, qst, ip, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = sp[-1];
+                        MP_GC_WRITE_BARRIER(sp[-1]);
+                    } else
+                    #endif
+                    {
+                        mp_store_attr(sp[0], qst, sp[-1]);
+                    }
                     sp -= 2;
                     DISPATCH();
                 }
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 autolab-fi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_SHARED_RUNTIME_EVENTRING_H
+#define MICROPY_INCLUDED_SHARED_RUNTIME_EVENTRING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// A lock-free single-producer/single-consumer ring of (time, value) events,
+// for recording interrupts in an ISR and draining them later from the VM.
+//
+// The producer (the ISR) only writes head and overflow; the consumer only
+// writes tail.  Indices are free-running and wrap at 2**32, the capacity
+// must be a power of two.  When the ring is full new events are dropped and
+// counted, so the consumer always sees the oldest events in order.
+
+typedef struct _mp_event_ring_event_t {
+    uint32_t time;
+    uint32_t value;
+} mp_event_ring_event_t;
+
+typedef struct _mp_event_ring_t {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t mask;
+    uint32_t overflow;
+    mp_event_ring_event_t *events;
+} mp_event_ring_t;
+
+static inline void mp_event_ring_init(mp_event_ring_t *r, mp_event_ring_event_t *events, uint32_t size) {
+    r->head = 0;
+    r->tail = 0;
+    r->mask = size - 1;
+    r->overflow = 0;
+    r->events = events;
+}
+
+// Producer side.  Returns false (and counts an overflow) if the ring is full.
+static inline bool mp_event_ring_put(mp_event_ring_t *r, uint32_t time, uint32_t value) {
+    uint32_t head = r->head;
+    if (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) > r->mask) {
+        __atomic_store_n(&r->overflow, r->overflow + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    mp_event_ring_event_t *ev = &r->events[head & r->mask];
+    ev->time = time;
+    ev->value = value;
+    __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Consumer side.
+static inline uint32_t mp_event_ring_avail(mp_event_ring_t *r) {
+    return __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - r->tail;
+}
+
+// Copy up to n events out of the ring, returns the number copied.
+static inline uint32_t mp_event_ring_get(mp_event_ring_t *r, mp_event_ring_event_t *out, uint32_t n) {
+    uint32_t tail = r->tail;
+    uint32_t avail = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail;
+    if (n > avail) {
+        n = avail;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        out[i] = r->events[(tail + i) & r->mask];
+    }
+    __atomic_store_n(&r->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+static inline uint32_t mp_event_ring_overflow(mp_event_ring_t *r) {
+    return __atomic_load_n(&r->overflow, __ATOMIC_RELAXED);
+}
+
+#endif // MICROPY_INCLUDED_SHARED_RUNTIME_EVENTRING_H
@@ -0,0 +1,65 @@
+# test attribute loads and stores at one site on objects that differ
+
+
+class A:
+    def __init__(self):
+        self.x = 1
+        self.y = 2
+
+
+class B:
+    def __init__(self):
+        self.y = 3
+        self.z = 4
+        self.x = 5
+
+
+def get_x(o):
+    return o.x
+
+
+def set_x(o, v):
+    o.x = v
+
+
+# the same sites on different classes and on instances with a different layout
+objs = [A(), B(), A(), B()]
+objs[2].w = 6
+for o in objs:
+    set_x(o, get_x(o) + 10)
+print([get_x(o) for o in objs])
+
+# the members map grows while a site keeps storing
+a = A()
+for i in range(40):
+    setattr(a, "a%d" % i, i)
+    set_x(a, i)
+print(get_x(a), a.a39)
+
+# deleting and adding back
+del a.x
+try:
+    get_x(a)
+except AttributeError:
+    print("AttributeError")
+set_x(a, 7)
+print(get_x(a))
+
+
+# a class that gets special accessors after its instances have been used
+class C:
+    pass
+
+
+c = C()
+set_x(c, 1)
+print(get_x(c))
+
+
+def setattr_hook(self, attr, value):
+    print("setattr", attr, value)
+
+
+C.__setattr__ = setattr_hook
+set_x(c, 2)
+print(get_x(c))
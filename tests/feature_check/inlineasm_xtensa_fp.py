@@ -0,0 +1,9 @@
+# check if Xtensa inline asm supports FPU instructions
+
+
+@micropython.asm_xtensa
+def f():
+    wfr(f0, a2)
+
+
+print("xtensa_fp")
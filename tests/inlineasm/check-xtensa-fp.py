@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+
+# Check the encodings of the Xtensa inline assembler FPU instructions.
+#
+# This runs on the host: each instruction is compiled with mpy-cross for the
+# xtensawin architecture and the machine code is compared with the encoding
+# given by the Xtensa ISA reference.  The instructions themselves are run on
+# hardware by the tests in inlineasm/xtensa.
+
+import os
+import subprocess
+import sys
+import tempfile
+
+sys.path.append(os.path.join(os.path.dirname(__file__), "../../py"))
+sys.path.append(os.path.join(os.path.dirname(__file__), "../../tools"))
+mpy_tool = __import__("mpy-tool")
+
+MPYCROSS = os.getenv(
+    "MICROPY_MPYCROSS", os.path.join(os.path.dirname(__file__), "../../mpy-cross/build/mpy-cross")
+)
+
+# Instructions and their encoding, as bytes in memory order.
+ENCODINGS = (
+    ("add_s(f1, f2, f3)", "30120a"),
+    ("sub_s(f15, f14, f13)", "d0fe1a"),
+    ("mul_s(f0, f1, f2)", "20012a"),
+    ("madd_s(f15, f0, f7)", "70f04a"),
+    ("msub_s(f4, f5, f6)", "60455a"),
+    ("round_s(a4, f5, 3)", "30458a"),
+    ("trunc_s(a2, f0, 0)", "00209a"),
+    ("floor_s(a3, f1, 15)", "f031aa"),
+    ("ceil_s(a15, f15, 1)", "10ffba"),
+    ("float_s(f1, a2, 0)", "0012ca"),
+    ("ufloat_s(f3, a4, 2)", "2034da"),
+    ("utrunc_s(a5, f6, 4)", "4056ea"),
+    ("mov_s(f1, f2)", "0012fa"),
+    ("abs_s(f3, f4)", "1034fa"),
+    ("rfr(a2, f0)", "4020fa"),
+    ("wfr(f0, a2)", "5002fa"),
+    ("neg_s(f6, f7)", "6067fa"),
+    ("un_s(b0, f1, f2)", "20011b"),
+    ("oeq_s(b1, f2, f3)", "30122b"),
+    ("ueq_s(b2, f3, f4)", "40233b"),
+    ("olt_s(b3, f4, f5)", "50344b"),
+    ("ult_s(b4, f5, f6)", "60455b"),
+    ("ole_s(b5, f6, f7)", "70566b"),
+    ("ule_s(b15, f8, f9)", "90f87b"),
+    ("moveqz_s(f1, f2, a3)", "30128b"),
+    ("movnez_s(f1, f2, a3)", "30129b"),
+    ("movltz_s(f1, f2, a3)", "3012ab"),
+    ("movgez_s(f1, f2, a3)", "3012bb"),
+    ("movf_s(f1, f2, b3)", "3012cb"),
+    ("movt_s(f1, f2, b3)", "3012db"),
+    ("lsx(f1, a2, a3)", "301208"),
+    ("lsxu(f1, a2, a3)", "301218"),
+    ("ssx(f1, a2, a3)", "301248"),
+    ("ssxu(f1, a2, a3)", "301258"),
+    ("lsi(f3, a2, 8)", "330202"),
+    ("ssi(f0, a1, 0)", "034100"),
+    ("lsiu(f5, a6, 4)", "538601"),
+    ("ssiu(f4, a3, 1020)", "43c3ff"),
+    ("label(L)\n    bt(b1, L)", "7611fc"),
+    ("label(L)\n    bf(b15, L)", "760ffc"),
+    ("bt(b0, L)\n    nop()\n    label(L)", "761002f02000"),
+)
+
+# Code that must fail to compile, and the start of the error message.
+ERRORS = (
+    ("add_s(f1, f2, a3)", "'add_s' expects an FPU register"),
+    ("add_s(f1, f2, f16)", "'add_s' expects an FPU register"),
+    ("oeq_s(f1, f2, f3)", "'oeq_s' expects a boolean register"),
+    ("bt(a2, L)\n    label(L)", "'bt' expects a boolean register"),
+    ("wfr(f0, f1)", "'wfr' expects a register"),
+    ("round_s(a2, f1, 16)", "'round_s' integer 16 isn't within range 0..15"),
+    ("lsi(f0, a2, 2)", "2 is not a multiple of 4"),
+    ("lsi(f0, a2, 1024)", "'lsi' integer 1024 isn't within range 0..1020"),
+    ("neg_s(f0, f1, f2)", "unsupported Xtensa instruction 'neg_s' with 3 arguments"),
+)
+
+
+def compile_asm(body, arch):
+    # Compile a function with the given body, returning (code, error).
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "asm.py")
+        out = os.path.join(tmp, "asm.mpy")
+        with open(src, "w") as f:
+            f.write("@micropython.asm_xtensa\ndef f():\n    {}\n".format(body))
+        result = subprocess.run(
+            [MPYCROSS, "-march=" + arch, "-o", out, src], capture_output=True, text=True
+        )
+        if result.returncode != 0:
+            return None, result.stderr
+        mpy_tool.config.native_arch = mpy_tool.MP_NATIVE_ARCH_NONE
+        mpy_tool.global_qstrs = mpy_tool.GlobalQStrList()
+        return mpy_tool.read_mpy(out).raw_code.children[0].fun_data, None
+
+
+def main():
+    # The prologue and epilogue are found from an empty function.
+    empty, _ = compile_asm("nop()", "xtensawin")
+    nop = empty.find(bytes.fromhex("f02000"))
+    prologue, epilogue = empty[:nop], empty[nop + 3 :]
+
+    failed = 0
+    for body, expected in ENCODINGS:
+        code, error = compile_asm(body, "xtensawin")
+        if error is not None:
+            code = error.strip()
+        elif code.startswith(prologue) and code.endswith(epilogue):
+            code = code[len(prologue) : -len(epilogue)].hex()
+        if code != expected:
+            name = body.split("\n")[-1].strip()
+            print("FAIL {}: expected {} got {}".format(name, expected, code))
+            failed += 1
+    for body, expected in ERRORS:
+        _, error = compile_asm(body, "xtensawin")
+        if error is None or expected not in error:
+            print("FAIL {}: expected error {!r} got {!r}".format(body, expected, error))
+            failed += 1
+
+    # Plain xtensa targets (ESP8266) have no FPU.
+    _, error = compile_asm("add_s(f1, f2, f3)", "xtensa")
+    if error is None or "unsupported Xtensa instruction 'add_s'" not in error:
+        print("FAIL add_s compiled for xtensa")
+        failed += 1
+
+    total = len(ENCODINGS) + len(ERRORS) + 1
+    print("{} of {} checks passed".format(total - failed, total))
+    if failed:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,112 @@
+@micropython.asm_xtensa  # a2 = a2 + a3 - a4
+def add_sub(a2, a3, a4) -> int:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    float_s(f2, a4, 0)
+    add_s(f0, f0, f1)
+    sub_s(f0, f0, f2)
+    trunc_s(a2, f0, 0)
+
+
+print(add_sub(100, 20, 30))
+
+
+@micropython.asm_xtensa  # a2 = a2 * a3 + a4 / 4
+def mul_add(a2, a3, a4) -> int:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    float_s(f2, a4, 2)
+    madd_s(f2, f0, f1)
+    round_s(a2, f2, 0)
+
+
+print(mul_add(6, 7, 5))
+
+
+@micropython.asm_xtensa  # a2 = a4 - a2 * a3
+def mul_sub(a2, a3, a4) -> int:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    float_s(f2, a4, 0)
+    msub_s(f2, f0, f1)
+    trunc_s(a2, f2, 0)
+
+
+print(mul_sub(6, 7, 50))
+
+
+@micropython.asm_xtensa  # a2 = a2 * a3
+def mul(a2, a3) -> int:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    mul_s(f2, f0, f1)
+    trunc_s(a2, f2, 0)
+
+
+print(mul(-12, 11))
+
+
+@micropython.asm_xtensa
+def fneg(a2) -> int:
+    float_s(f0, a2, 0)
+    neg_s(f1, f0)
+    trunc_s(a2, f1, 0)
+
+
+@micropython.asm_xtensa
+def fabs(a2) -> int:
+    float_s(f0, a2, 0)
+    abs_s(f1, f0)
+    trunc_s(a2, f1, 0)
+
+
+for value in (5, -7, 0):
+    print(fneg(value), fabs(value))
+
+
+@micropython.asm_xtensa  # conversions of a2 / 2
+def round_half(a2) -> int:
+    float_s(f0, a2, 1)
+    round_s(a2, f0, 0)
+
+
+@micropython.asm_xtensa
+def trunc_half(a2) -> int:
+    float_s(f0, a2, 1)
+    trunc_s(a2, f0, 0)
+
+
+@micropython.asm_xtensa
+def floor_half(a2) -> int:
+    float_s(f0, a2, 1)
+    floor_s(a2, f0, 0)
+
+
+@micropython.asm_xtensa
+def ceil_half(a2) -> int:
+    float_s(f0, a2, 1)
+    ceil_s(a2, f0, 0)
+
+
+for value in (-5, 7):
+    print([f(value) for f in (round_half, trunc_half, floor_half, ceil_half)])
+
+
+@micropython.asm_xtensa  # scaled conversions
+def fixed(a2) -> int:
+    ufloat_s(f0, a2, 8)
+    utrunc_s(a2, f0, 4)
+
+
+print(fixed(0x1230))
+
+
+@micropython.asm_xtensa
+def one_bits() -> uint:
+    movi(a2, 1)
+    float_s(f3, a2, 0)
+    mov_s(f4, f3)
+    rfr(a2, f4)
+
+
+print(hex(one_bits()))
@@ -0,0 +1,85 @@
+@micropython.asm_xtensa  # a2 = a2 < a3
+def lt(a2, a3) -> bool:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    olt_s(b0, f0, f1)
+    movi(a2, 1)
+    bt(b0, END)
+    movi(a2, 0)
+    label(END)
+
+
+@micropython.asm_xtensa  # a2 = a2 <= a3
+def le(a2, a3) -> bool:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    ole_s(b15, f0, f1)
+    movi(a2, 0)
+    bf(b15, END)
+    movi(a2, 1)
+    label(END)
+
+
+@micropython.asm_xtensa  # a2 = a2 == a3
+def eq(a2, a3) -> bool:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    oeq_s(b3, f0, f1)
+    movi(a2, 1)
+    bt(b3, END)
+    movi(a2, 0)
+    label(END)
+
+
+for a, b in ((1, 2), (2, 2), (3, 2)):
+    print(lt(a, b), le(a, b), eq(a, b))
+
+
+@micropython.asm_xtensa  # a2 = max(a2, a3)
+def fmax(a2, a3) -> int:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    olt_s(b1, f0, f1)
+    movt_s(f0, f1, b1)
+    trunc_s(a2, f0, 0)
+
+
+@micropython.asm_xtensa  # a2 = min(a2, a3)
+def fmin(a2, a3) -> int:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    olt_s(b1, f0, f1)
+    movf_s(f0, f1, b1)
+    trunc_s(a2, f0, 0)
+
+
+for a, b in ((3, 8), (8, 3), (-1, -2)):
+    print(fmax(a, b), fmin(a, b))
+
+
+@micropython.asm_xtensa  # a2 = a2 if a4 < 0 else a3
+def select(a2, a3, a4) -> int:
+    float_s(f0, a2, 0)
+    float_s(f1, a3, 0)
+    movgez_s(f0, f1, a4)
+    trunc_s(a2, f0, 0)
+
+
+print(select(10, 20, -1), select(10, 20, 0), select(10, 20, 1))
+
+
+@micropython.asm_xtensa  # NaN compares unordered
+def unordered(a2) -> bool:
+    wfr(f0, a2)
+    movi(a3, 1)
+    float_s(f1, a3, 0)
+    un_s(b2, f0, f1)
+    ueq_s(b4, f0, f1)
+    movi(a2, 0)
+    bf(b2, END)
+    bf(b4, END)
+    movi(a2, 1)
+    label(END)
+
+
+print(unordered(0x3F800000), unordered(0x7FC00000))
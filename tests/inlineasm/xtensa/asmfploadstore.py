@@ -0,0 +1,50 @@
+import array
+
+
+@micropython.asm_xtensa  # test lsi, ssi
+def arrayadd(a2):
+    lsi(f0, a2, 0)
+    lsi(f1, a2, 4)
+    add_s(f2, f0, f1)
+    ssi(f2, a2, 8)
+
+
+z = array.array("f", [2, 4, 10])
+arrayadd(z)
+print(z[2])
+
+
+@micropython.asm_xtensa  # test lsiu, ssx
+def sum3(a2, a3):
+    lsi(f0, a3, 0)
+    lsiu(f1, a3, 4)
+    add_s(f0, f0, f1)
+    lsiu(f1, a3, 4)
+    add_s(f0, f0, f1)
+    movi(a4, 8)
+    ssx(f0, a2, a4)
+
+
+out = array.array("f", [0, 0, 0])
+sum3(out, array.array("f", [1.5, 2.25, 4]))
+print(out)
+
+
+@micropython.asm_xtensa  # out[0] = sum(h[i] * x[i] for i in range(n))
+def fir(a2, a3, a4, a5):
+    movi(a6, 0)
+    float_s(f0, a6, 0)
+    label(LOOP)
+    lsx(f1, a3, a6)
+    lsx(f2, a4, a6)
+    madd_s(f0, f1, f2)
+    addi(a6, a6, 4)
+    addi(a5, a5, -1)
+    bnez(a5, LOOP)
+    ssi(f0, a2, 0)
+
+
+h = array.array("f", [0.25, 0.5, 0.25])
+x = array.array("f", [4, 8, -2])
+fir(out, h, x, len(h))
+print(out[0])
@@ -0,0 +1,3 @@
+import gc_pause
+
+gc_pause.run(1000)
@@ -0,0 +1,46 @@
+# Longest GC pause of the incremental collector, for the gc_pause-*.py tests.
+#
+# A large set of live objects is kept while short-lived ones are allocated in
+# a loop.  Every loop iteration does the same work, so the slowest iteration
+# is the longest pause the collector caused.  Without MICROPY_GC_INCREMENTAL
+# every budget collects all at once.
+#
+# The live set is a global: what only the locals of running functions refer
+# to is traced in the final pause of a collection, so long-lived data should
+# be reachable from a module or an object.
+
+import gc
+import time
+
+ITERATIONS = 200000
+N_LIVE = 1000
+
+live = {}
+
+
+def make_live():
+    # Lists of small tuples and strings.
+    for i in range(N_LIVE):
+        live[i] = [(j, str(j)) for j in range(16)]
+
+
+def run(budget_us):
+    if hasattr(gc, "incremental"):
+        gc.incremental(budget_us)
+    make_live()
+    gc.collect()
+    ticks_us = time.ticks_us
+    ticks_diff = time.ticks_diff
+    max_pause = 0
+    t_prev = ticks_us()
+    for i in range(ITERATIONS):
+        # Short-lived garbage, and now and then a store into the live set.
+        tmp = [i, i + 1, (i, i)]
+        if i % 64 == 0:
+            live[i % N_LIVE][i % 16] = (i, tmp)
+        t = ticks_us()
+        dt = ticks_diff(t, t_prev)
+        t_prev = t
+        if dt > max_pause:
+            max_pause = dt
+    print(max_pause / 1000000)
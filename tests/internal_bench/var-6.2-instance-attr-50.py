@@ -0,0 +1,19 @@
+import bench
+
+
+class Foo:
+    def __init__(self):
+        for i in range(50):
+            setattr(self, "num%d" % i, 0)
+        self.num = 5000000
+
+
+def test(num):
+    o = Foo()
+    i = 0
+    while i < o.num:
+        o.num49 = o.num10 + o.num25
+        i += 1
+
+
+bench.run(test)
@@ -0,0 +1,50 @@
+# test gc.incremental() and incremental collection
+
+import gc
+
+if not hasattr(gc, "incremental"):
+    print("SKIP")
+    raise SystemExit
+
+budget = gc.incremental()
+print(type(budget))
+
+try:
+    gc.incremental(-1)
+except ValueError:
+    print("ValueError")
+
+# run with tiny steps so that many collections are in progress while the
+# program changes the objects the collector is tracing
+gc.incremental(1)
+
+d = {}
+l = []
+s = set()
+for i in range(5000):
+    l.append([i, str(i)])
+    d[i % 97] = (i, [str(i)])
+    s.add(str(i % 89))
+    l[i % len(l)] = (str(i),)
+    if len(l) > 300:
+        l = l[100:]
+print(len(l), len(d), len(s))
+print(sum(len(x) for x in l), sum(v[0] for v in d.values()), sorted(s)[:3])
+
+
+# generators keep their state in the heap
+def gen(n):
+    acc = []
+    for i in range(n):
+        acc.append(str(i))
+        yield len(acc)
+
+
+print(sum(gen(1000)))
+
+# switching off incremental collection finishes the one in progress
+gc.incremental(0)
+print(gc.incremental())
+gc.collect()
+
+gc.incremental(budget)
@@ -0,0 +1,39 @@
+# test that objects survive collections started by the allocator, and that
+# the finalisers of the ones freed by them run (with MICROPY_GC_LAZY_SWEEP
+# the garbage is freed as the allocator needs memory)
+
+import gc
+
+try:
+    gc.threshold
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+# collect after every few kB of allocation
+gc.collect()
+gc.threshold(4096)
+
+live = [None] * 50
+for i in range(5000):
+    live[i % 50] = ([i] * (i % 10), str(i), bytearray(i % 30))
+    if i % 1000 == 999:
+        print(sum(int(s) for l, s, b in live))
+
+for i, (l, s, b) in enumerate(live):
+    if l != [int(s)] * (int(s) % 10) or len(b) != int(s) % 30 or int(s) % 50 != i:
+        print("corrupt", i)
+
+# files that aren't closed have to be closed by their finaliser, or this runs
+# out of file descriptors
+try:
+    for i in range(2000):
+        f = open(__file__)
+        f.read(1)
+    print("files ok")
+except OSError as er:
+    print(er)
+
+gc.threshold(-1)
+gc.collect()
+print(gc.mem_free() > 0)
@@ -0,0 +1,30 @@
+# test that replacing a removed key in a full dict doesn't use the heap
+
+import micropython
+
+
+def test(n):
+    d = {}
+    for i in range(n):
+        d[i] = i
+    # fill the dict's table, so another new key would need a bigger one
+    i = n
+    while True:
+        micropython.heap_lock()
+        try:
+            d[i] = i
+        except MemoryError:
+            micropython.heap_unlock()
+            break
+        micropython.heap_unlock()
+        i += 1
+    micropython.heap_lock()
+    for j in range(3 * i):
+        del d[j % i]
+        d[j % i] = j
+    micropython.heap_unlock()
+    print(n, len(d) == i, sum(d.values()) == sum(range(2 * i, 3 * i)))
+
+
+for n in (1, 5, 50, 300):
+    test(n)
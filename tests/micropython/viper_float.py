@@ -0,0 +1,122 @@
+# test viper float type, which needs a target with an FPU
+# values are chosen so results are exact in single precision
+
+import micropython
+
+try:
+    exec("@micropython.viper\ndef f(x: float) -> float:\n return x")
+except (NameError, ViperTypeError):
+    print("SKIP")
+    raise SystemExit
+
+
+# args, return value and arithmetic
+@micropython.viper
+def arith(a: float, b: float) -> float:
+    return (a + b) * (a - b) / b
+
+
+print(arith(3.5, 2.0))
+print(arith(-1.0, 4.0))
+
+
+# negation and in-place ops
+@micropython.viper
+def unary(a: float) -> float:
+    b = -a
+    b += +a * 2.0
+    b *= 3.0
+    b -= 0.5
+    b /= 2.0
+    return b
+
+
+print(unary(1.5))
+
+
+# division by zero follows IEEE 754
+@micropython.viper
+def div(a: float, b: float) -> float:
+    return a / b
+
+
+print(div(1.0, 0.0), div(-1.0, 0.0))
+
+
+# comparisons, including with nan
+@micropython.viper
+def compare(a: float, b: float):
+    print(a < b, a > b, a == b, a <= b, a >= b, a != b)
+
+
+compare(1.0, 2.0)
+compare(2.0, 2.0)
+compare(3.0, 2.0)
+compare(float("nan"), 1.0)
+
+
+# casting to and from int
+@micropython.viper
+def cast(x: int) -> int:
+    f = float(x) * 0.5
+    return int(f) * 10 + int(-f)
+
+
+print(cast(7), cast(-8))
+
+
+@micropython.viper
+def cast_obj(x) -> float:
+    return float(x)
+
+
+print(cast_obj(5), cast_obj(1.25))
+
+
+# ints and objects mixed with floats are converted to floats
+@micropython.viper
+def mixed(a: float, n: int, o) -> float:
+    return a * n + o - 1 + (2 - a) * o
+
+
+print(mixed(1.5, 3, 2))
+print(mixed(0.5, -2, 0.25))
+
+
+# accumulating in a loop
+@micropython.viper
+def total(buf, n: int) -> float:
+    s = float(0)
+    i = 0
+    while i < n:
+        s += float(buf[i]) / 4.0
+        i += 1
+    return s
+
+
+print(total([1, 2.5, 3, -0.5], 4))
+
+
+# a float local is converted to an object where one is needed
+@micropython.viper
+def to_obj(a: float):
+    x = a * 2.0
+    l = [x]
+    return l
+
+
+print(to_obj(1.75))
+
+
+# errors
+def test(code):
+    try:
+        exec(code)
+    except ViperTypeError as e:
+        print(repr(e))
+
+
+test("@micropython.viper\ndef f(a: float): a % 1.0")
+test("@micropython.viper\ndef f(a: float): ~a")
+test("@micropython.viper\ndef f(a: float, b: uint): a + b")
+test("@micropython.viper\ndef f(a: float) -> int: return a")
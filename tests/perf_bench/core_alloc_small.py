@@ -0,0 +1,57 @@
+# This tests the speed of allocating small objects (floats, tuples, bound
+# methods, instances) in a heap fragmented by long-lived objects.
+
+
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+    def scale(self, k):
+        return Point(self.x * k, self.y * k)
+
+
+def test(niter, nlive):
+    # Interleave long-lived objects of various sizes with garbage, so that
+    # after a collection the free memory is spread over many small holes.
+    live = []
+    for i in range(nlive):
+        garbage = [i] * (i % 7)
+        live.append((i, "x" * (i % 13)))
+    garbage = None
+
+    total = 0
+    for i in range(niter):
+        p = Point(i, 0.5)
+        f = p.scale
+        q = f(2.0)
+        t = (q.x, q.y)
+        total += t[0]
+    return int(total) + len(live)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (500, 50),
+    (50, 10): (1000, 100),
+    (100, 10): (2000, 200),
+    (500, 10): (10000, 1000),
+    (1000, 10): (20000, 2000),
+    (5000, 10): (100000, 4000),
+}
+
+
+def bm_setup(params):
+    niter, nlive = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter, nlive)
+
+    def result():
+        return niter, state
+
+    return run, result
@@ -0,0 +1,61 @@
+# This tests the speed of instances with many attributes: creating them, reading
+# and writing attributes, calling methods (which first miss in the instance's
+# dict), iterating over __dict__, and dicts with removed keys.
+
+NUM_ATTRS = 50
+
+
+class Robot:
+    def __init__(self, i):
+        for j in range(NUM_ATTRS):
+            setattr(self, "a%d" % j, i + j)
+
+    def speed(self):
+        return self.a0 + self.a49
+
+    def step(self):
+        self.a25 += 1
+        return self.a25
+
+
+def test(n):
+    robots = [Robot(i) for i in range(n // 10)]
+    total = 0
+    for r in robots:
+        for i in range(10):
+            total += r.speed() + r.step()
+            total += hasattr(r, "name")
+        total += sum(r.__dict__.values())
+    d = {}
+    for i in range(n):
+        d[i] = i
+        if i >= 20:
+            del d[i - 20]
+    total += sum(d)
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (100,),
+    (50, 10): (500,),
+    (100, 10): (1000,),
+    (1000, 10): (10000,),
+    (5000, 10): (50000,),
+}
+
+
+def bm_setup(params):
+    (n,) = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(n)
+
+    def result():
+        return n, state
+
+    return run, result
@@ -0,0 +1,50 @@
+# This tests the speed of compiling source code when many qstrs have already
+# been interned, as in a long running program that has loaded a lot of code.
+# Most names in the source are looked up in the dynamic qstr pools.
+
+
+class Namespace:
+    pass
+
+
+def make_source(nqstr, nfunc):
+    # Intern a large number of names, like the identifiers of loaded modules.
+    ns = Namespace()
+    for i in range(nqstr):
+        name = "name_{}".format(i)
+        setattr(ns, name, i)
+        delattr(ns, name)
+
+    # Source that refers to many of those names, plus some local ones.
+    lines = []
+    for i in range(nfunc):
+        a = "arg_{}".format(i % 50)
+        n1 = "name_{}".format(i * 7 % nqstr)
+        n2 = "name_{}".format(i * 13 % nqstr)
+        lines.append("def func_{}({}, {}):".format(i, a, n1))
+        lines.append("    {} = {} + {}".format(n2, a, n1))
+        lines.append("    return {}.attr_{}".format(n2, i % 20))
+    return "\n".join(lines)
+
+
+def test(src, nloop):
+    for _ in range(nloop):
+        compile(src, "<bench>", "exec")
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (100, 5, 10),
+    (50, 10): (500, 10, 10),
+    (100, 10): (1000, 20, 10),
+    (1000, 10): (5000, 100, 10),
+    (5000, 10): (10000, 200, 20),
+}
+
+
+def bm_setup(params):
+    nqstr, nfunc, nloop = params
+    src = make_source(nqstr, nfunc)
+    return lambda: test(src, nloop), lambda: (nfunc * nloop // 10, None)
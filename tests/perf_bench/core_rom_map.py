@@ -0,0 +1,43 @@
+# This tests the speed of looking up names in large constant dicts: builtins
+# found through a function's globals, functions in the math module, and
+# methods of str, including names that are not there.
+
+import math
+
+
+def test(n):
+    s = "robot"
+    total = 0
+    for i in range(n):
+        total += len(s) + abs(-i) + min(i, 3)
+        f = math.sqrt, math.atan2, math.floor, math.fabs, math.log
+        f = s.lower, s.strip, s.replace, s.startswith, s.endswith, s.count
+        total += hasattr(s, "speed") + hasattr(math, "pid") + hasattr(str, "name")
+        total += getattr(math, "tau", 0) > 6
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (100,),
+    (50, 10): (500,),
+    (100, 10): (1000,),
+    (1000, 10): (10000,),
+    (5000, 10): (50000,),
+}
+
+
+def bm_setup(params):
+    (n,) = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(n)
+
+    def result():
+        return n, state
+
+    return run, result
@@ -0,0 +1,69 @@
+# Source: a two-wheel robot's speed control loop.
+# Each step turns encoder counts into wheel speeds and runs a PID controller
+# per wheel, so nearly every operation creates a new float.
+
+
+class PID:
+    def __init__(self, kp, ki, kd, limit):
+        self.kp = kp
+        self.ki = ki
+        self.kd = kd
+        self.limit = limit
+        self.integral = 0.0
+        self.last_error = 0.0
+
+    def step(self, target, measured, dt):
+        error = target - measured
+        self.integral += error * dt
+        if self.integral > self.limit:
+            self.integral = self.limit
+        elif self.integral < -self.limit:
+            self.integral = -self.limit
+        derivative = (error - self.last_error) / dt
+        self.last_error = error
+        out = self.kp * error + self.ki * self.integral + self.kd * derivative
+        return max(-1.0, min(1.0, out))
+
+
+def run(n):
+    rad_per_count = 2 * 3.14159265 / 1440
+    left = PID(1.2, 0.5, 0.01, 4.0)
+    right = PID(1.2, 0.5, 0.01, 4.0)
+    speed_l = speed_r = 0.0
+    count_l = count_r = 0
+    dt = 0.01
+    for i in range(n):
+        target = 6.0 if i % 400 < 200 else -3.0
+        # a crude motor model drives the encoders
+        count_l += int(speed_l * 40)
+        count_r += int(speed_r * 38)
+        w_l = speed_l * 40 * rad_per_count / dt
+        w_r = speed_r * 38 * rad_per_count / dt
+        speed_l = left.step(target, w_l, dt)
+        speed_r = right.step(target, w_r, dt)
+    return count_l, count_r
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (200,),
+    (100, 10): (500,),
+    (1000, 10): (4000,),
+    (5000, 10): (20000,),
+}
+
+
+def bm_setup(params):
+    (n,) = params
+    state = None
+
+    def run_bm():
+        nonlocal state
+        state = run(n)
+
+    def result():
+        return n, state
+
+    return run_bm, result
@@ -0,0 +1,73 @@
+# The control loop of misc_pid.py written in viper, so the floats are native
+# values in registers instead of objects on the heap.  The two wheels do not
+# interact, so each one runs in its own loop.
+
+try:
+    exec("@micropython.viper\ndef f(x: float) -> float:\n return x")
+except (NameError, ViperTypeError):
+    print("SKIP")
+    raise SystemExit
+
+
+@micropython.viper
+def run_wheel(n: int, gain: int) -> int:
+    rad_per_count = 2 * 3.14159265 / 1440
+    kp = 1.2
+    ki = 0.5
+    kd = 0.01
+    limit = 4.0
+    integral = 0.0
+    last_error = 0.0
+    speed = 0.0
+    count = 0
+    dt = 0.01
+    i = 0
+    while i < n:
+        target = 6.0 if i % 400 < 200 else -3.0
+        # a crude motor model drives the encoder
+        count += int(speed * gain)
+        w = speed * gain * rad_per_count / dt
+        error = target - w
+        integral += error * dt
+        if integral > limit:
+            integral = limit
+        elif integral < -limit:
+            integral = -limit
+        derivative = (error - last_error) / dt
+        last_error = error
+        speed = kp * error + ki * integral + kd * derivative
+        if speed > 1.0:
+            speed = 1.0
+        elif speed < -1.0:
+            speed = -1.0
+        i += 1
+    return count
+
+
+def run(n):
+    return run_wheel(n, 40), run_wheel(n, 38)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (200,),
+    (100, 10): (500,),
+    (1000, 10): (4000,),
+    (5000, 10): (20000,),
+}
+
+
+def bm_setup(params):
+    (n,) = params
+    state = None
+
+    def run_bm():
+        nonlocal state
+        state = run(n)
+
+    def result():
+        return n, state
+
+    return run_bm, result
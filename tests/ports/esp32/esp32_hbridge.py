@@ -0,0 +1,49 @@
+# Test the esp32 HBridge class - batched H-bridge motor PWM
+
+from esp32 import HBridge
+from machine import Pin, PWM
+
+pwms = [PWM(Pin(p), freq=1000, duty=0) for p in (4, 5, 18, 19)]
+
+hb = HBridge(pwms)
+print(hb.duty())
+
+# forward/backward drive only one input per motor
+hb.duty(512, -256)
+print(hb.duty())
+print([p.duty_u16() for p in pwms])
+
+# values are clamped to DUTY_MAX
+hb.duty(5000, -5000)
+print(hb.duty())
+print([p.duty() for p in pwms])
+
+# coast drives both inputs low, brake drives both high
+hb.coast()
+print([p.duty() for p in pwms])
+hb.brake()
+print([p.duty() for p in pwms])
+hb.duty(0, 100)
+print([p.duty() for p in pwms])
+
+# wrong number of duties
+try:
+    hb.duty(1)
+except TypeError:
+    print("TypeError")
+
+# odd number of PWM objects
+try:
+    HBridge(pwms[:3])
+except ValueError:
+    print("ValueError")
+
+# non-PWM objects
+try:
+    HBridge((1, 2))
+except TypeError:
+    print("TypeError")
+
+hb.stop(HBridge.COAST)
+for p in pwms:
+    p.deinit()
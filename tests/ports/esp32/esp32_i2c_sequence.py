@@ -0,0 +1,50 @@
+# Test esp32.I2CSequence argument checking and error reporting, with nothing
+# answering at the address used.
+
+import errno
+from esp32 import I2CSequence
+from machine import I2C, SoftI2C, Pin
+
+# A reserved address, so no device acknowledges it.
+ADDR = 0x78
+
+# Only hardware I2C is supported.
+try:
+    I2CSequence(SoftI2C(sda=Pin(21), scl=Pin(22)), ADDR, read=1)
+except TypeError:
+    print("TypeError")
+
+i2c = I2C(0, sda=Pin(21), scl=Pin(22))
+
+print(I2CSequence(i2c, ADDR, b"\x00", 2))
+print(I2CSequence(i2c, ADDR, read=32))
+print(I2CSequence(i2c, ADDR, bytes(16), stop=True))
+
+# Empty or too long sequences.
+for write, read in ((None, 0), (b"", 0), (bytes(17), 1), (b"\x00", 33), (b"\x00", -1)):
+    try:
+        I2CSequence(i2c, ADDR, write, read)
+    except ValueError as er:
+        print("ValueError", er)
+
+# A missing device is reported by run(), and by wait() after start().
+seq = I2CSequence(i2c, ADDR, b"\x00", 2)
+try:
+    seq.run()
+except OSError:
+    print("OSError")
+seq.start()
+try:
+    seq.wait()
+except OSError:
+    print("OSError")
+print(seq.done())
+
+# A deinitialised sequence can't be used.
+seq.deinit()
+seq.deinit()
+for method in (seq.run, seq.start, seq.wait):
+    try:
+        method()
+    except OSError as er:
+        print("OSError", er.errno == errno.EBADF)
@@ -0,0 +1,51 @@
+# Test the esp32.Recorder flight recorder.
+
+import esp32
+import struct
+
+try:
+    esp32.Partition.find(esp32.Partition.TYPE_DATA, label="rec")[0]
+except IndexError:
+    print("SKIP")
+    raise SystemExit
+
+esp32.Recorder.erase()
+
+rec = esp32.Recorder("hhf", "left,right,err")
+print(rec.stats())
+for i in range(5):
+    print(rec.log(i, -i, i / 2))
+
+# Wrong number of values.
+try:
+    rec.log(1, 2)
+except TypeError:
+    print("TypeError")
+
+# Only one recorder can be open.
+try:
+    esp32.Recorder("B")
+except OSError as er:
+    print("OSError", er.errno)
+
+rec.flush()
+print(rec.stats())
+rec.close()
+
+# Check the data written to flash.
+part = esp32.Partition.find(esp32.Partition.TYPE_DATA, label="rec")[0]
+buf = bytearray(4096)
+part.readblocks(0, buf)
+magic, ver, size, seq, session, fmt, names = struct.unpack("<4sHHII24s88s", buf[:128])
+print(magic, ver, size, seq, session, fmt.rstrip(b"\x00"), names.rstrip(b"\x00"))
+for i in range(5):
+    print(struct.unpack("<hhf", buf[128 + i * 12 + 4 : 128 + i * 12 + 12]))
+# Unused slots stay erased.
+print(buf[128 + 5 * 12 :] == b"\xff" * (4096 - 128 - 5 * 12))
+
+# A new recorder continues with the next session and sector.
+rec = esp32.Recorder("B")
+print(rec.stats()[0])
+rec.close()
+
+esp32.Recorder.erase()
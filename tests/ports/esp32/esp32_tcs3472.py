@@ -0,0 +1,25 @@
+# Test esp32.TCS3472 argument checking, which needs no sensor on the bus.
+
+from esp32 import TCS3472
+from machine import I2C, Pin
+
+i2c = I2C(0, sda=Pin(21), scl=Pin(22))
+
+# Not an I2C object.
+try:
+    TCS3472(None)
+except TypeError:
+    print("TypeError")
+
+# Unsupported gain and integration times are rejected before the bus is used.
+for kw in (
+    {"gain": 2},
+    {"gain": 0},
+    {"integration_ms": 0},
+    {"integration_ms": 1},
+    {"integration_ms": 700},
+):
+    try:
+        TCS3472(i2c, **kw)
+    except ValueError as er:
+        print("ValueError", er)
@@ -0,0 +1,60 @@
+# Test esp32.TCS3472 palette classification, with a sensor at the default address.
+
+from esp32 import TCS3472
+from machine import I2C, Pin
+from array import array
+
+i2c = I2C(0, sda=Pin(21), scl=Pin(22))
+if 0x29 not in i2c.scan():
+    print("SKIP")
+    raise SystemExit
+
+tcs = TCS3472(i2c)
+
+# No palette yet.
+try:
+    tcs.classify((1, 1, 1, 1))
+except ValueError as er:
+    print("ValueError", er)
+
+# Calibration samples for black, white, red, green, blue and grey.
+palette = [
+    (120, 45, 40, 35),
+    (4000, 1600, 1400, 1200),
+    (1500, 1000, 300, 250),
+    (1400, 300, 800, 350),
+    (1300, 250, 400, 700),
+    (2000, 800, 700, 600),
+]
+tcs.palette(palette)
+print(tcs)
+
+# Samples near each palette colour.
+samples = [
+    (100, 38, 33, 30),
+    (3800, 1500, 1350, 1150),
+    (1600, 1050, 330, 260),
+    (1300, 290, 720, 330),
+    (1200, 240, 370, 640),
+    (2100, 820, 730, 640),
+]
+print([tcs.classify(s) for s in samples])
+
+# A buffer of four uint16 works like a tuple, and no light is black.
+print(tcs.classify(array("H", samples[2])))
+print(tcs.classify((0, 0, 0, 0)))
+
+# With an explicit white level, brighter than the palette's.
+tcs.palette(palette, 8000)
+print(tcs.classify((8000, 3200, 2800, 2400)), tcs.classify((2000, 800, 700, 600)))
+
+# Bad samples and palettes.
+for sample in ((1, 2, 3), array("H", (1, 2, 3))):
+    try:
+        tcs.classify(sample)
+    except ValueError:
+        print("ValueError")
+try:
+    tcs.palette([(1, 1, 1, 1)] * 17)
+except ValueError as er:
+    print("ValueError", er)
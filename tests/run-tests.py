@@ -696,6 +696,14 @@ def run_tests(pyb, tests, args, result_dir, num_threads=1):
                 skip_tests.add("inlineasm/thumb/asmit.py")
                 skip_tests.add("inlineasm/thumb/asmspecialregs.py")
 
+        if args.inlineasm_arch == "xtensa":
+            # Check if @micropython.asm_xtensa supports FPU instructions, and skip such tests if it doesn't
+            output = run_feature_check(pyb, args, "inlineasm_xtensa_fp.py")
+            if output != b"xtensa_fp\n":
+                skip_tests.add("inlineasm/xtensa/asmfparith.py")
+                skip_tests.add("inlineasm/xtensa/asmfpcmp.py")
+                skip_tests.add("inlineasm/xtensa/asmfploadstore.py")
+
         # Check if emacs repl is supported, and skip such tests if it's not
         t = run_feature_check(pyb, args, "repl_emacs_check.py")
         if "True" not in str(t, "ascii"):